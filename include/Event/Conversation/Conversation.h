@@ -2,16 +2,24 @@
  * @class Conversation
  *
  * A conversation is one fully contained set of entries that are displayed to communicate
- * to the player through a dynamic content presentation system.
+ * to the player through a dynamic content presentation system. When a load asks for lazy
+ * subtrees (see {@link LoadOptions}), the entries are only built the first time they are
+ * accessed.
  */
 #ifndef CORE_CONVERSATION_H
 #define CORE_CONVERSATION_H
 
+#include <functional>
+#include <memory>
+
 #include "Event/Conversation/ConversationEntry.h"
 #include "Event/Conversation/ConversationEntryIndex.h"
 #include "Event/Conversation/ConversationEntryNone.h"
 #include "Event/Conversation/ConversationEntryText.h"
+#include "Persistence/LazySubtree.h"
+#include "Persistence/Profiler.h"
 #include "Persistence/XmlData.h"
+#include "Persistence/XmlDataView.h"
 #include "Persistence/XmlWriter.h"
 
 namespace core
@@ -29,6 +37,16 @@ namespace core
     ~Conversation();
 
   private:
+    /* Has the conversation changed since it was last saved, outside of the entries themselves?
+     * Mutable so a full save, which doesn't change the conversation, can clear it */
+    mutable bool dirty = true;
+
+    /* Entry data lines whose load is deferred until the entries are accessed */
+    mutable LazySubtree pending;
+
+    /* Settings of the load that deferred the pending lines, to replay them with */
+    LoadOptions pending_options;
+
     /* Starting conversation entry, top of the decision tree */
     ConversationEntry* root_entry = new ConversationEntryNone();
 
@@ -59,6 +77,15 @@ namespace core
                                      const ConversationEntryIndex& index,
                                      uint16_t group_max, uint16_t group = 0) const;
 
+    /* Loads a single entry data line into the tree */
+    void loadEntry(XmlDataView data, int index, const LoadOptions& options) const;
+
+    /* Loads the deferred entry data lines into the tree, if there are any */
+    void loadPending() const;
+
+    /* Marks the conversation as changed since it was last saved */
+    void markDirty();
+
     /* Saves an individual conversation entry into the XML writer */
     void save(XmlWriter* writer, const ConversationEntryIndex& index,
               ConversationEntry& entry) const;
@@ -67,6 +94,9 @@ namespace core
    * PUBLIC FUNCTIONS
    *============================================================================*/
   public:
+    /* Marks the conversation and all of its entries as matching the saved data */
+    void clearDirty();
+
     /* Deletes a single entry at the index in the conversation tree */
     void deleteEntry(const ConversationEntryIndex& index);
 
@@ -82,12 +112,21 @@ namespace core
     /* Inserts a single entry at the index in the conversation tree */
     void insertEntry(const ConversationEntryIndex& index, ConversationEntry& entry);
 
+    /* Returns if the conversation or any of its entries changed since it was last saved */
+    bool isDirty() const;
+
     /* Loads conversation data from the XML entry */
-    void load(XmlData data, int index);
+    void load(XmlDataView data, int index, const LoadOptions& options);
 
     /* Saves all conversation data into the XML writer */
     void save(XmlWriter* writer) const;
 
+    /* Rewrites the conversation data at the location in the XML writer, only if it changed */
+    bool saveIncremental(XmlWriter* writer, XmlData location);
+
+    /* Captures a copy of the conversation, as a task that saves it at the location */
+    std::function<void(XmlWriter*)> snapshot(XmlData location) const;
+
     /* Sets a single entry at the index in the conversation tree */
     void setEntry(const ConversationEntryIndex& index, ConversationEntry& entry);
 
@@ -12,7 +12,9 @@
 #include <vector>
 
 #include "Event/Conversation/ConversationEntryType.h"
+#include "Persistence/LoadOptions.h"
 #include "Persistence/XmlData.h"
+#include "Persistence/XmlDataView.h"
 #include "Persistence/XmlWriter.h"
 
 namespace core
@@ -30,6 +32,9 @@ namespace core
     virtual ~ConversationEntry();
 
   private:
+    /* Has the entry data changed since it was last saved? */
+    bool dirty = true;
+
     /* Set of next entry pointers following the current text entry */
     std::vector<ConversationEntry*> next_entries;
 
@@ -46,10 +51,20 @@ namespace core
     /* Pad set of next entries up to the index using the filler */
     void padNextEntries(uint8_t index, ConversationEntry& filler_entry);
 
+  /*=============================================================================
+   * PROTECTED FUNCTIONS
+   *============================================================================*/
+  protected:
+    /* Marks the entry data as changed since it was last saved */
+    void markDirty();
+
   /*=============================================================================
    * PUBLIC FUNCTIONS
    *============================================================================*/
   public:
+    /* Marks the entry, and all entries following it, as matching the saved data */
+    virtual void clearDirty();
+
     /* Deep clones the entry to return a new memory space version of the same data */
     virtual ConversationEntry* clone() const = 0;
 
@@ -68,11 +83,14 @@ namespace core
     /* Inserts a single entry following this entry at the given index in the vector */
     void insertNextEntry(uint8_t index, ConversationEntry& entry, ConversationEntry& filler_entry);
 
+    /* Returns if the entry, or any entry following it, changed since it was last saved */
+    virtual bool isDirty() const;
+
     /* Returns if the event can be saved */
     virtual bool isSaveable() const = 0;
 
     /* Loads event data from the XML entry */
-    virtual void load(XmlData data, int index) = 0;
+    virtual void load(XmlDataView data, int index, const LoadOptions& options) = 0;
 
     /* Saves all event data into the XML writer */
     virtual void save(XmlWriter* writer) const = 0;
@@ -8,8 +8,8 @@
 #ifndef CORE_CONVERSATIONENTRYINDEX_H
 #define CORE_CONVERSATIONENTRYINDEX_H
 
+#include <algorithm>
 #include <cstdint>
-#include <regex>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -38,9 +38,6 @@ namespace core
     /* Index string group delimiter */
     const static char kINDEX_GROUP_DELIMITER;
 
-    /* Index string strict format, in regex. Requires index in form "1.4.1" */
-    const static std::regex kINDEX_STRING_FORMAT;
-
   /*=============================================================================
    * PUBLIC FUNCTIONS
    *============================================================================*/
@@ -25,7 +25,7 @@ namespace core
     bool isSaveable() const override;
 
     /* Loads conversation entry data from the XML entry */
-    void load(XmlData data, int index) override;
+    void load(XmlDataView data, int index, const LoadOptions& options) override;
 
     /* Saves all conversation entry data into the XML writer */
     void save(XmlWriter* writer) const override;
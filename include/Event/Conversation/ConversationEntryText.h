@@ -66,6 +66,9 @@ namespace core
    * PUBLIC FUNCTIONS
    *============================================================================*/
   public:
+    /* Marks the entry, its event and all entries following it, as matching the saved data */
+    void clearDirty() override;
+
     /* Deep clones the entry to return a new memory space version of the same data */
     ConversationEntry* clone() const override;
 
@@ -84,11 +87,14 @@ namespace core
     /* Returns entry type classification */
     ConversationEntryType getType() const override;
 
+    /* Returns if the entry, its event or any entry following it, changed since last saved */
+    bool isDirty() const override;
+
     /* Returns if the conversation entry can be saved */
     bool isSaveable() const override;
 
     /* Loads conversation entry data from the XML entry */
-    void load(XmlData data, int index) override;
+    void load(XmlDataView data, int index, const LoadOptions& options) override;
 
     /* Saves all conversation entry data into the XML writer */
     void save(XmlWriter* writer) const override;
@@ -2,13 +2,20 @@
  * @class Event
  *
  * Event base abstract class. This parent centralizes the common event functionality shared
- * by all implementations.
+ * by all implementations, including tracking if the event changed since it was last saved.
+ * Every implementation is allocated from the {@link EventPool}.
  */
 #ifndef CORE_EVENT_H
 #define CORE_EVENT_H
 
+#include <cstddef>
+
+#include "Event/EventPool.h"
 #include "Event/EventType.h"
+#include "Persistence/Atom.h"
+#include "Persistence/LoadOptions.h"
 #include "Persistence/XmlData.h"
+#include "Persistence/XmlDataView.h"
 #include "Persistence/XmlWriter.h"
 
 namespace core
@@ -19,24 +26,55 @@ namespace core
     /* Destructor function of the implementation */
     virtual ~Event() = 0;
 
+  private:
+    /* Has the event data changed since it was last saved? */
+    bool dirty = true;
+
+  /*=============================================================================
+   * PROTECTED FUNCTIONS
+   *============================================================================*/
+  protected:
+    /* Marks the event data as changed since it was last saved */
+    void markDirty();
+
   /*=============================================================================
    * PUBLIC FUNCTIONS
    *============================================================================*/
   public:
+    /* Marks the event, and any nested events, as matching the saved data */
+    virtual void clearDirty();
+
     /* Deep clones the event to return a new memory space version of the same data */
     virtual Event* clone() const = 0;
 
+    /* Returns the slot of the nested event held by the XML element. Null if it holds none */
+    virtual Event** getNestedEvent(Atom element, XmlDataView data, int index,
+                                   const LoadOptions& options);
+
     /* Returns the event type classification of the implementation */
     virtual EventType getType() const = 0;
 
+    /* Returns if the event, or any nested event, changed since it was last saved */
+    virtual bool isDirty() const;
+
     /* Returns if the event can be saved */
     virtual bool isSaveable() const = 0;
 
     /* Loads event data from the XML entry */
-    virtual void load(XmlData data, int index) = 0;
+    virtual void load(XmlDataView data, int index, const LoadOptions& options) = 0;
 
     /* Saves all event data into the XML writer */
     virtual void save(XmlWriter* writer) const = 0;
+
+  /*=============================================================================
+   * OPERATOR FUNCTIONS
+   *============================================================================*/
+  public:
+    /* Allocates the memory of an event from the event pool */
+    static void* operator new(std::size_t size);
+
+    /* Returns the memory of an event to the event pool */
+    static void operator delete(void* event, std::size_t size);
   };
 };
 
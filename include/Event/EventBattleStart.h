@@ -2,7 +2,8 @@
  * @class EventBattleStart
  *
  * A battle start event definition for the configuration of the battle that will be set
- * up around the current player.
+ * up around the current player. When a load asks for lazy subtrees (see {@link LoadOptions}),
+ * the win and lose events are only built the first time they are accessed.
  */
 #ifndef CORE_EVENTBATTLESTART_H
 #define CORE_EVENTBATTLESTART_H
@@ -10,6 +11,7 @@
 #include "Event/EventNone.h"
 #include "Event/EventType.h"
 #include "Event/ExecutableEvent.h"
+#include "Persistence/LazySubtree.h"
 
 namespace core
 {
@@ -26,11 +28,11 @@ namespace core
     ~EventBattleStart() override;
 
   private:
-    /* Event to trigger on win condition */
-    Event* event_lose = new EventNone();
+    /* Event to trigger on lose condition. Mutable, since a deferred load finishes on access */
+    mutable Event* event_lose = new EventNone();
 
-    /* Event to trigger on lose condition */
-    Event* event_win = new EventNone();
+    /* Event to trigger on win condition. Mutable, since a deferred load finishes on access */
+    mutable Event* event_win = new EventNone();
 
     /* If on loss, should the game be over? */
     bool game_over_on_loss = false;
@@ -41,6 +43,12 @@ namespace core
     /* If on battle end, should qd is restored? */
     bool restore_qd = false;
 
+    /* Win and lose event data lines whose load is deferred until the events are accessed */
+    mutable LazySubtree pending;
+
+    /* Settings of the load that deferred the pending lines, to replay them with */
+    LoadOptions pending_options;
+
     /* If on win, should the initiating thing disappear? */
     bool target_hide_on_win = false;
 
@@ -62,7 +70,15 @@ namespace core
     void cloneSource(const EventBattleStart& source);
 
     /* Loads event data from the XML entry, specific to the event type (sub-class) */
-    void loadForType(std::string element, XmlData data, int index) override;
+    void loadForType(Atom element, XmlDataView data, int index,
+                     const LoadOptions& options) override;
+
+    /* Loads a win or lose event data line into the nested event */
+    void loadNestedEvent(Atom element, XmlDataView data, int index,
+                         const LoadOptions& options) const;
+
+    /* Loads the deferred win and lose event data lines, if there are any */
+    void loadPending() const;
 
     /* Saves all event data into the XML writer, specific to the event type (sub-class) */
     void saveForType(XmlWriter* writer) const override;
@@ -71,18 +87,28 @@ namespace core
    * PUBLIC FUNCTIONS
    *============================================================================*/
   public:
+    /* Marks the event, and any nested events, as matching the saved data */
+    void clearDirty() override;
+
     /* Deep clones the event to return a new memory space version of the same data */
     Event* clone() const override;
 
     /* Returns the event triggered on battle loss */
     Event& getLoseEvent() const;
 
+    /* Returns the slot of the nested event held by the XML element. Null if it holds none */
+    Event** getNestedEvent(Atom element, XmlDataView data, int index,
+                           const LoadOptions& options) override;
+
     /* Returns event type classification */
     EventType getType() const override;
 
     /* Returns the event triggered on battle win */
     Event& getWinEvent() const;
 
+    /* Returns if the event, or any nested event, changed since it was last saved */
+    bool isDirty() const override;
+
     /* Returns if on lose, the game should be over */
     bool isGameOverOnLoss() const;
 
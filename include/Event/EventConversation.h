@@ -25,7 +25,8 @@ namespace core
    *============================================================================*/
   private:
     /* Loads event data from the XML entry, specific to the event type (sub-class) */
-    void loadForType(std::string element, XmlData data, int index) override;
+    void loadForType(Atom element, XmlDataView data, int index,
+                     const LoadOptions& options) override;
 
     /* Saves all event data into the XML writer, specific to the event type (sub-class) */
     void saveForType(XmlWriter* writer) const override;
@@ -34,6 +35,9 @@ namespace core
    * PUBLIC FUNCTIONS
    *============================================================================*/
   public:
+    /* Marks the event, and any nested events, as matching the saved data */
+    void clearDirty() override;
+
     /* Deep clones the event to return a new memory space version of the same data */
     Event* clone() const override;
 
@@ -43,6 +47,9 @@ namespace core
     /* Returns event type classification */
     EventType getType() const override;
 
+    /* Returns if the event, or any entry in the conversation, changed since it was last saved */
+    bool isDirty() const override;
+
     /* Sets the conversation data to display when triggered */
     void setConversation(Conversation& conversation);
   };
@@ -49,7 +49,8 @@ namespace core
    *============================================================================*/
   private:
     /* Loads event data from the XML entry, specific to the event type (sub-class) */
-    void loadForType(std::string element, XmlData data, int index) override;
+    void loadForType(Atom element, XmlDataView data, int index,
+                     const LoadOptions& options) override;
 
     /* Saves all event data into the XML writer, specific to the event type (sub-class) */
     void saveForType(XmlWriter* writer) const override;
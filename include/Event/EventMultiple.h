@@ -8,13 +8,14 @@
 #define CORE_EVENTMULTIPLE_H
 
 #include <cstdint>
-#include <regex>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "Event/EventNone.h"
 #include "Event/EventType.h"
 #include "Event/ExecutableEvent.h"
+#include "Persistence/TextEncoding.h"
 
 namespace core
 {
@@ -40,8 +41,8 @@ namespace core
     const static std::string kKEY_EVENT;
     const static std::string kKEY_EVENT_ID;
 
-    /* Format representing a positive integer, 0+ */
-    const static std::regex kPOSITIVE_INTEGER_FORMAT;
+    /* Characters of a positive integer, 0+ */
+    const static std::string_view kPOSITIVE_INTEGER_CHARS;
 
   /*=============================================================================
    * PRIVATE FUNCTIONS
@@ -54,7 +55,8 @@ namespace core
     void deleteEvents();
 
     /* Loads event data from the XML entry, specific to the event type (sub-class) */
-    void loadForType(std::string element, XmlData data, int index) override;
+    void loadForType(Atom element, XmlDataView data, int index,
+                     const LoadOptions& options) override;
 
     /* Saves all event data into the XML writer, specific to the event type (sub-class) */
     void saveForType(XmlWriter* writer) const override;
@@ -63,6 +65,9 @@ namespace core
    * PUBLIC FUNCTIONS
    *============================================================================*/
   public:
+    /* Marks the event, and any nested events, as matching the saved data */
+    void clearDirty() override;
+
     /* Deep clones the event to return a new memory space version of the same data */
     Event* clone() const override;
 
@@ -72,9 +77,16 @@ namespace core
     /* Returns the number of events in the multiple stack */
     uint8_t getEventCount();
 
+    /* Returns the slot of the nested event held by the XML element. Null if it holds none */
+    Event** getNestedEvent(Atom element, XmlDataView data, int index,
+                           const LoadOptions& options) override;
+
     /* Returns event type classification */
     EventType getType() const override;
 
+    /* Returns if the event, or any nested event, changed since it was last saved */
+    bool isDirty() const override;
+
     /* Sets the event in the multiple stack at the index location */
     void setEvent(uint8_t index, Event& event);
 
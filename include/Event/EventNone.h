@@ -24,7 +24,7 @@ namespace core
     bool isSaveable() const override;
 
     /* Loads event data from the XML entry */
-    void load(XmlData data, int index) override;
+    void load(XmlDataView data, int index, const LoadOptions& options) override;
 
     /* Saves all event data into the XML writer */
     void save(XmlWriter* writer) const override;
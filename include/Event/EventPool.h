@@ -0,0 +1,119 @@
+/**
+ * @class EventPool
+ *
+ * Pooled memory for every event object (see Event::operator new). Events are small and are made
+ * and dropped in bursts (a placeholder replaced by the loaded type, a snapshot clone for a save),
+ * so instead of a heap allocation each, they are carved from chunks of same sized slots, one
+ * size class per 16 bytes. Each thread keeps its own free list of each class, so a new or delete
+ * is a pointer swap without a lock, and the events made together by a load sit next to each
+ * other in the chunks.
+ *
+ * Free slots move between threads through a shared list, under a lock, a chunk's worth at a
+ * time: a thread takes from it before making a new chunk, and gives to it once it holds more
+ * than a few chunks of free slots, such as the saver thread deleting the clones made on the main
+ * thread. A thread gives all of its slots back when it finishes. Chunks are reused, so the pool
+ * only grows to the most events alive at once, until trim() frees the chunks that are entirely
+ * free again, such as once a map is unloaded and its events are dropped.
+ */
+#ifndef CORE_EVENTPOOL_H
+#define CORE_EVENTPOOL_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace core
+{
+  class EventPool
+  {
+    /*------------------- Constants -----------------------*/
+  public:
+    /* Size step between the size classes, which is also the alignment of every slot */
+    const static size_t kALIGNMENT = 16;
+
+    /* Number of size classes. Larger objects are allocated from the heap */
+    const static size_t kCLASS_COUNT = 8;
+
+    /* Largest object size that is pooled */
+    const static size_t kMAX_SIZE = kALIGNMENT * kCLASS_COUNT;
+
+  private:
+    /* Number of free slots of a class a thread keeps before giving them to the shared list */
+    const static size_t kMAX_THREAD_SLOTS = 256;
+
+    /* Number of slots in each chunk, and moved at once between a thread and the shared list */
+    const static size_t kSLOTS_PER_CHUNK = 64;
+
+    /* Free slot, linked into the free list of its size class */
+    struct FreeSlot
+    {
+      FreeSlot* next;
+    };
+
+    /* Free slots of each size class */
+    struct FreeLists
+    {
+      std::array<FreeSlot*, kCLASS_COUNT> heads;
+      std::array<size_t, kCLASS_COUNT> counts;
+    };
+
+    /* Free lists of a thread. Has no destructor, so it can still be used by deletes that run
+     * after the thread has given its slots back */
+    struct ThreadLists
+    {
+      FreeLists lists;
+      bool released;
+    };
+
+    /* Gives the free slots of the thread back to the shared lists when the thread finishes */
+    struct ThreadRelease
+    {
+      ~ThreadRelease();
+    };
+
+    /* Chunks made for each size class, guarded by the lock */
+    static std::array<std::vector<char*>, kCLASS_COUNT> chunks;
+
+    /* Free slots given back by the threads, guarded by the lock */
+    static FreeLists shared_lists;
+    static std::mutex shared_lock;
+
+    /* Total bytes of the chunks made so far */
+    static std::atomic<size_t> reserved_bytes;
+
+  /*=============================================================================
+   * PRIVATE STATIC FUNCTIONS
+   *============================================================================*/
+  private:
+    /* Returns the free lists of the calling thread */
+    static ThreadLists& getThreadLists();
+
+    /* Moves up to the count of free slots of the class from one list to the other */
+    static void moveSlots(FreeLists& from, FreeLists& to, size_t size_class, size_t count);
+
+    /* Fills the empty thread list of the class from the shared list, or a new chunk */
+    static void refill(FreeLists& lists, size_t size_class);
+
+  /*=============================================================================
+   * PUBLIC STATIC FUNCTIONS
+   *============================================================================*/
+  public:
+    /* Allocates memory for an object of the size */
+    static void* allocate(size_t size);
+
+    /* Frees the memory of an object of the size, that was allocated by the pool */
+    static void deallocate(void* memory, size_t size);
+
+    /* Returns the total bytes of the chunks that the pool holds */
+    static size_t getReservedBytes();
+
+    /* Frees every chunk whose slots are all free. Returns the bytes freed */
+    static size_t trim();
+  };
+};
+
+#endif // CORE_EVENTPOOL_H
@@ -9,12 +9,13 @@
 #define CORE_EVENTPROPERTY_H
 
 #include <cstdint>
+#include <stdexcept>
 #include <string>
-#include <unordered_map>
 
 #include "Event/EventType.h"
 #include "Event/ExecutableEvent.h"
 #include "Map/Tracking.h"
+#include "Persistence/NameRegistry.h"
 
 namespace core
 {
@@ -79,15 +80,13 @@ namespace core
     const static std::string kKEY_THING_RESPAWN;
     const static std::string kKEY_THING_RESPAWN_DISABLED;
     const static std::string kKEY_THING_VISIBLE;
-    const static std::string kKEY_TRACKING_AVOID;
-    const static std::string kKEY_TRACKING_CHASE;
-    const static std::string kKEY_TRACKING_NONE;
 
-    /* Tracking enumerator from string key map */
-    const static std::unordered_map<std::string, Tracking> kTRACKING_FROM_STRING;
-
-    /* Tracking enumerator to string key map */
-    const static std::unordered_map<Tracking, std::string> kTRACKING_TO_STRING;
+    /* Tracking names, indexed by the tracking enumerator */
+    constexpr static NameRegistry<Tracking, 3> kTRACKING_REGISTRY{{
+      "notrack",
+      "avoidplayer",
+      "toplayer"
+    }};
 
   public:
     /* Unset thing ID */
@@ -98,7 +97,8 @@ namespace core
    *============================================================================*/
   private:
     /* Loads event data from the XML entry, specific to the event type (sub-class) */
-    void loadForType(std::string element, XmlData data, int index) override;
+    void loadForType(Atom element, XmlDataView data, int index,
+                     const LoadOptions& options) override;
 
     /* Saves all event data into the XML writer, specific to the event type (sub-class) */
     void saveForType(XmlWriter* writer) const override;
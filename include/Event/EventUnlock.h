@@ -42,10 +42,11 @@ namespace core
    *============================================================================*/
   private:
     /* Loads event data from the XML entry, specific to the event type (sub-class) */
-    void loadForType(std::string element, XmlData data, int index) override;
+    void loadForType(Atom element, XmlDataView data, int index,
+                     const LoadOptions& options) override;
 
     /* Loads unlock event data from the XML entry, specific to the unlock type */
-    virtual void loadForUnlock(std::string element, XmlData data, int index) = 0;
+    virtual void loadForUnlock(Atom element, XmlDataView data, int index) = 0;
 
     /* Saves all event data into the XML writer, specific to the event type (sub-class) */
     void saveForType(XmlWriter* writer) const override;
@@ -35,7 +35,7 @@ namespace core
    *============================================================================*/
   private:
     /* Loads unlock event data from the XML entry, specific to the unlock type */
-    void loadForUnlock(std::string element, XmlData data, int index) override;
+    void loadForUnlock(Atom element, XmlDataView data, int index) override;
 
     /* Saves unlock event data into the XML writer, specific to the unlock type */
     void saveForUnlock(XmlWriter* writer) const override;
@@ -11,6 +11,7 @@
 
 #include "Event/Event.h"
 #include "Persistence/XmlData.h"
+#include "Persistence/XmlDataView.h"
 #include "Persistence/XmlWriter.h"
 
 namespace core
@@ -39,7 +40,8 @@ namespace core
    *============================================================================*/
   private:
     /* Loads event data from the XML entry, specific to the event type (sub-class) */
-    virtual void loadForType(std::string element, XmlData data, int index) = 0;
+    virtual void loadForType(Atom element, XmlDataView data, int index,
+                             const LoadOptions& options) = 0;
 
     /* Saves all event data into the XML writer, specific to the event type (sub-class) */
     virtual void saveForType(XmlWriter* writer) const = 0;
@@ -58,7 +60,7 @@ namespace core
     bool isSaveable() const override;
 
     /* Loads event data from the XML entry */
-    void load(XmlData data, int index) override;
+    void load(XmlDataView data, int index, const LoadOptions& options) override;
 
     /* Saves all event data into the XML writer */
     void save(XmlWriter* writer) const override;
@@ -27,7 +27,7 @@ namespace core
    *============================================================================*/
   private:
     /* Loads lock data from the XML entry, specific to the lock type (sub-class) */
-    virtual void loadForType(std::string element, XmlData data, int index) = 0;
+    virtual void loadForType(Atom element, XmlDataView data, int index) = 0;
 
     /* Saves lock data into the XML writer, specific to the lock type (sub-class) */
     virtual void saveForType(XmlWriter* writer) const = 0;
@@ -43,7 +43,7 @@ namespace core
     bool isSaveable() const override;
 
     /* Loads lock data from the XML entry */
-    void load(XmlData data, int index) override;
+    void load(XmlDataView data, int index) override;
 
     /* Saves lock data into the XML writer */
     void save(XmlWriter* writer) const override;
@@ -9,6 +9,7 @@
 
 #include "Event/Lock/LockType.h"
 #include "Persistence/XmlData.h"
+#include "Persistence/XmlDataView.h"
 #include "Persistence/XmlWriter.h"
 
 namespace core
@@ -33,7 +34,7 @@ namespace core
     virtual bool isSaveable() const = 0;
 
     /* Loads lock data from the XML entry */
-    virtual void load(XmlData data, int index) = 0;
+    virtual void load(XmlDataView data, int index) = 0;
 
     /* Saves lock data into the XML writer */
     virtual void save(XmlWriter* writer) const = 0;
@@ -44,7 +44,7 @@ namespace core
    *============================================================================*/
   private:
     /* Loads lock data from the XML entry, specific to the lock type (sub-class) */
-    void loadForType(std::string element, XmlData data, int index) override;
+    void loadForType(Atom element, XmlDataView data, int index) override;
 
     /* Saves lock data into the XML writer, specific to the lock type (sub-class) */
     void saveForType(XmlWriter* writer) const override;
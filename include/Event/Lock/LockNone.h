@@ -23,7 +23,7 @@ namespace core
     bool isSaveable() const override;
 
     /* Loads lock data from the XML entry */
-    void load(XmlData data, int index) override;
+    void load(XmlDataView data, int index) override;
 
     /* Saves lock data into the XML writer */
     void save(XmlWriter* writer) const override;
@@ -8,14 +8,18 @@
 #ifndef CORE_PERSISTLOCK_H
 #define CORE_PERSISTLOCK_H
 
-#include <unordered_map>
+#include <stdexcept>
+#include <string>
 
 #include "Event/Lock/Lock.h"
 #include "Event/Lock/LockItem.h"
 #include "Event/Lock/LockNone.h"
 #include "Event/Lock/LockTrigger.h"
 #include "Event/Lock/LockType.h"
+#include "Persistence/NameRegistry.h"
+#include "Persistence/Profiler.h"
 #include "Persistence/XmlData.h"
+#include "Persistence/XmlDataView.h"
 #include "Persistence/XmlWriter.h"
 
 namespace core
@@ -24,16 +28,12 @@ namespace core
   {
   /*------------------- Constants -----------------------*/
   private:
-    /* Data storage key names */
-    const static std::string kKEY_TYPE_ITEM;
-    const static std::string kKEY_TYPE_NONE;
-    const static std::string kKEY_TYPE_TRIGGER;
-
-    /* Lock type enumerator from string key map */
-    const static std::unordered_map<std::string, LockType> kTYPE_FROM_STRING;
-
-    /* Lock type enumerator to string key map */
-    const static std::unordered_map<LockType, std::string> kTYPE_TO_STRING;
+    /* Lock type names, indexed by the lock type enumerator */
+    constexpr static NameRegistry<LockType, 3> kTYPE_REGISTRY{{
+      "none",
+      "item",
+      "trigger"
+    }};
 
   /*=============================================================================
    * PRIVATE STATIC FUNCTIONS
@@ -47,7 +47,7 @@ namespace core
    *============================================================================*/
   public:
     /* Loads lock data from the XML entry */
-    static Lock* load(Lock* lock, XmlData data, int index);
+    static Lock* load(Lock* lock, XmlDataView data, int index);
 
     /* Saves lock data into the XML writer */
     static void save(Lock* lock, XmlWriter* writer, bool save_if_invalid = false);
@@ -8,7 +8,10 @@
 #ifndef CORE_PERSISTEVENT_H
 #define CORE_PERSISTEVENT_H
 
-#include <unordered_map>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
 
 #include "Event/Event.h"
 #include "Event/EventBattleStart.h"
@@ -27,7 +30,12 @@
 #include "Event/EventUnlockIO.h"
 #include "Event/EventUnlockThing.h"
 #include "Event/EventUnlockTile.h"
+#include "Persistence/Atom.h"
+#include "Persistence/ElementPathDfa.h"
+#include "Persistence/NameRegistry.h"
+#include "Persistence/Profiler.h"
 #include "Persistence/XmlData.h"
+#include "Persistence/XmlDataView.h"
 #include "Persistence/XmlWriter.h"
 
 namespace core
@@ -36,28 +44,50 @@ namespace core
   {
   /*------------------- Constants -----------------------*/
   private:
-    /* Data storage key names */
-    const static std::string kKEY_TYPE_BATTLESTART;
-    const static std::string kKEY_TYPE_CONVERSATION;
-    const static std::string kKEY_TYPE_ITEMGIVE;
-    const static std::string kKEY_TYPE_ITEMTAKE;
-    const static std::string kKEY_TYPE_MAPSWITCH;
-    const static std::string kKEY_TYPE_MULTIPLE;
-    const static std::string kKEY_TYPE_NONE;
-    const static std::string kKEY_TYPE_NOTIFICATION;
-    const static std::string kKEY_TYPE_PROPERTY;
-    const static std::string kKEY_TYPE_SOUND;
-    const static std::string kKEY_TYPE_TELEPORT;
-    const static std::string kKEY_TYPE_TRIGGERIO;
-    const static std::string kKEY_TYPE_UNLOCKIO;
-    const static std::string kKEY_TYPE_UNLOCKTHING;
-    const static std::string kKEY_TYPE_UNLOCKTILE;
+    /* Event type names, indexed by the event type enumerator */
+    constexpr static NameRegistry<EventType, 15> kTYPE_REGISTRY{{
+      "none",
+      "startbattle",
+      "conversation",
+      "giveitem",
+      "takeitem",
+      "startmap",
+      "multiple",
+      "notification",
+      "propertymod",
+      "justsound",
+      "teleportthing",
+      "triggerio",
+      "unlockio",
+      "unlockthing",
+      "unlocktile"
+    }};
 
-    /* Event type enumerator from string key map */
-    const static std::unordered_map<std::string, EventType> kTYPE_FROM_STRING;
+    /* Load path state that expects an event type element, after the state of each event type */
+    constexpr static EventType kPATH_EVENT = static_cast<EventType>(15);
 
-    /* Event type enumerator to string key map */
-    const static std::unordered_map<EventType, std::string> kTYPE_TO_STRING;
+    /* Schema of the event load paths. Each event type element leads to the state of its type,
+     * and each element holding a nested event leads back to expecting an event type. The
+     * "none" type isn't interned, so it falls back to the name lookup */
+    constexpr static ElementPathDfa<EventType, 16, 17> kLOAD_PATHS{{
+      {kPATH_EVENT, Atom::CONVERSATION, EventType::CONVERSATION},
+      {kPATH_EVENT, Atom::GIVEITEM, EventType::ITEMGIVE},
+      {kPATH_EVENT, Atom::JUSTSOUND, EventType::SOUND},
+      {kPATH_EVENT, Atom::MULTIPLE, EventType::MULTIPLE},
+      {kPATH_EVENT, Atom::NOTIFICATION, EventType::NOTIFICATION},
+      {kPATH_EVENT, Atom::PROPERTYMOD, EventType::PROPERTY},
+      {kPATH_EVENT, Atom::STARTBATTLE, EventType::BATTLESTART},
+      {kPATH_EVENT, Atom::STARTMAP, EventType::MAPSWITCH},
+      {kPATH_EVENT, Atom::TAKEITEM, EventType::ITEMTAKE},
+      {kPATH_EVENT, Atom::TELEPORTTHING, EventType::TELEPORT},
+      {kPATH_EVENT, Atom::TRIGGERIO, EventType::TRIGGERIO},
+      {kPATH_EVENT, Atom::UNLOCKIO, EventType::UNLOCKIO},
+      {kPATH_EVENT, Atom::UNLOCKTHING, EventType::UNLOCKTHING},
+      {kPATH_EVENT, Atom::UNLOCKTILE, EventType::UNLOCKTILE},
+      {EventType::BATTLESTART, Atom::EVENTLOSE, kPATH_EVENT},
+      {EventType::BATTLESTART, Atom::EVENTWIN, kPATH_EVENT},
+      {EventType::MULTIPLE, Atom::EVENT, kPATH_EVENT}
+    }};
 
   /*=============================================================================
    * PRIVATE STATIC FUNCTIONS
@@ -66,15 +96,27 @@ namespace core
     /* Create an empty event of the given type */
     static Event* createEventFromType(EventType type);
 
+    /* Returns the event type of the XML element, which names it */
+    static EventType getTypeFromData(XmlDataView data, int index);
+
   /*=============================================================================
    * PUBLIC STATIC FUNCTIONS
    *============================================================================*/
   public:
     /* Loads event data from the XML entry */
-    static Event* load(Event* event, XmlData data, int index);
+    static Event* load(Event* event, XmlDataView data, int index,
+                       const LoadOptions& options = LoadOptions());
 
     /* Saves all event data into the XML writer */
     static void save(Event* event, XmlWriter* writer, bool save_if_invalid = false);
+
+    /* Rewrites the event data at the location in the XML writer, only if it changed */
+    static bool saveIncremental(Event* event, XmlWriter* writer, XmlData location,
+                                bool save_if_invalid = false);
+
+    /* Captures a copy of the event, as a task that saves it at the location in the XML writer */
+    static std::function<void(XmlWriter*)> snapshot(const Event* event, XmlData location,
+                                                    bool save_if_invalid = false);
   };
 };
 
@@ -9,6 +9,7 @@
 
 #include <cstdint>
 #include <optional>
+#include <stdexcept>
 #include <unordered_map>
 
 #include "Foundation/Direction.h"
@@ -12,6 +12,7 @@
 #include <cstdint>
 #include <memory>
 #include <optional>
+#include <stdexcept>
 #include <string>
 
 #include "Event/Event.h"
@@ -40,6 +41,9 @@ namespace core
     /* Render-ready image info for the dialog snapshot of the object */
     std::optional<Frame> dialog_image;
 
+    /* Has the thing data changed since it was last saved? */
+    bool dirty = true;
+
     /* Object general event, triggered during interaction by the player */
     std::unique_ptr<Event> event;
 
@@ -76,10 +80,20 @@ namespace core
     const static bool kDEFAULT_ACTIVE = true;
     const static bool kDEFAULT_VISIBLE = true;
 
+  /*=============================================================================
+   * PROTECTED FUNCTIONS
+   *============================================================================*/
+  protected:
+    /* Marks the thing data as changed since it was last saved */
+    void markDirty();
+
   /*=============================================================================
    * PUBLIC FUNCTIONS
    *============================================================================*/
   public:
+    /* Marks the thing and its event as matching the saved data */
+    void clearDirty();
+
     /* Returns the base thing reference for defining the underlying reference definition */
     std::weak_ptr<MapThing> getBase() const;
 
@@ -132,6 +146,9 @@ namespace core
     /* Returns if the render-ready image info for the dialog snapshot of the object is set */
     bool isDialogImageSet(bool check_base = true) const;
 
+    /* Returns if the thing or its event changed since it was last saved */
+    bool isDirty() const;
+
     /* Returns if the the associated object event is set */
     bool isEventSet(bool check_base = true) const;
 
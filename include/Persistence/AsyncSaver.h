@@ -0,0 +1,99 @@
+/**
+ * @class AsyncSaver
+ *
+ * Double buffered background save pipeline. The calling thread only captures a snapshot: a set
+ * of save tasks that each own an immutable copy of the state they write. commit() hands the
+ * snapshot to a worker thread, which serializes it through the writer into its own buffer and
+ * commits it atomically with stop(true), while the next snapshot is captured. If a snapshot is
+ * committed while an older one is still waiting for the worker, the newer one replaces it, since
+ * every snapshot is a whole save.
+ */
+#ifndef CORE_ASYNCSAVER_H
+#define CORE_ASYNCSAVER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Persistence/XmlWriter.h"
+
+namespace core
+{
+  class AsyncSaver
+  {
+  public:
+    /* A single save step, which writes the state it owns at the current writer node */
+    using SaveTask = std::function<void(XmlWriter*)>;
+
+    /* Constructor function, from the writer that the worker saves through */
+    AsyncSaver(std::unique_ptr<XmlWriter> writer);
+
+    /* Destructor function */
+    ~AsyncSaver();
+
+  private:
+    /* Snapshot being captured on the calling thread */
+    std::vector<SaveTask> capture;
+
+    /* Number of snapshots committed and saved by the worker */
+    uint32_t committed_count = 0;
+    uint32_t saved_count = 0;
+
+    /* First exception thrown by a save task, held until wait() */
+    std::exception_ptr error;
+
+    /* Guards everything shared with the worker below */
+    std::mutex lock;
+
+    /* Did the last save that finished succeed? */
+    bool last_success = true;
+
+    /* Snapshot committed and waiting for the worker */
+    std::vector<SaveTask> pending;
+
+    /* Signals the worker and the waiting threads when the state changes */
+    std::condition_variable signal;
+
+    /* Is the worker shutting down? */
+    bool stopping = false;
+
+    /* Background thread that runs the saves */
+    std::thread worker;
+
+    /* Writer used only by the worker */
+    std::unique_ptr<XmlWriter> writer;
+
+  /*=============================================================================
+   * PRIVATE FUNCTIONS
+   *============================================================================*/
+  private:
+    /* Runs the saves of the worker thread until it's stopped */
+    void runWorker();
+
+    /* Saves the snapshot through the writer, from start() to stop() */
+    bool saveSnapshot(std::vector<SaveTask>& snapshot);
+
+  /*=============================================================================
+   * PUBLIC FUNCTIONS
+   *============================================================================*/
+  public:
+    /* Adds a save task to the snapshot being captured */
+    void add(SaveTask task);
+
+    /* Commits the captured snapshot to be saved by the worker */
+    bool commit();
+
+    /* Returns if a committed snapshot hasn't been saved yet */
+    bool isSaving();
+
+    /* Waits for every committed snapshot to be saved. Returns the success of the last one */
+    bool wait();
+  };
+};
+
+#endif // CORE_ASYNCSAVER_H
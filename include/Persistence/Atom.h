@@ -0,0 +1,79 @@
+/**
+ * @class Atom
+ *
+ * Enumerator defining the interned element and attribute key names that the load path
+ * dispatches on. Each atom is named after the exact name it interns (see {@link AtomTable}).
+ * Any name outside of this set is NONE.
+ */
+#ifndef CORE_ATOM_H
+#define CORE_ATOM_H
+
+#include <cstdint>
+
+namespace core
+{
+  enum class Atom : std::uint16_t
+  {
+    NONE = 0,
+    ACTIVE,
+    AUTODROP,
+    CHANCE,
+    CONSUME,
+    CONVERSATION,
+    COUNT,
+    DELAY,
+    ENTRY,
+    EVENT,
+    EVENTALL,
+    EVENTENTER,
+    EVENTEXIT,
+    EVENTLOSE,
+    EVENTUSE,
+    EVENTWALKOVER,
+    EVENTWIN,
+    FORCEINTERACT,
+    GIVEITEM,
+    ID,
+    INACTIVE,
+    INACTIVE_DISABLE,
+    JUSTSOUND,
+    LOSEGG,
+    MODELOCK,
+    MOVEDISABLE,
+    MULTIPLE,
+    NOTIFICATION,
+    ONE_SHOT,
+    PERMANENT,
+    PROPERTYMOD,
+    RESETLOCATION,
+    RESPAWN,
+    RESPAWN_DISABLE,
+    RESTOREHEALTH,
+    RESTOREQD,
+    SECTION,
+    SECTIONID,
+    SOUND_ID,
+    SPEED,
+    STARTBATTLE,
+    STARTMAP,
+    STATE,
+    TAKEITEM,
+    TELEPORTTHING,
+    TEXT,
+    TRACKING,
+    TRIGGERIO,
+    TYPE,
+    UNLOCKIO,
+    UNLOCKTHING,
+    UNLOCKTILE,
+    VIEW,
+    VIEWSCROLL,
+    VIEWTIME,
+    VISIBLE,
+    WINDISAPPEAR,
+    X,
+    Y
+  };
+};
+
+#endif // CORE_ATOM_H
@@ -0,0 +1,102 @@
+/**
+ * @class AtomTable
+ *
+ * Global table that interns element and attribute key names into {@link Atom}s. Names are
+ * resolved once, when they are added to a line of data, so the load path can dispatch with a
+ * switch on small integers instead of comparing strings.
+ */
+#ifndef CORE_ATOMTABLE_H
+#define CORE_ATOMTABLE_H
+
+#include <cstddef>
+#include <string_view>
+
+#include "Persistence/Atom.h"
+#include "Persistence/NameRegistry.h"
+
+namespace core
+{
+  class AtomTable
+  {
+    /*------------------- Constants -----------------------*/
+  public:
+    /* Number of atoms, including NONE */
+    const static size_t kCOUNT = static_cast<size_t>(Atom::Y) + 1;
+
+  private:
+    /* Interned name of each atom, indexed by the atom value */
+    constexpr static NameRegistry<Atom, kCOUNT> kREGISTRY{{
+      "",
+      "active",
+      "autodrop",
+      "chance",
+      "consume",
+      "conversation",
+      "count",
+      "delay",
+      "entry",
+      "event",
+      "eventall",
+      "evententer",
+      "eventexit",
+      "eventlose",
+      "eventuse",
+      "eventwalkover",
+      "eventwin",
+      "forceinteract",
+      "giveitem",
+      "id",
+      "inactive",
+      "inactive_disable",
+      "justsound",
+      "losegg",
+      "modelock",
+      "movedisable",
+      "multiple",
+      "notification",
+      "one_shot",
+      "permanent",
+      "propertymod",
+      "resetlocation",
+      "respawn",
+      "respawn_disable",
+      "restorehealth",
+      "restoreqd",
+      "section",
+      "sectionid",
+      "sound_id",
+      "speed",
+      "startbattle",
+      "startmap",
+      "state",
+      "takeitem",
+      "teleportthing",
+      "text",
+      "tracking",
+      "triggerio",
+      "type",
+      "unlockio",
+      "unlockthing",
+      "unlocktile",
+      "view",
+      "viewscroll",
+      "viewtime",
+      "visible",
+      "windisappear",
+      "x",
+      "y"
+    }};
+
+  /*=============================================================================
+   * PUBLIC STATIC FUNCTIONS
+   *============================================================================*/
+  public:
+    /* Returns the atom for the name. NONE if the name is not interned */
+    static Atom fromName(std::string_view name);
+
+    /* Returns the interned name of the atom. Blank for NONE */
+    static std::string_view getName(Atom atom);
+  };
+};
+
+#endif // CORE_ATOMTABLE_H
@@ -0,0 +1,71 @@
+/**
+ * @class BinaryEncoding
+ *
+ * Primitive encoders and decoders for the binary content format. A binary file is the magic
+ * "FISB" and a version byte, followed by a flat sequence of records that each start with a
+ * {@link BinaryRecordType} tag byte:
+ *  - DICT:  string. Defines the next dictionary id (ids count up from 0)
+ *  - OPEN:  name id, key id + 1 (0 if no key) and the key value string if there is a key
+ *  - CLOSE: no payload, closes the last open element
+ *  - DATA:  name id, {@link DataType} byte and the typed payload
+ *  - REF:   offset of the OPEN record of an earlier element, which is read again in its place
+ *           (without its DICT records). Used for repeated subtrees
+ * Unsigned numbers are LEB128 varints and signed integers are zigzag encoded first. Strings are
+ * a varint length and the raw bytes. Floats are the 4 byte IEEE pattern, little endian.
+ */
+#ifndef CORE_BINARYENCODING_H
+#define CORE_BINARYENCODING_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#include "Persistence/PageBuffer.h"
+
+namespace core
+{
+  class BinaryEncoding
+  {
+    /*------------------- Constants -----------------------*/
+  public:
+    /* Checksum of no data, which a checksum of data in parts starts from */
+    const static uint32_t kCHECKSUM_SEED = 2166136261u;
+
+    /* Magic bytes at the start of every binary file */
+    const static std::string kMAGIC;
+
+    /* Size of the file header: magic and version */
+    const static size_t kHEADER_SIZE = 5;
+
+    /* Current version of the format */
+    const static uint8_t kVERSION = 1;
+
+  /*=============================================================================
+   * PUBLIC STATIC FUNCTIONS
+   *============================================================================*/
+  public:
+    /* Appends the encoded primitive to the buffer */
+    static void appendFixed32(PageBuffer& buffer, uint32_t value);
+    static void appendFloat(PageBuffer& buffer, float value);
+    static void appendHeader(PageBuffer& buffer);
+    static void appendSignedVarint(PageBuffer& buffer, int64_t value);
+    static void appendString(PageBuffer& buffer, std::string_view value);
+    static void appendVarint(PageBuffer& buffer, uint64_t value);
+
+    /* Returns the FNV-1a checksum of the data, for detecting torn or corrupt records */
+    static uint32_t checksum(const char* data, size_t size, uint32_t hash = kCHECKSUM_SEED);
+
+    /* Checks the file header at the start of the data */
+    static bool isHeaderValid(const char* data, size_t size);
+
+    /* Decodes the primitive at the cursor and advances it. False if malformed or truncated */
+    static bool readFixed32(const char*& cursor, const char* end, uint32_t& value);
+    static bool readFloat(const char*& cursor, const char* end, float& value);
+    static bool readSignedVarint(const char*& cursor, const char* end, int64_t& value);
+    static bool readString(const char*& cursor, const char* end, std::string_view& value);
+    static bool readVarint(const char*& cursor, const char* end, uint64_t& value);
+  };
+};
+
+#endif // CORE_BINARYENCODING_H
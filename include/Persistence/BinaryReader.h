@@ -0,0 +1,161 @@
+/**
+ * @class BinaryReader
+ *
+ * Reader implementation for the compact binary content format (see {@link BinaryEncoding}). It
+ * follows the same contract as the XML readers so all existing load code works unchanged, but
+ * data arrives already typed so nothing is parsed from text. The source file is memory mapped,
+ * and a compressed one is loaded a block at a time as the records are read. A REF record is read
+ * as the element it points to, so deduplicated files read back the same as the document that was
+ * written.
+ */
+#ifndef CORE_BINARYREADER_H
+#define CORE_BINARYREADER_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Persistence/Atom.h"
+#include "Persistence/AtomTable.h"
+#include "Persistence/BinaryEncoding.h"
+#include "Persistence/BinaryRecordType.h"
+#include "Persistence/DataType.h"
+#include "Persistence/MappedFile.h"
+#include "Persistence/TextEncoding.h"
+#include "Persistence/XmlData.h"
+#include "Persistence/XmlDataView.h"
+#include "Persistence/XmlReader.h"
+
+namespace core
+{
+  class BinaryReader : public XmlReader
+  {
+  public:
+    /* Constructor function, from the path of the source file */
+    BinaryReader(std::string path);
+
+    /* Destructor function */
+    ~BinaryReader();
+
+  private:
+    /* Constructor function, for a split reader over a range of the source file */
+    BinaryReader(std::string path, size_t range_begin, size_t range_end, XmlData range_branch,
+                 std::vector<std::string> range_dictionary);
+
+  private:
+    /* Element branch to the current read location */
+    XmlData branch;
+
+    /* Payload of the last DATA record */
+    Atom data_atom = Atom::NONE;
+    bool data_boolean = false;
+    float data_float = 0.0f;
+    int data_integer = 0;
+    std::string_view data_name;
+    std::string_view data_string;
+    DataType data_type = DataType::NONE;
+
+    /* Dictionary defined so far, and as interned atoms. Copied out of the source, since the
+     * blocks of a compressed source are released as the read moves on */
+    std::vector<std::string> dictionary;
+    std::vector<Atom> dictionary_atom;
+
+    /* Memory mapped source file */
+    MappedFile file;
+
+    /* Current read location in the source */
+    size_t offset = 0;
+
+    /* Path to the source file */
+    std::string path;
+
+    /* Range of the source that is read, the branch that wraps it and the dictionary defined
+     * before it. The whole source if the reader isn't split */
+    size_t range_begin = BinaryEncoding::kHEADER_SIZE;
+    XmlData range_branch;
+    std::vector<std::string> range_dictionary;
+    size_t range_end = SIZE_MAX;
+
+    /* Offset in the source that has already been released from memory */
+    size_t released_offset = 0;
+
+    /* Stack of references being read: branch depth at the REF record, its offset, which bounds
+     * the read of the element it points to, and the offset to return to after it */
+    std::vector<int> ref_stack_depth;
+    std::vector<size_t> ref_stack_offset;
+    std::vector<size_t> ref_stack_return;
+
+    /* Cached total count of data elements in the source. Negative if not yet counted */
+    int total_data_count = -1;
+
+    /*------------------- Constants -----------------------*/
+  private:
+    /* Amount of the source that is read before the pages behind it are released */
+    const static size_t kRELEASE_INTERVAL = 16 * 1024 * 1024;
+
+  /*=============================================================================
+   * PRIVATE FUNCTIONS
+   *============================================================================*/
+  private:
+    /* Returns the offset where the read stops: the end of the source or the range */
+    size_t getReadEnd() const;
+
+    /* Decodes the record at the read location that ends by the offset, applying it */
+    bool decodeRecord(size_t end_offset, BinaryRecordType& type);
+
+    /* Decodes the next record, applying it to the branch and dictionary */
+    bool nextRecord(BinaryRecordType& type);
+
+    /* Reads the next XML data element into the line, reusing its memory */
+    void readLine(XmlData& line, bool& done, bool& success);
+
+    /* Resets the read location back to the start of the source */
+    void resetReadLocation();
+
+    /*--------------------- XmlReader ---------------------*/
+
+    /* Finds an element node from the current read location */
+    bool findInSource(XmlData branch) override;
+
+    /* Is the reader started already and available? */
+    bool isSourceAvailable() override;
+
+    /* Jumps the reader back to the root element of the document */
+    bool jumpToRootInSource() override;
+
+    /* Last date the data source was modified */
+    std::string lastModifiedDateFromSource() override;
+
+    /* Reads the next XML data element at the end of a branch */
+    XmlData readFromSource(bool& done, bool& success) override;
+
+    /* Reads the next batch of XML data elements into the lines, filling each in place */
+    size_t readBatchFromSource(std::vector<XmlData>& lines, size_t count, bool& done,
+                               bool& success) override;
+
+    /* Sets up the reader to be able to read from the data source */
+    bool startReadFromSource() override;
+
+    /* Stops and cleans up the reader after reading from the data source */
+    bool stopReadFromSource() override;
+
+    /* Total count of the number of XML data elements available in the data source */
+    int totalDataCountFromSource() override;
+
+    /* Splits the source into independent readers at the top-level element boundaries */
+    std::vector<std::unique_ptr<XmlReader>> splitSource(int shard_count) override;
+
+  /*=============================================================================
+   * PUBLIC FUNCTIONS
+   *============================================================================*/
+  public:
+    /* Returns the path to the source file */
+    std::string getPath() const;
+  };
+};
+
+#endif // CORE_BINARYREADER_H
@@ -0,0 +1,23 @@
+/**
+ * @class BinaryRecordType
+ *
+ * Enumerator defining the tag byte at the start of each record in the binary content format.
+ */
+#ifndef CORE_BINARYRECORDTYPE_H
+#define CORE_BINARYRECORDTYPE_H
+
+#include <cstdint>
+
+namespace core
+{
+  enum class BinaryRecordType : std::uint8_t
+  {
+    CLOSE = 1,
+    DATA  = 2,
+    DICT  = 3,
+    OPEN  = 4,
+    REF   = 5
+  };
+};
+
+#endif // CORE_BINARYRECORDTYPE_H
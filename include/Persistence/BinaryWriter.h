@@ -0,0 +1,165 @@
+/**
+ * @class BinaryWriter
+ *
+ * Writer implementation for the compact binary content format (see {@link BinaryEncoding}). It
+ * follows the same contract as the XML writers so all existing save code works unchanged.
+ * Element names and attribute keys are dictionary coded on first use and data is stored typed,
+ * so nothing needs to be formatted to text. Like the buffered XML writer, the whole document is
+ * built in a paged memory buffer and only flushed to the file by stop(true), optionally
+ * compressed with {@link BlockCompression}.
+ *
+ * With deduplication enabled, each closed element is keyed by its content and an element that
+ * repeats an earlier one is replaced by a REF record to it, so copied event chains and locks are
+ * stored once per file. The key is the element's own records with each large child replaced by
+ * the offset of its first copy, so it is exact and only as long as the element's direct content.
+ */
+#ifndef CORE_BINARYWRITER_H
+#define CORE_BINARYWRITER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "Persistence/BinaryEncoding.h"
+#include "Persistence/BinaryRecordType.h"
+#include "Persistence/BlockCompression.h"
+#include "Persistence/DataType.h"
+#include "Persistence/PageBuffer.h"
+#include "Persistence/TextEncoding.h"
+#include "Persistence/XmlData.h"
+#include "Persistence/XmlDataView.h"
+#include "Persistence/XmlWriter.h"
+
+namespace core
+{
+  class BinaryWriter : public XmlWriter
+  {
+  public:
+    /* Constructor function, from the path of the destination file */
+    BinaryWriter(std::string path);
+
+  private:
+    /* Document content written since start() */
+    PageBuffer buffer;
+
+    /* Is the file compressed when it's saved? */
+    bool compression_enabled = false;
+
+    /* Are repeated elements replaced by references to their first copy? */
+    bool deduplication_enabled = false;
+
+    /* Is the current document deduplicated? Set from the option when it's started */
+    bool deduplicating = false;
+
+    /* Dictionary of names and keys defined so far, by id and by string */
+    std::vector<std::string> dictionary;
+    std::unordered_map<std::string, uint32_t> dictionary_ids;
+
+    /* Path to the destination file */
+    std::string path;
+
+    /* Stack of open elements: content offset and dictionary size when each was opened */
+    std::vector<size_t> stack_content_offset;
+    std::vector<size_t> stack_dictionary_size;
+
+    /* Stack of open elements, if deduplicating: offset of the open record, content key and the
+     * size of the key at the end of the open record */
+    std::vector<std::string> stack_key;
+    std::vector<size_t> stack_key_open_size;
+    std::vector<size_t> stack_open_offset;
+
+    /* Has the writer been started? */
+    bool started = false;
+
+    /* Offset of the open record of the first copy of each element written, by content key */
+    std::unordered_map<std::string, size_t> subtree_offsets;
+
+    /*------------------- Constants -----------------------*/
+  private:
+    /* Smallest element, in bytes, that is replaced by a reference when it repeats */
+    const static size_t kMIN_SUBTREE_SIZE = 16;
+
+  /*=============================================================================
+   * PRIVATE FUNCTIONS
+   *============================================================================*/
+  private:
+    /* Returns the dictionary id of the string, defining it first if required */
+    uint32_t defineString(const std::string& value);
+
+    /* Replaces the element that was just closed with a reference, if it repeats an earlier one */
+    void deduplicate();
+
+    /* Adds the record that ends at the end of the buffer to the key of the open element */
+    void endRecord(size_t record_offset);
+
+    /* Rolls the buffer and the dictionary back to an earlier state */
+    void truncate(size_t content_offset, size_t dictionary_size);
+
+    /* Appends the start of a data record, up to the typed payload. Returns its offset */
+    size_t writeDataHeader(const std::string& element, DataType type);
+
+    /*--------------------- XmlWriter ---------------------*/
+
+    /* Deletes all children element and data nodes beneath the current tree location */
+    bool deleteChildrenFromSource() override;
+
+    /* Finds a lower child node from the current node location in the XML tree */
+    bool findInSource(XmlData branch) override;
+
+    /* Is the writer started already and available? */
+    bool isSourceAvailable() override;
+
+    /* Jumps the writer back to the parent element of the current node */
+    bool jumpToParentInSource() override;
+
+    /* Jumps the writer back to the root element of the document */
+    bool jumpToRootInSource() override;
+
+    /* Sets up the writer to be able to write to the data source */
+    bool startWriteToSource() override;
+
+    /* Stops and cleans up the writer after writing to the data source */
+    bool stopWriteToSource(bool save_changes) override;
+
+    /* Writes a data node at the current tree location */
+    bool writeDataToSource(std::string element, DataType type, std::string data) override;
+    bool writeDataToSource(std::string element, bool data) override;
+    bool writeDataToSource(std::string element, float data) override;
+    bool writeDataToSource(std::string element, int data) override;
+    bool writeDataToSource(std::string element, std::string data) override;
+    bool writeDataToSource(std::string element, uint32_t data) override;
+
+    /* Writes an element child at the current tree location */
+    bool writeElementToSource(std::string element, std::string key, std::string value) override;
+
+    /* Writes one or more elements at the current tree location */
+    bool writeElementsToSource(XmlData element_set) override;
+
+  /*=============================================================================
+   * PUBLIC FUNCTIONS
+   *============================================================================*/
+  public:
+    /* Returns the size of the document written so far, in bytes */
+    size_t getBufferSize() const;
+
+    /* Returns the path to the destination file */
+    std::string getPath() const;
+
+    /* Returns if the file is compressed when it's saved */
+    bool isCompressionEnabled() const;
+
+    /* Returns if repeated elements are replaced by references to their first copy */
+    bool isDeduplicationEnabled() const;
+
+    /* Sets if the file is compressed when it's saved */
+    void setCompressionEnabled(bool enabled);
+
+    /* Sets if repeated elements are replaced by references to their first copy */
+    void setDeduplicationEnabled(bool enabled);
+  };
+};
+
+#endif // CORE_BINARYWRITER_H
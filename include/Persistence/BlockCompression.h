@@ -0,0 +1,127 @@
+/**
+ * @class BlockCompression
+ *
+ * Streaming block compression stage between the reader and writer backends and the file. The
+ * content is cut into fixed size blocks that are each compressed on their own with a small LZ77
+ * codec, so blocks are compressed and decompressed in parallel, or one at a time as they're
+ * needed. {@link MappedFile} decodes the blocks of a compressed file as the reader backends reach
+ * them, so every backend handles one.
+ *
+ * A compressed file is the magic "FISZ" and a version byte, the content size and block size
+ * (varints), then a varint per block of its compressed size shifted left one, with the low bit
+ * set if the block is stored raw instead, and then the blocks themselves. Each block is a
+ * sequence of a token byte (literal count in the high nibble, match length - 4 in the low
+ * nibble, 15 meaning more length bytes follow, each adding up to 255), the literals, and a 2 byte
+ * little endian match offset and its length bytes. The last sequence of a block is only literals.
+ */
+#ifndef CORE_BLOCKCOMPRESSION_H
+#define CORE_BLOCKCOMPRESSION_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Persistence/BinaryEncoding.h"
+#include "Persistence/PageBuffer.h"
+
+namespace core
+{
+  class BlockCompression
+  {
+  public:
+    /* Location of every block of a compressed file, from the table in its header */
+    struct BlockTable
+    {
+      /* Start of the first block, in the compressed file */
+      const char* blocks = nullptr;
+
+      /* Size of each block of content, except the last which can be shorter */
+      size_t block_size = 0;
+
+      /* Size of the whole content */
+      size_t content_size = 0;
+
+      /* Offset of each block from the first, its compressed size and if it's stored raw */
+      std::vector<size_t> offsets;
+      std::vector<size_t> sizes;
+      std::vector<char> stored;
+    };
+
+    /*------------------- Constants -----------------------*/
+  public:
+    /* Size of each independently compressed block of content */
+    const static size_t kBLOCK_SIZE = 256 * 1024;
+
+    /* Magic bytes at the start of every compressed file */
+    const static std::string kMAGIC;
+
+  private:
+    /* Number of bits in the match finder hash */
+    const static int kHASH_BITS = 14;
+
+    /* Match lengths. Matches never start in the last bytes of a block */
+    const static size_t kMATCH_MIN = 4;
+    const static size_t kMATCH_END_GUARD = 8;
+
+    /* Furthest back a match can start, to fit the 2 byte offset */
+    const static size_t kMAX_OFFSET = 65535;
+
+    /* Current version of the format */
+    const static uint8_t kVERSION = 1;
+
+  /*=============================================================================
+   * PRIVATE STATIC FUNCTIONS
+   *============================================================================*/
+  private:
+    /* Appends a length to an LZ block, in the bytes that follow a nibble of 15 */
+    static void appendLength(std::string& block, size_t length);
+
+    /* Compresses a single block of content */
+    static void compressBlock(const char* data, size_t size, std::string& block);
+
+    /* Decompresses a single block into exactly size bytes. False if malformed */
+    static bool decompressBlock(const char* block, size_t block_size, char* data, size_t size);
+
+    /* Reads a length from an LZ block, after a nibble of 15. False if truncated */
+    static bool readLength(const uint8_t*& cursor, const uint8_t* end, size_t& length);
+
+    /* Runs the task for every block index, spread over worker threads */
+    static bool runBlocks(size_t block_count, unsigned int thread_count,
+                          std::function<bool(size_t)> task);
+
+  /*=============================================================================
+   * PUBLIC STATIC FUNCTIONS
+   *============================================================================*/
+  public:
+    /* Compresses the content into the destination, as a whole compressed file */
+    static void compress(const PageBuffer& source, PageBuffer& destination,
+                         unsigned int thread_count = 0);
+
+    /* Decompresses a whole compressed file into new memory. False if malformed */
+    static bool decompress(const char* data, size_t size, std::unique_ptr<char[]>& content,
+                           size_t& content_size, unsigned int thread_count = 0);
+
+    /* Decompresses a single block of the table into its place in the content. False if malformed */
+    static bool decompressBlock(const BlockTable& table, size_t index, char* content);
+
+    /* Returns if the data starts with the compressed file header */
+    static bool isCompressed(const char* data, size_t size);
+
+    /* Reads the block table from the header of a compressed file. False if malformed */
+    static bool readBlockTable(const char* data, size_t size, BlockTable& table);
+
+    /* Compresses the content and writes it to the file, replacing it atomically */
+    static bool writeToFile(const PageBuffer& source, const std::string& path,
+                            unsigned int thread_count = 0);
+  };
+};
+
+#endif // CORE_BLOCKCOMPRESSION_H
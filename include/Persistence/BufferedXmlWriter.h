@@ -0,0 +1,154 @@
+/**
+ * @class BufferedXmlWriter
+ *
+ * Streaming XML writer implementation that appends the entire document into a single paged
+ * memory buffer, tracking only the stack of open elements. Nothing touches the file system until
+ * stop(true), which flushes the buffer with one vectored write into a temporary file that then
+ * replaces the destination. stop(false) rolls back by truncating the buffer. Since the output is
+ * append only, find() to an existing node is not supported. The writer can also record the
+ * offsets of the elements as they are written and save them as the {@link XmlIndex} sidecar,
+ * and can compress the file with {@link BlockCompression}.
+ */
+#ifndef CORE_BUFFEREDXMLWRITER_H
+#define CORE_BUFFEREDXMLWRITER_H
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Persistence/BlockCompression.h"
+#include "Persistence/DataType.h"
+#include "Persistence/PageBuffer.h"
+#include "Persistence/TextEncoding.h"
+#include "Persistence/XmlData.h"
+#include "Persistence/XmlDataView.h"
+#include "Persistence/XmlIndex.h"
+#include "Persistence/XmlTokenizer.h"
+#include "Persistence/XmlWriter.h"
+
+namespace core
+{
+  class BufferedXmlWriter : public XmlWriter
+  {
+  public:
+    /* Constructor function, from the path of the destination file */
+    BufferedXmlWriter(std::string path);
+
+  private:
+    /* Document content written since start() */
+    PageBuffer buffer;
+
+    /* Is the file compressed when it's saved? */
+    bool compression_enabled = false;
+
+    /* Offset index of the elements written since start() */
+    XmlIndex index;
+
+    /* Is the offset index recorded and saved as the sidecar of the destination? */
+    bool index_enabled = false;
+
+    /* Path to the destination file */
+    std::string path;
+
+    /* Reusable scratch space for entity encoding */
+    std::string scratch;
+
+    /* Stack of open elements: name, buffer offset of the content, if it has children and its
+     * index entry */
+    std::vector<size_t> stack_content_offset;
+    std::vector<bool> stack_has_children;
+    std::vector<uint32_t> stack_index_entry;
+    std::vector<std::string> stack_name;
+
+    /* Buffer offset of the content after the XML declaration */
+    size_t root_content_offset = 0;
+
+    /* Has the writer been started? */
+    bool started = false;
+
+    /*------------------- Constants -----------------------*/
+  private:
+    /* Characters of indentation for each level of depth */
+    const static int kINDENT = 2;
+
+    /* Declaration at the start of every document */
+    const static std::string kXML_DECLARATION;
+
+  /*=============================================================================
+   * PRIVATE FUNCTIONS
+   *============================================================================*/
+  private:
+    /* Appends a line break and the indentation for a new child of the top element */
+    void appendChildIndent();
+
+    /* Appends the text to the buffer with the XML reserved characters encoded */
+    void appendEncoded(std::string_view plain);
+
+    /* Closes the top element on the stack */
+    void closeElement();
+
+    /*--------------------- XmlWriter ---------------------*/
+
+    /* Deletes all children element and data nodes beneath the current tree location */
+    bool deleteChildrenFromSource() override;
+
+    /* Finds a lower child node from the current node location in the XML tree */
+    bool findInSource(XmlData branch) override;
+
+    /* Is the writer started already and available? */
+    bool isSourceAvailable() override;
+
+    /* Jumps the writer back to the parent element of the current node */
+    bool jumpToParentInSource() override;
+
+    /* Jumps the writer back to the root element of the document */
+    bool jumpToRootInSource() override;
+
+    /* Sets up the writer to be able to write to the data source */
+    bool startWriteToSource() override;
+
+    /* Stops and cleans up the writer after writing to the data source */
+    bool stopWriteToSource(bool save_changes) override;
+
+    /* Writes a data node at the current tree location */
+    bool writeDataToSource(std::string element, DataType type, std::string data) override;
+    bool writeDataToSource(std::string element, bool data) override;
+    bool writeDataToSource(std::string element, float data) override;
+    bool writeDataToSource(std::string element, int data) override;
+    bool writeDataToSource(std::string element, std::string data) override;
+    bool writeDataToSource(std::string element, uint32_t data) override;
+
+    /* Writes an element child at the current tree location */
+    bool writeElementToSource(std::string element, std::string key, std::string value) override;
+
+    /* Writes one or more elements at the current tree location */
+    bool writeElementsToSource(XmlData element_set) override;
+
+  /*=============================================================================
+   * PUBLIC FUNCTIONS
+   *============================================================================*/
+  public:
+    /* Returns the size of the document written so far, in bytes */
+    size_t getBufferSize() const;
+
+    /* Returns the path to the destination file */
+    std::string getPath() const;
+
+    /* Returns if the file is compressed when it's saved */
+    bool isCompressionEnabled() const;
+
+    /* Returns if the offset index is saved as the sidecar of the destination */
+    bool isIndexEnabled() const;
+
+    /* Sets if the file is compressed when it's saved */
+    void setCompressionEnabled(bool enabled);
+
+    /* Sets if the offset index is saved as the sidecar of the destination */
+    void setIndexEnabled(bool enabled);
+  };
+};
+
+#endif // CORE_BUFFEREDXMLWRITER_H
@@ -0,0 +1,155 @@
+/**
+ * @class CachedXmlReader
+ *
+ * Reader implementation for an XML source that keeps a persistent cache of its parsed content
+ * next to it. The first full read parses the XML and writes every line into a binary copy (see
+ * {@link BinaryWriter}) as it goes. While the source is unchanged, every later read comes from
+ * that copy through a memory mapped {@link BinaryReader}, so nothing is tokenized, entity
+ * decoded or parsed from text. The lines read back are the same either way.
+ *
+ * The cache is the source path with ".cache" appended, and is stamped in a small file beside it
+ * (".cache.stamp") with the size, modified time and FNV-1a hash of the source. The cache is used
+ * if the size matches and either the modified time or the hash does, so a source that was only
+ * touched or copied is hashed once and then stamped again. The stamp is removed before the cache
+ * is rebuilt and only written once the cache is saved, so a cache is never used with a stale
+ * stamp. The cache is only built by a read from the start to the end: a find() abandons it, and
+ * a jump to the root starts it over.
+ */
+#ifndef CORE_CACHEDXMLREADER_H
+#define CORE_CACHEDXMLREADER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Persistence/BinaryEncoding.h"
+#include "Persistence/BinaryReader.h"
+#include "Persistence/BinaryWriter.h"
+#include "Persistence/MappedFile.h"
+#include "Persistence/MappedXmlReader.h"
+#include "Persistence/PageBuffer.h"
+#include "Persistence/XmlConverter.h"
+#include "Persistence/XmlData.h"
+#include "Persistence/XmlReader.h"
+
+namespace core
+{
+  class CachedXmlReader : public XmlReader
+  {
+  public:
+    /* Constructor function, from the path of the XML source file */
+    CachedXmlReader(std::string path);
+
+    /* Destructor function */
+    ~CachedXmlReader();
+
+  private:
+    /* Writer of the cache while it's built from the source. Null if it isn't */
+    std::unique_ptr<BinaryWriter> cache_writer;
+
+    /* Branch open in the cache writer */
+    XmlData cache_branch;
+
+    /* Is the current read from the cache? */
+    bool from_cache = false;
+
+    /* Path to the XML source file */
+    std::string path;
+
+    /* Reader of the current read: the cache or the source. Null if not started */
+    std::unique_ptr<XmlReader> reader;
+
+    /* Stamp of the source when the read was started */
+    uint32_t source_hash = 0;
+    std::string source_modified_date;
+    std::time_t source_modified_time = 0;
+    size_t source_size = 0;
+
+    /*------------------- Constants -----------------------*/
+  public:
+    /* Extension appended to the source path for the cache file */
+    const static std::string kEXTENSION;
+
+    /* Extension appended to the cache path for its stamp file */
+    const static std::string kSTAMP_EXTENSION;
+
+  private:
+    /* Magic bytes at the start of every stamp file */
+    const static std::string kMAGIC;
+
+    /* Current version of the stamp file */
+    const static uint8_t kVERSION = 1;
+
+  /*=============================================================================
+   * PRIVATE FUNCTIONS
+   *============================================================================*/
+  private:
+    /* Stops building the cache, discarding what was written */
+    void abandonCache();
+
+    /* Writes the lines into the cache being built, and saves it at the end of the source */
+    void cacheLines(std::vector<XmlData>& lines, size_t count, bool done, bool success);
+
+    /* Returns the checksum of the content of the source, loading it a block at a time */
+    static uint32_t checksumSource(MappedFile& source);
+
+    /* Returns if the cache matches the source. Stamps it again if only the time changed */
+    bool isCacheValid(MappedFile& source);
+
+    /* Saves the stamp file of the source */
+    bool saveStamp() const;
+
+    /*--------------------- XmlReader ---------------------*/
+
+    /* Finds an element node from the current read location */
+    bool findInSource(XmlData branch) override;
+
+    /* Is the reader started already and available? */
+    bool isSourceAvailable() override;
+
+    /* Jumps the reader back to the root element of the document */
+    bool jumpToRootInSource() override;
+
+    /* Last date the data source was modified */
+    std::string lastModifiedDateFromSource() override;
+
+    /* Reads the next XML data element at the end of a branch */
+    XmlData readFromSource(bool& done, bool& success) override;
+
+    /* Reads the next batch of XML data elements into the lines, filling each in place */
+    size_t readBatchFromSource(std::vector<XmlData>& lines, size_t count, bool& done,
+                               bool& success) override;
+
+    /* Sets up the reader to be able to read from the data source */
+    bool startReadFromSource() override;
+
+    /* Stops and cleans up the reader after reading from the data source */
+    bool stopReadFromSource() override;
+
+    /* Total count of the number of XML data elements available in the data source */
+    int totalDataCountFromSource() override;
+
+    /* Splits the source into independent readers at the top-level element boundaries */
+    std::vector<std::unique_ptr<XmlReader>> splitSource(int shard_count) override;
+
+  /*=============================================================================
+   * PUBLIC FUNCTIONS
+   *============================================================================*/
+  public:
+    /* Returns the path to the cache file */
+    std::string getCachePath() const;
+
+    /* Returns the path to the XML source file */
+    std::string getPath() const;
+
+    /* Returns if the current read is from the cache */
+    bool isReadFromCache() const;
+  };
+};
+
+#endif // CORE_CACHEDXMLREADER_H
@@ -0,0 +1,105 @@
+/**
+ * @class ElementPathDfa
+ *
+ * Compile time automaton over the element paths of a schema. The schema is listed once as the
+ * edges between states, each taken by one interned element name ({@link Atom}), and compiles
+ * into a dense table indexed by the state and atom. Walking a line of data is then one table
+ * read per element, so a nested path resolves straight to the state of its leaf without a name
+ * lookup at each level. Declared as a constexpr constant, it has no static initialization. If
+ * an edge is repeated or a state is out of range, construction throws, which fails the build.
+ */
+#ifndef CORE_ELEMENTPATHDFA_H
+#define CORE_ELEMENTPATHDFA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+#include "Persistence/Atom.h"
+#include "Persistence/AtomTable.h"
+
+namespace core
+{
+  template <typename T, std::size_t S, std::size_t E>
+  class ElementPathDfa
+  {
+    static_assert(S > 0 && S < 255, "Element path automaton supports between 1 and 254 states");
+
+  public:
+    /* A single schema edge: the element that leads from one state to the next */
+    struct Edge
+    {
+      T from;
+      Atom element;
+      T to;
+    };
+
+    /* Constructor function, from the schema edges */
+    constexpr ElementPathDfa(const Edge (&edges)[E]);
+
+  private:
+    /* Next state + 1 for each state and element atom. 0 if the element has no edge */
+    std::uint8_t transitions[S][AtomTable::kCOUNT] = {};
+
+  /*=============================================================================
+   * PUBLIC FUNCTIONS
+   *============================================================================*/
+  public:
+    /* Finds the state the element leads to. Returns false if it has no edge from the state */
+    constexpr bool next(T state, Atom element, T& next_state) const;
+  };
+};
+
+/*============================================================================
+ * CONSTRUCTORS / DESTRUCTORS
+ *===========================================================================*/
+
+/**
+ * Constructor function - Compiles the edges into the transition table.
+ * @param edges list of schema edges, in any order
+ * @throws std::logic_error if a state is out of range or an edge is repeated
+ */
+template <typename T, std::size_t S, std::size_t E>
+constexpr core::ElementPathDfa<T, S, E>::ElementPathDfa(const Edge (&edges)[E])
+{
+  for(const Edge& edge : edges)
+  {
+    std::size_t from = static_cast<std::size_t>(edge.from);
+    std::size_t to = static_cast<std::size_t>(edge.to);
+    std::size_t element = static_cast<std::size_t>(edge.element);
+    if(from >= S || to >= S || element >= AtomTable::kCOUNT)
+      throw std::logic_error("Element path edge state or element is out of range");
+    if(transitions[from][element] != 0)
+      throw std::logic_error("Element path edges must be unique");
+
+    transitions[from][element] = static_cast<std::uint8_t>(to + 1);
+  }
+}
+
+/*============================================================================
+ * PUBLIC FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Finds the state the element leads to: one table read.
+ * @param state the current state
+ * @param element interned name of the next element in the path
+ * @param next_state set to the state the element leads to, if it has an edge
+ * @return TRUE if the element has an edge from the state
+ */
+template <typename T, std::size_t S, std::size_t E>
+constexpr bool core::ElementPathDfa<T, S, E>::next(T state, Atom element, T& next_state) const
+{
+  std::size_t from = static_cast<std::size_t>(state);
+  if(from >= S)
+    return false;
+
+  std::uint8_t entry = transitions[from][static_cast<std::size_t>(element)];
+  if(entry == 0)
+    return false;
+
+  next_state = static_cast<T>(entry - 1);
+  return true;
+}
+
+#endif // CORE_ELEMENTPATHDFA_H
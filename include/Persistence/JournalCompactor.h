@@ -0,0 +1,129 @@
+/**
+ * @class JournalCompactor
+ *
+ * Background compactor for a journaled save. A worker thread checks the log written by
+ * {@link JournalWriter} on an interval and, once it has grown past the size threshold, folds it
+ * into the snapshot: the live log is rotated out (new checkpoints start a fresh log), the
+ * snapshot and the rotated log are replayed with only the last line of each element path kept,
+ * and the result is saved as the new snapshot through the snapshot writer, which replaces it
+ * atomically. The rotated log is only deleted once the new snapshot is saved, so a crash at any
+ * point replays the same state, since replaying a log that was already folded changes nothing.
+ *
+ * The snapshot must already exist, such as the full save written when the game was created. The
+ * rotation is only coordinated with the journal writers of this process.
+ */
+#ifndef CORE_JOURNALCOMPACTOR_H
+#define CORE_JOURNALCOMPACTOR_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "Persistence/JournalReader.h"
+#include "Persistence/JournalWriter.h"
+#include "Persistence/XmlConverter.h"
+#include "Persistence/XmlData.h"
+#include "Persistence/XmlDataView.h"
+#include "Persistence/XmlReader.h"
+#include "Persistence/XmlWriter.h"
+
+namespace core
+{
+  class JournalCompactor
+  {
+  public:
+    /* Constructor function, from the log path and the reader and writer of the snapshot */
+    JournalCompactor(std::string log_path, std::unique_ptr<XmlReader> snapshot_reader,
+                     std::unique_ptr<XmlWriter> snapshot_writer,
+                     size_t size_threshold = kSIZE_THRESHOLD,
+                     uint32_t interval_ms = kINTERVAL_MS);
+
+    /* Destructor function */
+    ~JournalCompactor();
+
+  private:
+    /* Serializes the compactions of the worker and the calling thread */
+    std::mutex compact_lock;
+
+    /* First exception thrown by a background compaction, held until wait() */
+    std::exception_ptr error;
+
+    /* Time between checks of the log size, in milliseconds */
+    uint32_t interval_ms;
+
+    /* Did the last background compaction succeed? */
+    bool last_success = true;
+
+    /* Guards the worker state below */
+    std::mutex lock;
+
+    /* Path to the live log file */
+    std::string log_path;
+
+    /* Signals the worker when it's stopping */
+    std::condition_variable signal;
+
+    /* Log size that triggers a background compaction, in bytes */
+    size_t size_threshold;
+
+    /* Reader and writer of the snapshot, both on the same file. Only used to compact */
+    std::unique_ptr<XmlReader> snapshot_reader;
+    std::unique_ptr<XmlWriter> snapshot_writer;
+
+    /* Is the worker shutting down? */
+    bool stopping = false;
+
+    /* Background thread that checks the log */
+    std::thread worker;
+
+    /*------------------- Constants -----------------------*/
+  public:
+    /* Default time between checks of the log size */
+    const static uint32_t kINTERVAL_MS = 5000;
+
+    /* Default log size that triggers a background compaction */
+    const static size_t kSIZE_THRESHOLD = 4 * 1024 * 1024;
+
+  /*=============================================================================
+   * PRIVATE FUNCTIONS
+   *============================================================================*/
+  private:
+    /* Runs the checks of the worker thread until it's stopped */
+    void runWorker();
+
+  /*=============================================================================
+   * PRIVATE STATIC FUNCTIONS
+   *============================================================================*/
+  private:
+    /* Returns the key that identifies the element path of the line */
+    static std::string getPathKey(XmlDataView line);
+
+    /* Finds the size of the file. False if it doesn't exist */
+    static bool getFileSize(const std::string& path, size_t& size);
+
+  /*=============================================================================
+   * PUBLIC FUNCTIONS
+   *============================================================================*/
+  public:
+    /* Folds the log into the snapshot now, on the calling thread */
+    bool compact();
+
+    /* Returns if the log has grown past the threshold or a rotated log is waiting */
+    bool isCompactionDue() const;
+
+    /* Waits for a running compaction. Returns the success of the last background one */
+    bool wait();
+  };
+};
+
+#endif // CORE_JOURNALCOMPACTOR_H
@@ -0,0 +1,159 @@
+/**
+ * @class JournalReader
+ *
+ * Reader implementation that replays a journaled save: every line of the snapshot, then every
+ * line of the log written by {@link JournalWriter}, in the order they were appended. A log that
+ * was rotated out for compaction but not yet folded into the snapshot is replayed before the
+ * live log. Since the loaders apply each line over the state already loaded, the result is the
+ * state of the last checkpoint. The removals recorded in the log are found when the reader
+ * starts, and every line beneath a removed node that comes before its removal is skipped, in the
+ * snapshot as well. A frame that fails its checksum, such as one cut short by a crash, ends the
+ * replay of that log file, which is reported by isTruncated().
+ */
+#ifndef CORE_JOURNALREADER_H
+#define CORE_JOURNALREADER_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "Persistence/BinaryEncoding.h"
+#include "Persistence/DataType.h"
+#include "Persistence/JournalWriter.h"
+#include "Persistence/MappedFile.h"
+#include "Persistence/TextEncoding.h"
+#include "Persistence/XmlData.h"
+#include "Persistence/XmlIndex.h"
+#include "Persistence/XmlDataView.h"
+#include "Persistence/XmlReader.h"
+
+namespace core
+{
+  class JournalReader : public XmlReader
+  {
+    /* Replays only the rotated log, for folding it into the snapshot */
+    friend class JournalCompactor;
+
+  public:
+    /* Constructor function, from the snapshot reader and the path of the log file */
+    JournalReader(XmlReader* snapshot, std::string log_path);
+
+  private:
+    /* Constructor function, for replaying the snapshot and the listed log files */
+    JournalReader(XmlReader* snapshot, std::vector<std::string> log_paths);
+
+  private:
+    /* Element branch of the last line record in the current frame */
+    XmlData branch;
+
+    /* Memory mapped log file being replayed */
+    MappedFile file;
+
+    /* Offset in the log file where the current frame ends */
+    size_t frame_end = 0;
+
+    /* Log files to replay, in order, and the index of the next one to open */
+    size_t log_index = 0;
+    std::vector<std::string> log_paths;
+
+    /* Current read location in the log file */
+    size_t offset = 0;
+
+    /* Is the snapshot still being replayed? */
+    bool reading_snapshot = false;
+
+    /* Sequence number of the last removal record of each node removed by the log files, by the
+     * path key of its branch (see XmlIndex::appendPathKey()) */
+    std::unordered_map<std::string, uint64_t> removals;
+
+    /* Most elements in the branch of any removed node */
+    int removal_depth = 0;
+
+    /* Reused path key of the branch being checked against the removals */
+    std::string removal_key;
+
+    /* Number of log records read since the start of the replay */
+    uint64_t sequence = 0;
+
+    /* Reader of the snapshot. Not owned, null if there is no snapshot yet */
+    XmlReader* snapshot;
+
+    /* Did the snapshot end properly? */
+    bool snapshot_success = true;
+
+    /* Has the reader been started? */
+    bool started = false;
+
+    /* Cached total count of data lines. Negative if not yet counted */
+    int total_data_count = -1;
+
+    /* Was a frame dropped since the replay started? */
+    bool truncated = false;
+
+  /*=============================================================================
+   * PRIVATE FUNCTIONS
+   *============================================================================*/
+  private:
+    /* Returns if the line is beneath a node removed after the line's sequence number */
+    bool isRemoved(XmlDataView line, uint64_t line_sequence);
+
+    /* Finds the removals recorded in the log files */
+    void loadRemovals();
+
+    /* Moves to the next whole frame, opening the next log file as needed */
+    bool nextFrame();
+
+    /* Reads the next XML data element into the line, reusing its memory */
+    void readLine(XmlData& line, bool& done, bool& success);
+
+    /* Decodes the line or removal record at the read location into the line */
+    bool readRecord(XmlData& line, bool& removal);
+
+    /* Resets the read location back to the start of the snapshot */
+    void resetReadLocation();
+
+    /*--------------------- XmlReader ---------------------*/
+
+    /* Finds an element node from the current read location */
+    bool findInSource(XmlData branch) override;
+
+    /* Is the reader started already and available? */
+    bool isSourceAvailable() override;
+
+    /* Jumps the reader back to the root element of the document */
+    bool jumpToRootInSource() override;
+
+    /* Last date the data source was modified */
+    std::string lastModifiedDateFromSource() override;
+
+    /* Reads the next XML data element at the end of a branch */
+    XmlData readFromSource(bool& done, bool& success) override;
+
+    /* Reads the next batch of XML data elements into the lines, filling each in place */
+    size_t readBatchFromSource(std::vector<XmlData>& lines, size_t count, bool& done,
+                               bool& success) override;
+
+    /* Sets up the reader to be able to read from the data source */
+    bool startReadFromSource() override;
+
+    /* Stops and cleans up the reader after reading from the data source */
+    bool stopReadFromSource() override;
+
+    /* Total count of the number of XML data elements available in the data source */
+    int totalDataCountFromSource() override;
+
+  /*=============================================================================
+   * PUBLIC FUNCTIONS
+   *============================================================================*/
+  public:
+    /* Returns if a torn or corrupt frame was dropped since the replay started */
+    bool isTruncated() const;
+  };
+};
+
+#endif // CORE_JOURNALREADER_H
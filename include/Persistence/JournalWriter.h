@@ -0,0 +1,138 @@
+/**
+ * @class JournalWriter
+ *
+ * Append only writer for the write-ahead journal of a save (see {@link JournalReader} and
+ * {@link JournalCompactor}). It follows the same contract as the other writers, so a checkpoint
+ * is the usual incremental save of the changed state, but stop(true) appends only the data lines
+ * written since start() to the log, as one frame with a single write and sync, instead of
+ * rewriting the whole document. Nodes in the log can't be revisited, so find() is not supported
+ * and deleteChildren() records a removal instead: a load drops every line beneath the current
+ * node from before it. A rewrite (see {@link XmlWriter#rewriteElements}) is then a removal
+ * followed by the new lines, so data the new state no longer has is gone on load as well.
+ *
+ * Each frame is a varint payload size and a 4 byte checksum of the payload (see
+ * {@link BinaryEncoding}), then the payload: a version byte and a sequence of line records. A
+ * line record is the number of leading elements shared with the line before it in the frame, the
+ * number of new elements and their name, key and value strings, and then the data element name,
+ * its {@link DataType} byte and the typed payload. A removal record has a blank data element
+ * name, the NONE type and no payload. A frame cut short by a crash fails its checksum, so it's
+ * dropped whole on load.
+ */
+#ifndef CORE_JOURNALWRITER_H
+#define CORE_JOURNALWRITER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+#include "Persistence/BinaryEncoding.h"
+#include "Persistence/DataType.h"
+#include "Persistence/PageBuffer.h"
+#include "Persistence/TextEncoding.h"
+#include "Persistence/XmlData.h"
+#include "Persistence/XmlDataView.h"
+#include "Persistence/XmlWriter.h"
+
+namespace core
+{
+  class JournalWriter : public XmlWriter
+  {
+    /* Rotates the log under the append lock */
+    friend class JournalCompactor;
+
+  public:
+    /* Constructor function, from the path of the log file */
+    JournalWriter(std::string path);
+
+  private:
+    /* Element branch of the current write location */
+    XmlData branch;
+
+    /* Line records of the checkpoint written since start() */
+    PageBuffer buffer;
+
+    /* Element branch of the last line record in the buffer */
+    XmlData last_branch;
+
+    /* Number of line and removal records in the buffer */
+    uint32_t line_count = 0;
+
+    /* Path to the log file */
+    std::string path;
+
+    /* Has the writer been started? */
+    bool started = false;
+
+    /* Serializes the appends with the log rotation of the compactor */
+    static std::mutex append_lock;
+
+    /*------------------- Constants -----------------------*/
+  public:
+    /* Suffix of the log once it's rotated out for compaction */
+    const static std::string kROTATED_SUFFIX;
+
+    /* Current version of the frame payload */
+    const static uint8_t kVERSION = 1;
+
+  /*=============================================================================
+   * PRIVATE FUNCTIONS
+   *============================================================================*/
+  private:
+    /* Appends the start of a line or removal record, up to the typed payload */
+    void writeLineHeader(const std::string& element, DataType type);
+
+    /*--------------------- XmlWriter ---------------------*/
+
+    /* Deletes all children element and data nodes beneath the current tree location */
+    bool deleteChildrenFromSource() override;
+
+    /* Finds a lower child node from the current node location in the XML tree */
+    bool findInSource(XmlData branch) override;
+
+    /* Is the writer started already and available? */
+    bool isSourceAvailable() override;
+
+    /* Does the writer add to the saved content, instead of replacing it? */
+    bool isSourceIncremental() override;
+
+    /* Jumps the writer back to the parent element of the current node */
+    bool jumpToParentInSource() override;
+
+    /* Jumps the writer back to the root element of the document */
+    bool jumpToRootInSource() override;
+
+    /* Sets up the writer to be able to write to the data source */
+    bool startWriteToSource() override;
+
+    /* Stops and cleans up the writer after writing to the data source */
+    bool stopWriteToSource(bool save_changes) override;
+
+    /* Writes a data node at the current tree location */
+    bool writeDataToSource(std::string element, DataType type, std::string data) override;
+    bool writeDataToSource(std::string element, bool data) override;
+    bool writeDataToSource(std::string element, float data) override;
+    bool writeDataToSource(std::string element, int data) override;
+    bool writeDataToSource(std::string element, std::string data) override;
+    bool writeDataToSource(std::string element, uint32_t data) override;
+
+    /* Writes an element child at the current tree location */
+    bool writeElementToSource(std::string element, std::string key, std::string value) override;
+
+    /* Writes one or more elements at the current tree location */
+    bool writeElementsToSource(XmlData element_set) override;
+
+  /*=============================================================================
+   * PUBLIC FUNCTIONS
+   *============================================================================*/
+  public:
+    /* Returns the number of data lines and removals in the checkpoint written so far */
+    uint32_t getLineCount() const;
+
+    /* Returns the path to the log file */
+    std::string getPath() const;
+  };
+};
+
+#endif // CORE_JOURNALWRITER_H
@@ -0,0 +1,133 @@
+/**
+ * @class LayeredXmlReader
+ *
+ * Reader implementation that merges layered content packs into one stream of lines: a base pack
+ * and then any number of mod and patch packs, each of which overrides the earlier ones. Lines are
+ * merged by element path (every element name, key and value, then the data element name), and
+ * only the line of the last layer with a path is returned, so the loaders never see, or build
+ * anything from, the data that is overridden.
+ *
+ * The base is streamed in document order and each of its lines is returned in place, or replaced
+ * by the override of its path. The patch layers are read into memory when the reader is started,
+ * keeping only the last line of each path, since they don't share the document order of the base
+ * and are small next to it. The paths that the base doesn't have are returned after the end of
+ * the base, in the order they first appear in the layers. Overrides apply to single data lines,
+ * so a patch that replaces a whole object must override all of its lines.
+ */
+#ifndef CORE_LAYEREDXMLREADER_H
+#define CORE_LAYEREDXMLREADER_H
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Persistence/XmlData.h"
+#include "Persistence/XmlDataView.h"
+#include "Persistence/XmlIndex.h"
+#include "Persistence/XmlReader.h"
+
+namespace core
+{
+  class LayeredXmlReader : public XmlReader
+  {
+  public:
+    /* Constructor function, from the layers in order, base first */
+    LayeredXmlReader(std::vector<std::unique_ptr<XmlReader>> layers);
+
+    /* Destructor function */
+    ~LayeredXmlReader();
+
+  private:
+    /* Has the end of the base been reached, and was the base well formed? */
+    bool base_done = false;
+    bool base_success = true;
+
+    /* Readers of each layer, base first */
+    std::vector<std::unique_ptr<XmlReader>> layers;
+
+    /* Last line of each path in the patch layers, in the order the paths first appear */
+    std::vector<XmlData> override_lines;
+
+    /* Index of the override line of each path */
+    std::unordered_map<std::string, size_t> override_paths;
+
+    /* Was each override line returned in place of a base line? */
+    std::vector<bool> override_used;
+
+    /* Number of override lines that replaced at least one base line */
+    size_t override_used_count = 0;
+
+    /* Latest modified date of the patch layers, when they were read */
+    std::string patch_modified_date;
+
+    /* Path key of the last base line, kept to reuse its memory */
+    std::string path_key;
+
+    /* Has the reader been started? */
+    bool started = false;
+
+    /* Index of the next override line to return after the end of the base */
+    size_t tail_index = 0;
+
+  /*=============================================================================
+   * PRIVATE FUNCTIONS
+   *============================================================================*/
+  private:
+    /* Builds the path key of the line into the path key member */
+    void buildPathKey(XmlDataView line);
+
+    /* Reads the patch layers into the override lines. False if any of them failed */
+    bool readOverrides();
+
+    /* Replaces the base line with its override, if it has one */
+    void replaceLine(XmlData& line);
+
+    /* Resets the read location back to the start of the base */
+    void resetReadLocation();
+
+    /*--------------------- XmlReader ---------------------*/
+
+    /* Finds an element node from the current read location */
+    bool findInSource(XmlData branch) override;
+
+    /* Is the reader started already and available? */
+    bool isSourceAvailable() override;
+
+    /* Jumps the reader back to the root element of the document */
+    bool jumpToRootInSource() override;
+
+    /* Last date the data source was modified */
+    std::string lastModifiedDateFromSource() override;
+
+    /* Reads the next XML data element at the end of a branch */
+    XmlData readFromSource(bool& done, bool& success) override;
+
+    /* Reads the next batch of XML data elements into the lines, filling each in place */
+    size_t readBatchFromSource(std::vector<XmlData>& lines, size_t count, bool& done,
+                               bool& success) override;
+
+    /* Sets up the reader to be able to read from the data source */
+    bool startReadFromSource() override;
+
+    /* Stops and cleans up the reader after reading from the data source */
+    bool stopReadFromSource() override;
+
+    /* Total count of the number of XML data elements available in the data source */
+    int totalDataCountFromSource() override;
+
+  /*=============================================================================
+   * PUBLIC FUNCTIONS
+   *============================================================================*/
+  public:
+    /* Returns the number of layers, including the base */
+    size_t getLayerCount() const;
+
+    /* Returns the number of distinct paths in the patch layers */
+    size_t getOverrideCount() const;
+  };
+};
+
+#endif // CORE_LAYEREDXMLREADER_H
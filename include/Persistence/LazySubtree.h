@@ -0,0 +1,85 @@
+/**
+ * @class LazySubtree
+ *
+ * Deferred load of a heavy subtree, such as the entries of a conversation or the win and lose
+ * events of a battle. When a load asks for lazy subtrees (see {@link LoadOptions}), the owner
+ * appends each data line of the subtree here instead of building its objects, and replays them
+ * through its loader the first time the subtree is accessed. The lines are kept as compact
+ * binary records (see {@link BinaryEncoding}) in small pages, which is a fraction of the size of
+ * the built objects, so the subtrees that are never triggered in a session cost neither the parse
+ * nor the memory.
+ */
+#ifndef CORE_LAZYSUBTREE_H
+#define CORE_LAZYSUBTREE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+#include "Persistence/Atom.h"
+#include "Persistence/AtomTable.h"
+#include "Persistence/BinaryEncoding.h"
+#include "Persistence/DataType.h"
+#include "Persistence/PageBuffer.h"
+#include "Persistence/TextEncoding.h"
+#include "Persistence/XmlData.h"
+#include "Persistence/XmlDataView.h"
+
+namespace core
+{
+  class LazySubtree
+  {
+  public:
+    /* Constructor function */
+    LazySubtree();
+
+    /* Copy constructor */
+    LazySubtree(const LazySubtree& source);
+
+  private:
+    /* Data line records appended since the last replay */
+    PageBuffer buffer;
+
+    /*------------------- Constants -----------------------*/
+  private:
+    /* Size of each page of records. Small, since most subtrees are a few lines */
+    const static size_t kPAGE_SIZE = 256;
+
+  /*=============================================================================
+   * PRIVATE STATIC FUNCTIONS
+   *============================================================================*/
+  private:
+    /* Appends an element name or key, as its atom if it's interned */
+    static void appendName(PageBuffer& buffer, std::string_view name, Atom atom);
+
+    /* Decodes an element name or key at the cursor */
+    static bool readName(const char*& cursor, const char* end, std::string_view& name,
+                         Atom& atom);
+
+  /*=============================================================================
+   * PUBLIC FUNCTIONS
+   *============================================================================*/
+  public:
+    /* Appends the data line, from the element at the index, to be loaded later */
+    void append(XmlDataView data, int index);
+
+    /* Drops the lines that have not been loaded yet */
+    void clear();
+
+    /* Returns if there are no lines waiting to be loaded */
+    bool isEmpty() const;
+
+    /* Passes each waiting line to the loader, in order, and then drops them */
+    void replay(const std::function<void(XmlDataView)>& load);
+
+  /*=============================================================================
+   * OPERATOR FUNCTIONS
+   *============================================================================*/
+  public:
+    LazySubtree& operator=(const LazySubtree& source);
+  };
+};
+
+#endif // CORE_LAZYSUBTREE_H
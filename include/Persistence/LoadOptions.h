@@ -0,0 +1,26 @@
+/**
+ * @class LoadOptions
+ *
+ * Settings of a single load, passed down the load path with each line of data. Every load picks
+ * its own, so loads running at the same time, such as the shards of a {@link ShardedLoader},
+ * never affect each other. A default constructed set loads everything as it is read, and still
+ * accepts the legacy layouts.
+ */
+#ifndef CORE_LOADOPTIONS_H
+#define CORE_LOADOPTIONS_H
+
+namespace core
+{
+  struct LoadOptions
+  {
+    /* Are heavy subtrees (conversation entries and battle win and lose events) kept as their
+     * lines and only built the first time they are accessed? See LazySubtree */
+    bool lazy_subtrees = false;
+
+    /* Are conversation entries in the legacy layout, with the entry id as a key on the
+     * conversation element, loaded? Disable once every save is migrated. See SaveMigrator */
+    bool legacy_conversations = true;
+  };
+};
+
+#endif // CORE_LOADOPTIONS_H
@@ -0,0 +1,136 @@
+/**
+ * @class MappedFile
+ *
+ * Read-only memory mapping of a file on disk. This wraps the platform specific calls so that
+ * reader backends can treat any size of file as a single contiguous buffer, with the operating
+ * system paging the content in and out on demand. A file written by {@link BlockCompression} is
+ * decoded a block at a time as the content is loaded, into memory that is only reserved when the
+ * file is opened, so the content is always the uncompressed document. Only a few decoded blocks
+ * are kept, so the memory used stays small regardless of the size of the file.
+ */
+#ifndef CORE_MAPPEDFILE_H
+#define CORE_MAPPEDFILE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include "Persistence/BlockCompression.h"
+#include "Persistence/XmlTokenType.h"
+#include "Persistence/XmlTokenizer.h"
+
+namespace core
+{
+  class MappedFile
+  {
+  public:
+    /* Constructor function */
+    MappedFile() = default;
+
+    /* Non-copyable, the mapping is owned by a single instance */
+    MappedFile(const MappedFile& source) = delete;
+
+    /* Destructor function */
+    ~MappedFile();
+
+  private:
+    /* Is each block of a compressed file decoded into the content? */
+    std::vector<bool> block_decoded;
+
+    /* Block table of a compressed file, into its mapping. Empty if the file is mapped as is */
+    BlockCompression::BlockTable block_table;
+
+    /* Decoded blocks of a compressed file, least recently used first */
+    std::vector<size_t> cached_blocks;
+
+    /* Start of the file content. Null if not open or if the file is empty. For a compressed file,
+     * this is reserved memory that only holds the decoded blocks */
+    const char* data = nullptr;
+
+    /* Platform handles for the open file and mapping */
+    intptr_t file_handle = -1;
+    intptr_t map_handle = -1;
+
+    /* Start and size of the mapping of the file. The content itself, unless it's compressed */
+    const char* mapped_data = nullptr;
+    size_t mapped_size = 0;
+
+    /* Last modified time of the file, when it was opened */
+    std::time_t modified_time = 0;
+
+    /* Is the file open and mapped? */
+    bool mapped = false;
+
+    /* Size of the file content, in bytes */
+    size_t size = 0;
+
+    /*------------------- Constants -----------------------*/
+  private:
+    /* Number of decoded blocks of a compressed file that are kept, besides those being loaded */
+    const static size_t kCACHED_BLOCKS = 4;
+
+  /*=============================================================================
+   * PRIVATE FUNCTIONS
+   *============================================================================*/
+  private:
+    /* Decodes a block of a compressed file, making room in the cache outside the kept blocks */
+    bool decodeBlock(size_t index, size_t keep_first, size_t keep_last);
+
+    /* Releases the memory of the decoded block at the position in the cache */
+    void evictBlock(size_t position);
+
+    /* Reads the block table of the mapped compressed file and reserves memory for the content */
+    bool openCompressed();
+
+  /*=============================================================================
+   * PUBLIC FUNCTIONS
+   *============================================================================*/
+  public:
+    /* Unmaps and closes the file */
+    void close();
+
+    /* Returns the start of the file content */
+    const char* getData() const;
+
+    /* Returns the last modified date of the file, formatted for display */
+    std::string getModifiedDate() const;
+
+    /* Returns the last modified time of the file, when it was opened */
+    std::time_t getModifiedTime() const;
+
+    /* Returns the size of the file content, in bytes */
+    size_t getSize() const;
+
+    /* Returns if the content is decoded from a compressed file */
+    bool isCompressed() const;
+
+    /* Returns if the file is open and mapped */
+    bool isOpen() const;
+
+    /* Makes the content in the range readable. Returns the end of the readable content after it */
+    size_t load(size_t begin, size_t end);
+
+    /* Scans the next token with a tokenizer over the content, loading more content as needed */
+    XmlTokenType nextToken(XmlTokenizer& tokenizer, size_t end = SIZE_MAX);
+
+    /* Opens and maps the file at the path */
+    bool open(const std::string& path);
+
+    /* Hints that all content before the offset is no longer needed in memory */
+    void releaseBefore(size_t offset);
+
+    /* Returns a tokenizer over the content that starts at the offset */
+    XmlTokenizer tokenize(size_t offset, size_t end = SIZE_MAX);
+
+  /*=============================================================================
+   * OPERATOR FUNCTIONS
+   *============================================================================*/
+  public:
+    MappedFile& operator=(const MappedFile& source) = delete;
+  };
+};
+
+#endif // CORE_MAPPEDFILE_H
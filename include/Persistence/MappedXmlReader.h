@@ -0,0 +1,156 @@
+/**
+ * @class MappedXmlReader
+ *
+ * Streaming XML reader implementation that memory maps the source file and tokenizes it
+ * incrementally as lines are requested. No document tree is ever built: the only state held is
+ * the element branch to the current read location, so memory stays constant regardless of the
+ * size of the file. Data elements are expected in the form <element type="N">data</element>,
+ * where N is the numeric {@link DataType} of the data. If the source has an up to date
+ * {@link XmlIndex} sidecar, find() seeks straight to the element instead of scanning for it.
+ */
+#ifndef CORE_MAPPEDXMLREADER_H
+#define CORE_MAPPEDXMLREADER_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Persistence/MappedFile.h"
+#include "Persistence/XmlData.h"
+#include "Persistence/XmlDataView.h"
+#include "Persistence/XmlIndex.h"
+#include "Persistence/XmlReader.h"
+#include "Persistence/XmlTokenizer.h"
+
+namespace core
+{
+  class MappedXmlReader : public XmlReader
+  {
+  public:
+    /* Constructor function, from the path of the source file */
+    MappedXmlReader(std::string path);
+
+    /* Destructor function */
+    ~MappedXmlReader();
+
+  private:
+    /* Constructor function, for a split reader over a range of the source file */
+    MappedXmlReader(std::string path, size_t range_begin, size_t range_end,
+                    XmlData range_branch);
+
+  private:
+    /* Element branch to the current read location */
+    XmlData branch;
+
+    /* Reused buffers for the key and value of the last element, if they held any entities */
+    std::string decoded_key;
+    std::string decoded_value;
+
+    /* Memory mapped source file */
+    MappedFile file;
+
+    /* Offset index of the source, from its sidecar file. Empty if there is none */
+    XmlIndex index;
+
+    /* Is the last opened element still able to hold data (no child elements yet)? */
+    bool leaf_open = false;
+
+    /* Decoded text collected inside the open leaf element, and was every entity in it valid? */
+    std::string leaf_text;
+    bool leaf_text_valid = true;
+
+    /* Path to the source file */
+    std::string path;
+
+    /* Range of the source that is read and the branch that wraps it. The whole source if the
+     * reader isn't split */
+    size_t range_begin = 0;
+    XmlData range_branch;
+    size_t range_end = SIZE_MAX;
+
+    /* Offset in the source that has already been released from memory */
+    size_t released_offset = 0;
+
+    /* Tokenizer over the mapped source */
+    XmlTokenizer tokenizer;
+
+    /* Cached total count of data elements in the source. Negative if not yet counted */
+    int total_data_count = -1;
+
+    /*------------------- Constants -----------------------*/
+  private:
+    /* Amount of the source that is read before the pages behind it are released */
+    const static size_t kRELEASE_INTERVAL = 16 * 1024 * 1024;
+
+  /*=============================================================================
+   * PRIVATE FUNCTIONS
+   *============================================================================*/
+  private:
+    /* Finds an element node from the current read location with a seek through the index */
+    bool findInIndex(XmlDataView target, bool& found);
+
+    /* Returns if the top element of the branch is the one that matches the close tag */
+    bool isBranchTop(std::string_view element);
+
+    /* Returns if the top element of the branch is a data element */
+    bool isBranchTopData();
+
+    /* Reads the next XML data element into the line, reusing its memory */
+    void readLine(XmlData& line, bool& done, bool& success);
+
+    /* Resets the read location back to the start of the source */
+    void resetReadLocation();
+
+    /*--------------------- XmlReader ---------------------*/
+
+    /* Finds an element node from the current read location */
+    bool findInSource(XmlData branch) override;
+
+    /* Is the reader started already and available? */
+    bool isSourceAvailable() override;
+
+    /* Jumps the reader back to the root element of the document */
+    bool jumpToRootInSource() override;
+
+    /* Last date the data source was modified */
+    std::string lastModifiedDateFromSource() override;
+
+    /* Reads the next XML data element at the end of a branch */
+    XmlData readFromSource(bool& done, bool& success) override;
+
+    /* Reads the next batch of XML data elements into the lines, filling each in place */
+    size_t readBatchFromSource(std::vector<XmlData>& lines, size_t count, bool& done,
+                               bool& success) override;
+
+    /* Sets up the reader to be able to read from the data source */
+    bool startReadFromSource() override;
+
+    /* Stops and cleans up the reader after reading from the data source */
+    bool stopReadFromSource() override;
+
+    /* Total count of the number of XML data elements available in the data source */
+    int totalDataCountFromSource() override;
+
+    /* Splits the source into independent readers at the top-level element boundaries */
+    std::vector<std::unique_ptr<XmlReader>> splitSource(int shard_count) override;
+
+  /*=============================================================================
+   * PUBLIC FUNCTIONS
+   *============================================================================*/
+  public:
+    /* Builds the offset index of the source with a first pass and saves it as the sidecar */
+    bool buildIndex();
+
+    /* Returns the path to the source file */
+    std::string getPath() const;
+
+    /* Returns if find() is using the offset index of the source */
+    bool isIndexed() const;
+  };
+};
+
+#endif // CORE_MAPPEDXMLREADER_H
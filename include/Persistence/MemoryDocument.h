@@ -0,0 +1,106 @@
+/**
+ * @class MemoryDocument
+ *
+ * Document recorded by {@link MemoryXmlWriter} and replayed by {@link MemoryXmlReader}. It's a
+ * flat array of fixed size nodes in document order (the OPEN, DATA and CLOSE records of
+ * {@link BinaryRecordType}) with all of their strings in a single pool, so a whole document is a
+ * handful of allocations and nothing is formatted to or parsed from text. Names and keys that are
+ * interned are kept as their atom only. Each OPEN node also holds the index of its CLOSE node,
+ * so a reader can skip a whole subtree.
+ *
+ * A document is immutable once the writer saves it and is shared by const pointer, so any number
+ * of readers on any threads can replay it at the same time.
+ */
+#ifndef CORE_MEMORYDOCUMENT_H
+#define CORE_MEMORYDOCUMENT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Persistence/Atom.h"
+#include "Persistence/AtomTable.h"
+#include "Persistence/BinaryRecordType.h"
+#include "Persistence/DataType.h"
+
+namespace core
+{
+  class MemoryDocument
+  {
+    /* Only the writer builds documents, and only the reader decodes them */
+    friend class MemoryXmlReader;
+    friend class MemoryXmlWriter;
+
+  public:
+    /* Constructor function */
+    MemoryDocument() = default;
+
+  private:
+    /* A single record of the document. Strings are ranges of the pool */
+    struct Node
+    {
+      BinaryRecordType type;
+      DataType data_type;
+      Atom name_atom;
+      Atom key_atom;
+      uint32_t name_offset;
+      uint32_t name_size;
+      uint32_t key_offset;
+      uint32_t key_size;
+      uint32_t value_offset;
+      uint32_t value_size;
+      union
+      {
+        bool data_boolean;
+        float data_float;
+        int64_t data_integer;
+        uint32_t close_index;
+      };
+    };
+
+    /* Number of DATA nodes */
+    size_t data_count = 0;
+
+    /* Time the document was saved */
+    std::time_t modified_time = 0;
+
+    /* Records of the document, in order */
+    std::vector<Node> nodes;
+
+    /* Pool of the strings of the nodes */
+    std::string strings;
+
+  /*=============================================================================
+   * PRIVATE FUNCTIONS
+   *============================================================================*/
+  private:
+    /* Appends a string to the pool. Returns its offset */
+    uint32_t appendString(std::string_view value);
+
+    /* Returns the name, key or value of a node */
+    std::string_view getKey(const Node& node) const;
+    std::string_view getName(const Node& node) const;
+    std::string_view getValue(const Node& node) const;
+
+  /*=============================================================================
+   * PUBLIC FUNCTIONS
+   *============================================================================*/
+  public:
+    /* Returns the memory held by the document, in bytes */
+    size_t getByteSize() const;
+
+    /* Returns the number of data elements in the document */
+    size_t getDataCount() const;
+
+    /* Returns the time the document was saved, formatted as a UTC date */
+    std::string getModifiedDate() const;
+
+    /* Returns the number of records in the document */
+    size_t getNodeCount() const;
+  };
+};
+
+#endif // CORE_MEMORYDOCUMENT_H
@@ -0,0 +1,113 @@
+/**
+ * @class MemoryXmlReader
+ *
+ * Reader implementation that replays a {@link MemoryDocument} saved by {@link MemoryXmlWriter}.
+ * It follows the same contract as the file readers, so all existing load code works unchanged,
+ * but the data arrives already typed and nothing is parsed. The document is shared, not copied,
+ * so readers on several threads can replay the same snapshot, and find() skips the subtrees that
+ * can't match without walking them.
+ */
+#ifndef CORE_MEMORYXMLREADER_H
+#define CORE_MEMORYXMLREADER_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Persistence/Atom.h"
+#include "Persistence/BinaryRecordType.h"
+#include "Persistence/DataType.h"
+#include "Persistence/MemoryDocument.h"
+#include "Persistence/TextEncoding.h"
+#include "Persistence/XmlData.h"
+#include "Persistence/XmlDataView.h"
+#include "Persistence/XmlReader.h"
+
+namespace core
+{
+  class MemoryXmlReader : public XmlReader
+  {
+  public:
+    /* Constructor function, from the document to replay */
+    MemoryXmlReader(std::shared_ptr<const MemoryDocument> document);
+
+  private:
+    /* Constructor function, for a split reader over a range of the document */
+    MemoryXmlReader(std::shared_ptr<const MemoryDocument> document, size_t range_begin,
+                    size_t range_end, XmlData range_branch);
+
+  private:
+    /* Element branch to the current read location */
+    XmlData branch;
+
+    /* The document that is replayed */
+    std::shared_ptr<const MemoryDocument> document;
+
+    /* Index of the next node to read */
+    size_t node_index = 0;
+
+    /* Range of the nodes that is read and the branch that wraps it. The whole document if the
+     * reader isn't split */
+    size_t range_begin = 0;
+    XmlData range_branch;
+    size_t range_end = SIZE_MAX;
+
+    /* Has the reader been started? */
+    bool started = false;
+
+  /*=============================================================================
+   * PRIVATE FUNCTIONS
+   *============================================================================*/
+  private:
+    /* Returns the index of the node where the read stops: the end of the document or range */
+    size_t getReadEnd() const;
+
+    /* Reads the next XML data element into the line, reusing its memory */
+    void readLine(XmlData& line, bool& done, bool& success);
+
+    /*--------------------- XmlReader ---------------------*/
+
+    /* Finds an element node from the current read location */
+    bool findInSource(XmlData branch) override;
+
+    /* Is the reader started already and available? */
+    bool isSourceAvailable() override;
+
+    /* Jumps the reader back to the root element of the document */
+    bool jumpToRootInSource() override;
+
+    /* Last date the data source was modified */
+    std::string lastModifiedDateFromSource() override;
+
+    /* Reads the next XML data element at the end of a branch */
+    XmlData readFromSource(bool& done, bool& success) override;
+
+    /* Reads the next batch of XML data elements into the lines, filling each in place */
+    size_t readBatchFromSource(std::vector<XmlData>& lines, size_t count, bool& done,
+                               bool& success) override;
+
+    /* Sets up the reader to be able to read from the data source */
+    bool startReadFromSource() override;
+
+    /* Stops and cleans up the reader after reading from the data source */
+    bool stopReadFromSource() override;
+
+    /* Total count of the number of XML data elements available in the data source */
+    int totalDataCountFromSource() override;
+
+    /* Splits the source into independent readers at the top-level element boundaries */
+    std::vector<std::unique_ptr<XmlReader>> splitSource(int shard_count) override;
+
+  /*=============================================================================
+   * PUBLIC FUNCTIONS
+   *============================================================================*/
+  public:
+    /* Returns the document that is replayed */
+    std::shared_ptr<const MemoryDocument> getDocument() const;
+  };
+};
+
+#endif // CORE_MEMORYXMLREADER_H
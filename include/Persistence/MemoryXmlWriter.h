@@ -0,0 +1,106 @@
+/**
+ * @class MemoryXmlWriter
+ *
+ * Writer implementation that records into a {@link MemoryDocument} instead of a file. It follows
+ * the same contract as the file writers, so any save code can serialize to memory: to clone an
+ * object through its save and load, to hand a snapshot to another thread or as the baseline
+ * backend of persistence benchmarks. Data is stored typed and interned names as their atom, so
+ * nothing is formatted to text. stop(true) closes all open elements and publishes the document,
+ * which is then immutable and can be read by a {@link MemoryXmlReader} on any thread.
+ */
+#ifndef CORE_MEMORYXMLWRITER_H
+#define CORE_MEMORYXMLWRITER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Persistence/AtomTable.h"
+#include "Persistence/BinaryRecordType.h"
+#include "Persistence/DataType.h"
+#include "Persistence/MemoryDocument.h"
+#include "Persistence/TextEncoding.h"
+#include "Persistence/XmlData.h"
+#include "Persistence/XmlDataView.h"
+#include "Persistence/XmlWriter.h"
+
+namespace core
+{
+  class MemoryXmlWriter : public XmlWriter
+  {
+  public:
+    /* Constructor function */
+    MemoryXmlWriter() = default;
+
+  private:
+    /* Document written since start() */
+    MemoryDocument content;
+
+    /* Last document saved by stop(true). Null if none has been saved */
+    std::shared_ptr<const MemoryDocument> document;
+
+    /* Stack of open elements: node index, and the data count and string pool size after it */
+    std::vector<size_t> stack_data_count;
+    std::vector<uint32_t> stack_node;
+    std::vector<size_t> stack_strings_size;
+
+    /* Has the writer been started? */
+    bool started = false;
+
+  /*=============================================================================
+   * PRIVATE FUNCTIONS
+   *============================================================================*/
+  private:
+    /* Appends a DATA node of the type. Returns it, for the caller to set the payload */
+    MemoryDocument::Node& writeDataNode(const std::string& element, DataType type);
+
+    /*--------------------- XmlWriter ---------------------*/
+
+    /* Deletes all children element and data nodes beneath the current tree location */
+    bool deleteChildrenFromSource() override;
+
+    /* Finds a lower child node from the current node location in the XML tree */
+    bool findInSource(XmlData branch) override;
+
+    /* Is the writer started already and available? */
+    bool isSourceAvailable() override;
+
+    /* Jumps the writer back to the parent element of the current node */
+    bool jumpToParentInSource() override;
+
+    /* Jumps the writer back to the root element of the document */
+    bool jumpToRootInSource() override;
+
+    /* Sets up the writer to be able to write to the data source */
+    bool startWriteToSource() override;
+
+    /* Stops and cleans up the writer after writing to the data source */
+    bool stopWriteToSource(bool save_changes) override;
+
+    /* Writes a data node at the current tree location */
+    bool writeDataToSource(std::string element, DataType type, std::string data) override;
+    bool writeDataToSource(std::string element, bool data) override;
+    bool writeDataToSource(std::string element, float data) override;
+    bool writeDataToSource(std::string element, int data) override;
+    bool writeDataToSource(std::string element, std::string data) override;
+    bool writeDataToSource(std::string element, uint32_t data) override;
+
+    /* Writes an element child at the current tree location */
+    bool writeElementToSource(std::string element, std::string key, std::string value) override;
+
+    /* Writes one or more elements at the current tree location */
+    bool writeElementsToSource(XmlData element_set) override;
+
+  /*=============================================================================
+   * PUBLIC FUNCTIONS
+   *============================================================================*/
+  public:
+    /* Returns the last saved document. Null if none has been saved */
+    std::shared_ptr<const MemoryDocument> getDocument() const;
+  };
+};
+
+#endif // CORE_MEMORYXMLWRITER_H
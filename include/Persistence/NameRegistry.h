@@ -0,0 +1,167 @@
+/**
+ * @class NameRegistry
+ *
+ * Compile time mapping between an enumerator and the name it is persisted with. The names are
+ * listed once, indexed by the enumerator value, and construction searches for a hash seed that
+ * places every name in its own slot. Declared as a constexpr constant, it has no static
+ * initialization, a name lookup is one hash and one compare, and the enumerator to name mapping
+ * is an array index. If a name is repeated or no perfect seed is found, construction throws,
+ * which fails the build for a constexpr constant.
+ */
+#ifndef CORE_NAMEREGISTRY_H
+#define CORE_NAMEREGISTRY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+
+namespace core
+{
+  template <typename T, std::size_t N>
+  class NameRegistry
+  {
+    static_assert(N > 0 && N < 255, "Name registry supports between 1 and 254 names");
+
+    /*------------------- Constants -----------------------*/
+  private:
+    /* FNV-1a hash parameters */
+    constexpr static std::uint32_t kHASH_BASIS = 2166136261u;
+    constexpr static std::uint32_t kHASH_PRIME = 16777619u;
+
+    /* Number of seeds tried before giving up on a perfect hash */
+    constexpr static std::uint32_t kSEED_LIMIT = 4096;
+
+    /* Number of hash slots. Sparse enough that a perfect seed is found quickly */
+    constexpr static std::size_t kSLOT_COUNT = 8 * N;
+
+  public:
+    /* Constructor function, from the names indexed by the enumerator value */
+    constexpr NameRegistry(const std::string_view (&names)[N]);
+
+  private:
+    /* Names indexed by the enumerator value */
+    std::string_view names[N] = {};
+
+    /* Seed of the perfect hash */
+    std::uint32_t seed = 0;
+
+    /* Index + 1 of the name that hashes to each slot. 0 for an empty slot */
+    std::uint8_t slots[kSLOT_COUNT] = {};
+
+  /*=============================================================================
+   * PRIVATE STATIC FUNCTIONS
+   *============================================================================*/
+  private:
+    /* Returns the hash slot of the name for the seed */
+    constexpr static std::size_t slotOf(std::string_view name, std::uint32_t seed);
+
+  /*=============================================================================
+   * PUBLIC FUNCTIONS
+   *============================================================================*/
+  public:
+    /* Finds the enumerator for the name. Returns false if the name is not registered */
+    constexpr bool find(std::string_view name, T& value) const;
+
+    /* Returns the name of the enumerator. Blank if out of range */
+    constexpr std::string_view getName(T value) const;
+  };
+};
+
+/*============================================================================
+ * CONSTRUCTORS / DESTRUCTORS
+ *===========================================================================*/
+
+/**
+ * Constructor function - Copies the names and searches for the first seed that gives each name
+ * its own slot.
+ * @param names list of names, indexed by the enumerator value
+ * @throws std::logic_error if a name is repeated or no perfect seed is found within the limit
+ */
+template <typename T, std::size_t N>
+constexpr core::NameRegistry<T, N>::NameRegistry(const std::string_view (&names)[N])
+{
+  for(std::size_t i = 0; i < N; i++)
+  {
+    for(std::size_t j = 0; j < i; j++)
+      if(names[j] == names[i])
+        throw std::logic_error("Name registry names must be unique");
+    this->names[i] = names[i];
+  }
+
+  for(std::uint32_t candidate = 0; candidate < kSEED_LIMIT; candidate++)
+  {
+    for(std::size_t s = 0; s < kSLOT_COUNT; s++)
+      slots[s] = 0;
+
+    bool collision = false;
+    for(std::size_t i = 0; !collision && i < N; i++)
+    {
+      std::size_t slot = slotOf(names[i], candidate);
+      collision = (slots[slot] != 0);
+      slots[slot] = static_cast<std::uint8_t>(i + 1);
+    }
+
+    if(!collision)
+    {
+      seed = candidate;
+      return;
+    }
+  }
+  throw std::logic_error("Name registry could not find a perfect hash for the names");
+}
+
+/*============================================================================
+ * PRIVATE STATIC FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Returns the hash slot of the name for the seed. The seed is mixed into the FNV-1a basis.
+ * @param name the name to hash
+ * @param seed the hash seed
+ * @return slot index, less than the slot count
+ */
+template <typename T, std::size_t N>
+constexpr std::size_t core::NameRegistry<T, N>::slotOf(std::string_view name,
+                                                       std::uint32_t seed)
+{
+  std::uint32_t hash = kHASH_BASIS ^ (seed * kHASH_PRIME);
+  for(char c : name)
+    hash = (hash ^ static_cast<std::uint8_t>(c)) * kHASH_PRIME;
+  return (hash ^ (hash >> 16)) % kSLOT_COUNT;
+}
+
+/*============================================================================
+ * PUBLIC FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Finds the enumerator for the name: one hash to the slot and one compare to confirm it.
+ * @param name the persisted name
+ * @param value set to the enumerator if the name is registered
+ * @return TRUE if the name is registered
+ */
+template <typename T, std::size_t N>
+constexpr bool core::NameRegistry<T, N>::find(std::string_view name, T& value) const
+{
+  std::uint8_t entry = slots[slotOf(name, seed)];
+  if(entry == 0 || names[entry - 1] != name)
+    return false;
+
+  value = static_cast<T>(entry - 1);
+  return true;
+}
+
+/**
+ * Returns the name of the enumerator.
+ * @param value the enumerator
+ * @return view of the name, valid for the life of the program. Blank if out of range
+ */
+template <typename T, std::size_t N>
+constexpr std::string_view core::NameRegistry<T, N>::getName(T value) const
+{
+  std::size_t index = static_cast<std::size_t>(value);
+  return (index < N ? names[index] : std::string_view());
+}
+
+#endif // CORE_NAMEREGISTRY_H
@@ -0,0 +1,81 @@
+/**
+ * @class PageBuffer
+ *
+ * Append only byte buffer built as a chain of fixed size pages. Appending never moves existing
+ * content, growth costs one allocation per page and the whole chain can be flushed to a file in
+ * a single vectored write. Truncating keeps the pages allocated so they are reused by the next
+ * append.
+ */
+#ifndef CORE_PAGEBUFFER_H
+#define CORE_PAGEBUFFER_H
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace core
+{
+  class PageBuffer
+  {
+  public:
+    /* Constructor function, with an optional page size in bytes */
+    PageBuffer(size_t page_size = kPAGE_SIZE);
+
+  private:
+    /* Size of each page in the chain, in bytes */
+    size_t page_size;
+
+    /* Chain of allocated pages. Only the pages that hold content are used */
+    std::vector<std::unique_ptr<char[]>> pages;
+
+    /* Total bytes of content in the buffer */
+    size_t size = 0;
+
+    /*------------------- Constants -----------------------*/
+  public:
+    /* Default size of each page */
+    const static size_t kPAGE_SIZE = 64 * 1024;
+
+  private:
+    /* Suffix of the temporary file written before it replaces the destination */
+    const static std::string kTEMP_SUFFIX;
+
+    /* Maximum number of pages given to the operating system in one write call */
+    const static int kWRITE_BATCH = 1024;
+
+  /*=============================================================================
+   * PUBLIC FUNCTIONS
+   *============================================================================*/
+  public:
+    /* Appends bytes to the end of the buffer */
+    void append(char character);
+    void append(const char* data, size_t length);
+    void append(std::string_view data);
+
+    /* Appends the content of the buffer to the end of the file, creating it if required */
+    bool appendToFile(const std::string& path) const;
+
+    /* Copies the content of the buffer into the string, replacing its content */
+    void copyTo(std::string& destination) const;
+
+    /* Copies a range of the content of the buffer into the destination */
+    void copyTo(size_t offset, size_t length, char* destination) const;
+
+    /* Returns the total bytes of content in the buffer */
+    size_t getSize() const;
+
+    /* Truncates the content back to the size. Pages are kept for reuse */
+    void truncate(size_t size);
+
+    /* Writes the content of the buffer to the open file descriptor */
+    bool writeTo(int file_descriptor) const;
+
+    /* Writes the content of the buffer to the file, replacing it atomically */
+    bool writeToFile(const std::string& path) const;
+  };
+};
+
+#endif // CORE_PAGEBUFFER_H
@@ -0,0 +1,139 @@
+/**
+ * @class Profiler
+ *
+ * Optional load and save profiler for the persistence layer. Each profiled call records a count,
+ * the bytes it handled and its duration in nanoseconds, both as a total and in a histogram of
+ * power of two buckets, keyed by a category (such as event loads) and a name within it (such as
+ * the event type or element name). Counters are kept per thread, so worker threads never
+ * contend, and are summed when exported as JSON. Nested calls each record their own time, so the
+ * time of an outer call includes the calls within it.
+ *
+ * Profiling is only compiled in when the library is built with FIS_PROFILE defined (make
+ * PROFILE=1). Otherwise the FIS_PROFILE macros expand to nothing, arguments included.
+ */
+#ifndef CORE_PROFILER_H
+#define CORE_PROFILER_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifdef FIS_PROFILE
+  /* Profiles the rest of the enclosing block, under the category and name */
+  #define FIS_PROFILE_SCOPE(category, name) \
+    core::Profiler::Scope fis_profile_scope((category), (name))
+
+  /* Adds to the bytes handled by the profiled block */
+  #define FIS_PROFILE_BYTES(bytes) fis_profile_scope.addBytes(bytes)
+
+  /* Replaces the name of the profiled block, once it's known */
+  #define FIS_PROFILE_NAME(name) fis_profile_scope.setName(name)
+#else
+  #define FIS_PROFILE_SCOPE(category, name)
+  #define FIS_PROFILE_BYTES(bytes)
+  #define FIS_PROFILE_NAME(name)
+#endif
+
+namespace core
+{
+  class Profiler
+  {
+  public:
+    /* Number of histogram buckets. Bucket i counts durations from 2^i up to 2^(i+1) ns */
+    const static size_t kBUCKET_COUNT = 40;
+
+    /* Recorded totals of a single category and name */
+    struct Counter
+    {
+      uint64_t bytes = 0;
+      uint64_t count = 0;
+      uint64_t histogram[kBUCKET_COUNT] = {};
+      uint64_t total_ns = 0;
+    };
+
+    /* Times the block it lives in, and records it when destroyed */
+    class Scope
+    {
+    public:
+      /* Constructor function, starts the timer */
+      Scope(std::string_view category, std::string_view name);
+
+      /* Destructor function, records the block */
+      ~Scope();
+
+    private:
+      /* Bytes handled by the block */
+      size_t bytes = 0;
+
+      /* Category and name recorded under */
+      std::string_view category;
+      std::string name;
+
+      /* Time the block started */
+      std::chrono::steady_clock::time_point start;
+
+    public:
+      /* Adds to the bytes handled by the block */
+      void addBytes(size_t bytes);
+
+      /* Replaces the name recorded under */
+      void setName(std::string_view name);
+    };
+
+    /*------------------- Constants -----------------------*/
+  public:
+    /* Categories of the profiled calls */
+    constexpr static std::string_view kCONVERSATION_LOAD = "conversation_load";
+    constexpr static std::string_view kEVENT_LOAD = "event_load";
+    constexpr static std::string_view kEVENT_SAVE = "event_save";
+    constexpr static std::string_view kLOCK_LOAD = "lock_load";
+    constexpr static std::string_view kLOCK_SAVE = "lock_save";
+    constexpr static std::string_view kREAD = "read";
+    constexpr static std::string_view kWRITE = "write";
+
+  private:
+    /* Counters of one thread, by category and then name */
+    using CounterTable = std::map<std::string, std::map<std::string, Counter, std::less<>>,
+                                  std::less<>>;
+
+    /* Counter table of every thread that has recorded, guarded by the lock */
+    static std::vector<std::unique_ptr<CounterTable>> tables;
+    static std::mutex tables_lock;
+
+  /*=============================================================================
+   * PRIVATE STATIC FUNCTIONS
+   *============================================================================*/
+  private:
+    /* Appends the string to the JSON text, quoted and escaped */
+    static void appendJsonString(std::string& json, std::string_view value);
+
+    /* Returns the counter table of the calling thread, adding it on first use */
+    static CounterTable& getThreadTable();
+
+  /*=============================================================================
+   * PUBLIC STATIC FUNCTIONS
+   *============================================================================*/
+  public:
+    /* Returns if profiling was compiled into the library */
+    static bool isEnabled();
+
+    /* Records a single call under the category and name */
+    static void record(std::string_view category, std::string_view name, uint64_t duration_ns,
+                       size_t bytes);
+
+    /* Clears all recorded counters */
+    static void reset();
+
+    /* Returns the recorded counters, summed over all threads, as JSON */
+    static std::string toJson();
+  };
+};
+
+#endif // CORE_PROFILER_H
@@ -0,0 +1,97 @@
+/**
+ * @class SaveMigrator
+ *
+ * Offline migration of saves from legacy layouts into the current schema. Lines are piped from
+ * any reader into any writer one batch at a time, the same as {@link XmlConverter}, and each
+ * legacy line is rewritten on the way, so a save is never loaded whole. A directory of saves is
+ * migrated in parallel, one file at a time on each worker thread, and each file is rewritten in
+ * place in the format (and compression) it was read in. A file without legacy lines is left as
+ * it is.
+ *
+ * The only legacy layout is the conversation event that holds the entry id as a key on the
+ * conversation element (<conversation id="1.2"><text>), which is rewritten to the current entry
+ * element (<conversation><entry id="1.2"><text>). Once every save is migrated, the legacy load
+ * can be disabled for each load (see LoadOptions::legacy_conversations).
+ */
+#ifndef CORE_SAVEMIGRATOR_H
+#define CORE_SAVEMIGRATOR_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "Persistence/Atom.h"
+#include "Persistence/BinaryEncoding.h"
+#include "Persistence/BinaryReader.h"
+#include "Persistence/BinaryWriter.h"
+#include "Persistence/BufferedXmlWriter.h"
+#include "Persistence/MappedFile.h"
+#include "Persistence/MappedXmlReader.h"
+#include "Persistence/XmlConverter.h"
+#include "Persistence/XmlData.h"
+#include "Persistence/XmlDataView.h"
+#include "Persistence/XmlIndex.h"
+#include "Persistence/XmlReader.h"
+#include "Persistence/XmlWriter.h"
+
+namespace core
+{
+  class SaveMigrator
+  {
+  public:
+    /* Constructor function, from the worker thread count */
+    SaveMigrator(unsigned int thread_count = 0);
+
+  private:
+    /* Number of worker threads, which is also the maximum number of files migrated at once */
+    unsigned int thread_count;
+
+    /*------------------- Constants -----------------------*/
+  private:
+    /* Element that holds the entry id in the current conversation layout */
+    const static std::string kKEY_ENTRY;
+
+    /* Extension of the XML text saves. Binary saves are found by their magic instead */
+    const static std::string kXML_EXTENSION;
+
+  /*=============================================================================
+   * PRIVATE STATIC FUNCTIONS
+   *============================================================================*/
+  private:
+    /* Starts both, and pipes every line from the reader into the writer, migrating each */
+    static bool migrateLines(XmlReader* reader, XmlWriter* writer, size_t& migrated_count);
+
+  /*=============================================================================
+   * PUBLIC FUNCTIONS
+   *============================================================================*/
+  public:
+    /* Returns the number of worker threads */
+    unsigned int getThreadCount() const;
+
+    /* Migrates every save in the directory in place, in parallel */
+    bool migrateDirectory(const std::string& directory, size_t& migrated_file_count) const;
+
+  /*=============================================================================
+   * PUBLIC STATIC FUNCTIONS
+   *============================================================================*/
+  public:
+    /* Copies every data line from the reader into the writer, migrating each legacy line */
+    static bool migrate(XmlReader* reader, XmlWriter* writer, size_t& migrated_count);
+
+    /* Migrates the save file in place, only rewriting it if it has legacy lines */
+    static bool migrateFile(const std::string& path, size_t& migrated_count);
+
+    /* Rewrites the data line from a legacy layout into the current one */
+    static bool migrateLine(XmlData& line);
+  };
+};
+
+#endif // CORE_SAVEMIGRATOR_H
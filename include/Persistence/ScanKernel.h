@@ -0,0 +1,22 @@
+/**
+ * @class ScanKernel
+ *
+ * Enumerator defining the instruction set that the structural scanner uses to classify the
+ * characters of a block of XML text.
+ */
+#ifndef CORE_SCANKERNEL_H
+#define CORE_SCANKERNEL_H
+
+#include <cstdint>
+
+namespace core
+{
+  enum class ScanKernel : std::uint8_t
+  {
+    SCALAR,
+    SSE2,
+    AVX2
+  };
+};
+
+#endif // CORE_SCANKERNEL_H
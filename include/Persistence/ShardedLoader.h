@@ -0,0 +1,95 @@
+/**
+ * @class ShardedLoader
+ *
+ * Parallel content loader. The source is split into shards at the top-level element boundaries
+ * (the children of the root element) and each shard is read on its own worker thread, into a
+ * result object that only that shard touches. Results are returned in document order, so
+ * merging them in sequence gives the same content as one sequential read. If the reader can't
+ * be split, the whole source is read as a single shard on the calling thread.
+ */
+#ifndef CORE_SHARDEDLOADER_H
+#define CORE_SHARDEDLOADER_H
+
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "Persistence/XmlData.h"
+#include "Persistence/XmlDataView.h"
+#include "Persistence/XmlReader.h"
+
+namespace core
+{
+  class ShardedLoader
+  {
+  public:
+    /* Constructor function, from the reader of the source and the worker thread count */
+    ShardedLoader(XmlReader* reader, unsigned int thread_count = 0);
+
+  private:
+    /* Reader of the whole source, split into the shard readers */
+    XmlReader* reader;
+
+    /* Number of worker threads, which is also the maximum number of shards */
+    unsigned int thread_count;
+
+  /*=============================================================================
+   * PRIVATE FUNCTIONS
+   *============================================================================*/
+  private:
+    /* Reads every line of the shard into the line handler */
+    bool readShard(XmlReader* shard, std::function<void(XmlDataView)> load_line);
+
+    /* Runs the task for each shard index, each on its own worker thread */
+    bool runShards(size_t shard_count, std::function<bool(size_t)> task);
+
+  /*=============================================================================
+   * PUBLIC FUNCTIONS
+   *============================================================================*/
+  public:
+    /* Returns the number of worker threads */
+    unsigned int getThreadCount() const;
+
+    /* Loads the source in parallel, one result per shard in document order */
+    template <typename T>
+    bool load(std::vector<T>& results, std::function<void(T&, XmlDataView)> load_line);
+  };
+};
+
+/*============================================================================
+ * PUBLIC FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Loads the source in parallel. Each shard gets a default constructed result, and every line in
+ * the shard is passed to the handler with that result. A shard always holds whole top-level
+ * elements, so state kept in the result (such as the object currently being loaded) never spans
+ * two shards. If a handler throws, the first exception in document order is rethrown once all
+ * workers finish. Split shard readers allocate their lines from their own session arena, so the
+ * workers don't contend on the heap; a handler must not keep the line past its call.
+ * @param results set to one result per shard, in document order
+ * @param load_line handler that loads a single line of data into the shard result
+ * @return TRUE if every shard was read to the end and all of its lines were valid
+ */
+template <typename T>
+bool core::ShardedLoader::load(std::vector<T>& results,
+                               std::function<void(T&, XmlDataView)> load_line)
+{
+  std::vector<std::unique_ptr<XmlReader>> shards;
+  if(thread_count > 1)
+    shards = reader->split(thread_count);
+  for(std::unique_ptr<XmlReader>& shard : shards)
+    shard->setSessionArenaEnabled(true);
+  results = std::vector<T>(shards.empty() ? 1 : shards.size());
+
+  return runShards(results.size(), [&](size_t index)
+  {
+    XmlReader* shard = (shards.empty() ? reader : shards[index].get());
+    return readShard(shard, [&](XmlDataView line) { load_line(results[index], line); });
+  });
+}
+
+#endif // CORE_SHARDEDLOADER_H
@@ -0,0 +1,59 @@
+/**
+ * @class TextEncoding
+ *
+ * Primitive encoders and decoders for data stored as text in the XML content format. These are
+ * built on std::from_chars and std::to_chars, so they are independent of the locale, never
+ * allocate to parse and report malformed text with a return status instead of an exception.
+ * Floats are formatted as the shortest text that reads back to exactly the same value.
+ */
+#ifndef CORE_TEXTENCODING_H
+#define CORE_TEXTENCODING_H
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <climits>
+#include <clocale>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+namespace core
+{
+  class TextEncoding
+  {
+    /*------------------- Constants -----------------------*/
+  public:
+    /* Text of each boolean value */
+    const static std::string_view kBOOLEAN_FALSE;
+    const static std::string_view kBOOLEAN_TRUE;
+
+  /*=============================================================================
+   * PRIVATE STATIC FUNCTIONS
+   *============================================================================*/
+  private:
+    /* Trims the surrounding whitespace and a leading '+' off number text */
+    static std::string_view trimNumber(std::string_view text);
+
+  /*=============================================================================
+   * PUBLIC STATIC FUNCTIONS
+   *============================================================================*/
+  public:
+    /* Formats the primitive as text */
+    static std::string formatBoolean(bool value);
+    static std::string formatFloat(float value);
+    static std::string formatInteger(int value);
+    static std::string formatUnsigned(uint32_t value);
+
+    /* Decodes the primitive from the whole text. False if malformed or out of range */
+    static bool readBoolean(std::string_view text, bool& value);
+    static bool readFloat(std::string_view text, float& value);
+    static bool readInteger(std::string_view text, int& value);
+  };
+};
+
+#endif // CORE_TEXTENCODING_H
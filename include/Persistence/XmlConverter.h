@@ -0,0 +1,36 @@
+/**
+ * @class XmlConverter
+ *
+ * Offline conversion of a full document between any reader and writer backend, such as XML text
+ * to the compact binary format. The reader only yields data lines, so the element tree is
+ * rebuilt from the difference between each line and the branch that is currently open in the
+ * writer.
+ */
+#ifndef CORE_XMLCONVERTER_H
+#define CORE_XMLCONVERTER_H
+
+#include <string>
+
+#include "Persistence/DataType.h"
+#include "Persistence/XmlData.h"
+#include "Persistence/XmlDataView.h"
+#include "Persistence/XmlReader.h"
+#include "Persistence/XmlWriter.h"
+
+namespace core
+{
+  class XmlConverter
+  {
+  /*=============================================================================
+   * PUBLIC STATIC FUNCTIONS
+   *============================================================================*/
+  public:
+    /* Copies every data line from the reader into the writer */
+    static bool convert(XmlReader* reader, XmlWriter* writer);
+
+    /* Writes the data line into the writer, moving from the open branch to the line branch */
+    static bool writeLine(XmlWriter* writer, XmlData& line, XmlData& open_branch);
+  };
+};
+
+#endif // CORE_XMLCONVERTER_H
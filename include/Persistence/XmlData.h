@@ -7,19 +7,34 @@
 #ifndef CORE_XMLDATA_H
 #define CORE_XMLDATA_H
 
-#include <deque>
+#include <memory_resource>
 #include <string>
+#include <string_view>
+#include <typeinfo>
+#include <vector>
 
+#include "Persistence/Atom.h"
+#include "Persistence/AtomTable.h"
 #include "Persistence/DataType.h"
+#include "Persistence/TextEncoding.h"
 
 namespace core
 {
   class XmlData
   {
+    /* Read-only view used through the load path */
+    friend class XmlDataView;
+
   public:
     /* Constructor: Sets up a blank template with no data in the line set */
     XmlData() = default;
 
+    /* Constructor: Sets up a blank template that allocates from the memory resource */
+    XmlData(std::pmr::memory_resource* resource);
+
+    /* Constructor: Copies the line, allocating the copy from the memory resource */
+    XmlData(const XmlData& source, std::pmr::memory_resource* resource);
+
     /* Constructor: Sets up a template with one data item */
     XmlData(bool data);
     XmlData(float data);
@@ -27,25 +42,53 @@ namespace core
     XmlData(std::string data);
 
   private:
-    /* Element, key, and value stacks for data */
-    std::deque<std::string> element;
-    std::deque<std::string> key;
-    std::deque<std::string> value;
+    /* A single element of the branch, with its name and key interned as it is added. Its
+     * strings allocate from the same memory resource as the branch that holds it */
+    struct BranchElement
+    {
+      using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+      BranchElement(std::string_view element, std::string_view key, std::string_view value,
+                    Atom element_atom, Atom key_atom, const allocator_type& allocator = {});
+      BranchElement(const BranchElement& source, const allocator_type& allocator = {});
+      BranchElement(BranchElement&& source) = default;
+      BranchElement(BranchElement&& source, const allocator_type& allocator);
+      BranchElement& operator=(const BranchElement& source) = default;
+      BranchElement& operator=(BranchElement&& source) = default;
+
+      std::pmr::string element;
+      std::pmr::string key;
+      std::pmr::string value;
+      Atom element_atom;
+      Atom key_atom;
+    };
+
+    /* Element stack for data. One container keeps copying a line down to a single allocation */
+    std::pmr::vector<BranchElement> branch;
 
     /* The data from the XML */
     DataType data_type = DataType::NONE;
-    bool bool_data;
-    float float_data;
-    int int_data;
-    std::string string_data;
+    bool bool_data = false;
+    float float_data = 0.0f;
+    int int_data = 0;
+    std::pmr::string string_data;
+
+    /*------------------- Constants -----------------------*/
+  public:
+    /* Attribute key on the data element that holds the DataType of the data */
+    const static std::string kKEY_DATA_TYPE;
 
   /*=============================================================================
    * PUBLIC FUNCTIONS
    *============================================================================*/
   public:
     /* Add element to XML array */
-    void addElementBack(std::string element, std::string key = "", std::string value = "");
-    void addElementFront(std::string element, std::string key = "", std::string value = "");
+    void addElementBack(std::string_view element, std::string_view key = "",
+                        std::string_view value = "");
+    void addElementBack(std::string_view element, std::string_view key, std::string_view value,
+                        Atom element_atom, Atom key_atom);
+    void addElementFront(std::string_view element, std::string_view key = "",
+                         std::string_view value = "");
 
     /* Get data calls - success holds if the data is actually set in the class */
     std::string getData(bool* success = nullptr);
@@ -63,11 +106,16 @@ namespace core
 
     /* Element handling */
     std::string getElement(uint16_t index);
+    Atom getElementAtom(uint16_t index);
     std::string getKey(uint16_t index);
+    Atom getKeyAtom(uint16_t index);
     std::string getKeyValue(uint16_t index);
     std::string getLastElement();
     int getNumElements();
 
+    /* Returns the memory resource the line allocates from */
+    std::pmr::memory_resource* getMemoryResource() const;
+
     /* Determine the type of the data */
     bool isDataBoolean();
     bool isDataFloat();
@@ -80,13 +128,13 @@ namespace core
 
     /* If the start element has been added that indicates the data, call this
      * with a string read of the data and it will be converted */
-    bool setData(std::string data);
+    bool setData(std::string_view data);
 
     /* Set data to encapsulate in this class */
     void setDataOfType(bool data);
     void setDataOfType(float data);
     void setDataOfType(int data);
-    void setDataOfType(std::string data);
+    void setDataOfType(std::string_view data);
   };
 };
 
@@ -0,0 +1,72 @@
+/**
+ * @class XmlDataView
+ *
+ * Immutable, non-owning view of a line of XML data. This is what is passed down through the
+ * load path so a single line read from the source reaches the final setter without being copied.
+ * The viewed line is owned by the reader (or the caller of the reader) and must outlive the view.
+ */
+#ifndef CORE_XMLDATAVIEW_H
+#define CORE_XMLDATAVIEW_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "Persistence/Atom.h"
+#include "Persistence/DataType.h"
+#include "Persistence/XmlData.h"
+
+namespace core
+{
+  class XmlDataView
+  {
+  public:
+    /* Constructor: Sets up a view over an existing line of data */
+    explicit XmlDataView(const XmlData& data);
+
+    /* A view over a temporary line would dangle once the line is destroyed */
+    XmlDataView(XmlData&& data) = delete;
+
+  private:
+    /* The viewed line of data, not owned by the view */
+    const XmlData* data;
+
+  /*=============================================================================
+   * PUBLIC FUNCTIONS
+   *============================================================================*/
+  public:
+    /* Returns the size of the line: the names, keys and values of the elements and the data */
+    size_t getByteCount() const;
+
+    /* Get data calls - success holds if the data is actually set in the viewed line */
+    bool getDataBoolean(bool* success = nullptr) const;
+    bool getDataBooleanOrThrow() const;
+    float getDataFloat(bool* success = nullptr) const;
+    float getDataFloatOrThrow() const;
+    int getDataInteger(bool* success = nullptr) const;
+    int getDataIntegerOrThrow() const;
+    std::string_view getDataString(bool* success = nullptr) const;
+    std::string_view getDataStringOrThrow() const;
+
+    /* Returns the data type */
+    DataType getDataType() const;
+
+    /* Element handling */
+    std::string_view getElement(uint16_t index) const;
+    Atom getElementAtom(uint16_t index) const;
+    std::string_view getKey(uint16_t index) const;
+    Atom getKeyAtom(uint16_t index) const;
+    std::string_view getKeyValue(uint16_t index) const;
+    std::string_view getLastElement() const;
+    int getNumElements() const;
+
+    /* Determine the type of the data */
+    bool isDataBoolean() const;
+    bool isDataFloat() const;
+    bool isDataInteger() const;
+    bool isDataString() const;
+    bool isDataUnset() const;
+  };
+};
+
+#endif // CORE_XMLDATAVIEW_H
@@ -0,0 +1,145 @@
+/**
+ * @class XmlIndex
+ *
+ * Offset index of the elements in an XML source, kept in a sidecar file next to it (the source
+ * path with ".idx" appended). Every non-data element is recorded with its parent, its key and
+ * the byte offsets of its open and close tags, so a reader can seek straight to an element path
+ * instead of scanning everything before it. The index is stamped with the size and modified
+ * time of the source it describes, and is not loaded if either has changed since.
+ *
+ * The sidecar is the magic "FISI" and a version byte, the source size (varint) and modified time
+ * (signed varint), the entry count and then each entry in document order: parent entry + 1 (0 for
+ * a root element), element, key and value strings, and the open and close tag offsets. The
+ * primitives are encoded as in {@link BinaryEncoding}.
+ */
+#ifndef CORE_XMLINDEX_H
+#define CORE_XMLINDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "Persistence/BinaryEncoding.h"
+#include "Persistence/MappedFile.h"
+#include "Persistence/PageBuffer.h"
+#include "Persistence/XmlData.h"
+#include "Persistence/XmlTokenizer.h"
+
+namespace core
+{
+  class XmlIndex
+  {
+  public:
+    /* Constructor function */
+    XmlIndex() = default;
+
+  private:
+    /* A single indexed element */
+    struct Entry
+    {
+      uint32_t parent;
+      std::string element;
+      std::string key;
+      std::string value;
+      size_t tag_offset;
+      size_t end_offset;
+    };
+
+    /* The first element at an element path key, and if it's the only one */
+    struct Match
+    {
+      uint32_t entry;
+      bool unique;
+    };
+
+    /* Indexed elements, in document order */
+    std::vector<Entry> entries;
+
+    /* Match of each element path key */
+    std::unordered_map<std::string, Match> lookup;
+
+    /* Modified time and size of the source the index describes */
+    std::time_t source_modified_time = 0;
+    size_t source_size = 0;
+
+    /*------------------- Constants -----------------------*/
+  public:
+    /* Entry that stands in for none, such as the parent of a root element */
+    constexpr static uint32_t kNO_ENTRY = UINT32_MAX;
+
+    /* Extension appended to the source path for the sidecar file */
+    const static std::string kEXTENSION;
+
+  private:
+    /* Magic bytes at the start of every sidecar file */
+    const static std::string kMAGIC;
+
+    /* Current version of the sidecar format */
+    const static uint8_t kVERSION = 1;
+
+  /*=============================================================================
+   * PRIVATE FUNCTIONS
+   *============================================================================*/
+  private:
+    /* Rebuilds the path key lookup from the entries */
+    void buildLookup();
+
+  /*=============================================================================
+   * PUBLIC FUNCTIONS
+   *============================================================================*/
+  public:
+    /* Adds an element, opened at the offset, as the last child of the parent entry */
+    uint32_t addElement(uint32_t parent, std::string_view element, std::string_view key,
+                        std::string_view value, size_t tag_offset);
+
+    /* Builds the index of the source with a single scan */
+    bool build(MappedFile& source);
+
+    /* Removes all entries */
+    void clear();
+
+    /* Finds the first element at the element path key, and if it's the only one */
+    bool find(const std::string& path_key, uint32_t& entry, bool& unique) const;
+
+    /* Returns the data of the indexed element */
+    std::string_view getElement(uint32_t entry) const;
+    size_t getEndOffset(uint32_t entry) const;
+    size_t getEntryCount() const;
+    std::string_view getKey(uint32_t entry) const;
+    std::string_view getKeyValue(uint32_t entry) const;
+    uint32_t getParent(uint32_t entry) const;
+    size_t getTagOffset(uint32_t entry) const;
+
+    /* Returns if there are no entries */
+    bool isEmpty() const;
+
+    /* Loads the sidecar of the source. False if missing, malformed or out of date */
+    bool load(const std::string& source_path, const MappedFile& source);
+
+    /* Saves the sidecar of the source, stamped with its current size and modified time */
+    bool save(const std::string& source_path);
+
+    /* Sets the offset of the close tag of the element */
+    void setElementEnd(uint32_t entry, size_t end_offset);
+
+    /* Removes all elements opened past the offset */
+    void truncate(size_t offset);
+
+  /*=============================================================================
+   * PUBLIC STATIC FUNCTIONS
+   *============================================================================*/
+  public:
+    /* Appends one element level to an element path key */
+    static void appendPathKey(std::string& path_key, std::string_view element,
+                              std::string_view key, std::string_view value);
+
+    /* Returns the path of the sidecar file for the source */
+    static std::string getIndexPath(const std::string& source_path);
+  };
+};
+
+#endif // CORE_XMLINDEX_H
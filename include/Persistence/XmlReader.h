@@ -7,14 +7,39 @@
 #ifndef CORE_XMLREADER_H
 #define CORE_XMLREADER_H
 
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
 #include <string>
+#include <vector>
 
+#include "Persistence/Profiler.h"
 #include "Persistence/XmlData.h"
+#include "Persistence/XmlDataView.h"
 
 namespace core
 {
   class XmlReader
   {
+  public:
+    /* Destructor function */
+    virtual ~XmlReader() = default;
+
+  private:
+    /* Session arena: a pool that recycles the memory of freed lines, over a monotonic buffer
+     * that is released all at once by stop() */
+    std::pmr::monotonic_buffer_resource session_buffer;
+    std::pmr::unsynchronized_pool_resource session_pool{&session_buffer};
+
+    /* Are lines read in a session allocated from the session arena? */
+    bool session_arena_enabled = false;
+
+    /*------------------- Constants -----------------------*/
+  public:
+    /* Default number of lines read by readBatch(). Small enough that the reused lines stay in
+     * cache while they're filled and loaded */
+    const static size_t kBATCH_SIZE = 16;
+
   /*=============================================================================
    * PUBLIC FUNCTIONS - STABLE, NON-VIRTUAL INTERFACE
    *============================================================================*/
@@ -22,6 +47,9 @@ namespace core
     /* Finds an element node from the current read location */
     bool find(XmlData branch);
 
+    /* Returns the memory resource that lines read in the session are allocated from */
+    std::pmr::memory_resource* getMemoryResource();
+
     /* Is the reader started already and available? */
     bool isStarted();
 
@@ -34,6 +62,16 @@ namespace core
     /* Reads the next XML data element at the end of a branch */
     XmlData read(bool& done, bool& success);
 
+    /* Reads the next batch of XML data elements into a reusable buffer of lines */
+    size_t readBatch(std::vector<XmlData>& lines, bool& done, bool& success,
+                     size_t count = kBATCH_SIZE);
+
+    /* Sets if lines read in a session are allocated from the session arena */
+    void setSessionArenaEnabled(bool enabled);
+
+    /* Splits the source into independent readers at the top-level element boundaries */
+    std::vector<std::unique_ptr<XmlReader>> split(int shard_count);
+
     /* Sets up the reader to be able to read from the data source */
     bool start();
 
@@ -70,6 +108,17 @@ namespace core
 
     /* Total count of the number of XML data elements available in the data source */
     virtual int totalDataCountFromSource() = 0;
+
+  /*=============================================================================
+   * PRIVATE FUNCTIONS - IMPLEMENTATION SPECIFIC, OPTIONAL
+   *============================================================================*/
+  private:
+    /* Reads the next batch of XML data elements into the lines. Defaults to line by line */
+    virtual size_t readBatchFromSource(std::vector<XmlData>& lines, size_t count, bool& done,
+                                       bool& success);
+
+    /* Splits the source into independent readers. None if splitting isn't supported */
+    virtual std::vector<std::unique_ptr<XmlReader>> splitSource(int shard_count);
   };
 };
 
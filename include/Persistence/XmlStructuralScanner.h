@@ -0,0 +1,81 @@
+/**
+ * @class XmlStructuralScanner
+ *
+ * Vectorized classifier of the characters in XML text, used by the tokenizer to jump between the
+ * characters that matter instead of testing every byte. Each 64 byte block of text is scanned
+ * into two bitmaps, one bit per byte: the markup characters (< > = " ' & /) and the whitespace
+ * characters. The kernel is picked for the processor on the first scan: AVX2 or SSE2 on x86,
+ * otherwise a portable scalar loop. Every kernel returns the same bitmaps.
+ */
+#ifndef CORE_XMLSTRUCTURALSCANNER_H
+#define CORE_XMLSTRUCTURALSCANNER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define FIS_SCAN_X86
+#endif
+
+#include "Persistence/ScanKernel.h"
+
+namespace core
+{
+  class XmlStructuralScanner
+  {
+    /*------------------- Constants -----------------------*/
+  public:
+    /* Number of bytes scanned into each bitmap */
+    const static size_t kBLOCK_SIZE = 64;
+
+  private:
+    /* Scans a full block into the markup and whitespace bitmaps */
+    using BlockScan = void (*)(const char* block, uint64_t& markup, uint64_t& whitespace);
+
+    /* Kernel used to scan each block. Starts on the detection, which replaces itself */
+    static std::atomic<BlockScan> block_scan;
+
+    /* Instruction set of the kernel in use */
+    static std::atomic<ScanKernel> kernel;
+
+  /*=============================================================================
+   * PRIVATE STATIC FUNCTIONS
+   *============================================================================*/
+  private:
+    /* Picks the fastest supported kernel, then scans the block with it */
+    static void scanBlockDetect(const char* block, uint64_t& markup, uint64_t& whitespace);
+
+    /* Scans a block one byte at a time */
+    static void scanBlockScalar(const char* block, uint64_t& markup, uint64_t& whitespace);
+
+#ifdef FIS_SCAN_X86
+    /* Scans a block in 16 byte vectors */
+    static void scanBlockSse2(const char* block, uint64_t& markup, uint64_t& whitespace);
+
+    /* Scans a block in 32 byte vectors */
+    static void scanBlockAvx2(const char* block, uint64_t& markup, uint64_t& whitespace);
+#endif
+
+  /*=============================================================================
+   * PUBLIC STATIC FUNCTIONS
+   *============================================================================*/
+  public:
+    /* Returns the instruction set of the kernel in use */
+    static ScanKernel getKernel();
+
+    /* Returns if the processor supports the kernel */
+    static bool isKernelSupported(ScanKernel kernel);
+
+    /* Scans the block at the offset, which may run past the end of the text */
+    static void scanBlock(const char* data, size_t size, size_t offset, uint64_t& markup,
+                          uint64_t& whitespace);
+
+    /* Sets the kernel to use. False if it's not supported */
+    static bool setKernel(ScanKernel kernel);
+  };
+};
+
+#endif // CORE_XMLSTRUCTURALSCANNER_H
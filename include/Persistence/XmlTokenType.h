@@ -0,0 +1,25 @@
+/**
+ * @class XmlTokenType
+ *
+ * Enumerator defining the classification of a single markup token, as scanned out of a raw
+ * XML text buffer by the tokenizer.
+ */
+#ifndef CORE_XMLTOKENTYPE_H
+#define CORE_XMLTOKENTYPE_H
+
+#include <cstdint>
+
+namespace core
+{
+  enum class XmlTokenType : std::uint8_t
+  {
+    END,
+    ERROR,
+    ELEMENT_CLOSE,
+    ELEMENT_EMPTY,
+    ELEMENT_OPEN,
+    TEXT
+  };
+};
+
+#endif // CORE_XMLTOKENTYPE_H
@@ -0,0 +1,143 @@
+/**
+ * @class XmlTokenizer
+ *
+ * Incremental pull tokenizer over a raw XML text buffer. Each call to next() scans exactly one
+ * markup token (open tag, close tag, empty tag or text run) and exposes it as views into the
+ * buffer, so no memory is allocated while scanning. Declarations, comments and doctype nodes are
+ * skipped. The buffer is not owned and must outlive the tokenizer.
+ *
+ * The buffer is classified a 64 byte block at a time by {@link XmlStructuralScanner}, and names,
+ * whitespace, text runs and attribute values are all found from the bitmaps of the block, so
+ * only the characters that end a token are ever tested one at a time.
+ */
+#ifndef CORE_XMLTOKENIZER_H
+#define CORE_XMLTOKENIZER_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#include "Persistence/XmlStructuralScanner.h"
+#include "Persistence/XmlTokenType.h"
+
+namespace core
+{
+  class XmlTokenizer
+  {
+  public:
+    /* Constructor function, with no buffer */
+    XmlTokenizer() = default;
+
+    /* Constructor function, over the raw text buffer */
+    XmlTokenizer(const char* data, size_t size);
+
+  private:
+    /* Offset of the scanned block, and its bitmaps of the markup and whitespace characters */
+    size_t block_offset = SIZE_MAX;
+    uint64_t block_markup = 0;
+    uint64_t block_whitespace = 0;
+
+    /* Raw text buffer being scanned, not owned */
+    const char* data = nullptr;
+    size_t size = 0;
+
+    /* Current scan location in the buffer */
+    size_t offset = 0;
+
+    /* Details of the last scanned token */
+    std::string_view key;
+    std::string_view name;
+    std::string_view text;
+    bool text_encoded = true;
+    size_t token_offset = 0;
+    std::string_view value;
+
+  /*=============================================================================
+   * PRIVATE FUNCTIONS
+   *============================================================================*/
+  private:
+    /* Appends a numeric character reference as UTF-8. Returns false if it's malformed */
+    static bool appendCharacterReference(std::string_view entity, std::string& decoded);
+
+    /* Returns the offset of the next markup character from the offset, or the size if none */
+    size_t findMarkup(size_t from);
+
+    /* Returns the offset of the next markup or whitespace character from the offset */
+    size_t findMarkupOrWhitespace(size_t from);
+
+    /* Returns the offset of the next character from the offset that is not whitespace */
+    size_t findNonWhitespace(size_t from);
+
+    /* Is the character XML whitespace? */
+    static bool isWhitespace(char character);
+
+    /* Scans the block that holds the offset, if it isn't already. Returns the block offset */
+    size_t scanBlockAt(size_t from);
+
+    /* Scans a tag name starting at the current offset */
+    std::string_view scanName();
+
+    /* Scans a tag starting at the current offset, which is just past the opening '<' */
+    XmlTokenType scanTag();
+
+    /* Moves the offset past the terminator. Returns false if it was never found */
+    bool skipPast(std::string_view terminator);
+
+    /* Moves the offset past any whitespace */
+    void skipWhitespace();
+
+  /*=============================================================================
+   * PUBLIC FUNCTIONS
+   *============================================================================*/
+  public:
+    /* Returns the first attribute key of the last open or empty element token */
+    std::string_view getKey() const;
+
+    /* Returns the tag name of the last element token */
+    std::string_view getName() const;
+
+    /* Returns the current scan offset in the buffer */
+    size_t getOffset() const;
+
+    /* Returns the size of the buffer being scanned */
+    size_t getSize() const;
+
+    /* Returns the raw text of the last text token */
+    std::string_view getText() const;
+
+    /* Returns the buffer offset where the last token started */
+    size_t getTokenOffset() const;
+
+    /* Returns the first attribute value of the last open or empty element token */
+    std::string_view getValue() const;
+
+    /* Returns if the last text token is entity encoded (FALSE for CDATA sections) */
+    bool isTextEncoded() const;
+
+    /* Scans the next token in the buffer */
+    XmlTokenType next();
+
+    /* Moves the scan offset to a new location in the buffer */
+    void seek(size_t offset);
+
+  /*=============================================================================
+   * PUBLIC STATIC FUNCTIONS
+   *============================================================================*/
+  public:
+    /* Decodes the XML entities in raw text into a plain string (or appends to one) */
+    static std::string decode(std::string_view raw);
+    static bool decode(std::string_view raw, std::string& decoded);
+
+    /* Returns the raw text as is, or decoded into the scratch buffer if it has any entities */
+    static std::string_view decodeView(std::string_view raw, std::string& scratch, bool& valid);
+
+    /* Encodes the XML reserved characters in plain text (or appends to one) */
+    static std::string encode(std::string_view plain);
+    static void encode(std::string_view plain, std::string& encoded);
+  };
+};
+
+#endif // CORE_XMLTOKENIZER_H
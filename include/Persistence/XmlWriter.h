@@ -11,12 +11,18 @@
 #include <string>
 
 #include "Persistence/DataType.h"
+#include "Persistence/Profiler.h"
 #include "Persistence/XmlData.h"
+#include "Persistence/XmlDataView.h"
 
 namespace core
 {
   class XmlWriter
   {
+  public:
+    /* Destructor function */
+    virtual ~XmlWriter() = default;
+
   /*=============================================================================
    * PUBLIC FUNCTIONS - STABLE, NON-VIRTUAL INTERFACE
    *============================================================================*/
@@ -27,6 +33,9 @@ namespace core
     /* Finds a lower child node from the current node location in the XML tree */
     bool find(XmlData branch);
 
+    /* Does the writer add to the saved content, instead of replacing it? */
+    bool isIncremental();
+
     /* Is the writer started already and available? */
     bool isStarted();
 
@@ -36,6 +45,9 @@ namespace core
     /* Jumps the writer back to the root element of the document */
     bool jumpToRoot();
 
+    /* Moves to the child elements to rewrite them, if the writer adds to the saved content */
+    bool rewriteElements(XmlData element_set);
+
     /* Sets up the writer to be able to write to the data source */
     bool start();
 
@@ -94,6 +106,13 @@ namespace core
 
     /* Writes one or more elements at the current tree location */
     virtual bool writeElementsToSource(XmlData element_set) = 0;
+
+  /*=============================================================================
+   * PRIVATE FUNCTIONS - IMPLEMENTATION SPECIFIC, OPTIONAL
+   *============================================================================*/
+  private:
+    /* Does the writer add to the saved content, instead of replacing it? Not by default */
+    virtual bool isSourceIncremental();
   };
 };
 
@@ -2,7 +2,9 @@
  * @class Conversation
  *
  * A conversation is one fully contained set of entries that are displayed to communicate
- * to the player through a dynamic content presentation system.
+ * to the player through a dynamic content presentation system. When a load asks for lazy
+ * subtrees (see {@link LoadOptions}), the entries are only built the first time they are
+ * accessed.
  */
 #include "Event/Conversation/Conversation.h"
 using namespace core;
@@ -52,8 +54,11 @@ Conversation::~Conversation()
  */
 void Conversation::cloneSource(const Conversation& source)
 {
+  markDirty();
   delete root_entry;
   root_entry = source.root_entry->clone();
+  pending = source.pending;
+  pending_options = source.pending_options;
 }
 
 /**
@@ -65,7 +70,7 @@ void Conversation::createFirstEntry()
   if(root_entry->getNextEntryCount() == 0)
   {
     ConversationEntryNone first_entry;
-    root_entry->setNextEntry(0, first_entry, first_entry);
+    root_entry->setNextEntry(0, *first_entry.clone(), first_entry);
   }
 }
 
@@ -125,12 +130,96 @@ ConversationEntry& Conversation::getOrAddEntry(ConversationEntry& previous_entry
   if(group_index >= previous_entry.getNextEntryCount())
   {
     ConversationEntryNone blank_entry;
-    previous_entry.setNextEntry(group_index, blank_entry, blank_entry);
+    previous_entry.setNextEntry(group_index, *blank_entry.clone(), blank_entry);
   }
 
   return getOrAddEntry(previous_entry.getNextEntry(group_index), index, group_max, group + 1);
 }
 
+/**
+ * Loads a single entry data line into the tree, creating the entry and any gaps before it.
+ * @param data single packet of XML data
+ * @param index current index within the line, represents which XML element is currently being read
+ * @param options settings of the load
+ */
+void Conversation::loadEntry(XmlDataView data, int index, const LoadOptions& options) const
+{
+  // The legacy index is using the top level of the event (<conversation>) to
+  // define the entry identifier. This is to support conversion of legacy save files, until
+  // they are all migrated (see SaveMigrator) and the load disables the legacy layout
+  int legacy_index = index - 1;
+
+  // Fetch the string version of the entry index
+  int entry_data_index;
+  std::string_view entry_string_id;
+  if(data.getElementAtom(index) == Atom::ENTRY && data.getKeyAtom(index) == Atom::ID)
+  {
+    entry_data_index = index;
+    entry_string_id = data.getKeyValue(index);
+  }
+  else if(options.legacy_conversations && data.getElementAtom(legacy_index) == Atom::CONVERSATION &&
+          data.getKeyAtom(legacy_index) == Atom::ID)
+  {
+    entry_data_index = legacy_index;
+    entry_string_id = data.getKeyValue(legacy_index);
+  }
+
+  // If its a valid index format for the entry, process it and finish the load
+  std::string entry_string(entry_string_id);
+  if(ConversationEntryIndex::isValidString(entry_string))
+  {
+    ConversationEntryIndex entry_id(entry_string);
+
+    uint16_t last_group = entry_id.groupCount() - 1;
+    ConversationEntry& previous_entry = getOrAddEntry(*root_entry, entry_id, last_group);
+
+    // Check that the current entry is a TEXT type (only current supported type). If it isn't,
+    // swap it out before loading. Otherwise, just fetch the existing one.
+    ConversationEntry* entry_to_load;
+    uint8_t last_group_value = entry_id.groupValue(last_group);
+    if(previous_entry.getNextEntryCount() <= last_group_value ||
+       previous_entry.getNextEntry(last_group_value).getType() != ConversationEntryType::TEXT)
+    {
+      entry_to_load = new ConversationEntryText();
+
+      ConversationEntryNone filler_entry;
+      previous_entry.setNextEntry(last_group_value, *entry_to_load, filler_entry);
+    }
+    else
+    {
+      entry_to_load = &previous_entry.getNextEntry(last_group_value);
+    }
+
+    // Load the entry details
+    entry_to_load->load(data, entry_data_index + 1, options);
+  }
+}
+
+/**
+ * Loads the deferred entry data lines into the tree, in the order they were read and with the
+ * settings of the load that deferred them. Building the entries doesn't change whether the
+ * conversation needs to be saved, since they match the data they were loaded from.
+ */
+void Conversation::loadPending() const
+{
+  if(pending.isEmpty())
+    return;
+
+  bool clean = !isDirty();
+  pending.replay([this](XmlDataView line) { loadEntry(line, 1, pending_options); });
+  if(clean)
+    root_entry->clearDirty();
+}
+
+/**
+ * Marks the conversation as changed since it was last saved. Changes to the entries are tracked
+ * by the entries themselves.
+ */
+void Conversation::markDirty()
+{
+  dirty = true;
+}
+
 /**
  * Saves an individual conversation entry into the XML writer. This is recursive and will continue
  * through all leaf nodes before saving the entire tree.
@@ -165,6 +254,16 @@ void Conversation::save(XmlWriter* writer, const ConversationEntryIndex& index,
  * PUBLIC FUNCTIONS
  *============================================================================*/
 
+/**
+ * Marks the conversation and all of its entries as matching the saved data, once it's been
+ * fully loaded or saved.
+ */
+void Conversation::clearDirty()
+{
+  dirty = false;
+  root_entry->clearDirty();
+}
+
 /**
  * Deletes a single entry at the index in the conversation tree. This will also delete all
  * sub-entries off this single entry when deleted.
@@ -172,6 +271,8 @@ void Conversation::save(XmlWriter* writer, const ConversationEntryIndex& index,
  */
 void Conversation::deleteEntry(const ConversationEntryIndex& index)
 {
+  loadPending();
+  markDirty();
   if(hasEntry(index))
   {
     uint16_t last_group = index.groupCount() - 1;
@@ -190,6 +291,7 @@ void Conversation::deleteEntry(const ConversationEntryIndex& index)
  */
 ConversationEntry& Conversation::getEntry(const ConversationEntryIndex& index) const
 {
+  loadPending();
   return getEntry(*root_entry, index, index.groupCount());
 }
 
@@ -199,6 +301,7 @@ ConversationEntry& Conversation::getEntry(const ConversationEntryIndex& index) c
  */
 ConversationEntry& Conversation::getFirstEntry() const
 {
+  loadPending();
   return root_entry->getNextEntry(0);
 }
 
@@ -229,6 +332,8 @@ bool Conversation::hasEntry(const ConversationEntryIndex& index) const
  */
 void Conversation::insertEntry(const ConversationEntryIndex& index, ConversationEntry& entry)
 {
+  loadPending();
+  markDirty();
   uint16_t last_group = index.groupCount() - 1;
 
   ConversationEntry& previous_entry = getOrAddEntry(*root_entry, index, last_group);
@@ -238,69 +343,100 @@ void Conversation::insertEntry(const ConversationEntryIndex& index, Conversation
 }
 
 /**
- * Loads conversation data from the XML entry.
+ * Returns if the conversation or any of its entries changed since it was last saved. A new
+ * conversation is dirty until it's cleared.
+ * @return TRUE if the conversation needs to be saved again
+ */
+bool Conversation::isDirty() const
+{
+  return (dirty || root_entry->isDirty());
+}
+
+/**
+ * Loads conversation data from the XML entry. When the load asks for lazy subtrees, the line is
+ * only kept until the entries are accessed. Otherwise, any lines deferred by an earlier load are
+ * applied first, so the lines are applied in the order they were read. The conversation is then
+ * marked as matching the saved data.
  * @param data single packet of XML data
  * @param index current index within the line, represents which XML element is currently being read
+ * @param options settings of the load
  */
-void Conversation::load(XmlData data, int index)
+void Conversation::load(XmlDataView data, int index, const LoadOptions& options)
 {
-  // The legacy index is using the top level of the event (<conversation>) to
-  // define the entry identifier. This is to support conversion of legacy save files
-  int legacy_index = index - 1;
+  FIS_PROFILE_SCOPE(Profiler::kCONVERSATION_LOAD, data.getLastElement());
+  FIS_PROFILE_BYTES(data.getByteCount());
 
-  // Fetch the string version of the entry index
-  int entry_data_index;
-  std::string entry_string_id;
-  if(data.getElement(index) == kKEY_ENTRY && data.getKey(index) == kKEY_ENTRY_ID)
+  // Keep the element before the index, which holds the entry id in legacy save files
+  if(options.lazy_subtrees)
   {
-    entry_data_index = index;
-    entry_string_id = data.getKeyValue(index);
+    pending_options = options;
+    pending.append(data, index - 1);
   }
-  else if(data.getElement(legacy_index) == kKEY_ENTRY_LEGACY &&
-          data.getKey(legacy_index) == kKEY_ENTRY_ID)
+  else
   {
-    entry_data_index = legacy_index;
-    entry_string_id = data.getKeyValue(legacy_index);
+    loadPending();
+    loadEntry(data, index, options);
   }
+  clearDirty();
+}
 
-  // If its a valid index format for the entry, process it and finish the load
-  if(ConversationEntryIndex::isValidString(entry_string_id))
+/**
+ * Saves all conversation data into the XML writer. If the writer is available, the conversation
+ * and all of its entries are then marked as matching the saved data.
+ * @param writer saving file handler interface
+ */
+void Conversation::save(XmlWriter* writer) const
+{
+  ConversationEntryIndex first_entry_index;
+  save(writer, first_entry_index, getFirstEntry());
+  if(writer->isStarted())
   {
-    ConversationEntryIndex entry_id(entry_string_id);
-
-    uint16_t last_group = entry_id.groupCount() - 1;
-    ConversationEntry& previous_entry = getOrAddEntry(*root_entry, entry_id, last_group);
+    dirty = false;
+    root_entry->clearDirty();
+  }
+}
 
-    // Check that the current entry is a TEXT type (only current supported type). If it isn't,
-    // swap it out before loading. Otherwise, just fetch the existing one.
-    ConversationEntry* entry_to_load;
-    uint8_t last_group_value = entry_id.groupValue(last_group);
-    if(previous_entry.getNextEntryCount() <= last_group_value ||
-       previous_entry.getNextEntry(last_group_value).getType() != ConversationEntryType::TEXT)
-    {
-      entry_to_load = new ConversationEntryText();
+/**
+ * Rewrites the conversation data at the location in the XML writer, only if it changed since it
+ * was last saved. See {@link XmlWriter#rewriteElements} for how the location is rewritten, which
+ * is only done by a writer that adds to the saved content. Deleted entries are dropped with the
+ * rest of the old content.
+ * @param writer saving file handler interface
+ * @param location element branch, from the current writer node, that only holds the conversation
+ * @return TRUE if the conversation changed and was rewritten. FALSE if it didn't change, or if
+ *         the writer replaces the saved content, in which case nothing is written
+ */
+bool Conversation::saveIncremental(XmlWriter* writer, XmlData location)
+{
+  if(!isDirty() || !writer->rewriteElements(location))
+    return false;
 
-      ConversationEntryNone filler_entry;
-      previous_entry.setNextEntry(last_group_value, *entry_to_load, filler_entry);
-    }
-    else
-    {
-      entry_to_load = &previous_entry.getNextEntry(last_group_value);
-    }
+  int depth = XmlDataView(location).getNumElements();
+  save(writer);
+  for(int i = 0; i < depth; i++)
+    writer->jumpToParent();
 
-    // Load the entry details
-    entry_to_load->load(data, entry_data_index + 1);
-  }
+  clearDirty();
+  return true;
 }
 
 /**
- * Saves all conversation data into the XML writer.
- * @param writer saving file handler interface
+ * Captures a copy of the conversation, for saving it later (such as on another thread) while the
+ * live conversation keeps changing. The copy is taken now and is only touched by the task.
+ * @param location element branch, from the writer node the task runs at, to save it in
+ * @return task that writes the location and saves the copy, leaving the writer where it started
  */
-void Conversation::save(XmlWriter* writer) const
+std::function<void(XmlWriter*)> Conversation::snapshot(XmlData location) const
 {
-  ConversationEntryIndex first_entry_index;
-  save(writer, first_entry_index, getFirstEntry());
+  auto copy = std::make_shared<const Conversation>(*this);
+  return [copy, location](XmlWriter* writer)
+  {
+    int depth = XmlDataView(location).getNumElements();
+    writer->writeElements(location);
+    copy->save(writer);
+    for(int i = 0; i < depth; i++)
+      writer->jumpToParent();
+  };
 }
 
 /**
@@ -311,6 +447,8 @@ void Conversation::save(XmlWriter* writer) const
  */
 void Conversation::setEntry(const ConversationEntryIndex& index, ConversationEntry& entry)
 {
+  loadPending();
+  markDirty();
   uint16_t last_group = index.groupCount() - 1;
 
   ConversationEntry& previous_entry = getOrAddEntry(*root_entry, index, last_group);
@@ -44,6 +44,7 @@ ConversationEntry::~ConversationEntry()
  */
 void ConversationEntry::cloneSource(const ConversationEntry& source)
 {
+  markDirty();
   deleteNextEntries();
   for(auto entry : source.next_entries)
     next_entries.push_back(entry->clone());
@@ -70,19 +71,38 @@ void ConversationEntry::padNextEntries(uint8_t index, ConversationEntry& filler_
 {
   while(next_entries.size() < index)
   {
-    // Copy filler entry
-    ConversationEntry* new_filler_entry;
-    *new_filler_entry = filler_entry;
-
-    // Add to the back
-    next_entries.push_back(new_filler_entry);
+    // Copy filler entry and add to the back
+    next_entries.push_back(filler_entry.clone());
   }
 }
 
+/*=============================================================================
+ * PROTECTED FUNCTIONS
+ *============================================================================*/
+
+/**
+ * Marks the entry data as changed since it was last saved. Every function that changes data
+ * which is saved calls this.
+ */
+void ConversationEntry::markDirty()
+{
+  dirty = true;
+}
+
 /*=============================================================================
  * PUBLIC FUNCTIONS
  *============================================================================*/
 
+/**
+ * Marks the entry, and all entries following it, as matching the saved data.
+ */
+void ConversationEntry::clearDirty()
+{
+  dirty = false;
+  for(ConversationEntry* entry : next_entries)
+    entry->clearDirty();
+}
+
 /**
  * Deletes a single entry following this entry at the given index in the vector. If there is no
  * entry at the index, this is a no-op.
@@ -90,6 +110,7 @@ void ConversationEntry::padNextEntries(uint8_t index, ConversationEntry& filler_
  */
 void ConversationEntry::deleteNextEntry(uint8_t index)
 {
+  markDirty();
   if(index < next_entries.size())
   {
     delete next_entries.at(index);
@@ -129,6 +150,7 @@ uint8_t ConversationEntry::getNextEntryCount() const
 void ConversationEntry::insertNextEntry(uint8_t index, ConversationEntry& entry,
                                         ConversationEntry& filler_entry)
 {
+  markDirty();
   // If this is inserting an index at first spot and there's only one currently in the entry,
   // push the entry deeper in the tree instead of adding it as an option
   if(index == 0 && getNextEntryCount() == 1)
@@ -145,6 +167,21 @@ void ConversationEntry::insertNextEntry(uint8_t index, ConversationEntry& entry,
   }
 }
 
+/**
+ * Returns if the entry, or any entry following it, changed since it was last saved. A new entry
+ * is dirty until it's cleared.
+ * @return TRUE if the entry needs to be saved again
+ */
+bool ConversationEntry::isDirty() const
+{
+  if(dirty)
+    return true;
+  for(ConversationEntry* entry : next_entries)
+    if(entry->isDirty())
+      return true;
+  return false;
+}
+
 /**
  * Sets a single entry following this entry at the given index in the vector. It will
  * insert copies of {@param filler_entry} in between if there is gaps in the vector.
@@ -155,6 +192,7 @@ void ConversationEntry::insertNextEntry(uint8_t index, ConversationEntry& entry,
 void ConversationEntry::setNextEntry(uint8_t index, ConversationEntry& entry,
                                      ConversationEntry& filler_entry)
 {
+  markDirty();
   padNextEntries(index, filler_entry);
 
   // If the index is at the end, just add to the back
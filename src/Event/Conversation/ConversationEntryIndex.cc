@@ -10,7 +10,6 @@ using namespace core;
 
 /* Constant Implementation - see header file for descriptions */
 const char ConversationEntryIndex::kINDEX_GROUP_DELIMITER = '.';
-const std::regex ConversationEntryIndex::kINDEX_STRING_FORMAT("^1(\\.[1-9]\\d*)*$");
 
 /*=============================================================================
  * CONSTRUCTORS / DESTRUCTORS
@@ -123,7 +122,7 @@ bool ConversationEntryIndex::isRoot() const
 
 /**
  * Converts the index to a serialized string.
- * @return string address, matching format {#kINDEX_STRING_FORMAT}
+ * @return string address, in the form "1.4.1" (see {@link #isValidString})
  */
 std::string ConversationEntryIndex::toString() const
 {
@@ -143,11 +142,27 @@ std::string ConversationEntryIndex::toString() const
  *============================================================================*/
 
 /**
- * Returns if the string is in the valid format to convert into the index object.
+ * Returns if the string is in the valid format to convert into the index object: a root group of
+ * 1, then any number of groups of a delimiter and a number without leading zeros, such as
+ * "1.4.1". It's checked by hand, since it's run on every loaded entry line.
  * @param index_str index string representing an entry in the tree
  * @return TRUE if the string is correctly formed and can be converted into the entry object
  */
 bool ConversationEntryIndex::isValidString(std::string index_str)
 {
-  return std::regex_match(index_str, kINDEX_STRING_FORMAT);
+  if(index_str.empty() || index_str[0] != '1')
+    return false;
+
+  size_t group_length = 1;
+  for(size_t i = 1; i < index_str.size(); i++)
+  {
+    char c = index_str[i];
+    if(c == kINDEX_GROUP_DELIMITER && group_length > 0)
+      group_length = 0;
+    else if(i > 1 && c >= (group_length == 0 ? '1' : '0') && c <= '9')
+      group_length++;
+    else
+      return false;
+  }
+  return (group_length > 0);
 }
@@ -41,7 +41,7 @@ bool ConversationEntryNone::isSaveable() const
 /**
  * Loads conversation entry data from the XML entry. In this implementation, it is no-op.
  */
-void ConversationEntryNone::load(XmlData, int)
+void ConversationEntryNone::load(XmlDataView, int, const LoadOptions&)
 {
 }
 
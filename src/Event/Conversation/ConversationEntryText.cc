@@ -54,6 +54,7 @@ ConversationEntryText::~ConversationEntryText()
  */
 void ConversationEntryText::cloneSource(const ConversationEntryText& source)
 {
+  markDirty();
   delay_ms = source.delay_ms;
 
   delete event;
@@ -67,6 +68,15 @@ void ConversationEntryText::cloneSource(const ConversationEntryText& source)
  * PUBLIC FUNCTIONS
  *============================================================================*/
 
+/**
+ * Marks the entry, its event and all entries following it, as matching the saved data.
+ */
+void ConversationEntryText::clearDirty()
+{
+  ConversationEntry::clearDirty();
+  event->clearDirty();
+}
+
 /**
  * Deep clones the entry to return a new memory space version of the same data.
  * @return newly created event
@@ -123,6 +133,15 @@ ConversationEntryType ConversationEntryText::getType() const
   return ConversationEntryType::TEXT;
 }
 
+/**
+ * Returns if the entry, its event or any entry following it, changed since it was last saved.
+ * @return TRUE if the entry needs to be saved again
+ */
+bool ConversationEntryText::isDirty() const
+{
+  return (ConversationEntry::isDirty() || event->isDirty());
+}
+
 /**
  * Returns if the conversation entry can be saved using {@link save(XmlWriter*)}.
  * @return TRUE if it will generate save data
@@ -136,19 +155,26 @@ bool ConversationEntryText::isSaveable() const
  * Loads conversation entry data from the XML entry.
  * @param data single packet of XML data
  * @param index current index within the line, represents which XML element is currently being read
+ * @param options settings of the load
  */
-void ConversationEntryText::load(XmlData data, int index)
+void ConversationEntryText::load(XmlDataView data, int index, const LoadOptions& options)
 {
-  std::string element = data.getElement(index);
-
-  if(element == kKEY_DELAY)
-    setDelayMilliseconds(data.getDataIntegerOrThrow());
-  else if(element == kKEY_EVENT)
-    event = PersistEvent::load(event, data, index + 1);
-  else if(element == kKEY_MESSAGE)
-    setMessage(data.getDataStringOrThrow());
-  else if(element == kKEY_THING_ID)
-    setThingId(data.getDataIntegerOrThrow());
+  switch(data.getElementAtom(index)) {
+    case Atom::DELAY:
+      setDelayMilliseconds(data.getDataIntegerOrThrow());
+      break;
+    case Atom::EVENT:
+      event = PersistEvent::load(event, data, index + 1, options);
+      break;
+    case Atom::TEXT:
+      setMessage(std::string(data.getDataStringOrThrow()));
+      break;
+    case Atom::ID:
+      setThingId(data.getDataIntegerOrThrow());
+      break;
+    default:
+      break;
+  }
 }
 
 /**
@@ -179,6 +205,7 @@ void ConversationEntryText::save(XmlWriter* writer) const
  */
 void ConversationEntryText::setDelayMilliseconds(uint32_t delay_ms)
 {
+  markDirty();
   this->delay_ms = delay_ms;
 }
 
@@ -188,6 +215,7 @@ void ConversationEntryText::setDelayMilliseconds(uint32_t delay_ms)
  */
 void ConversationEntryText::setEvent(Event& event)
 {
+  markDirty();
   delete this->event;
   this->event = &event;
 }
@@ -198,6 +226,7 @@ void ConversationEntryText::setEvent(Event& event)
  */
 void ConversationEntryText::setMessage(std::string message)
 {
+  markDirty();
   this->message = message;
 }
 
@@ -208,6 +237,7 @@ void ConversationEntryText::setMessage(std::string message)
  */
 void ConversationEntryText::setThingId(int32_t thing_id)
 {
+  markDirty();
   this->thing_id = thing_id;
 }
 
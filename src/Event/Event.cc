@@ -0,0 +1,97 @@
+/**
+ * @class Event
+ *
+ * Event base abstract class. This parent centralizes the common event functionality shared
+ * by all implementations, including tracking if the event changed since it was last saved.
+ * Every implementation is allocated from the {@link EventPool}.
+ */
+#include "Event/Event.h"
+using namespace core;
+
+/*=============================================================================
+ * CONSTRUCTORS / DESTRUCTORS
+ *============================================================================*/
+
+/**
+ * Destructor function. Pure virtual to keep the class abstract but it still requires a body
+ * since every implementation destructor calls through to it.
+ */
+Event::~Event() {}
+
+/*=============================================================================
+ * PROTECTED FUNCTIONS
+ *============================================================================*/
+
+/**
+ * Marks the event data as changed since it was last saved. Every function that changes data
+ * which is saved calls this.
+ */
+void Event::markDirty()
+{
+  dirty = true;
+}
+
+/*=============================================================================
+ * PUBLIC FUNCTIONS
+ *============================================================================*/
+
+/**
+ * Marks the event as matching the saved data, once it's been fully loaded or saved.
+ * Implementations with nested events override this to clear them as well.
+ */
+void Event::clearDirty()
+{
+  dirty = false;
+}
+
+/**
+ * Returns the slot of the nested event held by the XML element, for loading into it. Events
+ * without nested events hold none, so this is only overridden by the composite events. If there
+ * is no slot, the line is loaded by this event at the element instead.
+ * @param element interned XML key name for the {@link index} in the tree
+ * @param data single packet of XML data
+ * @param index current index within the line, represents which XML element is currently being read
+ * @param options settings of the load
+ * @return slot of the nested event, which a load may replace. Null if the element holds none
+ */
+Event** Event::getNestedEvent(Atom, XmlDataView, int, const LoadOptions&)
+{
+  return nullptr;
+}
+
+/**
+ * Returns if the event changed since it was last saved. A new event is dirty until it's cleared.
+ * Implementations with nested events override this to check them as well, since a nested
+ * event can be changed through the reference returned by its getter.
+ * @return TRUE if the event needs to be saved again
+ */
+bool Event::isDirty() const
+{
+  return dirty;
+}
+
+/*=============================================================================
+ * OPERATOR FUNCTIONS
+ *============================================================================*/
+
+/**
+ * Allocates the memory of an event from the event pool, for every implementation. A new, such as
+ * the load of an event type or a clone(), is a slot from the free list of the calling thread.
+ * @param size size of the implementation in bytes
+ * @return memory for the event
+ */
+void* Event::operator new(std::size_t size)
+{
+  return EventPool::allocate(size);
+}
+
+/**
+ * Returns the memory of an event to the event pool. The event is deleted through the virtual
+ * destructor, so the size is of the implementation that was allocated.
+ * @param event memory of the event
+ * @param size size of the implementation in bytes
+ */
+void Event::operator delete(void* event, std::size_t size)
+{
+  EventPool::deallocate(event, size);
+}
@@ -2,7 +2,8 @@
  * @class EventBattleStart
  *
  * A battle start event definition for the configuration of the battle that will be set
- * up around the current player.
+ * up around the current player. When a load asks for lazy subtrees (see {@link LoadOptions}),
+ * the win and lose events are only built the first time they are accessed.
  */
 #include "Event/EventBattleStart.h"
 #include "Event/PersistEvent.h"
@@ -54,12 +55,16 @@ EventBattleStart::~EventBattleStart()
  */
 void EventBattleStart::cloneSource(const EventBattleStart& source)
 {
+  markDirty();
   delete event_lose;
   event_lose = source.event_lose->clone();
 
   delete event_win;
   event_win = source.event_win->clone();
 
+  pending = source.pending;
+  pending_options = source.pending_options;
+
   game_over_on_loss = source.game_over_on_loss;
   restore_health = source.restore_health;
   restore_qd = source.restore_qd;
@@ -67,26 +72,84 @@ void EventBattleStart::cloneSource(const EventBattleStart& source)
 }
 
 /**
- * Loads event data from the XML entry, specific to the event type (sub-class).
- * @param element XML key name for the {@link index} in the tree
+ * Loads event data from the XML entry, specific to the event type (sub-class). A win or lose
+ * event line only reaches here when the load asks for lazy subtrees, since getNestedEvent()
+ * otherwise hands the slot to the load, but it's handled either way.
+ * @param element interned XML key name for the {@link index} in the tree
  * @param data single packet of XML data
  * @param index current index within the line, represents which XML element is currently being read
+ * @param options settings of the load
  * @throws std::bad_cast if any correctly named element doesn't match the type expected
  */
-void EventBattleStart::loadForType(std::string element, XmlData data, int index)
+void EventBattleStart::loadForType(Atom element, XmlDataView data, int index,
+                                   const LoadOptions& options)
+{
+  switch(element) {
+    case Atom::EVENTLOSE:
+    case Atom::EVENTWIN:
+      if(options.lazy_subtrees)
+      {
+        pending_options = options;
+        pending.append(data, index);
+      }
+      else
+      {
+        // Any deferred lines are applied first, so the lines stay in the order they were read
+        loadPending();
+        loadNestedEvent(element, data, index, options);
+      }
+      break;
+    case Atom::LOSEGG:
+      setGameOverOnLoss(data.getDataBooleanOrThrow());
+      break;
+    case Atom::RESTOREHEALTH:
+      setHealthRestored(data.getDataBooleanOrThrow());
+      break;
+    case Atom::RESTOREQD:
+      setQdRestored(data.getDataBooleanOrThrow());
+      break;
+    case Atom::WINDISAPPEAR:
+      setTargetHiddenOnWin(data.getDataBooleanOrThrow());
+      break;
+    default:
+      break;
+  }
+}
+
+/**
+ * Loads a win or lose event data line into the nested event, replacing it if the type changed.
+ * @param element interned XML key name for the {@link index} in the tree
+ * @param data single packet of XML data
+ * @param index current index within the line, represents which XML element is currently being read
+ * @param options settings of the load
+ */
+void EventBattleStart::loadNestedEvent(Atom element, XmlDataView data, int index,
+                                       const LoadOptions& options) const
 {
-  if(element == kKEY_EVENT_LOSE)
-    event_lose = PersistEvent::load(event_lose, data, index + 1);
-  else if(element == kKEY_EVENT_WIN)
-    event_win = PersistEvent::load(event_win, data, index + 1);
-  else if(element == kKEY_GAME_OVER_ON_LOSS)
-    setGameOverOnLoss(data.getDataBooleanOrThrow());
-  else if(element == kKEY_RESTORE_HEALTH)
-    setHealthRestored(data.getDataBooleanOrThrow());
-  else if(element == kKEY_RESTORE_QD)
-    setQdRestored(data.getDataBooleanOrThrow());
-  else if(element == kKEY_TARGET_HIDE_ON_WIN)
-    setTargetHiddenOnWin(data.getDataBooleanOrThrow());
+  Event*& nested_event = (element == Atom::EVENTLOSE ? event_lose : event_win);
+  nested_event = PersistEvent::load(nested_event, data, index + 1, options);
+}
+
+/**
+ * Loads the deferred win and lose event data lines, in the order they were read and with the
+ * settings of the load that deferred them. Building the events doesn't change whether the
+ * battle needs to be saved, since they match the data they were loaded from.
+ */
+void EventBattleStart::loadPending() const
+{
+  if(pending.isEmpty())
+    return;
+
+  bool clean = !isDirty();
+  pending.replay([this](XmlDataView line)
+  {
+    loadNestedEvent(line.getElementAtom(0), line, 0, pending_options);
+  });
+  if(clean)
+  {
+    event_lose->clearDirty();
+    event_win->clearDirty();
+  }
 }
 
 /**
@@ -95,6 +158,7 @@ void EventBattleStart::loadForType(std::string element, XmlData data, int index)
  */
 void EventBattleStart::saveForType(XmlWriter* writer) const
 {
+  loadPending();
   if(event_lose->isSaveable())
   {
     writer->writeElement(kKEY_EVENT_LOSE);
@@ -122,6 +186,16 @@ void EventBattleStart::saveForType(XmlWriter* writer) const
  * PUBLIC FUNCTIONS
  *============================================================================*/
 
+/**
+ * Marks the event, and the battle lose and win events, as matching the saved data.
+ */
+void EventBattleStart::clearDirty()
+{
+  ExecutableEvent::clearDirty();
+  event_lose->clearDirty();
+  event_win->clearDirty();
+}
+
 /**
  * Deep clones the event to return a new memory space version of the same data.
  * @return newly created event
@@ -137,9 +211,39 @@ Event* EventBattleStart::clone() const
  */
 Event& EventBattleStart::getLoseEvent() const
 {
+  loadPending();
   return *event_lose;
 }
 
+/**
+ * Returns the slot of the nested event held by the XML element, for loading into it. Any win
+ * and lose event lines deferred by an earlier load are built first, so the slot holds the
+ * current event and the line lands after them. When the load asks for lazy subtrees, there is
+ * no slot, so the line is deferred by loadForType() instead.
+ * @param element interned XML key name for the {@link index} in the tree
+ * @param data single packet of XML data
+ * @param index current index within the line, represents which XML element is currently being read
+ * @param options settings of the load
+ * @return slot of the nested event, which a load may replace. Null if the element holds none
+ */
+Event** EventBattleStart::getNestedEvent(Atom element, XmlDataView, int,
+                                         const LoadOptions& options)
+{
+  if(options.lazy_subtrees)
+    return nullptr;
+
+  switch(element) {
+    case Atom::EVENTLOSE:
+      loadPending();
+      return &event_lose;
+    case Atom::EVENTWIN:
+      loadPending();
+      return &event_win;
+    default:
+      return nullptr;
+  }
+}
+
 /**
  * Returns {@link EventType#BATTLESTART} to define the type classification, overrides parent.
  * @return event type classification enum
@@ -155,9 +259,19 @@ EventType EventBattleStart::getType() const
  */
 Event& EventBattleStart::getWinEvent() const
 {
+  loadPending();
   return *event_win;
 }
 
+/**
+ * Returns if the event, or the battle lose or win event, changed since it was last saved.
+ * @return TRUE if the event needs to be saved again
+ */
+bool EventBattleStart::isDirty() const
+{
+  return (ExecutableEvent::isDirty() || event_lose->isDirty() || event_win->isDirty());
+}
+
 /**
  * Returns if on lose, the game should be over.
  * @return true to end game on loss, false to go back to the map
@@ -200,6 +314,7 @@ bool EventBattleStart::isTargetHiddenOnWin() const
  */
 void EventBattleStart::setGameOverOnLoss(bool game_over_on_loss)
 {
+  markDirty();
   this->game_over_on_loss = game_over_on_loss;
 }
 
@@ -209,6 +324,7 @@ void EventBattleStart::setGameOverOnLoss(bool game_over_on_loss)
  */
 void EventBattleStart::setHealthRestored(bool restore_health)
 {
+  markDirty();
   this->restore_health = restore_health;
 }
 
@@ -218,6 +334,8 @@ void EventBattleStart::setHealthRestored(bool restore_health)
  */
 void EventBattleStart::setLoseEvent(Event& event)
 {
+  loadPending();
+  markDirty();
   delete this->event_lose;
   this->event_lose = &event;
 }
@@ -228,6 +346,7 @@ void EventBattleStart::setLoseEvent(Event& event)
  */
 void EventBattleStart::setQdRestored(bool restore_qd)
 {
+  markDirty();
   this->restore_qd = restore_qd;
 }
 
@@ -237,6 +356,7 @@ void EventBattleStart::setQdRestored(bool restore_qd)
  */
 void EventBattleStart::setTargetHiddenOnWin(bool target_hide_on_win)
 {
+  markDirty();
   this->target_hide_on_win = target_hide_on_win;
 }
 
@@ -246,6 +366,8 @@ void EventBattleStart::setTargetHiddenOnWin(bool target_hide_on_win)
  */
 void EventBattleStart::setWinEvent(Event& event)
 {
+  loadPending();
+  markDirty();
   delete this->event_win;
   this->event_win = &event;
 }
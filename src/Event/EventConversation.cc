@@ -16,11 +16,12 @@ using namespace core;
  * Loads event data from the XML entry, specific to the event type (sub-class).
  * @param data single packet of XML data
  * @param index current index within the line, represents which XML element is currently being read
+ * @param options settings of the load
  * @throws std::bad_cast if any correctly named element doesn't match the type expected
  */
-void EventConversation::loadForType(std::string, XmlData data, int index)
+void EventConversation::loadForType(Atom, XmlDataView data, int index, const LoadOptions& options)
 {
-  conversation.load(data, index);
+  conversation.load(data, index, options);
 }
 
 /**
@@ -36,6 +37,15 @@ void EventConversation::saveForType(XmlWriter* writer) const
  * PUBLIC FUNCTIONS
  *============================================================================*/
 
+/**
+ * Marks the event, and the conversation, as matching the saved data.
+ */
+void EventConversation::clearDirty()
+{
+  ExecutableEvent::clearDirty();
+  conversation.clearDirty();
+}
+
 /**
  * Deep clones the event to return a new memory space version of the same data.
  * @return newly created event
@@ -63,11 +73,21 @@ EventType EventConversation::getType() const
   return EventType::CONVERSATION;
 }
 
+/**
+ * Returns if the event, or any entry in the conversation, changed since it was last saved.
+ * @return TRUE if the event needs to be saved again
+ */
+bool EventConversation::isDirty() const
+{
+  return (ExecutableEvent::isDirty() || conversation.isDirty());
+}
+
 /**
  * Sets the conversation data to display when triggered.
  * @param conversation definition to display and trigger in game
  */
 void EventConversation::setConversation(Conversation& conversation)
 {
+  markDirty();
   this->conversation = conversation;
 }
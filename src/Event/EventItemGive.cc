@@ -19,20 +19,28 @@ const std::string EventItemGive::kKEY_ITEM_COUNT = "count";
 
 /**
  * Loads event data from the XML entry, specific to the event type (sub-class).
- * @param element XML key name for the {@link index} in the tree
+ * @param element interned XML key name for the {@link index} in the tree
  * @param data single packet of XML data
  * @throws std::bad_cast if any correctly named element doesn't match the type expected
  */
-void EventItemGive::loadForType(std::string element, XmlData data, int)
+void EventItemGive::loadForType(Atom element, XmlDataView data, int, const LoadOptions&)
 {
-  if(element == kKEY_CHANCE)
-    setChance(data.getDataIntegerOrThrow());
-  else if(element == kKEY_DROP_IF_NO_ROOM)
-    setDropIfNoRoom(data.getDataBooleanOrThrow());
-  else if(element == kKEY_ITEM_ID)
-    setItemId(data.getDataIntegerOrThrow());
-  else if(element == kKEY_ITEM_COUNT)
-    setItemCount(data.getDataIntegerOrThrow());
+  switch(element) {
+    case Atom::CHANCE:
+      setChance(data.getDataIntegerOrThrow());
+      break;
+    case Atom::AUTODROP:
+      setDropIfNoRoom(data.getDataBooleanOrThrow());
+      break;
+    case Atom::ID:
+      setItemId(data.getDataIntegerOrThrow());
+      break;
+    case Atom::COUNT:
+      setItemCount(data.getDataIntegerOrThrow());
+      break;
+    default:
+      break;
+  }
 }
 
 /**
@@ -114,6 +122,7 @@ bool EventItemGive::isDropIfNoRoom() const
  */
 void EventItemGive::setChance(uint8_t chance)
 {
+  markDirty();
   if(chance > kMAX_CHANCE)
     this->chance = kMAX_CHANCE;
   else
@@ -126,6 +135,7 @@ void EventItemGive::setChance(uint8_t chance)
  */
 void EventItemGive::setDropIfNoRoom(bool drop_if_no_room)
 {
+  markDirty();
   this->drop_if_no_room = drop_if_no_room;
 }
 
@@ -135,6 +145,7 @@ void EventItemGive::setDropIfNoRoom(bool drop_if_no_room)
  */
 void EventItemGive::setItemCount(uint16_t item_count)
 {
+  markDirty();
   this->item_count = item_count;
 }
 
@@ -144,5 +155,6 @@ void EventItemGive::setItemCount(uint16_t item_count)
  */
 void EventItemGive::setItemId(int32_t item_id)
 {
+  markDirty();
   this->item_id = item_id;
 }
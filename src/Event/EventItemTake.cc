@@ -17,16 +17,22 @@ const std::string EventItemTake::kKEY_ITEM_COUNT = "count";
 
 /**
  * Loads event data from the XML entry, specific to the event type (sub-class).
- * @param element XML key name for the {@link index} in the tree
+ * @param element interned XML key name for the {@link index} in the tree
  * @param data single packet of XML data
  * @throws std::bad_cast if any correctly named element doesn't match the type expected
  */
-void EventItemTake::loadForType(std::string element, XmlData data, int)
+void EventItemTake::loadForType(Atom element, XmlDataView data, int, const LoadOptions&)
 {
-  if(element == kKEY_ITEM_ID)
-    setItemId(data.getDataIntegerOrThrow());
-  else if(element == kKEY_ITEM_COUNT)
-    setItemCount(data.getDataIntegerOrThrow());
+  switch(element) {
+    case Atom::ID:
+      setItemId(data.getDataIntegerOrThrow());
+      break;
+    case Atom::COUNT:
+      setItemCount(data.getDataIntegerOrThrow());
+      break;
+    default:
+      break;
+  }
 }
 
 /**
@@ -85,6 +91,7 @@ EventType EventItemTake::getType() const
  */
 void EventItemTake::setItemCount(uint16_t item_count)
 {
+  markDirty();
   this->item_count = item_count;
 }
 
@@ -94,5 +101,6 @@ void EventItemTake::setItemCount(uint16_t item_count)
  */
 void EventItemTake::setItemId(int32_t item_id)
 {
+  markDirty();
   this->item_id = item_id;
 }
@@ -16,13 +16,13 @@ const std::string EventMapSwitch::kKEY_MAP_ID = "id";
 
 /**
  * Loads event data from the XML entry, specific to the event type (sub-class).
- * @param element XML key name for the {@link index} in the tree
+ * @param element interned XML key name for the {@link index} in the tree
  * @param data single packet of XML data
  * @throws std::bad_cast if any correctly named element doesn't match the type expected
  */
-void EventMapSwitch::loadForType(std::string element, XmlData data, int)
+void EventMapSwitch::loadForType(Atom element, XmlDataView data, int, const LoadOptions&)
 {
-  if(element == kKEY_MAP_ID)
+  if(element == Atom::ID)
     setMapId(data.getDataIntegerOrThrow());
 }
 
@@ -73,5 +73,6 @@ EventType EventMapSwitch::getType() const
  */
 void EventMapSwitch::setMapId(uint16_t map_id)
 {
+  markDirty();
   this->map_id = map_id;
 }
@@ -12,7 +12,7 @@ using namespace core;
 const std::string EventMultiple::kKEY_EVENT = "event";
 const std::string EventMultiple::kKEY_EVENT_ID = "id";
 
-const std::regex EventMultiple::kPOSITIVE_INTEGER_FORMAT("^\\d+$");
+const std::string_view EventMultiple::kPOSITIVE_INTEGER_CHARS = "0123456789";
 
 /*=============================================================================
  * CONSTRUCTORS / DESTRUCTORS
@@ -51,6 +51,7 @@ EventMultiple::~EventMultiple()
  */
 void EventMultiple::cloneSource(const EventMultiple& source)
 {
+  markDirty();
   deleteEvents();
   for (auto event : source.events)
     events.push_back(event->clone());
@@ -69,30 +70,18 @@ void EventMultiple::deleteEvents()
 
 /**
  * Loads event data from the XML entry, specific to the event type (sub-class).
- * @param element XML key name for the {@link index} in the tree
+ * @param element interned XML key name for the {@link index} in the tree
  * @param data single packet of XML data
  * @param index current index within the line, represents which XML element is currently being read
+ * @param options settings of the load
  * @throws std::bad_cast if any correctly named element doesn't match the type expected
  */
-void EventMultiple::loadForType(std::string element, XmlData data, int index)
+void EventMultiple::loadForType(Atom element, XmlDataView data, int index,
+                                const LoadOptions& options)
 {
-  if(element == kKEY_EVENT)
-  {
-    std::string key = data.getKey(index);
-    std::string key_value = data.getKeyValue(index);
-    if(key == kKEY_EVENT_ID && std::regex_match(key_value, kPOSITIVE_INTEGER_FORMAT))
-    {
-      uint8_t event_index = std::stoi(key_value);
-
-      if(event_index >= getEventCount())
-      {
-        Event* empty_event = new EventNone();;
-        setEvent(event_index, *empty_event);
-      }
-
-      events[event_index] = PersistEvent::load(events.at(event_index), data, index + 1);
-    }
-  }
+  Event** nested_event = getNestedEvent(element, data, index, options);
+  if(nested_event != nullptr)
+    *nested_event = PersistEvent::load(*nested_event, data, index + 1, options);
 }
 
 /**
@@ -117,6 +106,16 @@ void EventMultiple::saveForType(XmlWriter* writer) const
  * PUBLIC FUNCTIONS
  *============================================================================*/
 
+/**
+ * Marks the event, and every event in the multiple stack, as matching the saved data.
+ */
+void EventMultiple::clearDirty()
+{
+  ExecutableEvent::clearDirty();
+  for(Event* event : events)
+    event->clearDirty();
+}
+
 /**
  * Deep clones the event to return a new memory space version of the same data.
  * @return newly created event
@@ -148,6 +147,40 @@ uint8_t EventMultiple::getEventCount()
   return events.size();
 }
 
+/**
+ * Returns the slot of the nested event held by the XML element, for loading into it. An event
+ * element with an index past the end of the stack grows it with empty events first.
+ * @param element interned XML key name for the {@link index} in the tree
+ * @param data single packet of XML data
+ * @param index current index within the line, represents which XML element is currently being read
+ * @param options settings of the load
+ * @return slot of the nested event, which a load may replace. Null if the element holds none
+ */
+Event** EventMultiple::getNestedEvent(Atom element, XmlDataView data, int index,
+                                      const LoadOptions&)
+{
+  if(element == Atom::EVENT)
+  {
+    std::string_view key_value = data.getKeyValue(index);
+    int key_index;
+    if(data.getKeyAtom(index) == Atom::ID && !key_value.empty() &&
+       key_value.find_first_not_of(kPOSITIVE_INTEGER_CHARS) == std::string_view::npos &&
+       TextEncoding::readInteger(key_value, key_index))
+    {
+      uint8_t event_index = key_index;
+
+      if(event_index >= getEventCount())
+      {
+        Event* empty_event = new EventNone();;
+        setEvent(event_index, *empty_event);
+      }
+
+      return &events.at(event_index);
+    }
+  }
+  return nullptr;
+}
+
 /**
  * Returns {@link EventType#MULTIPLE} to define the type classification, overrides parent.
  * @return event type classification enum
@@ -157,6 +190,20 @@ EventType EventMultiple::getType() const
  return EventType::MULTIPLE;
 }
 
+/**
+ * Returns if the event, or any event in the multiple stack, changed since it was last saved.
+ * @return TRUE if the event needs to be saved again
+ */
+bool EventMultiple::isDirty() const
+{
+  if(ExecutableEvent::isDirty())
+    return true;
+  for(Event* event : events)
+    if(event->isDirty())
+      return true;
+  return false;
+}
+
 /**
  * Sets the event in the multiple stack at the index location.
  * @param index ordered list location
@@ -164,6 +211,7 @@ EventType EventMultiple::getType() const
  */
 void EventMultiple::setEvent(uint8_t index, Event& event)
 {
+  markDirty();
   while(events.size() <= index)
     events.push_back(new EventNone());
 
@@ -40,7 +40,7 @@ bool EventNone::isSaveable() const
 /**
  * Loads event data from the XML entry. In this implementation, it is no-op.
  */
-void EventNone::load(XmlData, int)
+void EventNone::load(XmlDataView, int, const LoadOptions&)
 {
 }
 
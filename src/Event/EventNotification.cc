@@ -16,17 +16,17 @@ const std::string EventNotification::kKEY_TEXT = "text";
 
 /**
  * Loads event data from the XML entry, specific to the event type (sub-class).
- * @param element XML key name for the {@link index} in the tree
+ * @param element interned XML key name for the {@link index} in the tree
  * @param data single packet of XML data
  * @param index current index within the line, represents which XML element is currently being read
  * @throws std::bad_cast if any correctly named element doesn't match the type expected
  */
-void EventNotification::loadForType(std::string element, XmlData data, int index)
+void EventNotification::loadForType(Atom element, XmlDataView data, int index, const LoadOptions&)
 {
   // The (index == data.getNumElements()) represents the case where the string is defined
   // immediately inside the notification event XML wrapper. It is legacy support.
-  if(element == kKEY_TEXT || index == data.getNumElements())
-    setNotification(data.getDataStringOrThrow());
+  if(element == Atom::TEXT || index == data.getNumElements())
+    setNotification(std::string(data.getDataStringOrThrow()));
 }
 
 /**
@@ -75,5 +75,6 @@ EventType EventNotification::getType() const
  */
 void EventNotification::setNotification(std::string notification)
 {
+  markDirty();
   this->notification = notification;
 }
@@ -0,0 +1,262 @@
+/**
+ * @class EventPool
+ *
+ * Pooled memory for every event object (see Event::operator new). Events are small and are made
+ * and dropped in bursts (a placeholder replaced by the loaded type, a snapshot clone for a save),
+ * so instead of a heap allocation each, they are carved from chunks of same sized slots, one
+ * size class per 16 bytes. Each thread keeps its own free list of each class, so a new or delete
+ * is a pointer swap without a lock, and the events made together by a load sit next to each
+ * other in the chunks.
+ *
+ * Free slots move between threads through a shared list, under a lock, a chunk's worth at a
+ * time: a thread takes from it before making a new chunk, and gives to it once it holds more
+ * than a few chunks of free slots, such as the saver thread deleting the clones made on the main
+ * thread. A thread gives all of its slots back when it finishes. Chunks are reused, so the pool
+ * only grows to the most events alive at once, until trim() frees the chunks that are entirely
+ * free again, such as once a map is unloaded and its events are dropped.
+ */
+#include "Event/EventPool.h"
+using namespace core;
+
+/* Static Implementation - see header file for descriptions */
+std::array<std::vector<char*>, EventPool::kCLASS_COUNT> EventPool::chunks;
+EventPool::FreeLists EventPool::shared_lists{};
+std::mutex EventPool::shared_lock;
+std::atomic<size_t> EventPool::reserved_bytes{0};
+
+/*============================================================================
+ * CONSTRUCTORS / DESTRUCTORS
+ *===========================================================================*/
+
+/**
+ * Destructor function, runs as the thread finishes. Every free slot of the thread is given to
+ * the shared lists, and any delete after this, by a later thread local destructor, goes
+ * straight to them as well.
+ */
+EventPool::ThreadRelease::~ThreadRelease()
+{
+  ThreadLists& thread = getThreadLists();
+  std::lock_guard<std::mutex> guard(shared_lock);
+  for(size_t i = 0; i < kCLASS_COUNT; i++)
+    moveSlots(thread.lists, shared_lists, i, thread.lists.counts[i]);
+  thread.released = true;
+}
+
+/*============================================================================
+ * PRIVATE STATIC FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Returns the free lists of the calling thread. The first call on a thread also sets up the
+ * release of its slots when it finishes.
+ * @return free lists only used by the calling thread
+ */
+EventPool::ThreadLists& EventPool::getThreadLists()
+{
+  thread_local ThreadLists thread{};
+  thread_local ThreadRelease release;
+  return thread;
+}
+
+/**
+ * Moves up to the count of free slots of the size class from one list to the other. If either
+ * is the shared list, the lock must be held.
+ * @param from list to take the free slots from
+ * @param to list to give the free slots to
+ * @param size_class index of the size class
+ * @param count maximum number of free slots to move
+ */
+void EventPool::moveSlots(FreeLists& from, FreeLists& to, size_t size_class, size_t count)
+{
+  for(size_t i = 0; i < count && from.heads[size_class] != nullptr; i++)
+  {
+    FreeSlot* slot = from.heads[size_class];
+    from.heads[size_class] = slot->next;
+    from.counts[size_class]--;
+
+    slot->next = to.heads[size_class];
+    to.heads[size_class] = slot;
+    to.counts[size_class]++;
+  }
+}
+
+/**
+ * Fills the empty list of the size class. A thread list takes a chunk's worth of free slots from
+ * the shared list first, and otherwise a new chunk is made. The slots of a new chunk are listed
+ * in address order, so the events made next are laid out one after the other.
+ * @param lists the lists to fill. If it's the shared list, the lock must be held
+ * @param size_class index of the size class
+ */
+void EventPool::refill(FreeLists& lists, size_t size_class)
+{
+  std::unique_lock<std::mutex> guard(shared_lock, std::defer_lock);
+  if(&lists != &shared_lists)
+  {
+    guard.lock();
+    moveSlots(shared_lists, lists, size_class, kSLOTS_PER_CHUNK);
+  }
+  if(lists.heads[size_class] != nullptr)
+    return;
+
+  // The lock is held from here either way, to record the chunk for trim()
+  size_t slot_size = (size_class + 1) * kALIGNMENT;
+  char* chunk = static_cast<char*>(::operator new(slot_size * kSLOTS_PER_CHUNK));
+  chunks[size_class].push_back(chunk);
+  reserved_bytes.fetch_add(slot_size * kSLOTS_PER_CHUNK, std::memory_order_relaxed);
+  for(size_t i = kSLOTS_PER_CHUNK; i > 0; i--)
+  {
+    FreeSlot* slot = reinterpret_cast<FreeSlot*>(chunk + (i - 1) * slot_size);
+    slot->next = lists.heads[size_class];
+    lists.heads[size_class] = slot;
+  }
+  lists.counts[size_class] += kSLOTS_PER_CHUNK;
+}
+
+/*============================================================================
+ * PUBLIC STATIC FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Allocates memory for an object of the size, from the free list of its size class on the
+ * calling thread. Objects larger than the biggest class are allocated from the heap.
+ * @param size size of the object in bytes
+ * @return memory aligned to the size class step
+ * @throws std::bad_alloc if a new chunk can't be allocated
+ */
+void* EventPool::allocate(size_t size)
+{
+  if(size > kMAX_SIZE)
+    return ::operator new(size);
+  size_t size_class = (size == 0 ? 0 : (size - 1) / kALIGNMENT);
+
+  // Once the thread has released its lists, only the shared lists are used
+  ThreadLists& thread = getThreadLists();
+  std::unique_lock<std::mutex> guard(shared_lock, std::defer_lock);
+  FreeLists& lists = (thread.released ? shared_lists : thread.lists);
+  if(thread.released)
+    guard.lock();
+
+  if(lists.heads[size_class] == nullptr)
+    refill(lists, size_class);
+  FreeSlot* slot = lists.heads[size_class];
+  lists.heads[size_class] = slot->next;
+  lists.counts[size_class]--;
+  return slot;
+}
+
+/**
+ * Frees the memory of an object of the size onto the free list of its size class on the calling
+ * thread. If the thread then holds too many free slots of the class, half of them are given to
+ * the shared list, for the other threads.
+ * @param memory memory of the object, allocated by the pool with the same size. May be null
+ * @param size size of the object in bytes
+ */
+void EventPool::deallocate(void* memory, size_t size)
+{
+  if(memory == nullptr)
+    return;
+  if(size > kMAX_SIZE)
+  {
+    ::operator delete(memory);
+    return;
+  }
+  size_t size_class = (size == 0 ? 0 : (size - 1) / kALIGNMENT);
+
+  // Once the thread has released its lists, only the shared lists are used
+  ThreadLists& thread = getThreadLists();
+  std::unique_lock<std::mutex> guard(shared_lock, std::defer_lock);
+  FreeLists& lists = (thread.released ? shared_lists : thread.lists);
+  if(thread.released)
+    guard.lock();
+
+  FreeSlot* slot = static_cast<FreeSlot*>(memory);
+  slot->next = lists.heads[size_class];
+  lists.heads[size_class] = slot;
+  lists.counts[size_class]++;
+
+  if(!thread.released && lists.counts[size_class] > kMAX_THREAD_SLOTS)
+  {
+    guard.lock();
+    moveSlots(lists, shared_lists, size_class, kMAX_THREAD_SLOTS / 2);
+  }
+}
+
+/**
+ * Returns the total bytes of the chunks that the pool holds, on any thread. Chunks are only freed
+ * by trim(), so until then this is the most memory the events have needed at once, rounded up to
+ * the chunks.
+ * @return reserved bytes
+ */
+size_t EventPool::getReservedBytes()
+{
+  return reserved_bytes.load(std::memory_order_relaxed);
+}
+
+/**
+ * Frees every chunk whose slots are all free, back to the heap. The free slots of the calling
+ * thread are given to the shared lists first, so the slots freed on any thread that has finished
+ * or on the calling thread are all counted. Each thread still running keeps the few free slots it
+ * holds, along with their chunks. The free slots left are listed in address order again. Meant
+ * for when many events were dropped at once, such as once a map is unloaded.
+ * @return bytes of the chunks that were freed
+ */
+size_t EventPool::trim()
+{
+  ThreadLists& thread = getThreadLists();
+  std::lock_guard<std::mutex> guard(shared_lock);
+  if(!thread.released)
+    for(size_t i = 0; i < kCLASS_COUNT; i++)
+      moveSlots(thread.lists, shared_lists, i, thread.lists.counts[i]);
+
+  size_t freed_bytes = 0;
+  std::vector<FreeSlot*> slots;
+  for(size_t size_class = 0; size_class < kCLASS_COUNT; size_class++)
+  {
+    size_t slot_size = (size_class + 1) * kALIGNMENT;
+    size_t chunk_size = slot_size * kSLOTS_PER_CHUNK;
+    std::vector<char*>& class_chunks = chunks[size_class];
+
+    slots.clear();
+    for(FreeSlot* slot = shared_lists.heads[size_class]; slot != nullptr; slot = slot->next)
+      slots.push_back(slot);
+    std::sort(slots.begin(), slots.end());
+    std::sort(class_chunks.begin(), class_chunks.end());
+
+    // Walk the chunks and the free slots together, both in address order
+    size_t kept_chunks = 0;
+    size_t kept_slots = 0;
+    size_t next_slot = 0;
+    for(char* chunk : class_chunks)
+    {
+      size_t first_slot = next_slot;
+      char* chunk_end = chunk + chunk_size;
+      while(next_slot < slots.size() && reinterpret_cast<char*>(slots[next_slot]) < chunk_end)
+        next_slot++;
+
+      if(next_slot - first_slot == kSLOTS_PER_CHUNK)
+      {
+        ::operator delete(chunk);
+        freed_bytes += chunk_size;
+      }
+      else
+      {
+        class_chunks[kept_chunks++] = chunk;
+        for(size_t i = first_slot; i < next_slot; i++)
+          slots[kept_slots++] = slots[i];
+      }
+    }
+    class_chunks.resize(kept_chunks);
+
+    // Relist the slots that are left, so the events made next are laid out in order
+    shared_lists.heads[size_class] = nullptr;
+    for(size_t i = kept_slots; i > 0; i--)
+    {
+      slots[i - 1]->next = shared_lists.heads[size_class];
+      shared_lists.heads[size_class] = slots[i - 1];
+    }
+    shared_lists.counts[size_class] = kept_slots;
+  }
+
+  reserved_bytes.fetch_sub(freed_bytes, std::memory_order_relaxed);
+  return freed_bytes;
+}
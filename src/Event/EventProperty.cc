@@ -21,27 +21,6 @@ const std::string EventProperty::kKEY_THING_ID = "id";
 const std::string EventProperty::kKEY_THING_RESPAWN = "respawn";
 const std::string EventProperty::kKEY_THING_RESPAWN_DISABLED = "respawn_disable";
 const std::string EventProperty::kKEY_THING_VISIBLE = "visible";
-const std::string EventProperty::kKEY_TRACKING_AVOID = "avoidplayer";
-const std::string EventProperty::kKEY_TRACKING_CHASE = "toplayer";
-const std::string EventProperty::kKEY_TRACKING_NONE = "notrack";
-
-/**
- * Tracking enumerator from string key static map.
- */
-const std::unordered_map<std::string, Tracking> EventProperty::kTRACKING_FROM_STRING = {
-  { kKEY_TRACKING_NONE,  Tracking::NONE  },
-  { kKEY_TRACKING_AVOID, Tracking::AVOID },
-  { kKEY_TRACKING_CHASE, Tracking::CHASE }
-};
-
-/**
- * Tracking enumerator to string key static map.
- */
-const std::unordered_map<Tracking, std::string> EventProperty::kTRACKING_TO_STRING = {
-  { Tracking::NONE,  kKEY_TRACKING_NONE  },
-  { Tracking::AVOID, kKEY_TRACKING_AVOID },
-  { Tracking::CHASE, kKEY_TRACKING_CHASE }
-};
 
 /*=============================================================================
  * PRIVATE FUNCTIONS
@@ -49,51 +28,61 @@ const std::unordered_map<Tracking, std::string> EventProperty::kTRACKING_TO_STRI
 
 /**
  * Loads event data from the XML entry, specific to the event type (sub-class).
- * @param element XML key name for the {@link index} in the tree
+ * @param element interned XML key name for the {@link index} in the tree
  * @param data single packet of XML data
  * @throws std::bad_cast if any correctly named element doesn't match the type expected
  */
-void EventProperty::loadForType(std::string element, XmlData data, int)
-{
-  if(element == kKEY_IO_INACTIVE)
-    setIOStateInactiveMillis(data.getDataIntegerOrThrow());
-  else if(element == kKEY_IO_INACTIVE_DISABLED)
-  {
-    if(data.getDataBooleanOrThrow())
-      setIOStateInactiveDisabled();
-  }
-  else if(element == kKEY_NPC_INTERACTION_FORCED)
-    setNPCInteractionForced(data.getDataBooleanOrThrow());
-  else if(element == kKEY_NPC_TRACKING)
-  {
-    auto found_tracking_pair = kTRACKING_FROM_STRING.find(data.getDataStringOrThrow());
-    if(found_tracking_pair == kTRACKING_FROM_STRING.end())
-      throw std::domain_error("Tracking mapping for load property event is not defined");
-
-    setNPCTracking(found_tracking_pair->second);
-  }
-  else if(element == kKEY_PERSON_LOCATION_RESET)
-  {
-    if(data.getDataBooleanOrThrow())
-      setPersonLocationReset();
-  }
-  else if(element == kKEY_PERSON_MOVEMENT_DISABLED)
-    setPersonMovementDisabled(data.getDataBooleanOrThrow());
-  else if(element == kKEY_PERSON_SPEED)
-    setPersonSpeed(data.getDataIntegerOrThrow());
-  else if(element == kKEY_THING_ACTIVE)
-    setThingActive(data.getDataBooleanOrThrow());
-  else if(element == kKEY_THING_ID)
-    setThingId(data.getDataIntegerOrThrow());
-  else if(element == kKEY_THING_RESPAWN)
-    setThingRespawnMillis(data.getDataIntegerOrThrow());
-  else if(element == kKEY_THING_RESPAWN_DISABLED)
-  {
-    if(data.getDataBooleanOrThrow())
-      setThingRespawnDisabled();
+void EventProperty::loadForType(Atom element, XmlDataView data, int, const LoadOptions&)
+{
+  switch(element) {
+    case Atom::INACTIVE:
+      setIOStateInactiveMillis(data.getDataIntegerOrThrow());
+      break;
+    case Atom::INACTIVE_DISABLE:
+      if(data.getDataBooleanOrThrow())
+        setIOStateInactiveDisabled();
+      break;
+    case Atom::FORCEINTERACT:
+      setNPCInteractionForced(data.getDataBooleanOrThrow());
+      break;
+    case Atom::TRACKING:
+    {
+      Tracking tracking;
+      if(!kTRACKING_REGISTRY.find(data.getDataStringOrThrow(), tracking))
+        throw std::domain_error("Tracking mapping for load property event is not defined");
+
+      setNPCTracking(tracking);
+      break;
+    }
+    case Atom::RESETLOCATION:
+      if(data.getDataBooleanOrThrow())
+        setPersonLocationReset();
+      break;
+    case Atom::MOVEDISABLE:
+      setPersonMovementDisabled(data.getDataBooleanOrThrow());
+      break;
+    case Atom::SPEED:
+      setPersonSpeed(data.getDataIntegerOrThrow());
+      break;
+    case Atom::ACTIVE:
+      setThingActive(data.getDataBooleanOrThrow());
+      break;
+    case Atom::ID:
+      setThingId(data.getDataIntegerOrThrow());
+      break;
+    case Atom::RESPAWN:
+      setThingRespawnMillis(data.getDataIntegerOrThrow());
+      break;
+    case Atom::RESPAWN_DISABLE:
+      if(data.getDataBooleanOrThrow())
+        setThingRespawnDisabled();
+      break;
+    case Atom::VISIBLE:
+      setThingVisible(data.getDataBooleanOrThrow());
+      break;
+    default:
+      break;
   }
-  else if(element == kKEY_THING_VISIBLE)
-    setThingVisible(data.getDataBooleanOrThrow());
 }
 
 /**
@@ -130,11 +119,11 @@ void EventProperty::saveForType(XmlWriter* writer) const
     writer->writeData(kKEY_NPC_INTERACTION_FORCED, isNPCInteractionForced());
   if(isNPCTrackingSet())
   {
-    auto found_tracking_pair = kTRACKING_TO_STRING.find(getNPCTracking());
-    if(found_tracking_pair == kTRACKING_TO_STRING.end())
+    std::string_view tracking_name = kTRACKING_REGISTRY.getName(getNPCTracking());
+    if(tracking_name.empty())
       throw std::domain_error("Tracking mapping for save property event is not defined");
 
-    writer->writeData(kKEY_NPC_TRACKING, found_tracking_pair->second);
+    writer->writeData(kKEY_NPC_TRACKING, std::string(tracking_name));
   }
 
   // IO Data
@@ -368,6 +357,7 @@ bool EventProperty::isThingVisibleSet() const
  */
 void EventProperty::resetIOStateInactive()
 {
+  markDirty();
   io_state_inactive_set = false;
 }
 
@@ -376,6 +366,7 @@ void EventProperty::resetIOStateInactive()
  */
 void EventProperty::resetNPCInteractionForced()
 {
+  markDirty();
   npc_interaction_forced_set = false;
 }
 
@@ -384,6 +375,7 @@ void EventProperty::resetNPCInteractionForced()
  */
 void EventProperty::resetNPCTracking()
 {
+  markDirty();
   npc_tracking_set = false;
 }
 
@@ -392,6 +384,7 @@ void EventProperty::resetNPCTracking()
  */
 void EventProperty::resetPersonLocationReset()
 {
+  markDirty();
   person_location_reset = false;
 }
 
@@ -400,6 +393,7 @@ void EventProperty::resetPersonLocationReset()
  */
 void EventProperty::resetPersonMovementDisabled()
 {
+  markDirty();
   person_movement_disabled_set = false;
 }
 
@@ -408,6 +402,7 @@ void EventProperty::resetPersonMovementDisabled()
  */
 void EventProperty::resetPersonSpeed()
 {
+  markDirty();
   person_speed_set = false;
 }
 
@@ -416,6 +411,7 @@ void EventProperty::resetPersonSpeed()
  */
 void EventProperty::resetThingActive()
 {
+  markDirty();
   thing_active_set = false;
 }
 
@@ -424,6 +420,7 @@ void EventProperty::resetThingActive()
  */
 void EventProperty::resetThingRespawn()
 {
+  markDirty();
   thing_respawn_set = false;
 }
 
@@ -432,6 +429,7 @@ void EventProperty::resetThingRespawn()
  */
 void EventProperty::resetThingVisible()
 {
+  markDirty();
   thing_visible_set = false;
 }
 
@@ -441,6 +439,7 @@ void EventProperty::resetThingVisible()
  */
 void EventProperty::setIOStateInactiveDisabled()
 {
+  markDirty();
   io_state_inactive_disabled = true;
   io_state_inactive_set = true;
 }
@@ -451,6 +450,7 @@ void EventProperty::setIOStateInactiveDisabled()
  */
 void EventProperty::setIOStateInactiveMillis(uint32_t state_inactive_ms)
 {
+  markDirty();
   io_state_inactive_disabled = false;
   io_state_inactive_ms = state_inactive_ms;
   io_state_inactive_set = true;
@@ -462,6 +462,7 @@ void EventProperty::setIOStateInactiveMillis(uint32_t state_inactive_ms)
  */
 void EventProperty::setNPCInteractionForced(bool interaction_forced)
 {
+  markDirty();
   npc_interaction_forced = interaction_forced;
   npc_interaction_forced_set = true;
 }
@@ -472,6 +473,7 @@ void EventProperty::setNPCInteractionForced(bool interaction_forced)
  */
 void EventProperty::setNPCTracking(Tracking tracking)
 {
+  markDirty();
   npc_tracking = tracking;
   npc_tracking_set = true;
 }
@@ -481,6 +483,7 @@ void EventProperty::setNPCTracking(Tracking tracking)
  */
 void EventProperty::setPersonLocationReset()
 {
+  markDirty();
   person_location_reset = true;
 }
 
@@ -491,6 +494,7 @@ void EventProperty::setPersonLocationReset()
  */
 void EventProperty::setPersonMovementDisabled(bool movement_disabled)
 {
+  markDirty();
   person_movement_disabled = movement_disabled;
   person_movement_disabled_set = true;
 }
@@ -501,6 +505,7 @@ void EventProperty::setPersonMovementDisabled(bool movement_disabled)
  */
 void EventProperty::setPersonSpeed(uint16_t speed)
 {
+  markDirty();
   person_speed = speed;
   person_speed_set = true;
 }
@@ -512,6 +517,7 @@ void EventProperty::setPersonSpeed(uint16_t speed)
  */
 void EventProperty::setThingActive(bool active)
 {
+  markDirty();
   thing_active = active;
   thing_active_set = true;
 }
@@ -522,6 +528,7 @@ void EventProperty::setThingActive(bool active)
  */
 void EventProperty::setThingId(int32_t thing_id)
 {
+  markDirty();
   this->thing_id = thing_id;
 }
 
@@ -531,6 +538,7 @@ void EventProperty::setThingId(int32_t thing_id)
  */
 void EventProperty::setThingRespawnDisabled()
 {
+  markDirty();
   thing_respawn_disabled = true;
   thing_respawn_set = true;
 }
@@ -541,6 +549,7 @@ void EventProperty::setThingRespawnDisabled()
  */
 void EventProperty::setThingRespawnMillis(uint32_t respawn_ms)
 {
+  markDirty();
   thing_respawn_disabled = false;
   thing_respawn_ms = respawn_ms;
   thing_respawn_set = true;
@@ -553,6 +562,7 @@ void EventProperty::setThingRespawnMillis(uint32_t respawn_ms)
  */
 void EventProperty::setThingVisible(bool visible)
 {
+  markDirty();
   thing_visible = visible;
   thing_visible_set = true;
 }
@@ -16,7 +16,7 @@ using namespace core;
  * @param index current index within the line, represents which XML element is currently being read
  * @throws std::bad_cast if any correctly named element doesn't match the type expected
  */
-void EventSound::loadForType(std::string, XmlData data, int index)
+void EventSound::loadForType(Atom, XmlDataView data, int index, const LoadOptions&)
 {
   // The (index == data.getNumElements()) represents the case where the sound is defined
   // immediately inside the sound event XML wrapper. It is legacy support.
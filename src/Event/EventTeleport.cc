@@ -19,20 +19,28 @@ const std::string EventTeleport::kKEY_TILE_VERTICAL = "y";
 
 /**
  * Loads event data from the XML entry, specific to the event type (sub-class).
- * @param element XML key name for the {@link index} in the tree
+ * @param element interned XML key name for the {@link index} in the tree
  * @param data single packet of XML data
  * @throws std::bad_cast if any correctly named element doesn't match the type expected
  */
-void EventTeleport::loadForType(std::string element, XmlData data, int)
+void EventTeleport::loadForType(Atom element, XmlDataView data, int, const LoadOptions&)
 {
-  if(element == kKEY_SECTION_ID)
-    setSectionId(data.getDataIntegerOrThrow());
-  else if(element == kKEY_THING_ID)
-    setThingId(data.getDataIntegerOrThrow());
-  else if(element == kKEY_TILE_HORIZONTAL)
-    setTileHorizontal(data.getDataIntegerOrThrow());
-  else if(element == kKEY_TILE_VERTICAL)
-    setTileVertical(data.getDataIntegerOrThrow());
+  switch(element) {
+    case Atom::SECTION:
+      setSectionId(data.getDataIntegerOrThrow());
+      break;
+    case Atom::ID:
+      setThingId(data.getDataIntegerOrThrow());
+      break;
+    case Atom::X:
+      setTileHorizontal(data.getDataIntegerOrThrow());
+      break;
+    case Atom::Y:
+      setTileVertical(data.getDataIntegerOrThrow());
+      break;
+    default:
+      break;
+  }
 }
 
 /**
@@ -114,6 +122,7 @@ EventType EventTeleport::getType() const
  */
 void EventTeleport::setSectionId(int16_t section_id)
 {
+  markDirty();
   this->section_id = section_id;
 }
 
@@ -123,6 +132,7 @@ void EventTeleport::setSectionId(int16_t section_id)
  */
 void EventTeleport::setThingId(uint32_t thing_id)
 {
+  markDirty();
   this->thing_id = thing_id;
 }
 
@@ -132,6 +142,7 @@ void EventTeleport::setThingId(uint32_t thing_id)
  */
 void EventTeleport::setTileHorizontal(uint16_t tile_horizontal)
 {
+  markDirty();
   this->tile_horizontal = tile_horizontal;
 }
 
@@ -141,5 +152,6 @@ void EventTeleport::setTileHorizontal(uint16_t tile_horizontal)
  */
 void EventTeleport::setTileVertical(uint16_t tile_vertical)
 {
+  markDirty();
   this->tile_vertical = tile_vertical;
 }
@@ -16,13 +16,13 @@ const std::string EventTriggerIO::kKEY_IO_ID = "id";
 
 /**
  * Loads event data from the XML entry, specific to the event type (sub-class).
- * @param element XML key name for the {@link index} in the tree
+ * @param element interned XML key name for the {@link index} in the tree
  * @param data single packet of XML data
  * @throws std::bad_cast if any correctly named element doesn't match the type expected
  */
-void EventTriggerIO::loadForType(std::string element, XmlData data, int)
+void EventTriggerIO::loadForType(Atom element, XmlDataView data, int, const LoadOptions&)
 {
-  if(element == kKEY_IO_ID)
+  if(element == Atom::ID)
     setInteractiveObjectId(data.getDataIntegerOrThrow());
 }
 
@@ -72,5 +72,6 @@ EventType EventTriggerIO::getType() const
  */
 void EventTriggerIO::setInteractiveObjectId(int32_t io_id)
 {
+  markDirty();
   this->io_id = io_id;
 }
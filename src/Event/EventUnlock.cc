@@ -18,21 +18,28 @@ const std::string EventUnlock::kKEY_VIEW_TIME = "viewtime";
 
 /**
  * Loads event data from the XML entry, specific to the event type (sub-class).
- * @param element XML key name for the {@link index} in the tree
+ * @param element interned XML key name for the {@link index} in the tree
  * @param data single packet of XML data
  * @param index current index within the line, represents which XML element is currently being read
  * @throws std::bad_cast if any correctly named element doesn't match the type expected
  */
-void EventUnlock::loadForType(std::string element, XmlData data, int index)
+void EventUnlock::loadForType(Atom element, XmlDataView data, int index, const LoadOptions&)
 {
   loadForUnlock(element, data, index);
 
-  if(element == kKEY_VIEW_SCROLL)
-    setViewScroll(data.getDataBooleanOrThrow());
-  else if(element == kKEY_VIEW_TARGET)
-    setViewTarget(data.getDataBooleanOrThrow());
-  else if(element == kKEY_VIEW_TIME)
-    setViewTimeMilliseconds(data.getDataIntegerOrThrow());
+  switch(element) {
+    case Atom::VIEWSCROLL:
+      setViewScroll(data.getDataBooleanOrThrow());
+      break;
+    case Atom::VIEW:
+      setViewTarget(data.getDataBooleanOrThrow());
+      break;
+    case Atom::VIEWTIME:
+      setViewTimeMilliseconds(data.getDataIntegerOrThrow());
+      break;
+    default:
+      break;
+  }
 }
 
 /**
@@ -94,6 +101,7 @@ bool EventUnlock::isViewTarget() const
  */
 void EventUnlock::setViewScroll(bool scroll)
 {
+  markDirty();
   this->view_scroll = scroll;
 }
 
@@ -103,6 +111,7 @@ void EventUnlock::setViewScroll(bool scroll)
  */
 void EventUnlock::setViewTarget(bool view)
 {
+  markDirty();
   this->view_target = view;
 }
 
@@ -113,5 +122,6 @@ void EventUnlock::setViewTarget(bool view)
  */
 void EventUnlock::setViewTimeMilliseconds(uint32_t time_ms)
 {
+  markDirty();
   this->view_time_ms = time_ms;
 }
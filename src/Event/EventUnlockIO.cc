@@ -23,34 +23,46 @@ const std::string EventUnlockIO::kKEY_UNLOCK_INTERACTION = "modelock";
 
 /**
  * Loads unlock event data from the XML entry, specific to the unlock type.
- * @param element XML key name for the {@link index} in the tree
+ * @param element interned XML key name for the {@link index} in the tree
  * @param data single packet of XML data
  * @throws std::bad_cast if any correctly named element doesn't match the type expected
  */
-void EventUnlockIO::loadForUnlock(std::string element, XmlData data, int)
+void EventUnlockIO::loadForUnlock(Atom element, XmlDataView data, int)
 {
-  if(element == kKEY_IO_ID)
-    setInteractiveObjectId(data.getDataIntegerOrThrow());
-  else if(element == kKEY_STATE_ID)
-    setStateId(data.getDataIntegerOrThrow());
-  else if(element == kKEY_UNLOCK_EVENT_ALL)
-  {
-    bool unlock_event = data.getDataBooleanOrThrow();
-    setUnlockEventEnter(unlock_event);
-    setUnlockEventExit(unlock_event);
-    setUnlockEventUse(unlock_event);
-    setUnlockEventWalkover(unlock_event);
+  switch(element) {
+    case Atom::ID:
+      setInteractiveObjectId(data.getDataIntegerOrThrow());
+      break;
+    case Atom::STATE:
+      setStateId(data.getDataIntegerOrThrow());
+      break;
+    case Atom::EVENTALL:
+    {
+      bool unlock_event = data.getDataBooleanOrThrow();
+      setUnlockEventEnter(unlock_event);
+      setUnlockEventExit(unlock_event);
+      setUnlockEventUse(unlock_event);
+      setUnlockEventWalkover(unlock_event);
+      break;
+    }
+    case Atom::EVENTENTER:
+      setUnlockEventEnter(data.getDataBooleanOrThrow());
+      break;
+    case Atom::EVENTEXIT:
+      setUnlockEventExit(data.getDataBooleanOrThrow());
+      break;
+    case Atom::EVENTUSE:
+      setUnlockEventUse(data.getDataBooleanOrThrow());
+      break;
+    case Atom::EVENTWALKOVER:
+      setUnlockEventWalkover(data.getDataBooleanOrThrow());
+      break;
+    case Atom::MODELOCK:
+      setUnlockInteraction(data.getDataBooleanOrThrow());
+      break;
+    default:
+      break;
   }
-  else if(element == kKEY_UNLOCK_EVENT_ENTER)
-    setUnlockEventEnter(data.getDataBooleanOrThrow());
-  else if(element == kKEY_UNLOCK_EVENT_EXIT)
-    setUnlockEventExit(data.getDataBooleanOrThrow());
-  else if(element == kKEY_UNLOCK_EVENT_USE)
-    setUnlockEventUse(data.getDataBooleanOrThrow());
-  else if(element == kKEY_UNLOCK_EVENT_WALKOVER)
-    setUnlockEventWalkover(data.getDataBooleanOrThrow());
-  else if(element == kKEY_UNLOCK_INTERACTION)
-    setUnlockInteraction(data.getDataBooleanOrThrow());
 }
 
 /**
@@ -181,6 +193,7 @@ bool EventUnlockIO::isUnlockInteraction() const
  */
 void EventUnlockIO::setInteractiveObjectId(int32_t io_id)
 {
+  markDirty();
   this->io_id = io_id;
 }
 
@@ -191,6 +204,7 @@ void EventUnlockIO::setInteractiveObjectId(int32_t io_id)
  */
 void EventUnlockIO::setStateId(int16_t state_id)
 {
+  markDirty();
   this->state_id = state_id;
 }
 
@@ -200,6 +214,7 @@ void EventUnlockIO::setStateId(int16_t state_id)
  */
 void EventUnlockIO::setUnlockEventEnter(bool unlock_event)
 {
+  markDirty();
   this->unlock_event_enter = unlock_event;
 }
 
@@ -209,6 +224,7 @@ void EventUnlockIO::setUnlockEventEnter(bool unlock_event)
  */
 void EventUnlockIO::setUnlockEventExit(bool unlock_event)
 {
+  markDirty();
   this->unlock_event_exit = unlock_event;
 }
 
@@ -218,6 +234,7 @@ void EventUnlockIO::setUnlockEventExit(bool unlock_event)
  */
 void EventUnlockIO::setUnlockEventUse(bool unlock_event)
 {
+  markDirty();
   this->unlock_event_use = unlock_event;
 }
 
@@ -227,6 +244,7 @@ void EventUnlockIO::setUnlockEventUse(bool unlock_event)
  */
 void EventUnlockIO::setUnlockEventWalkover(bool unlock_event)
 {
+  markDirty();
   this->unlock_event_walkover = unlock_event;
 }
 
@@ -237,5 +255,6 @@ void EventUnlockIO::setUnlockEventWalkover(bool unlock_event)
  */
 void EventUnlockIO::setUnlockInteraction(bool unlock_interaction)
 {
+  markDirty();
   this->unlock_interaction = unlock_interaction;
 }
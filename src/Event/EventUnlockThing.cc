@@ -16,13 +16,13 @@ const std::string EventUnlockThing::kKEY_THING_ID = "id";
 
 /**
  * Loads unlock event data from the XML entry, specific to the unlock type.
- * @param element XML key name for the {@link index} in the tree
+ * @param element interned XML key name for the {@link index} in the tree
  * @param data single packet of XML data
  * @throws std::bad_cast if any correctly named element doesn't match the type expected
  */
-void EventUnlockThing::loadForUnlock(std::string element, XmlData data, int)
+void EventUnlockThing::loadForUnlock(Atom element, XmlDataView data, int)
 {
-  if(element == kKEY_THING_ID)
+  if(element == Atom::ID)
     setThingId(data.getDataIntegerOrThrow());
 }
 
@@ -74,5 +74,6 @@ EventType EventUnlockThing::getType() const
  */
 void EventUnlockThing::setThingId(int32_t thing_id)
 {
+  markDirty();
   this->thing_id = thing_id;
 }
@@ -21,28 +21,38 @@ const std::string EventUnlockTile::kKEY_UNLOCK_EVENT_EXIT = "eventexit";
 
 /**
  * Loads unlock event data from the XML entry, specific to the unlock type.
- * @param element XML key name for the {@link index} in the tree
+ * @param element interned XML key name for the {@link index} in the tree
  * @param data single packet of XML data
  * @throws std::bad_cast if any correctly named element doesn't match the type expected
  */
-void EventUnlockTile::loadForUnlock(std::string element, XmlData data, int)
+void EventUnlockTile::loadForUnlock(Atom element, XmlDataView data, int)
 {
-  if(element == kKEY_SECTION_ID)
-    setSectionId(data.getDataIntegerOrThrow());
-  else if(element == kKEY_TILE_HORIZONTAL)
-    setTileHorizontal(data.getDataIntegerOrThrow());
-  else if(element == kKEY_TILE_VERTICAL)
-    setTileVertical(data.getDataIntegerOrThrow());
-  else if(element == kKEY_UNLOCK_EVENT_ALL)
-  {
-    bool unlock_event = data.getDataBooleanOrThrow();
-    setUnlockEventEnter(unlock_event);
-    setUnlockEventExit(unlock_event);
+  switch(element) {
+    case Atom::SECTIONID:
+      setSectionId(data.getDataIntegerOrThrow());
+      break;
+    case Atom::X:
+      setTileHorizontal(data.getDataIntegerOrThrow());
+      break;
+    case Atom::Y:
+      setTileVertical(data.getDataIntegerOrThrow());
+      break;
+    case Atom::EVENTALL:
+    {
+      bool unlock_event = data.getDataBooleanOrThrow();
+      setUnlockEventEnter(unlock_event);
+      setUnlockEventExit(unlock_event);
+      break;
+    }
+    case Atom::EVENTENTER:
+      setUnlockEventEnter(data.getDataBooleanOrThrow());
+      break;
+    case Atom::EVENTEXIT:
+      setUnlockEventExit(data.getDataBooleanOrThrow());
+      break;
+    default:
+      break;
   }
-  else if(element == kKEY_UNLOCK_EVENT_ENTER)
-    setUnlockEventEnter(data.getDataBooleanOrThrow());
-  else if(element == kKEY_UNLOCK_EVENT_EXIT)
-    setUnlockEventExit(data.getDataBooleanOrThrow());
 }
 
 /**
@@ -141,6 +151,7 @@ bool EventUnlockTile::isUnlockEventExit() const
  */
 void EventUnlockTile::setSectionId(int16_t section_id)
 {
+  markDirty();
   this->section_id = section_id;
 }
 
@@ -150,6 +161,7 @@ void EventUnlockTile::setSectionId(int16_t section_id)
  */
 void EventUnlockTile::setTileHorizontal(uint16_t tile_horizontal)
 {
+  markDirty();
   this->tile_horizontal = tile_horizontal;
 }
 
@@ -159,6 +171,7 @@ void EventUnlockTile::setTileHorizontal(uint16_t tile_horizontal)
  */
 void EventUnlockTile::setTileVertical(uint16_t tile_vertical)
 {
+  markDirty();
   this->tile_vertical = tile_vertical;
 }
 
@@ -168,6 +181,7 @@ void EventUnlockTile::setTileVertical(uint16_t tile_vertical)
  */
 void EventUnlockTile::setUnlockEventEnter(bool unlock_event)
 {
+  markDirty();
   this->unlock_event_enter = unlock_event;
 }
 
@@ -177,5 +191,6 @@ void EventUnlockTile::setUnlockEventEnter(bool unlock_event)
  */
 void EventUnlockTile::setUnlockEventExit(bool unlock_event)
 {
+  markDirty();
   this->unlock_event_exit = unlock_event;
 }
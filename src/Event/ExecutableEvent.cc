@@ -47,17 +47,24 @@ bool ExecutableEvent::isSaveable() const
  * Loads event data from the XML entry.
  * @param data single packet of XML data
  * @param index current index within the line, represents which XML element is currently being read
+ * @param options settings of the load
  * @throws std::bad_cast if any correctly named element doesn't match the type expected
  */
-void ExecutableEvent::load(XmlData data, int index)
+void ExecutableEvent::load(XmlDataView data, int index, const LoadOptions& options)
 {
-  std::string element = data.getElement(index);
-  loadForType(element, data, index);
+  Atom element = data.getElementAtom(index);
+  loadForType(element, data, index, options);
 
-  if(element == kKEY_ONE_SHOT)
-    setOneShot(data.getDataBooleanOrThrow());
-  else if(element == kKEY_SOUND_ID)
-    setSoundId(data.getDataIntegerOrThrow());
+  switch(element) {
+    case Atom::ONE_SHOT:
+      setOneShot(data.getDataBooleanOrThrow());
+      break;
+    case Atom::SOUND_ID:
+      setSoundId(data.getDataIntegerOrThrow());
+      break;
+    default:
+      break;
+  }
 }
 
 /**
@@ -80,6 +87,7 @@ void ExecutableEvent::save(XmlWriter* writer) const
  */
 void ExecutableEvent::setOneShot(bool one_shot)
 {
+  markDirty();
   this->one_shot = one_shot;
 }
 
@@ -89,5 +97,6 @@ void ExecutableEvent::setOneShot(bool one_shot)
  */
 void ExecutableEvent::setSoundId(int32_t sound_id)
 {
+  markDirty();
   this->sound_id = sound_id;
 }
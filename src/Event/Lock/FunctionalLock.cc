@@ -39,12 +39,12 @@ bool FunctionalLock::isSaveable() const
  * @param index current index within the line, represents which XML element is currently being read
  * @throws std::bad_cast if any correctly named element doesn't match the type expected
  */
-void FunctionalLock::load(XmlData data, int index)
+void FunctionalLock::load(XmlDataView data, int index)
 {
-  std::string element = data.getElement(index);
+  Atom element = data.getElementAtom(index);
   loadForType(element, data, index);
 
-  if(element == kKEY_PERMANENT)
+  if(element == Atom::PERMANENT)
     setPermanent(data.getDataBooleanOrThrow());
 }
 
@@ -0,0 +1,18 @@
+/**
+ * @class Lock
+ *
+ * Lock pure interface (abstract) class. This defines the common lock functionality shared
+ * by all implementations.
+ */
+#include "Event/Lock/Lock.h"
+using namespace core;
+
+/*=============================================================================
+ * CONSTRUCTORS / DESTRUCTORS
+ *============================================================================*/
+
+/**
+ * Destructor function. Pure virtual to keep the class abstract but it still requires a body
+ * since every implementation destructor calls through to it.
+ */
+Lock::~Lock() {}
@@ -18,18 +18,25 @@ const std::string LockItem::kKEY_ITEM_ID = "id";
 
 /**
  * Loads lock data from the XML entry, specific to the lock type (sub-class).
- * @param element XML key name for the {@link index} in the tree
+ * @param element interned XML key name for the {@link index} in the tree
  * @param data single packet of XML data
  * @throws std::bad_cast if any correctly named element doesn't match the type expected
  */
-void LockItem::loadForType(std::string element, XmlData data, int)
+void LockItem::loadForType(Atom element, XmlDataView data, int)
 {
-  if(element == kKEY_CONSUME_TO_UNLOCK)
-    setConsumeToUnlock(data.getDataBooleanOrThrow());
-  else if(element == kKEY_ITEM_ID)
-    setItemId(data.getDataIntegerOrThrow());
-  else if(element == kKEY_ITEM_COUNT)
-    setItemCount(data.getDataIntegerOrThrow());
+  switch(element) {
+    case Atom::CONSUME:
+      setConsumeToUnlock(data.getDataBooleanOrThrow());
+      break;
+    case Atom::ID:
+      setItemId(data.getDataIntegerOrThrow());
+      break;
+    case Atom::COUNT:
+      setItemCount(data.getDataIntegerOrThrow());
+      break;
+    default:
+      break;
+  }
 }
 
 /**
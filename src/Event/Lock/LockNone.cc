@@ -40,7 +40,7 @@ bool LockNone::isSaveable() const
 /**
  * Loads lock data from the XML entry. In this implementation, it is no-op.
  */
-void LockNone::load(XmlData, int)
+void LockNone::load(XmlDataView, int)
 {
 }
 
@@ -15,7 +15,7 @@ using namespace core;
  * Loads lock data from the XML entry, specific to the lock type (sub-class).
  * @throws std::bad_cast if any correctly named element doesn't match the type expected
  */
-void LockTrigger::loadForType(std::string, XmlData, int)
+void LockTrigger::loadForType(Atom, XmlDataView, int)
 {
 }
 
@@ -8,29 +8,6 @@
 #include "Event/Lock/PersistLock.h"
 using namespace core;
 
-/* Constant Implementation - see header file for descriptions */
-const std::string PersistLock::kKEY_TYPE_ITEM = "item";
-const std::string PersistLock::kKEY_TYPE_NONE = "none";
-const std::string PersistLock::kKEY_TYPE_TRIGGER = "trigger";
-
-/**
- * Lock type enumerator from string key static map.
- */
-const std::unordered_map<std::string, LockType> PersistLock::kTYPE_FROM_STRING = {
-  { kKEY_TYPE_ITEM,    LockType::ITEM    },
-  { kKEY_TYPE_NONE,    LockType::NONE    },
-  { kKEY_TYPE_TRIGGER, LockType::TRIGGER }
-};
-
-/**
- * Lock type enumerator to string key static map.
- */
-const std::unordered_map<LockType, std::string> PersistLock::kTYPE_TO_STRING = {
-  { LockType::ITEM,    kKEY_TYPE_ITEM    },
-  { LockType::NONE,    kKEY_TYPE_NONE    },
-  { LockType::TRIGGER, kKEY_TYPE_TRIGGER }
-};
-
 /*=============================================================================
  * PRIVATE STATIC FUNCTIONS
  *============================================================================*/
@@ -65,16 +42,15 @@ Lock* PersistLock::createLockFromType(LockType type)
  * @param index current index within the line, represents which XML element is currently being read
  * @return augmented lock by the load state
  */
-Lock* PersistLock::load(Lock* lock, XmlData data, int index)
+Lock* PersistLock::load(Lock* lock, XmlDataView data, int index)
 {
-  std::string element = data.getElement(index);
+  FIS_PROFILE_SCOPE(Profiler::kLOCK_LOAD, data.getElement(index));
+  FIS_PROFILE_BYTES(data.getByteCount());
 
-  auto found_type_pair = kTYPE_FROM_STRING.find(element);
-  if(found_type_pair == kTYPE_FROM_STRING.end())
+  LockType type_from_data;
+  if(!kTYPE_REGISTRY.find(data.getElement(index), type_from_data))
     throw std::domain_error("Lock type mapping for load lock is not defined");
 
-  LockType type_from_data = found_type_pair->second;
-
   // Decide if the old lock can be used or if a new one need to be created
   Lock* lock_to_edit;
   if(lock->getType() != type_from_data)
@@ -102,12 +78,12 @@ void PersistLock::save(Lock* lock, XmlWriter* writer, bool save_if_invalid)
 {
   if(lock->isSaveable() || save_if_invalid)
   {
-    auto found_type_pair = kTYPE_TO_STRING.find(lock->getType());
-    if(found_type_pair == kTYPE_TO_STRING.end())
+    std::string_view type_name = kTYPE_REGISTRY.getName(lock->getType());
+    FIS_PROFILE_SCOPE(Profiler::kLOCK_SAVE, type_name);
+    if(type_name.empty())
       throw std::domain_error("Lock type mapping for save lock is not defined");
 
-    std::string type_string = found_type_pair->second;
-    writer->writeElement(type_string);
+    writer->writeElement(std::string(type_name));
     lock->save(writer);
     writer->jumpToParent();
   }
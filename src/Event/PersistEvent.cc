@@ -8,65 +8,6 @@
 #include "Event/PersistEvent.h"
 using namespace core;
 
-/* Constant Implementation - see header file for descriptions */
-const std::string PersistEvent::kKEY_TYPE_BATTLESTART = "startbattle";
-const std::string PersistEvent::kKEY_TYPE_CONVERSATION = "conversation";
-const std::string PersistEvent::kKEY_TYPE_ITEMGIVE = "giveitem";
-const std::string PersistEvent::kKEY_TYPE_ITEMTAKE = "takeitem";
-const std::string PersistEvent::kKEY_TYPE_MAPSWITCH = "startmap";
-const std::string PersistEvent::kKEY_TYPE_MULTIPLE = "multiple";
-const std::string PersistEvent::kKEY_TYPE_NONE = "none";
-const std::string PersistEvent::kKEY_TYPE_NOTIFICATION = "notification";
-const std::string PersistEvent::kKEY_TYPE_PROPERTY = "propertymod";
-const std::string PersistEvent::kKEY_TYPE_SOUND = "justsound";
-const std::string PersistEvent::kKEY_TYPE_TELEPORT = "teleportthing";
-const std::string PersistEvent::kKEY_TYPE_TRIGGERIO = "triggerio";
-const std::string PersistEvent::kKEY_TYPE_UNLOCKIO = "unlockio";
-const std::string PersistEvent::kKEY_TYPE_UNLOCKTHING = "unlockthing";
-const std::string PersistEvent::kKEY_TYPE_UNLOCKTILE = "unlocktile";
-
-/**
- * Event type enumerator from string key static map.
- */
-const std::unordered_map<std::string, EventType> PersistEvent::kTYPE_FROM_STRING = {
-  { kKEY_TYPE_BATTLESTART,  EventType::BATTLESTART  },
-  { kKEY_TYPE_CONVERSATION, EventType::CONVERSATION },
-  { kKEY_TYPE_ITEMGIVE,     EventType::ITEMGIVE     },
-  { kKEY_TYPE_ITEMTAKE,     EventType::ITEMTAKE     },
-  { kKEY_TYPE_MAPSWITCH,    EventType::MAPSWITCH    },
-  { kKEY_TYPE_MULTIPLE,     EventType::MULTIPLE     },
-  { kKEY_TYPE_NONE,         EventType::NONE         },
-  { kKEY_TYPE_NOTIFICATION, EventType::NOTIFICATION },
-  { kKEY_TYPE_PROPERTY,     EventType::PROPERTY     },
-  { kKEY_TYPE_SOUND,        EventType::SOUND        },
-  { kKEY_TYPE_TELEPORT,     EventType::TELEPORT     },
-  { kKEY_TYPE_TRIGGERIO,    EventType::TRIGGERIO    },
-  { kKEY_TYPE_UNLOCKIO,     EventType::UNLOCKIO     },
-  { kKEY_TYPE_UNLOCKTHING,  EventType::UNLOCKTHING  },
-  { kKEY_TYPE_UNLOCKTILE,   EventType::UNLOCKTILE   }
-};
-
-/**
- * Event type enumerator to string key static map.
- */
-const std::unordered_map<EventType, std::string> PersistEvent::kTYPE_TO_STRING = {
-  { EventType::BATTLESTART,  kKEY_TYPE_BATTLESTART  },
-  { EventType::CONVERSATION, kKEY_TYPE_CONVERSATION },
-  { EventType::ITEMGIVE,     kKEY_TYPE_ITEMGIVE     },
-  { EventType::ITEMTAKE,     kKEY_TYPE_ITEMTAKE     },
-  { EventType::MAPSWITCH,    kKEY_TYPE_MAPSWITCH    },
-  { EventType::MULTIPLE,     kKEY_TYPE_MULTIPLE     },
-  { EventType::NONE,         kKEY_TYPE_NONE         },
-  { EventType::NOTIFICATION, kKEY_TYPE_NOTIFICATION },
-  { EventType::PROPERTY,     kKEY_TYPE_PROPERTY     },
-  { EventType::SOUND,        kKEY_TYPE_SOUND        },
-  { EventType::TELEPORT,     kKEY_TYPE_TELEPORT     },
-  { EventType::TRIGGERIO,    kKEY_TYPE_TRIGGERIO    },
-  { EventType::UNLOCKIO,     kKEY_TYPE_UNLOCKIO     },
-  { EventType::UNLOCKTHING,  kKEY_TYPE_UNLOCKTHING  },
-  { EventType::UNLOCKTILE,   kKEY_TYPE_UNLOCKTILE   }
-};
-
 /*=============================================================================
  * PRIVATE STATIC FUNCTIONS
  *============================================================================*/
@@ -114,36 +55,80 @@ Event* PersistEvent::createEventFromType(EventType type)
   }
 }
 
+/**
+ * Returns the event type of the XML element, which names it. Interned type names resolve with
+ * the load path schema and any other, such as "none", with the name lookup.
+ * @param data single packet of XML data
+ * @param index current index within the line, represents which XML element is currently being read
+ * @return event type classification
+ * @throws std::domain_error if the element doesn't name an event type
+ */
+EventType PersistEvent::getTypeFromData(XmlDataView data, int index)
+{
+  EventType type_from_data;
+  if(!kLOAD_PATHS.next(kPATH_EVENT, data.getElementAtom(index), type_from_data) &&
+     !kTYPE_REGISTRY.find(data.getElement(index), type_from_data))
+    throw std::domain_error("Event type mapping for load event is not defined");
+  return type_from_data;
+}
+
 /*=============================================================================
  * PUBLIC STATIC FUNCTIONS
  *============================================================================*/
 
 /**
- * Loads the individual event data from the XML entry.
+ * Loads the individual event data from the XML entry. The line is walked with the load path
+ * schema, through every nested event, straight to the event that holds the data element, so
+ * only that event dispatches on it. The event is then marked as matching the saved data.
  * @param event current event stored locally that either needs to be augmented or thrown away
  * @param data single packet of XML data
  * @param index current index within the line, represents which XML element is currently being read
+ * @param options settings of the load
  * @return augmented event by the load state
  */
-Event* PersistEvent::load(Event* event, XmlData data, int index)
+Event* PersistEvent::load(Event* event, XmlDataView data, int index,
+                          const LoadOptions& options)
 {
-  std::string element = data.getElement(index);
-
-  auto found_type_pair = kTYPE_FROM_STRING.find(element);
-  if(found_type_pair == kTYPE_FROM_STRING.end())
-    throw std::domain_error("Event type mapping for load event is not defined");
-
-  EventType type_from_data = found_type_pair->second;
+  FIS_PROFILE_SCOPE(Profiler::kEVENT_LOAD, "");
+  FIS_PROFILE_BYTES(data.getByteCount());
 
   // Decide if the old event can be used or if a new one need to be created
+  EventType type_from_data = getTypeFromData(data, index);
   Event* event_to_edit;
   if(event->getType() != type_from_data)
     event_to_edit = createEventFromType(type_from_data);
   else
     event_to_edit = event;
 
-  // Call load in the event
-  event_to_edit->load(data, index + 1);
+  // Follow the nested events, replacing any of the wrong type in place
+  Event* leaf_event = event_to_edit;
+  EventType state;
+  index++;
+  while(kLOAD_PATHS.next(type_from_data, data.getElementAtom(index), state))
+  {
+    // Without a slot, the event loads the line itself, such as when it defers its nested events
+    Event** nested_event = leaf_event->getNestedEvent(data.getElementAtom(index), data, index,
+                                                       options);
+    if(nested_event == nullptr)
+      break;
+
+    type_from_data = getTypeFromData(data, index + 1);
+    if((*nested_event)->getType() != type_from_data)
+    {
+      Event* old_event = *nested_event;
+      *nested_event = createEventFromType(type_from_data);
+      delete old_event;
+    }
+    leaf_event = *nested_event;
+    index += 2;
+  }
+
+  // Call load in the event that holds the data element
+  FIS_PROFILE_NAME(kTYPE_REGISTRY.getName(leaf_event->getType()));
+  leaf_event->load(data, index, options);
+
+  // The loaded event now matches the saved data
+  event_to_edit->clearDirty();
 
   // If a new event was created, delete the old one
   if(event_to_edit != event)
@@ -153,7 +138,8 @@ Event* PersistEvent::load(Event* event, XmlData data, int index)
 }
 
 /**
- * Saves the individual event data into the XML writer.
+ * Saves the individual event data into the XML writer. Once written, the event is marked as
+ * matching the saved data.
  * @param event persist ready event object
  * @param writer saving file handler interface
  * @param save_if_invalid TRUE to save even if the event is not saveable (subs NONE event in place)
@@ -162,13 +148,66 @@ void PersistEvent::save(Event* event, XmlWriter* writer, bool save_if_invalid)
 {
   if(event->isSaveable() || save_if_invalid)
   {
-    auto found_type_pair = kTYPE_TO_STRING.find(event->getType());
-    if(found_type_pair == kTYPE_TO_STRING.end())
+    std::string_view type_name = kTYPE_REGISTRY.getName(event->getType());
+    FIS_PROFILE_SCOPE(Profiler::kEVENT_SAVE, type_name);
+    if(type_name.empty())
       throw std::domain_error("Event type mapping for save event is not defined");
 
-    std::string type_string = found_type_pair->second;
-    writer->writeElement(type_string);
+    bool written = writer->writeElement(std::string(type_name));
     event->save(writer);
     writer->jumpToParent();
+    if(written)
+      event->clearDirty();
   }
 }
+
+/**
+ * Rewrites the individual event data at the location in the XML writer, only if it changed
+ * since it was last saved. See {@link XmlWriter#rewriteElements} for how the location is
+ * rewritten, which is only done by a writer that adds to the saved content, such as a
+ * {@link JournalWriter}. Any other writer needs the full save. The writer is returned to the
+ * node it started at.
+ * @param event persist ready event object
+ * @param writer saving file handler interface
+ * @param location element branch, from the current writer node, that only holds the event
+ * @param save_if_invalid TRUE to save even if the event is not saveable (subs NONE event in place)
+ * @return TRUE if the event changed and was rewritten. FALSE if it didn't change, or if the
+ *         writer replaces the saved content, in which case nothing is written and the event
+ *         stays dirty
+ */
+bool PersistEvent::saveIncremental(Event* event, XmlWriter* writer, XmlData location,
+                                   bool save_if_invalid)
+{
+  if(!event->isDirty() || !writer->rewriteElements(location))
+    return false;
+
+  int depth = XmlDataView(location).getNumElements();
+  save(event, writer, save_if_invalid);
+  for(int i = 0; i < depth; i++)
+    writer->jumpToParent();
+
+  event->clearDirty();
+  return true;
+}
+
+/**
+ * Captures a copy of the event, for saving it later (such as on another thread) while the live
+ * event keeps changing. The copy is taken now and is only touched by the task.
+ * @param event the event to capture
+ * @param location element branch, from the writer node the task runs at, to save the event in
+ * @param save_if_invalid should the event be saved even if it is not valid? Default false
+ * @return task that writes the location and saves the copy, leaving the writer where it started
+ */
+std::function<void(XmlWriter*)> PersistEvent::snapshot(const Event* event, XmlData location,
+                                                       bool save_if_invalid)
+{
+  std::shared_ptr<Event> copy(event->clone());
+  return [copy, location, save_if_invalid](XmlWriter* writer)
+  {
+    int depth = XmlDataView(location).getNumElements();
+    writer->writeElements(location);
+    save(copy.get(), writer, save_if_invalid);
+    for(int i = 0; i < depth; i++)
+      writer->jumpToParent();
+  };
+}
@@ -128,6 +128,7 @@ bool MapPerson::isStartingDirectionSet(bool check_base) const
  */
 void MapPerson::setMatrix(MapPersonRenderKey key, SpriteMatrix& sprite_matrix)
 {
+  markDirty();
   this->matrix_states.at(key) = sprite_matrix;
 }
 
@@ -138,6 +139,7 @@ void MapPerson::setMatrix(MapPersonRenderKey key, SpriteMatrix& sprite_matrix)
  */
 void MapPerson::setSpeed(uint16_t speed)
 {
+  markDirty();
   this->speed = speed;
 }
 
@@ -149,6 +151,7 @@ void MapPerson::setSpeed(uint16_t speed)
  */
 void MapPerson::setStartingDirection(Direction direction)
 {
+  markDirty();
   this->starting_direction = direction;
 }
 
@@ -159,6 +162,7 @@ void MapPerson::setStartingDirection(Direction direction)
  */
 void MapPerson::unsetMatrix(MapPersonRenderKey key)
 {
+  markDirty();
   matrix_states.erase(key);
 }
 
@@ -168,6 +172,7 @@ void MapPerson::unsetMatrix(MapPersonRenderKey key)
  */
 void MapPerson::unsetSpeed()
 {
+  markDirty();
   speed.reset();
 }
 
@@ -177,5 +182,6 @@ void MapPerson::unsetSpeed()
  */
 void MapPerson::unsetStartingDirection()
 {
+  markDirty();
   starting_direction.reset();
 }
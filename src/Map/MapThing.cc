@@ -22,10 +22,33 @@ MapThing::MapThing(uint32_t id)
   setId(id);
 }
 
+/*=============================================================================
+ * PROTECTED FUNCTIONS
+ *============================================================================*/
+
+/**
+ * Marks the thing data as changed since it was last saved. Every function that changes data
+ * held by the thing itself calls this, including the ones in implementations.
+ */
+void MapThing::markDirty()
+{
+  dirty = true;
+}
+
 /*=============================================================================
  * PUBLIC FUNCTIONS
  *============================================================================*/
 
+/**
+ * Marks the thing and its event as matching the saved data, once it's been fully loaded or saved.
+ */
+void MapThing::clearDirty()
+{
+  dirty = false;
+  if(event)
+    event->clearDirty();
+}
+
 /**
  * Returns the base thing reference for defining the underlying reference definition. This may
  * be unset or already expired, in which case only the current object class variables will be used.
@@ -263,6 +286,16 @@ bool MapThing::isDialogImageSet(bool check_base) const
   return false;
 }
 
+/**
+ * Returns if the thing or its event changed since it was last saved. Changes to the base thing
+ * are not included, since they are saved with the base. A new thing is dirty until it's cleared.
+ * @return TRUE if the thing needs to be saved again
+ */
+bool MapThing::isDirty() const
+{
+  return (dirty || (event && event->isDirty()));
+}
+
 /**
  * Describes if the associated object event (@link #getEvent()) has been defined.
  * @param check_base TRUE to also check the base object, FALSE to only check the local version
@@ -411,6 +444,7 @@ bool MapThing::isVisibleSet(bool check_base) const
  */
 void MapThing::setActive(bool active)
 {
+  markDirty();
   this->active = active;
 }
 
@@ -422,6 +456,7 @@ void MapThing::setActive(bool active)
  */
 void MapThing::setBase(std::weak_ptr<MapThing> base_thing)
 {
+  markDirty();
   if(auto base = base_thing.lock())
   {
     if(base->getType() == getType())
@@ -442,6 +477,7 @@ void MapThing::setBase(std::weak_ptr<MapThing> base_thing)
  */
 void MapThing::setDescription(std::string description)
 {
+  markDirty();
   this->description = description;
 }
 
@@ -453,6 +489,7 @@ void MapThing::setDescription(std::string description)
  */
 void MapThing::setDialogImage(Frame& dialog_image)
 {
+  markDirty();
   this->dialog_image = dialog_image;
 }
 
@@ -464,6 +501,7 @@ void MapThing::setDialogImage(Frame& dialog_image)
  */
 void MapThing::setEvent(std::unique_ptr<Event> event)
 {
+  markDirty();
   this->event = std::move(event);
 }
 
@@ -475,6 +513,7 @@ void MapThing::setEvent(std::unique_ptr<Event> event)
  */
 void MapThing::setGameId(uint32_t game_id)
 {
+  markDirty();
   this->game_id = game_id;
 }
 
@@ -484,6 +523,7 @@ void MapThing::setGameId(uint32_t game_id)
  */
 void MapThing::setId(uint32_t id)
 {
+  markDirty();
   this->id = id;
 }
 
@@ -494,6 +534,7 @@ void MapThing::setId(uint32_t id)
  */
 void MapThing::setName(std::string name)
 {
+  markDirty();
   this->name = name;
 }
 
@@ -505,6 +546,7 @@ void MapThing::setName(std::string name)
  */
 void MapThing::setRespawnTimeMilliseconds(uint16_t respawn_time_ms)
 {
+  markDirty();
   this->respawn_time_ms = respawn_time_ms;
 }
 
@@ -516,6 +558,7 @@ void MapThing::setRespawnTimeMilliseconds(uint16_t respawn_time_ms)
  */
 void MapThing::setSoundId(uint32_t sound_id)
 {
+  markDirty();
   this->sound_id = sound_id;
 }
 
@@ -527,6 +570,7 @@ void MapThing::setSoundId(uint32_t sound_id)
  */
 void MapThing::setSpriteMatrix(SpriteMatrix& sprite_matrix)
 {
+  markDirty();
   this->sprite_matrix = sprite_matrix;
 }
 
@@ -538,6 +582,7 @@ void MapThing::setSpriteMatrix(SpriteMatrix& sprite_matrix)
  */
 void MapThing::setTileHorizontal(uint16_t tile_horizontal)
 {
+  markDirty();
   this->tile_horizontal = tile_horizontal;
 }
 
@@ -549,6 +594,7 @@ void MapThing::setTileHorizontal(uint16_t tile_horizontal)
  */
 void MapThing::setTileVertical(uint16_t tile_vertical)
 {
+  markDirty();
   this->tile_vertical = tile_vertical;
 }
 
@@ -559,6 +605,7 @@ void MapThing::setTileVertical(uint16_t tile_vertical)
  */
 void MapThing::setVisible(bool visible)
 {
+  markDirty();
   this->visible = visible;
 }
 
@@ -568,6 +615,7 @@ void MapThing::setVisible(bool visible)
  */
 void MapThing::unsetActive()
 {
+  markDirty();
   active.reset();
 }
 
@@ -577,6 +625,7 @@ void MapThing::unsetActive()
  */
 void MapThing::unsetBase()
 {
+  markDirty();
   base_thing.reset();
 }
 
@@ -586,6 +635,7 @@ void MapThing::unsetBase()
  */
 void MapThing::unsetDescription()
 {
+  markDirty();
   description.reset();
 }
 
@@ -595,6 +645,7 @@ void MapThing::unsetDescription()
  */
 void MapThing::unsetDialogImage()
 {
+  markDirty();
   dialog_image.reset();
 }
 
@@ -604,6 +655,7 @@ void MapThing::unsetDialogImage()
  */
 void MapThing::unsetEvent()
 {
+  markDirty();
   event.reset();
 }
 
@@ -613,6 +665,7 @@ void MapThing::unsetEvent()
  */
 void MapThing::unsetGameId()
 {
+  markDirty();
   game_id.reset();
 }
 
@@ -622,6 +675,7 @@ void MapThing::unsetGameId()
  */
 void MapThing::unsetName()
 {
+  markDirty();
   name.reset();
 }
 
@@ -631,6 +685,7 @@ void MapThing::unsetName()
  */
 void MapThing::unsetRespawnTime()
 {
+  markDirty();
   respawn_time_ms.reset();
 }
 
@@ -640,6 +695,7 @@ void MapThing::unsetRespawnTime()
  */
 void MapThing::unsetSoundId()
 {
+  markDirty();
   sound_id.reset();
 }
 
@@ -649,6 +705,7 @@ void MapThing::unsetSoundId()
  */
 void MapThing::unsetSpriteMatrix()
 {
+  markDirty();
   sprite_matrix.reset();
 }
 
@@ -658,6 +715,7 @@ void MapThing::unsetSpriteMatrix()
  */
 void MapThing::unsetTileHorizontal()
 {
+  markDirty();
   tile_horizontal.reset();
 }
 
@@ -667,6 +725,7 @@ void MapThing::unsetTileHorizontal()
  */
 void MapThing::unsetTileVertical()
 {
+  markDirty();
   tile_vertical.reset();
 }
 
@@ -676,5 +735,6 @@ void MapThing::unsetTileVertical()
  */
 void MapThing::unsetVisible()
 {
+  markDirty();
   visible.reset();
 }
@@ -0,0 +1,162 @@
+/**
+ * @class AsyncSaver
+ *
+ * Double buffered background save pipeline. The calling thread only captures a snapshot: a set
+ * of save tasks that each own an immutable copy of the state they write. commit() hands the
+ * snapshot to a worker thread, which serializes it through the writer into its own buffer and
+ * commits it atomically with stop(true), while the next snapshot is captured. If a snapshot is
+ * committed while an older one is still waiting for the worker, the newer one replaces it, since
+ * every snapshot is a whole save.
+ */
+#include "Persistence/AsyncSaver.h"
+using namespace core;
+
+/*============================================================================
+ * CONSTRUCTORS / DESTRUCTORS
+ *===========================================================================*/
+
+/**
+ * Constructor function - Sets up the saver and starts its worker thread.
+ * @param writer the writer that every snapshot is saved through. Only the worker uses it
+ */
+AsyncSaver::AsyncSaver(std::unique_ptr<XmlWriter> writer)
+          : writer{std::move(writer)}
+{
+  worker = std::thread(&AsyncSaver::runWorker, this);
+}
+
+/**
+ * Destructor function - Finishes every committed snapshot and stops the worker thread.
+ */
+AsyncSaver::~AsyncSaver()
+{
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    stopping = true;
+  }
+  signal.notify_all();
+  worker.join();
+}
+
+/*============================================================================
+ * PRIVATE FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Runs the saves of the worker thread. Each pending snapshot is taken out of the shared slot so
+ * the next one can be committed while it's written. Pending snapshots are still saved once
+ * stopping, so no commit is lost.
+ */
+void AsyncSaver::runWorker()
+{
+  std::unique_lock<std::mutex> guard(lock);
+  while(true)
+  {
+    signal.wait(guard, [this]() { return (stopping || saved_count != committed_count); });
+    if(saved_count == committed_count)
+      return;
+
+    std::vector<SaveTask> snapshot;
+    snapshot.swap(pending);
+    uint32_t snapshot_count = committed_count;
+
+    guard.unlock();
+    std::exception_ptr save_error;
+    bool success = false;
+    try
+    {
+      success = saveSnapshot(snapshot);
+    }
+    catch(...)
+    {
+      save_error = std::current_exception();
+      writer->stop(false);
+    }
+    snapshot.clear();
+    guard.lock();
+
+    if(save_error && !error)
+      error = save_error;
+    last_success = success;
+    saved_count = snapshot_count;
+    signal.notify_all();
+  }
+}
+
+/**
+ * Saves the snapshot through the writer. The tasks run in order on the one writer, the same as
+ * a save on the calling thread would, so each continues from wherever the last one left it.
+ * @param snapshot the save tasks to run, in order
+ * @return TRUE if the writer started and committed the save
+ */
+bool AsyncSaver::saveSnapshot(std::vector<SaveTask>& snapshot)
+{
+  if(!writer->start())
+    return false;
+
+  for(SaveTask& task : snapshot)
+    task(writer.get());
+  return writer->stop(true);
+}
+
+/*============================================================================
+ * PUBLIC FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Adds a save task to the snapshot being captured. The task runs later on the worker thread, so
+ * it must own (or share read only) everything it writes, such as a clone of the live object.
+ * @param task the save step, which writes at the current writer node
+ */
+void AsyncSaver::add(SaveTask task)
+{
+  capture.push_back(std::move(task));
+}
+
+/**
+ * Commits the captured snapshot to be saved by the worker and starts capturing a new one. This
+ * never waits on a save in progress.
+ * @return TRUE if there was a snapshot to commit
+ */
+bool AsyncSaver::commit()
+{
+  if(capture.empty())
+    return false;
+
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    pending.swap(capture);
+    committed_count++;
+  }
+  capture.clear();
+  signal.notify_all();
+  return true;
+}
+
+/**
+ * Returns if a committed snapshot hasn't been saved yet.
+ * @return TRUE if the worker is saving or has a snapshot waiting
+ */
+bool AsyncSaver::isSaving()
+{
+  std::lock_guard<std::mutex> guard(lock);
+  return (saved_count != committed_count);
+}
+
+/**
+ * Waits for every committed snapshot to be saved. If a save task threw, the first exception is
+ * rethrown here once.
+ * @return TRUE if the last snapshot saved was committed by the writer
+ */
+bool AsyncSaver::wait()
+{
+  std::unique_lock<std::mutex> guard(lock);
+  signal.wait(guard, [this]() { return (saved_count == committed_count); });
+  if(error)
+  {
+    std::exception_ptr save_error = error;
+    error = nullptr;
+    std::rethrow_exception(save_error);
+  }
+  return last_success;
+}
@@ -0,0 +1,36 @@
+/**
+ * @class AtomTable
+ *
+ * Global table that interns element and attribute key names into {@link Atom}s. Names are
+ * resolved once, when they are added to a line of data, so the load path can dispatch with a
+ * switch on small integers instead of comparing strings.
+ */
+#include "Persistence/AtomTable.h"
+using namespace core;
+
+/*============================================================================
+ * PUBLIC STATIC FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Returns the atom for the name.
+ * @param name element or attribute key name
+ * @return the interned atom. NONE if the name is not interned
+ */
+Atom AtomTable::fromName(std::string_view name)
+{
+  Atom atom;
+  if(!kREGISTRY.find(name, atom))
+    return Atom::NONE;
+  return atom;
+}
+
+/**
+ * Returns the interned name of the atom.
+ * @param atom the atom to look up
+ * @return view of the name, valid for the life of the program. Blank for NONE
+ */
+std::string_view AtomTable::getName(Atom atom)
+{
+  return kREGISTRY.getName(atom);
+}
@@ -0,0 +1,220 @@
+/**
+ * @class BinaryEncoding
+ *
+ * Primitive encoders and decoders for the binary content format. A binary file is the magic
+ * "FISB" and a version byte, followed by a flat sequence of records that each start with a
+ * {@link BinaryRecordType} tag byte:
+ *  - DICT:  string. Defines the next dictionary id (ids count up from 0)
+ *  - OPEN:  name id, key id + 1 (0 if no key) and the key value string if there is a key
+ *  - CLOSE: no payload, closes the last open element
+ *  - DATA:  name id, {@link DataType} byte and the typed payload
+ *  - REF:   offset of the OPEN record of an earlier element, which is read again in its place
+ *           (without its DICT records). Used for repeated subtrees
+ * Unsigned numbers are LEB128 varints and signed integers are zigzag encoded first. Strings are
+ * a varint length and the raw bytes. Floats are the 4 byte IEEE pattern, little endian.
+ */
+#include "Persistence/BinaryEncoding.h"
+using namespace core;
+
+/* Constant Implementation - see header file for descriptions */
+const std::string BinaryEncoding::kMAGIC = "FISB";
+
+/*============================================================================
+ * PUBLIC STATIC FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Appends an unsigned integer as 4 bytes, little endian.
+ * @param buffer the destination buffer
+ * @param value the integer to encode
+ */
+void BinaryEncoding::appendFixed32(PageBuffer& buffer, uint32_t value)
+{
+  char encoded[4];
+  for(int i = 0; i < 4; i++)
+    encoded[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+  buffer.append(encoded, sizeof(encoded));
+}
+
+/**
+ * Appends a float as its 4 byte IEEE pattern, little endian.
+ * @param buffer the destination buffer
+ * @param value the float to encode
+ */
+void BinaryEncoding::appendFloat(PageBuffer& buffer, float value)
+{
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  appendFixed32(buffer, bits);
+}
+
+/**
+ * Appends the file header: magic and version.
+ * @param buffer the destination buffer
+ */
+void BinaryEncoding::appendHeader(PageBuffer& buffer)
+{
+  buffer.append(kMAGIC);
+  buffer.append(static_cast<char>(kVERSION));
+}
+
+/**
+ * Appends a signed integer as a zigzag encoded varint, so small negative numbers stay small.
+ * @param buffer the destination buffer
+ * @param value the integer to encode
+ */
+void BinaryEncoding::appendSignedVarint(PageBuffer& buffer, int64_t value)
+{
+  appendVarint(buffer, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+}
+
+/**
+ * Appends a string as a varint length and the raw bytes.
+ * @param buffer the destination buffer
+ * @param value the string to encode
+ */
+void BinaryEncoding::appendString(PageBuffer& buffer, std::string_view value)
+{
+  appendVarint(buffer, value.size());
+  buffer.append(value);
+}
+
+/**
+ * Appends an unsigned integer as a LEB128 varint: 7 bits per byte, low bits first, with the high
+ * bit set on every byte but the last.
+ * @param buffer the destination buffer
+ * @param value the integer to encode
+ */
+void BinaryEncoding::appendVarint(PageBuffer& buffer, uint64_t value)
+{
+  char encoded[10];
+  int length = 0;
+  while(value >= 0x80)
+  {
+    encoded[length++] = static_cast<char>((value & 0x7F) | 0x80);
+    value >>= 7;
+  }
+  encoded[length++] = static_cast<char>(value);
+  buffer.append(encoded, length);
+}
+
+/**
+ * Returns the 32 bit FNV-1a checksum of the data. It's not cryptographic, only a check that a
+ * record was written whole and read back unchanged. Data in parts is checked by passing the
+ * checksum of each part to the next.
+ * @param data start of the data
+ * @param size size of the data
+ * @param hash checksum of the data before it. Default is none
+ * @return checksum of the data
+ */
+uint32_t BinaryEncoding::checksum(const char* data, size_t size, uint32_t hash)
+{
+  for(size_t i = 0; i < size; i++)
+    hash = (hash ^ static_cast<uint8_t>(data[i])) * 16777619u;
+  return hash;
+}
+
+/**
+ * Checks the file header at the start of the data.
+ * @param data start of the file content
+ * @param size size of the file content
+ * @return TRUE if the magic matches and the version is supported
+ */
+bool BinaryEncoding::isHeaderValid(const char* data, size_t size)
+{
+  return (size >= kHEADER_SIZE &&
+          std::memcmp(data, kMAGIC.data(), kMAGIC.size()) == 0 &&
+          static_cast<uint8_t>(data[kMAGIC.size()]) == kVERSION);
+}
+
+/**
+ * Decodes a 4 byte little endian unsigned integer at the cursor.
+ * @param cursor read location, advanced past the integer on success
+ * @param end end of the readable data
+ * @param value the decoded integer
+ * @return TRUE if there was enough data
+ */
+bool BinaryEncoding::readFixed32(const char*& cursor, const char* end, uint32_t& value)
+{
+  if(end - cursor < 4)
+    return false;
+
+  value = 0;
+  for(int i = 0; i < 4; i++)
+    value |= static_cast<uint32_t>(static_cast<uint8_t>(cursor[i])) << (8 * i);
+
+  cursor += 4;
+  return true;
+}
+
+/**
+ * Decodes a 4 byte little endian float at the cursor.
+ * @param cursor read location, advanced past the float on success
+ * @param end end of the readable data
+ * @param value the decoded float
+ * @return TRUE if there was enough data
+ */
+bool BinaryEncoding::readFloat(const char*& cursor, const char* end, float& value)
+{
+  uint32_t bits;
+  if(!readFixed32(cursor, end, bits))
+    return false;
+
+  std::memcpy(&value, &bits, sizeof(value));
+  return true;
+}
+
+/**
+ * Decodes a zigzag encoded varint at the cursor.
+ * @param cursor read location, advanced past the varint on success
+ * @param end end of the readable data
+ * @param value the decoded integer
+ * @return TRUE if the varint was well formed
+ */
+bool BinaryEncoding::readSignedVarint(const char*& cursor, const char* end, int64_t& value)
+{
+  uint64_t encoded;
+  if(!readVarint(cursor, end, encoded))
+    return false;
+
+  value = static_cast<int64_t>((encoded >> 1) ^ (~(encoded & 1) + 1));
+  return true;
+}
+
+/**
+ * Decodes a length prefixed string at the cursor, as a view into the data.
+ * @param cursor read location, advanced past the string on success
+ * @param end end of the readable data
+ * @param value view of the string bytes
+ * @return TRUE if the length was well formed and there was enough data
+ */
+bool BinaryEncoding::readString(const char*& cursor, const char* end, std::string_view& value)
+{
+  uint64_t length;
+  if(!readVarint(cursor, end, length) || static_cast<uint64_t>(end - cursor) < length)
+    return false;
+
+  value = std::string_view(cursor, length);
+  cursor += length;
+  return true;
+}
+
+/**
+ * Decodes a LEB128 varint at the cursor.
+ * @param cursor read location, advanced past the varint on success
+ * @param end end of the readable data
+ * @param value the decoded integer
+ * @return TRUE if the varint was terminated within 10 bytes and the readable data
+ */
+bool BinaryEncoding::readVarint(const char*& cursor, const char* end, uint64_t& value)
+{
+  value = 0;
+  for(int shift = 0; shift < 70 && cursor < end; shift += 7)
+  {
+    uint8_t byte = static_cast<uint8_t>(*cursor++);
+    value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+    if((byte & 0x80) == 0)
+      return true;
+  }
+  return false;
+}
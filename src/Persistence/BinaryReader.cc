@@ -0,0 +1,586 @@
+/**
+ * @class BinaryReader
+ *
+ * Reader implementation for the compact binary content format (see {@link BinaryEncoding}). It
+ * follows the same contract as the XML readers so all existing load code works unchanged, but
+ * data arrives already typed so nothing is parsed from text. The source file is memory mapped,
+ * and a compressed one is loaded a block at a time as the records are read. A REF record is read
+ * as the element it points to, so deduplicated files read back the same as the document that was
+ * written.
+ */
+#include "Persistence/BinaryReader.h"
+using namespace core;
+
+/*============================================================================
+ * CONSTRUCTORS / DESTRUCTORS
+ *===========================================================================*/
+
+/**
+ * Constructor function - Sets up the reader for the source file. Nothing is opened until start()
+ * is called.
+ * @param path file system path to the binary source file
+ */
+BinaryReader::BinaryReader(std::string path)
+            : path{path}
+{
+}
+
+/**
+ * Constructor function - Sets up a split reader that only reads a range of the source file. The
+ * range must start and end on element boundaries, within the elements of the wrapping branch.
+ * @param path file system path to the binary source file
+ * @param range_begin offset in the source where the range starts
+ * @param range_end offset in the source where the range ends
+ * @param range_branch elements that wrap the range, added to the front of every line
+ * @param range_dictionary dictionary entries defined in the source before the range
+ */
+BinaryReader::BinaryReader(std::string path, size_t range_begin, size_t range_end,
+                           XmlData range_branch, std::vector<std::string> range_dictionary)
+            : path{path},
+              range_begin{range_begin},
+              range_branch{range_branch},
+              range_dictionary{range_dictionary},
+              range_end{range_end}
+{
+}
+
+/**
+ * Destructor function, stops the reader if it is still started.
+ */
+BinaryReader::~BinaryReader()
+{
+  stopReadFromSource();
+}
+
+/*============================================================================
+ * PRIVATE FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Decodes the record at the read location and applies it: DICT grows the dictionary, OPEN and
+ * CLOSE move the branch and DATA fills in the data payload members. REF moves the read location
+ * to the earlier element it points to, until the CLOSE of that element returns it to the record
+ * after the REF. The DICT records in it were already read, so they are skipped. Nothing is
+ * applied and the read location doesn't move unless the record is well formed.
+ * @param end_offset offset that the record must end by
+ * @param type the tag of the decoded record
+ * @return TRUE if a record was decoded. FALSE if there is none before the end or it's malformed
+ */
+bool BinaryReader::decodeRecord(size_t end_offset, BinaryRecordType& type)
+{
+  const char* data = file.getData();
+  const char* cursor = data + offset;
+  const char* end = data + end_offset;
+  if(cursor >= end)
+    return false;
+
+  bool valid = false;
+  type = static_cast<BinaryRecordType>(*cursor++);
+  if(type == BinaryRecordType::CLOSE)
+  {
+    valid = (branch.getNumElements() > 0);
+    if(valid)
+      branch.removeLastElement();
+  }
+  else if(type == BinaryRecordType::DATA)
+  {
+    uint64_t name_id;
+    if(BinaryEncoding::readVarint(cursor, end, name_id) && name_id < dictionary.size() &&
+       cursor < end)
+    {
+      data_atom = dictionary_atom[name_id];
+      data_name = dictionary[name_id];
+      data_type = static_cast<DataType>(*cursor++);
+      if(data_type == DataType::BOOLEAN)
+      {
+        valid = (cursor < end);
+        if(valid)
+          data_boolean = (*cursor++ != 0);
+      }
+      else if(data_type == DataType::INTEGER)
+      {
+        int64_t value;
+        valid = BinaryEncoding::readSignedVarint(cursor, end, value);
+        data_integer = static_cast<int>(value);
+      }
+      else if(data_type == DataType::FLOAT)
+      {
+        valid = BinaryEncoding::readFloat(cursor, end, data_float);
+      }
+      else if(data_type == DataType::STRING)
+      {
+        valid = BinaryEncoding::readString(cursor, end, data_string);
+      }
+    }
+  }
+  else if(type == BinaryRecordType::DICT)
+  {
+    std::string_view entry;
+    valid = BinaryEncoding::readString(cursor, end, entry);
+    if(valid && ref_stack_offset.empty())
+    {
+      dictionary.emplace_back(entry);
+      dictionary_atom.push_back(AtomTable::fromName(entry));
+    }
+  }
+  else if(type == BinaryRecordType::OPEN)
+  {
+    uint64_t name_id;
+    uint64_t key_id;
+    std::string_view value;
+    valid = (BinaryEncoding::readVarint(cursor, end, name_id) && name_id < dictionary.size() &&
+             BinaryEncoding::readVarint(cursor, end, key_id) && key_id <= dictionary.size() &&
+             (key_id == 0 || BinaryEncoding::readString(cursor, end, value)));
+    if(valid)
+      branch.addElementBack(dictionary[name_id],
+                            key_id > 0 ? dictionary[key_id - 1] : std::string_view(),
+                            value, dictionary_atom[name_id],
+                            key_id > 0 ? dictionary_atom[key_id - 1] : Atom::NONE);
+  }
+  else if(type == BinaryRecordType::REF)
+  {
+    uint64_t ref_offset;
+    valid = (BinaryEncoding::readVarint(cursor, end, ref_offset) &&
+             ref_offset >= BinaryEncoding::kHEADER_SIZE && ref_offset < offset &&
+             file.load(ref_offset, ref_offset + 1) > ref_offset &&
+             static_cast<BinaryRecordType>(data[ref_offset]) == BinaryRecordType::OPEN);
+    if(valid)
+    {
+      ref_stack_depth.push_back(branch.getNumElements());
+      ref_stack_offset.push_back(offset);
+      ref_stack_return.push_back(cursor - data);
+      cursor = data + ref_offset;
+    }
+  }
+
+  if(valid)
+  {
+    offset = cursor - data;
+    if(type == BinaryRecordType::CLOSE && !ref_stack_depth.empty() &&
+       branch.getNumElements() == ref_stack_depth.back())
+    {
+      offset = ref_stack_return.back();
+      ref_stack_depth.pop_back();
+      ref_stack_offset.pop_back();
+      ref_stack_return.pop_back();
+    }
+  }
+  return valid;
+}
+
+/**
+ * Returns the offset where the read stops, which is the end of the range for a split reader.
+ * @return offset in the source. 0 if not started
+ */
+size_t BinaryReader::getReadEnd() const
+{
+  return std::min(file.getSize(), range_end);
+}
+
+/**
+ * Decodes the next record and applies it, as decodeRecord() does. The record is decoded from the
+ * content that's readable. If that runs out before the record is complete, as it can at the end
+ * of a block of a compressed source, it is decoded again once the next block is loaded.
+ * @param type the tag of the decoded record
+ * @return TRUE if a record was decoded. FALSE at the end of the source or if it is malformed
+ */
+bool BinaryReader::nextRecord(BinaryRecordType& type)
+{
+  // An element read through a reference must end before the REF record that points to it
+  size_t end_offset = (ref_stack_offset.empty() ? getReadEnd() : ref_stack_offset.back());
+  size_t readable = file.load(offset, offset + 1);
+  while(!decodeRecord(std::min(readable, end_offset), type))
+  {
+    if(readable >= end_offset)
+      return false;
+
+    size_t loaded = file.load(offset, readable + 1);
+    if(loaded <= readable)
+      return false;
+    readable = loaded;
+  }
+  return true;
+}
+
+/**
+ * Reads the next data element into the line by decoding records until a DATA record is reached.
+ * The line is assigned from the branch, which reuses the memory it holds.
+ * @param line set to the branch element that includes the full path location through the XML
+ *             wrapping the data. Untouched if no line was read
+ * @param done set when the end of the source has been reached and no line was read
+ * @param success set if the line was read. An unsuccessful read at the end is a malformed source
+ */
+void BinaryReader::readLine(XmlData& line, bool& done, bool& success)
+{
+  done = true;
+  success = false;
+  if(!file.isOpen())
+    return;
+
+  // Keep the resident memory of the mapping constant as the read moves forward
+  if(ref_stack_offset.empty() && offset - released_offset >= kRELEASE_INTERVAL)
+  {
+    released_offset = offset;
+    file.releaseBefore(released_offset);
+  }
+
+  BinaryRecordType type;
+  while(nextRecord(type))
+  {
+    if(type == BinaryRecordType::DATA)
+    {
+      line = branch;
+      line.addElementBack(data_name, XmlData::kKEY_DATA_TYPE,
+                          TextEncoding::formatInteger(static_cast<int>(data_type)), data_atom,
+                          Atom::TYPE);
+      if(data_type == DataType::BOOLEAN)
+        line.setDataOfType(data_boolean);
+      else if(data_type == DataType::INTEGER)
+        line.setDataOfType(data_integer);
+      else if(data_type == DataType::FLOAT)
+        line.setDataOfType(data_float);
+      else
+        line.setDataOfType(data_string);
+
+      done = false;
+      success = true;
+      return;
+    }
+  }
+
+  success = (offset == getReadEnd() &&
+             branch.getNumElements() == range_branch.getNumElements());
+}
+
+/**
+ * Resets the read location back to the first record (of the range), with the branch that wraps
+ * it and the dictionary defined before it.
+ */
+void BinaryReader::resetReadLocation()
+{
+  branch = range_branch;
+  dictionary.assign(range_dictionary.begin(), range_dictionary.end());
+  dictionary_atom.clear();
+  for(const std::string& entry : range_dictionary)
+    dictionary_atom.push_back(AtomTable::fromName(entry));
+  offset = range_begin;
+  ref_stack_depth.clear();
+  ref_stack_offset.clear();
+  ref_stack_return.clear();
+  released_offset = range_begin;
+}
+
+/*=============================================================================
+ * PRIVATE FUNCTIONS - XMLREADER
+ *============================================================================*/
+
+/**
+ * Finds an element node from the current read location by scanning forward through the records.
+ * The search is limited to the element that holds the current read location. If the branch is
+ * found, the next read() returns the first data element inside it. If it isn't, the read
+ * location is left untouched.
+ * @param branch the child branch to find. Any key left blank in the branch matches any key
+ * @return true if the path was found and the read pointer was moved
+ */
+bool BinaryReader::findInSource(XmlData branch)
+{
+  if(!file.isOpen())
+    return false;
+
+  XmlDataView target(branch);
+  int target_count = target.getNumElements();
+  if(target_count == 0)
+    return true;
+
+  // Keep the starting read location, to restore it if the branch isn't found
+  XmlData start_branch = this->branch;
+  size_t start_dictionary_size = dictionary.size();
+  size_t start_offset = offset;
+  std::vector<int> start_ref_stack_depth = ref_stack_depth;
+  std::vector<size_t> start_ref_stack_offset = ref_stack_offset;
+  std::vector<size_t> start_ref_stack_return = ref_stack_return;
+
+  int base_count = this->branch.getNumElements();
+  int matched_count = 0;
+  bool found = false;
+  BinaryRecordType type;
+  while(!found && nextRecord(type))
+  {
+    if(type == BinaryRecordType::OPEN)
+    {
+      // Only extends the match if all parent levels matched as well
+      XmlDataView branch_view(this->branch);
+      int top = branch_view.getNumElements() - 1;
+      int level = top - base_count;
+      if(level == matched_count && level < target_count &&
+         target.getElement(level) == branch_view.getElement(top) &&
+         (target.getKey(level).empty() ||
+          (target.getKey(level) == branch_view.getKey(top) &&
+           target.getKeyValue(level) == branch_view.getKeyValue(top))))
+      {
+        matched_count++;
+        found = (matched_count == target_count);
+      }
+    }
+    else if(type == BinaryRecordType::CLOSE)
+    {
+      // Left the element that held the starting read location
+      int level_count = this->branch.getNumElements() - base_count;
+      if(level_count < 0)
+        break;
+      else if(matched_count > level_count)
+        matched_count = level_count;
+    }
+  }
+
+  if(!found)
+  {
+    this->branch = start_branch;
+    dictionary.resize(start_dictionary_size);
+    dictionary_atom.resize(start_dictionary_size);
+    offset = start_offset;
+    ref_stack_depth = start_ref_stack_depth;
+    ref_stack_offset = start_ref_stack_offset;
+    ref_stack_return = start_ref_stack_return;
+  }
+  return found;
+}
+
+/**
+ * Checks if the reader has been started and the source file is mapped.
+ * @return true if start() has been called and the source is still available
+ */
+bool BinaryReader::isSourceAvailable()
+{
+  return file.isOpen();
+}
+
+/**
+ * Jumps the read location back to the start of the document.
+ * @return true if the reader is back at the root of the source for the next read()
+ */
+bool BinaryReader::jumpToRootInSource()
+{
+  if(!file.isOpen())
+    return false;
+
+  resetReadLocation();
+  return true;
+}
+
+/**
+ * Returns the last modified date of the source file, when the reader was started.
+ * @return UTC date formatted as YYYY-MM-DD HH:MM:SS. Blank if not started
+ */
+std::string BinaryReader::lastModifiedDateFromSource()
+{
+  return file.getModifiedDate();
+}
+
+/**
+ * Reads the next batch of data elements, filling each line of the buffer in place with the
+ * branch so the lines keep their memory from batch to batch.
+ * @param lines buffer of lines, at least count long
+ * @param count maximum number of lines to read
+ * @param done set when the end of the source has been reached
+ * @param success set if all lines were read and, at the end, the source was well formed
+ * @return number of lines read into the front of the buffer
+ */
+size_t BinaryReader::readBatchFromSource(std::vector<XmlData>& lines, size_t count, bool& done,
+                                         bool& success)
+{
+  size_t read_count = 0;
+  done = false;
+  success = true;
+  while(read_count < count && !done)
+  {
+    readLine(lines[read_count], done, success);
+    if(!done)
+      read_count++;
+  }
+  return read_count;
+}
+
+/**
+ * Reads the next data element by decoding records until a DATA record is reached.
+ * @param done set when the end of the source has been reached and no line was returned
+ * @param success set if the line was read. An unsuccessful read at the end is a malformed source
+ * @return branch element that includes the full path location through the XML wrapping the data
+ */
+XmlData BinaryReader::readFromSource(bool& done, bool& success)
+{
+  XmlData line(getMemoryResource());
+  readLine(line, done, success);
+  return line;
+}
+
+/**
+ * Maps the source file, validates the header and moves the read location to the first record.
+ * If the reader was already started, it is restarted.
+ * @return success status of opening the file. false if it is not a supported binary file
+ */
+bool BinaryReader::startReadFromSource()
+{
+  if(!file.open(path))
+    return false;
+
+  file.load(0, BinaryEncoding::kHEADER_SIZE);
+  if(!BinaryEncoding::isHeaderValid(file.getData(), file.getSize()))
+  {
+    file.close();
+    return false;
+  }
+
+  total_data_count = -1;
+  resetReadLocation();
+  return true;
+}
+
+/**
+ * Unmaps and closes the source file.
+ * @return success status of cleaning up. Always true
+ */
+bool BinaryReader::stopReadFromSource()
+{
+  file.close();
+  total_data_count = -1;
+  resetReadLocation();
+  return true;
+}
+
+/**
+ * Counts the total number of DATA records in the source. This scans the entire source once and
+ * is cached for the rest of the read. The read location is left untouched.
+ * @return total count. 0 if not started
+ */
+int BinaryReader::totalDataCountFromSource()
+{
+  if(!file.isOpen())
+    return 0;
+
+  if(total_data_count < 0)
+  {
+    XmlData start_branch = branch;
+    std::vector<std::string> start_dictionary = dictionary;
+    std::vector<Atom> start_dictionary_atom = dictionary_atom;
+    size_t start_offset = offset;
+    std::vector<int> start_ref_stack_depth = ref_stack_depth;
+    std::vector<size_t> start_ref_stack_offset = ref_stack_offset;
+    std::vector<size_t> start_ref_stack_return = ref_stack_return;
+    size_t start_released_offset = released_offset;
+
+    resetReadLocation();
+    total_data_count = 0;
+    BinaryRecordType type;
+    while(nextRecord(type))
+    {
+      if(type == BinaryRecordType::DATA)
+        total_data_count++;
+    }
+    file.releaseBefore(getReadEnd());
+
+    branch = start_branch;
+    dictionary = start_dictionary;
+    dictionary_atom = start_dictionary_atom;
+    offset = start_offset;
+    ref_stack_depth = start_ref_stack_depth;
+    ref_stack_offset = start_ref_stack_offset;
+    ref_stack_return = start_ref_stack_return;
+    released_offset = start_released_offset;
+  }
+
+  return total_data_count;
+}
+
+/**
+ * Splits the source into independent readers over contiguous runs of the top-level elements.
+ * The records are scanned once to find where each top-level element starts and how much of the
+ * dictionary is defined by then. The runs are then balanced by size. A split reader can not be
+ * split again.
+ * @param shard_count maximum number of readers to split into
+ * @return split readers in document order. Empty if the source is malformed or has no top-level
+ *         elements
+ */
+std::vector<std::unique_ptr<XmlReader>> BinaryReader::splitSource(int shard_count)
+{
+  std::vector<std::unique_ptr<XmlReader>> shards;
+  BinaryReader scanner(path);
+  if(shard_count < 1 || range_branch.getNumElements() > 0 || !scanner.start())
+    return shards;
+
+  // Find the root element and the start of each top-level element inside it
+  XmlData root;
+  std::vector<size_t> element_begin;
+  std::vector<size_t> element_dictionary_size;
+  size_t elements_end = 0;
+  size_t record_offset = scanner.offset;
+  BinaryRecordType type;
+  while(true)
+  {
+    // Only the records of the source itself start elements, not those read through a reference
+    bool referenced = !scanner.ref_stack_offset.empty();
+    if(!scanner.nextRecord(type))
+      break;
+
+    int depth = scanner.branch.getNumElements();
+    if(type == BinaryRecordType::OPEN && depth == 1)
+    {
+      // Only a single root element can be split
+      if(root.getNumElements() > 0)
+        return shards;
+      root = scanner.branch;
+    }
+    else if(!referenced && ((type == BinaryRecordType::OPEN && depth == 2) ||
+                            (type == BinaryRecordType::DATA && depth == 1) ||
+                            (type == BinaryRecordType::REF && depth == 1)))
+    {
+      element_begin.push_back(record_offset);
+      element_dictionary_size.push_back(scanner.dictionary.size());
+    }
+
+    if((type == BinaryRecordType::CLOSE || type == BinaryRecordType::DATA) && depth == 1)
+      elements_end = scanner.offset;
+    record_offset = scanner.offset;
+  }
+  if(scanner.offset != scanner.getReadEnd() || scanner.branch.getNumElements() > 0 ||
+     element_begin.empty())
+    return shards;
+
+  // Cut the runs at the first element start past each even share of the size
+  size_t count = std::min(static_cast<size_t>(shard_count), element_begin.size());
+  size_t total_size = elements_end - element_begin.front();
+  std::vector<size_t> boundaries = {0};
+  for(size_t i = 1, next = 0; i < count; i++)
+  {
+    size_t target = element_begin.front() + total_size * i / count;
+    while(next < element_begin.size() && element_begin[next] < target)
+      next++;
+    if(next < element_begin.size() && next > boundaries.back())
+      boundaries.push_back(next);
+  }
+
+  for(size_t i = 0; i < boundaries.size(); i++)
+  {
+    size_t first = boundaries[i];
+    size_t begin = element_begin[first];
+    size_t end = (i + 1 < boundaries.size() ? element_begin[boundaries[i + 1]] : elements_end);
+    size_t dictionary_size = element_dictionary_size[first];
+    std::vector<std::string> dictionary(scanner.dictionary.begin(),
+                                        scanner.dictionary.begin() + dictionary_size);
+    shards.emplace_back(new BinaryReader(path, begin, end, root, dictionary));
+  }
+  return shards;
+}
+
+/*============================================================================
+ * PUBLIC FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Returns the path to the source file that is read.
+ * @return file system path
+ */
+std::string BinaryReader::getPath() const
+{
+  return path;
+}
@@ -0,0 +1,499 @@
+/**
+ * @class BinaryWriter
+ *
+ * Writer implementation for the compact binary content format (see {@link BinaryEncoding}). It
+ * follows the same contract as the XML writers so all existing save code works unchanged.
+ * Element names and attribute keys are dictionary coded on first use and data is stored typed,
+ * so nothing needs to be formatted to text. Like the buffered XML writer, the whole document is
+ * built in a paged memory buffer and only flushed to the file by stop(true), optionally
+ * compressed with {@link BlockCompression}.
+ *
+ * With deduplication enabled, each closed element is keyed by its content and an element that
+ * repeats an earlier one is replaced by a REF record to it, so copied event chains and locks are
+ * stored once per file. The key is the element's own records with each large child replaced by
+ * the offset of its first copy, so it is exact and only as long as the element's direct content.
+ */
+#include "Persistence/BinaryWriter.h"
+using namespace core;
+
+/*============================================================================
+ * CONSTRUCTORS / DESTRUCTORS
+ *===========================================================================*/
+
+/**
+ * Constructor function - Sets up the writer for the destination file. Nothing is written until
+ * the writer is stopped with changes saved.
+ * @param path file system path to the destination binary file
+ */
+BinaryWriter::BinaryWriter(std::string path)
+            : path{path}
+{
+}
+
+/*============================================================================
+ * PRIVATE FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Returns the dictionary id of the string. The first time a string is used, a DICT record is
+ * appended to define it with the next id.
+ * @param value element name or attribute key
+ * @return dictionary id
+ */
+uint32_t BinaryWriter::defineString(const std::string& value)
+{
+  auto found = dictionary_ids.find(value);
+  if(found != dictionary_ids.end())
+    return found->second;
+
+  uint32_t id = static_cast<uint32_t>(dictionary.size());
+  buffer.append(static_cast<char>(BinaryRecordType::DICT));
+  BinaryEncoding::appendString(buffer, value);
+  dictionary.push_back(value);
+  dictionary_ids.emplace(value, id);
+  return id;
+}
+
+/**
+ * Closes the subtree of the element that was just closed. If it's large enough to be worth a
+ * reference and repeats an earlier element, it's replaced by a REF record to the first copy.
+ * A repeat can't define any dictionary entries, since its key would then hold a new id, so
+ * nothing but its records is removed. Its key is then added to the key of the parent: the offset
+ * of the first copy, or the whole key if it's too small to be referenced.
+ */
+void BinaryWriter::deduplicate()
+{
+  std::string key = std::move(stack_key.back());
+  size_t open_offset = stack_open_offset.back();
+  stack_key.pop_back();
+  stack_key_open_size.pop_back();
+  stack_open_offset.pop_back();
+
+  if(buffer.getSize() - open_offset >= kMIN_SUBTREE_SIZE)
+  {
+    auto subtree = subtree_offsets.emplace(std::move(key), open_offset);
+    size_t subtree_offset = subtree.first->second;
+    if(!subtree.second)
+    {
+      buffer.truncate(open_offset);
+      buffer.append(static_cast<char>(BinaryRecordType::REF));
+      BinaryEncoding::appendVarint(buffer, subtree_offset);
+    }
+
+    key.assign(1, static_cast<char>(BinaryRecordType::REF));
+    key.append(reinterpret_cast<const char*>(&subtree_offset), sizeof(subtree_offset));
+  }
+
+  if(!stack_key.empty())
+    stack_key.back() += key;
+}
+
+/**
+ * Adds the record that ends at the end of the buffer to the key of the open element, if the
+ * document is deduplicated.
+ * @param record_offset offset in the buffer where the record starts
+ */
+void BinaryWriter::endRecord(size_t record_offset)
+{
+  if(!deduplicating || stack_key.empty())
+    return;
+
+  std::string& key = stack_key.back();
+  size_t key_size = key.size();
+  size_t record_size = buffer.getSize() - record_offset;
+  key.resize(key_size + record_size);
+  buffer.copyTo(record_offset, record_size, &key[key_size]);
+}
+
+/**
+ * Rolls the buffer and the dictionary back to an earlier state. Any dictionary entries defined
+ * in the truncated content are forgotten, since their DICT records are gone. The same goes for
+ * the elements that can be referenced.
+ * @param content_offset the buffer size to truncate back to
+ * @param dictionary_size the dictionary size at that offset
+ */
+void BinaryWriter::truncate(size_t content_offset, size_t dictionary_size)
+{
+  buffer.truncate(content_offset);
+  while(dictionary.size() > dictionary_size)
+  {
+    dictionary_ids.erase(dictionary.back());
+    dictionary.pop_back();
+  }
+
+  for(auto subtree = subtree_offsets.begin(); subtree != subtree_offsets.end();)
+  {
+    if(subtree->second >= content_offset)
+      subtree = subtree_offsets.erase(subtree);
+    else
+      ++subtree;
+  }
+}
+
+/**
+ * Appends the start of a data record: the tag, the name id and the data type. The caller
+ * appends the typed payload and then ends the record.
+ * @param element name of the data element
+ * @param type category of the payload that follows
+ * @return offset in the buffer where the data record starts, after any DICT record
+ */
+size_t BinaryWriter::writeDataHeader(const std::string& element, DataType type)
+{
+  uint32_t name_id = defineString(element);
+  size_t record_offset = buffer.getSize();
+  buffer.append(static_cast<char>(BinaryRecordType::DATA));
+  BinaryEncoding::appendVarint(buffer, name_id);
+  buffer.append(static_cast<char>(type));
+  return record_offset;
+}
+
+/*=============================================================================
+ * PRIVATE FUNCTIONS - XMLWRITER
+ *============================================================================*/
+
+/**
+ * Deletes all child elements and data nodes beneath the current write location, by truncating
+ * the buffer back to the end of the current element open record.
+ * @return true if the writer is started
+ */
+bool BinaryWriter::deleteChildrenFromSource()
+{
+  if(!started)
+    return false;
+
+  if(stack_content_offset.size() > 0)
+    truncate(stack_content_offset.back(), stack_dictionary_size.back());
+  else
+    truncate(BinaryEncoding::kHEADER_SIZE, 0);
+
+  if(!stack_key.empty())
+    stack_key.back().resize(stack_key_open_size.back());
+  return true;
+}
+
+/**
+ * Finds a lower child node from the current node location. Written nodes can not be revisited in
+ * an append only document, so only an empty branch (the current location) is found.
+ * @param branch the child branch to find
+ * @return true only if the branch is empty and the writer is started
+ */
+bool BinaryWriter::findInSource(XmlData branch)
+{
+  return (started && XmlDataView(branch).getNumElements() == 0);
+}
+
+/**
+ * Checks if the writer has been started.
+ * @return true if start() has been called and stop() has not been called since
+ */
+bool BinaryWriter::isSourceAvailable()
+{
+  return started;
+}
+
+/**
+ * Jumps the write location up one level by closing the current element.
+ * @return true if the writer is started, even if already at the root
+ */
+bool BinaryWriter::jumpToParentInSource()
+{
+  if(!started)
+    return false;
+
+  if(stack_content_offset.size() > 0)
+  {
+    size_t record_offset = buffer.getSize();
+    buffer.append(static_cast<char>(BinaryRecordType::CLOSE));
+    endRecord(record_offset);
+    stack_content_offset.pop_back();
+    stack_dictionary_size.pop_back();
+    if(deduplicating)
+      deduplicate();
+  }
+  return true;
+}
+
+/**
+ * Jumps the write location back to the root by closing all open elements.
+ * @return true if the writer is started
+ */
+bool BinaryWriter::jumpToRootInSource()
+{
+  if(!started)
+    return false;
+
+  while(stack_content_offset.size() > 0)
+    jumpToParentInSource();
+  return true;
+}
+
+/**
+ * Starts a new blank document in the buffer. If the writer was already started, any unsaved
+ * changes are discarded.
+ * @return success status of beginning the write. Always true
+ */
+bool BinaryWriter::startWriteToSource()
+{
+  truncate(0, 0);
+  stack_content_offset.clear();
+  stack_dictionary_size.clear();
+  stack_key.clear();
+  stack_key_open_size.clear();
+  stack_open_offset.clear();
+  deduplicating = deduplication_enabled;
+
+  BinaryEncoding::appendHeader(buffer);
+  started = true;
+  return true;
+}
+
+/**
+ * Stops the writer. When saving, all open elements are closed and the document is flushed to
+ * the destination file. Either way, the buffer is truncated for the next start.
+ * @param save_changes true to write the document to the file. false to discard it
+ * @return success status of the flush, if saving. false if not started
+ */
+bool BinaryWriter::stopWriteToSource(bool save_changes)
+{
+  if(!started)
+    return false;
+
+  bool success = true;
+  if(save_changes)
+  {
+    jumpToRootInSource();
+    if(compression_enabled)
+      success = BlockCompression::writeToFile(buffer, path);
+    else
+      success = buffer.writeToFile(path);
+  }
+
+  truncate(0, 0);
+  stack_content_offset.clear();
+  stack_dictionary_size.clear();
+  stack_key.clear();
+  stack_key_open_size.clear();
+  stack_open_offset.clear();
+  started = false;
+  return success;
+}
+
+/**
+ * Writes a data element from its string form, converted to the typed binary payload.
+ * @param element name of the data element
+ * @param type category of the data
+ * @param data string converted data
+ * @return true if the data converted to the type and was written
+ */
+bool BinaryWriter::writeDataToSource(std::string element, DataType type, std::string data)
+{
+  bool boolean_data;
+  float float_data;
+  int integer_data;
+  if(type == DataType::BOOLEAN && TextEncoding::readBoolean(data, boolean_data))
+    return writeDataToSource(element, boolean_data);
+  else if(type == DataType::INTEGER && TextEncoding::readInteger(data, integer_data))
+    return writeDataToSource(element, integer_data);
+  else if(type == DataType::FLOAT && TextEncoding::readFloat(data, float_data))
+    return writeDataToSource(element, float_data);
+  else if(type == DataType::STRING)
+    return writeDataToSource(element, data);
+  return false;
+}
+
+/**
+ * Writes a boolean data element as a single byte.
+ * @param element name of the data element
+ * @param data boolean to store
+ * @return true if the writer is started and the element name is valid
+ */
+bool BinaryWriter::writeDataToSource(std::string element, bool data)
+{
+  if(!started || element.empty())
+    return false;
+
+  size_t record_offset = writeDataHeader(element, DataType::BOOLEAN);
+  buffer.append(static_cast<char>(data ? 1 : 0));
+  endRecord(record_offset);
+  return true;
+}
+
+/**
+ * Writes a float data element as its raw 4 byte pattern.
+ * @param element name of the data element
+ * @param data float to store
+ * @return true if the writer is started and the element name is valid
+ */
+bool BinaryWriter::writeDataToSource(std::string element, float data)
+{
+  if(!started || element.empty())
+    return false;
+
+  size_t record_offset = writeDataHeader(element, DataType::FLOAT);
+  BinaryEncoding::appendFloat(buffer, data);
+  endRecord(record_offset);
+  return true;
+}
+
+/**
+ * Writes an integer data element as a zigzag varint.
+ * @param element name of the data element
+ * @param data integer to store
+ * @return true if the writer is started and the element name is valid
+ */
+bool BinaryWriter::writeDataToSource(std::string element, int data)
+{
+  if(!started || element.empty())
+    return false;
+
+  size_t record_offset = writeDataHeader(element, DataType::INTEGER);
+  BinaryEncoding::appendSignedVarint(buffer, data);
+  endRecord(record_offset);
+  return true;
+}
+
+/**
+ * Writes a string data element as a length and the raw bytes.
+ * @param element name of the data element
+ * @param data string to store
+ * @return true if the writer is started and the element name is valid
+ */
+bool BinaryWriter::writeDataToSource(std::string element, std::string data)
+{
+  if(!started || element.empty())
+    return false;
+
+  size_t record_offset = writeDataHeader(element, DataType::STRING);
+  BinaryEncoding::appendString(buffer, data);
+  endRecord(record_offset);
+  return true;
+}
+
+/**
+ * Writes an unsigned integer data element. It is stored under the general integer data type, as
+ * its full unsigned value.
+ * @param element name of the data element
+ * @param data unsigned integer to store
+ * @return true if the writer is started and the element name is valid
+ */
+bool BinaryWriter::writeDataToSource(std::string element, uint32_t data)
+{
+  if(!started || element.empty())
+    return false;
+
+  size_t record_offset = writeDataHeader(element, DataType::INTEGER);
+  BinaryEncoding::appendSignedVarint(buffer, static_cast<int64_t>(data));
+  endRecord(record_offset);
+  return true;
+}
+
+/**
+ * Writes the open record of a new child element at the current location and moves inside it.
+ * @param element name of the element
+ * @param key optional attribute key. Blank for none
+ * @param value attribute value paired with the key
+ * @return true if the writer is started and the element name is valid
+ */
+bool BinaryWriter::writeElementToSource(std::string element, std::string key, std::string value)
+{
+  if(!started || element.empty())
+    return false;
+
+  uint32_t name_id = defineString(element);
+  uint32_t key_id = (key.empty() ? 0 : defineString(key) + 1);
+
+  size_t record_offset = buffer.getSize();
+  buffer.append(static_cast<char>(BinaryRecordType::OPEN));
+  BinaryEncoding::appendVarint(buffer, name_id);
+  BinaryEncoding::appendVarint(buffer, key_id);
+  if(key_id > 0)
+    BinaryEncoding::appendString(buffer, value);
+
+  stack_content_offset.push_back(buffer.getSize());
+  stack_dictionary_size.push_back(dictionary.size());
+  if(deduplicating)
+  {
+    stack_key.emplace_back();
+    endRecord(record_offset);
+    stack_key_open_size.push_back(stack_key.back().size());
+    stack_open_offset.push_back(record_offset);
+  }
+  return true;
+}
+
+/**
+ * Writes each element in the set as a nested child, moving inside the last one.
+ * @param element_set branch elements to write at the current location
+ * @return true if all elements were written
+ */
+bool BinaryWriter::writeElementsToSource(XmlData element_set)
+{
+  XmlDataView elements(element_set);
+  bool success = started;
+  for(int i = 0; success && i < elements.getNumElements(); i++)
+    success = writeElementToSource(std::string(elements.getElement(i)),
+                                   std::string(elements.getKey(i)),
+                                   std::string(elements.getKeyValue(i)));
+  return success;
+}
+
+/*============================================================================
+ * PUBLIC FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Returns the size of the document written so far, including the header.
+ * @return size in bytes
+ */
+size_t BinaryWriter::getBufferSize() const
+{
+  return buffer.getSize();
+}
+
+/**
+ * Returns the path to the destination file that is written.
+ * @return file system path
+ */
+std::string BinaryWriter::getPath() const
+{
+  return path;
+}
+
+/**
+ * Returns if the file is compressed with {@link BlockCompression} when it's saved.
+ * @return TRUE if compressed
+ */
+bool BinaryWriter::isCompressionEnabled() const
+{
+  return compression_enabled;
+}
+
+/**
+ * Returns if repeated elements are replaced by references to their first copy.
+ * @return TRUE if deduplicated
+ */
+bool BinaryWriter::isDeduplicationEnabled() const
+{
+  return deduplication_enabled;
+}
+
+/**
+ * Sets if the file is compressed with {@link BlockCompression} when it's saved. Readers inflate
+ * the file as it's opened, so it reads back the same either way.
+ * @param enabled TRUE to compress
+ */
+void BinaryWriter::setCompressionEnabled(bool enabled)
+{
+  compression_enabled = enabled;
+}
+
+/**
+ * Sets if repeated elements are replaced by references to their first copy. Readers replay a
+ * reference as the element it points to, so it reads back the same either way. Takes effect from
+ * the next start().
+ * @param enabled TRUE to deduplicate
+ */
+void BinaryWriter::setDeduplicationEnabled(bool enabled)
+{
+  deduplication_enabled = enabled;
+}
@@ -0,0 +1,417 @@
+/**
+ * @class BlockCompression
+ *
+ * Streaming block compression stage between the reader and writer backends and the file. The
+ * content is cut into fixed size blocks that are each compressed on their own with a small LZ77
+ * codec, so blocks are compressed and decompressed in parallel, or one at a time as they're
+ * needed. {@link MappedFile} decodes the blocks of a compressed file as the reader backends reach
+ * them, so every backend handles one.
+ *
+ * A compressed file is the magic "FISZ" and a version byte, the content size and block size
+ * (varints), then a varint per block of its compressed size shifted left one, with the low bit
+ * set if the block is stored raw instead, and then the blocks themselves. Each block is a
+ * sequence of a token byte (literal count in the high nibble, match length - 4 in the low
+ * nibble, 15 meaning more length bytes follow, each adding up to 255), the literals, and a 2 byte
+ * little endian match offset and its length bytes. The last sequence of a block is only literals.
+ */
+#include "Persistence/BlockCompression.h"
+using namespace core;
+
+/* Constant Implementation - see header file for descriptions */
+const std::string BlockCompression::kMAGIC = "FISZ";
+
+/*============================================================================
+ * PRIVATE STATIC FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Appends a length to an LZ block, after its nibble in the token was set to 15.
+ * @param block the block being compressed
+ * @param length the length left over after the 15 in the nibble
+ */
+void BlockCompression::appendLength(std::string& block, size_t length)
+{
+  while(length >= 255)
+  {
+    block.push_back(static_cast<char>(255));
+    length -= 255;
+  }
+  block.push_back(static_cast<char>(length));
+}
+
+/**
+ * Compresses a single block of content. Matches are found greedily through a hash of the next 4
+ * bytes, and the search steps further ahead the longer it goes without a match, so data that
+ * doesn't compress passes through quickly.
+ * @param data start of the block content
+ * @param size size of the block content. At most kBLOCK_SIZE
+ * @param block set to the compressed block
+ */
+void BlockCompression::compressBlock(const char* data, size_t size, std::string& block)
+{
+  const uint8_t* input = reinterpret_cast<const uint8_t*>(data);
+  std::vector<uint32_t> table(static_cast<size_t>(1) << kHASH_BITS, UINT32_MAX);
+  block.clear();
+  block.reserve(size + size / 255 + 16);
+
+  size_t literal_start = 0;
+  size_t match_limit = (size > kMATCH_END_GUARD ? size - kMATCH_END_GUARD : 0);
+  size_t position = 0;
+  while(position < match_limit)
+  {
+    uint32_t sequence;
+    std::memcpy(&sequence, input + position, sizeof(sequence));
+    uint32_t hash = (sequence * 2654435761U) >> (32 - kHASH_BITS);
+    size_t candidate = table[hash];
+    table[hash] = static_cast<uint32_t>(position);
+
+    if(candidate == UINT32_MAX || position - candidate > kMAX_OFFSET ||
+       std::memcmp(input + candidate, input + position, kMATCH_MIN) != 0)
+    {
+      position += 1 + ((position - literal_start) >> 6);
+      continue;
+    }
+
+    size_t length = kMATCH_MIN;
+    while(position + length < size && input[candidate + length] == input[position + length])
+      length++;
+
+    size_t literal_count = position - literal_start;
+    size_t match_extra = length - kMATCH_MIN;
+    block.push_back(static_cast<char>(((literal_count < 15 ? literal_count : 15) << 4) |
+                                      (match_extra < 15 ? match_extra : 15)));
+    if(literal_count >= 15)
+      appendLength(block, literal_count - 15);
+    block.append(data + literal_start, literal_count);
+
+    size_t offset = position - candidate;
+    block.push_back(static_cast<char>(offset & 0xFF));
+    block.push_back(static_cast<char>(offset >> 8));
+    if(match_extra >= 15)
+      appendLength(block, match_extra - 15);
+
+    position += length;
+    literal_start = position;
+  }
+
+  size_t literal_count = size - literal_start;
+  block.push_back(static_cast<char>((literal_count < 15 ? literal_count : 15) << 4));
+  if(literal_count >= 15)
+    appendLength(block, literal_count - 15);
+  block.append(data + literal_start, literal_count);
+}
+
+/**
+ * Decompresses a single block. Every length and offset is checked against both buffers, so a
+ * corrupt block fails instead of reading or writing out of bounds.
+ * @param block start of the compressed block
+ * @param block_size size of the compressed block
+ * @param data destination for the content
+ * @param size exact size of the block content
+ * @return TRUE if the block was well formed and filled the destination exactly
+ */
+bool BlockCompression::decompressBlock(const char* block, size_t block_size, char* data,
+                                       size_t size)
+{
+  const uint8_t* cursor = reinterpret_cast<const uint8_t*>(block);
+  const uint8_t* end = cursor + block_size;
+  char* output = data;
+  char* output_end = data + size;
+  while(cursor < end)
+  {
+    uint8_t token = *cursor++;
+    size_t literal_count = (token >> 4);
+    if(literal_count == 15 && !readLength(cursor, end, literal_count))
+      return false;
+    if(literal_count > static_cast<size_t>(end - cursor) ||
+       literal_count > static_cast<size_t>(output_end - output))
+      return false;
+    std::memcpy(output, cursor, literal_count);
+    cursor += literal_count;
+    output += literal_count;
+
+    // The last sequence is only literals
+    if(cursor == end)
+      return (output == output_end);
+
+    if(end - cursor < 2)
+      return false;
+    size_t offset = cursor[0] | (static_cast<size_t>(cursor[1]) << 8);
+    cursor += 2;
+    size_t length = (token & 0x0F);
+    if(length == 15 && !readLength(cursor, end, length))
+      return false;
+    length += kMATCH_MIN;
+    if(offset == 0 || offset > static_cast<size_t>(output - data) ||
+       length > static_cast<size_t>(output_end - output))
+      return false;
+
+    // Overlapping matches repeat the bytes just written, so they're copied forward one at a time
+    const char* match = output - offset;
+    if(offset >= length)
+      std::memcpy(output, match, length);
+    else
+      for(size_t i = 0; i < length; i++)
+        output[i] = match[i];
+    output += length;
+  }
+  return false;
+}
+
+/**
+ * Reads a length from an LZ block, after its nibble in the token was 15.
+ * @param cursor read location, advanced past the length bytes
+ * @param end end of the block
+ * @param length the nibble value, with the length bytes added to it
+ * @return TRUE if the length bytes were complete
+ */
+bool BlockCompression::readLength(const uint8_t*& cursor, const uint8_t* end, size_t& length)
+{
+  uint8_t value;
+  do
+  {
+    if(cursor == end)
+      return false;
+    value = *cursor++;
+    length += value;
+  } while(value == 255);
+  return true;
+}
+
+/**
+ * Runs the task for every block index. Blocks are handed out to the worker threads one at a
+ * time, so uneven blocks still balance. A single worker runs on the calling thread. Any exception
+ * thrown by a task is held until all workers are joined and then rethrown.
+ * @param block_count number of blocks
+ * @param thread_count maximum number of worker threads. 0 to use one per hardware thread
+ * @param task handles the block at the index. Returns its success
+ * @return TRUE if every task was successful
+ */
+bool BlockCompression::runBlocks(size_t block_count, unsigned int thread_count,
+                                 std::function<bool(size_t)> task)
+{
+  if(thread_count == 0)
+    thread_count = std::thread::hardware_concurrency();
+  if(thread_count > block_count)
+    thread_count = static_cast<unsigned int>(block_count);
+
+  if(thread_count <= 1)
+  {
+    bool success = true;
+    for(size_t i = 0; i < block_count && success; i++)
+      success = task(i);
+    return success;
+  }
+
+  std::atomic<size_t> next_block{0};
+  std::atomic<bool> success{true};
+  std::vector<std::exception_ptr> errors(thread_count);
+  std::vector<std::thread> workers;
+  for(unsigned int i = 0; i < thread_count; i++)
+  {
+    workers.emplace_back([&, i]()
+    {
+      try
+      {
+        for(size_t block = next_block++; block < block_count && success; block = next_block++)
+          if(!task(block))
+            success = false;
+      }
+      catch(...)
+      {
+        errors[i] = std::current_exception();
+        success = false;
+      }
+    });
+  }
+  for(std::thread& worker : workers)
+    worker.join();
+
+  for(std::exception_ptr& error : errors)
+    if(error)
+      std::rethrow_exception(error);
+  return success;
+}
+
+/*============================================================================
+ * PUBLIC STATIC FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Compresses the content into the destination, as a whole compressed file. Any block that doesn't
+ * get smaller is stored raw.
+ * @param source the content to compress
+ * @param destination buffer the compressed file is appended to
+ * @param thread_count maximum number of worker threads. 0 to use one per hardware thread
+ */
+void BlockCompression::compress(const PageBuffer& source, PageBuffer& destination,
+                                unsigned int thread_count)
+{
+  size_t content_size = source.getSize();
+  size_t block_count = (content_size + kBLOCK_SIZE - 1) / kBLOCK_SIZE;
+  std::vector<std::string> blocks(block_count);
+  std::vector<char> stored(block_count, false);
+
+  runBlocks(block_count, thread_count, [&](size_t index)
+  {
+    size_t offset = index * kBLOCK_SIZE;
+    size_t length = (content_size - offset < kBLOCK_SIZE ? content_size - offset : kBLOCK_SIZE);
+    std::string raw(length, '\0');
+    source.copyTo(offset, length, &raw[0]);
+
+    compressBlock(raw.data(), length, blocks[index]);
+    if(blocks[index].size() >= length)
+    {
+      blocks[index].swap(raw);
+      stored[index] = true;
+    }
+    return true;
+  });
+
+  destination.append(kMAGIC);
+  destination.append(static_cast<char>(kVERSION));
+  BinaryEncoding::appendVarint(destination, content_size);
+  BinaryEncoding::appendVarint(destination, kBLOCK_SIZE);
+  for(size_t i = 0; i < block_count; i++)
+    BinaryEncoding::appendVarint(destination, (blocks[i].size() << 1) | (stored[i] ? 1 : 0));
+  for(const std::string& block : blocks)
+    destination.append(block);
+}
+
+/**
+ * Decompresses a whole compressed file into new memory. The block table is read first, so every
+ * block can be found and decompressed in parallel.
+ * @param data start of the compressed file
+ * @param size size of the compressed file
+ * @param content set to the new memory holding the content. Untouched on failure
+ * @param content_size set to the size of the content
+ * @param thread_count maximum number of worker threads. 0 to use one per hardware thread
+ * @return TRUE if the file was well formed and fully decompressed
+ */
+bool BlockCompression::decompress(const char* data, size_t size,
+                                  std::unique_ptr<char[]>& content, size_t& content_size,
+                                  unsigned int thread_count)
+{
+  BlockTable table;
+  if(!readBlockTable(data, size, table))
+    return false;
+
+  std::unique_ptr<char[]> decompressed(new char[table.content_size]);
+  bool success = runBlocks(table.offsets.size(), thread_count, [&](size_t index)
+  {
+    return decompressBlock(table, index, decompressed.get());
+  });
+  if(!success)
+    return false;
+
+  content = std::move(decompressed);
+  content_size = table.content_size;
+  return true;
+}
+
+/**
+ * Decompresses a single block of a compressed file into its place in the content, which is at
+ * the block index times the block size. Only that block of the content is written.
+ * @param table block table of the compressed file, which must still be in memory
+ * @param index index of the block in the table
+ * @param content start of the content, at least the content size of the table long
+ * @return TRUE if the block was well formed and filled its place in the content exactly
+ */
+bool BlockCompression::decompressBlock(const BlockTable& table, size_t index, char* content)
+{
+  if(index >= table.offsets.size())
+    return false;
+
+  size_t offset = index * table.block_size;
+  size_t length = std::min(table.content_size - offset, table.block_size);
+  const char* block = table.blocks + table.offsets[index];
+  if(!table.stored[index])
+    return decompressBlock(block, table.sizes[index], content + offset, length);
+  if(table.sizes[index] != length)
+    return false;
+  std::memcpy(content + offset, block, length);
+  return true;
+}
+
+/**
+ * Returns if the data starts with the magic of a compressed file. The version is only checked
+ * when it's decompressed.
+ * @param data start of the file content
+ * @param size size of the file content
+ * @return TRUE if compressed
+ */
+bool BlockCompression::isCompressed(const char* data, size_t size)
+{
+  return (data != nullptr && size >= kMAGIC.size() &&
+          std::memcmp(data, kMAGIC.data(), kMAGIC.size()) == 0);
+}
+
+/**
+ * Reads the block table from the header of a compressed file. The sizes in the header are checked
+ * against the file, so the content size can be trusted for allocations.
+ * @param data start of the compressed file, which must stay in memory while the table is used
+ * @param size size of the compressed file
+ * @param table set to the location of every block
+ * @return TRUE if the header was well formed and the blocks fill the rest of the file
+ */
+bool BlockCompression::readBlockTable(const char* data, size_t size, BlockTable& table)
+{
+  if(!isCompressed(data, size) || size <= kMAGIC.size() ||
+     static_cast<uint8_t>(data[kMAGIC.size()]) != kVERSION)
+    return false;
+
+  const char* cursor = data + kMAGIC.size() + 1;
+  const char* end = data + size;
+  uint64_t total_size;
+  uint64_t block_size;
+  if(!BinaryEncoding::readVarint(cursor, end, total_size) ||
+     !BinaryEncoding::readVarint(cursor, end, block_size) || block_size == 0)
+    return false;
+
+  // Every block takes at least one byte in the table, which bounds the table allocations
+  uint64_t block_count = total_size / block_size + (total_size % block_size > 0 ? 1 : 0);
+  if(block_count > static_cast<uint64_t>(end - cursor))
+    return false;
+
+  table.offsets.assign(block_count, 0);
+  table.sizes.assign(block_count, 0);
+  table.stored.assign(block_count, false);
+  uint64_t blocks_size = 0;
+  for(size_t i = 0; i < block_count; i++)
+  {
+    uint64_t entry;
+    if(!BinaryEncoding::readVarint(cursor, end, entry))
+      return false;
+    table.offsets[i] = static_cast<size_t>(blocks_size);
+    table.sizes[i] = static_cast<size_t>(entry >> 1);
+    table.stored[i] = static_cast<char>(entry & 1);
+    blocks_size += (entry >> 1);
+  }
+  if(blocks_size != static_cast<uint64_t>(end - cursor))
+    return false;
+
+  // A block can't expand past one length byte per 255 bytes of content, which bounds the
+  // content size by the size of the file
+  if(total_size / 256 > blocks_size + block_count)
+    return false;
+
+  table.blocks = cursor;
+  table.block_size = static_cast<size_t>(block_size);
+  table.content_size = static_cast<size_t>(total_size);
+  return true;
+}
+
+/**
+ * Compresses the content and writes it to the file, replacing it atomically.
+ * @param source the content to compress
+ * @param path file system path of the destination
+ * @param thread_count maximum number of worker threads. 0 to use one per hardware thread
+ * @return TRUE if the compressed file was written
+ */
+bool BlockCompression::writeToFile(const PageBuffer& source, const std::string& path,
+                                   unsigned int thread_count)
+{
+  PageBuffer compressed;
+  compress(source, compressed, thread_count);
+  return compressed.writeToFile(path);
+}
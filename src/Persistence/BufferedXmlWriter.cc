@@ -0,0 +1,421 @@
+/**
+ * @class BufferedXmlWriter
+ *
+ * Streaming XML writer implementation that appends the entire document into a single paged
+ * memory buffer, tracking only the stack of open elements. Nothing touches the file system until
+ * stop(true), which flushes the buffer with one vectored write into a temporary file that then
+ * replaces the destination. stop(false) rolls back by truncating the buffer. Since the output is
+ * append only, find() to an existing node is not supported. The writer can also record the
+ * offsets of the elements as they are written and save them as the {@link XmlIndex} sidecar,
+ * and can compress the file with {@link BlockCompression}.
+ */
+#include "Persistence/BufferedXmlWriter.h"
+using namespace core;
+
+/* Constant Implementation - see header file for descriptions */
+const std::string BufferedXmlWriter::kXML_DECLARATION = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>";
+
+/*============================================================================
+ * CONSTRUCTORS / DESTRUCTORS
+ *===========================================================================*/
+
+/**
+ * Constructor function - Sets up the writer for the destination file. Nothing is written until
+ * the writer is stopped with changes saved.
+ * @param path file system path to the destination XML file
+ */
+BufferedXmlWriter::BufferedXmlWriter(std::string path)
+                 : path{path}
+{
+}
+
+/*============================================================================
+ * PRIVATE FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Appends a line break and the indentation for a new child of the top element on the stack, and
+ * marks that element as having children.
+ */
+void BufferedXmlWriter::appendChildIndent()
+{
+  if(stack_has_children.size() > 0)
+    stack_has_children.back() = true;
+
+  buffer.append('\n');
+  for(size_t i = 0; i < stack_name.size() * kINDENT; i++)
+    buffer.append(' ');
+}
+
+/**
+ * Appends the text to the buffer, encoding any XML reserved characters.
+ * @param plain the plain text to append
+ */
+void BufferedXmlWriter::appendEncoded(std::string_view plain)
+{
+  if(plain.find_first_of("<>&\"'") == std::string_view::npos)
+  {
+    buffer.append(plain);
+  }
+  else
+  {
+    scratch.clear();
+    XmlTokenizer::encode(plain, scratch);
+    buffer.append(scratch);
+  }
+}
+
+/**
+ * Closes the top element on the stack. An element with children gets its close tag on a new
+ * line, otherwise it closes on the same line as it was opened.
+ */
+void BufferedXmlWriter::closeElement()
+{
+  if(stack_has_children.back())
+  {
+    buffer.append('\n');
+    for(size_t i = 0; i < (stack_name.size() - 1) * kINDENT; i++)
+      buffer.append(' ');
+  }
+  if(stack_index_entry.back() != XmlIndex::kNO_ENTRY)
+    index.setElementEnd(stack_index_entry.back(), buffer.getSize());
+  buffer.append("</");
+  buffer.append(stack_name.back());
+  buffer.append('>');
+
+  stack_content_offset.pop_back();
+  stack_has_children.pop_back();
+  stack_index_entry.pop_back();
+  stack_name.pop_back();
+}
+
+/*=============================================================================
+ * PRIVATE FUNCTIONS - XMLWRITER
+ *============================================================================*/
+
+/**
+ * Deletes all child elements and data nodes beneath the current write location, by truncating
+ * the buffer back to the end of the current element open tag.
+ * @return true if the writer is started
+ */
+bool BufferedXmlWriter::deleteChildrenFromSource()
+{
+  if(!started)
+    return false;
+
+  if(stack_name.size() > 0)
+  {
+    buffer.truncate(stack_content_offset.back());
+    stack_has_children.back() = false;
+  }
+  else
+  {
+    buffer.truncate(root_content_offset);
+  }
+  index.truncate(buffer.getSize());
+  return true;
+}
+
+/**
+ * Finds a lower child node from the current node location. Written nodes can not be revisited in
+ * an append only document, so only an empty branch (the current location) is found.
+ * @param branch the child branch to find
+ * @return true only if the branch is empty and the writer is started
+ */
+bool BufferedXmlWriter::findInSource(XmlData branch)
+{
+  return (started && XmlDataView(branch).getNumElements() == 0);
+}
+
+/**
+ * Checks if the writer has been started.
+ * @return true if start() has been called and stop() has not been called since
+ */
+bool BufferedXmlWriter::isSourceAvailable()
+{
+  return started;
+}
+
+/**
+ * Jumps the write location up one level by closing the current element.
+ * @return true if the writer is started, even if already at the root
+ */
+bool BufferedXmlWriter::jumpToParentInSource()
+{
+  if(!started)
+    return false;
+
+  if(stack_name.size() > 0)
+    closeElement();
+  return true;
+}
+
+/**
+ * Jumps the write location back to the root by closing all open elements.
+ * @return true if the writer is started
+ */
+bool BufferedXmlWriter::jumpToRootInSource()
+{
+  if(!started)
+    return false;
+
+  while(stack_name.size() > 0)
+    closeElement();
+  return true;
+}
+
+/**
+ * Starts a new blank document in the buffer. If the writer was already started, any unsaved
+ * changes are discarded.
+ * @return success status of beginning the write. Always true
+ */
+bool BufferedXmlWriter::startWriteToSource()
+{
+  buffer.truncate(0);
+  index.clear();
+  stack_content_offset.clear();
+  stack_has_children.clear();
+  stack_index_entry.clear();
+  stack_name.clear();
+
+  buffer.append(kXML_DECLARATION);
+  root_content_offset = buffer.getSize();
+  started = true;
+  return true;
+}
+
+/**
+ * Stops the writer. When saving, all open elements are closed and the document is flushed to
+ * the destination file, along with the index sidecar if enabled. Otherwise any old sidecar is
+ * removed, since it no longer describes the file. Either way, the buffer is truncated for the
+ * next start.
+ * @param save_changes true to write the document to the file. false to discard it
+ * @return success status of the flush, if saving. false if not started
+ */
+bool BufferedXmlWriter::stopWriteToSource(bool save_changes)
+{
+  if(!started)
+    return false;
+
+  bool success = true;
+  if(save_changes)
+  {
+    jumpToRootInSource();
+    buffer.append('\n');
+    if(compression_enabled)
+      success = BlockCompression::writeToFile(buffer, path);
+    else
+      success = buffer.writeToFile(path);
+    if(success && index_enabled)
+      success = index.save(path);
+    else if(success)
+      std::remove(XmlIndex::getIndexPath(path).c_str());
+  }
+
+  buffer.truncate(0);
+  index.clear();
+  stack_content_offset.clear();
+  stack_has_children.clear();
+  stack_index_entry.clear();
+  stack_name.clear();
+  started = false;
+  return success;
+}
+
+/**
+ * Writes a data element at the current location, in the form <element type="N">data</element>.
+ * @param element name of the XML tag to wrap the data
+ * @param type category of the data
+ * @param data string converted data
+ * @return true if the writer is started and the element name is valid
+ */
+bool BufferedXmlWriter::writeDataToSource(std::string element, DataType type, std::string data)
+{
+  if(!started || element.empty())
+    return false;
+
+  appendChildIndent();
+  buffer.append('<');
+  buffer.append(element);
+  buffer.append(' ');
+  buffer.append(XmlData::kKEY_DATA_TYPE);
+  buffer.append("=\"");
+  buffer.append(TextEncoding::formatInteger(static_cast<int>(type)));
+  buffer.append("\">");
+  appendEncoded(data);
+  buffer.append("</");
+  buffer.append(element);
+  buffer.append('>');
+  return true;
+}
+
+/**
+ * Writes a boolean data element at the current location.
+ * @param element name of the XML tag to wrap the data
+ * @param data boolean to store
+ * @return true if successfully written
+ */
+bool BufferedXmlWriter::writeDataToSource(std::string element, bool data)
+{
+  return writeDataToSource(element, DataType::BOOLEAN, TextEncoding::formatBoolean(data));
+}
+
+/**
+ * Writes a float data element at the current location.
+ * @param element name of the XML tag to wrap the data
+ * @param data float to store
+ * @return true if successfully written
+ */
+bool BufferedXmlWriter::writeDataToSource(std::string element, float data)
+{
+  return writeDataToSource(element, DataType::FLOAT, TextEncoding::formatFloat(data));
+}
+
+/**
+ * Writes an integer data element at the current location.
+ * @param element name of the XML tag to wrap the data
+ * @param data integer to store
+ * @return true if successfully written
+ */
+bool BufferedXmlWriter::writeDataToSource(std::string element, int data)
+{
+  return writeDataToSource(element, DataType::INTEGER, TextEncoding::formatInteger(data));
+}
+
+/**
+ * Writes a string data element at the current location.
+ * @param element name of the XML tag to wrap the data
+ * @param data string to store
+ * @return true if successfully written
+ */
+bool BufferedXmlWriter::writeDataToSource(std::string element, std::string data)
+{
+  return writeDataToSource(element, DataType::STRING, data);
+}
+
+/**
+ * Writes an unsigned integer data element at the current location. It is stored under the
+ * general integer data type, as its full unsigned value.
+ * @param element name of the XML tag to wrap the data
+ * @param data unsigned integer to store
+ * @return true if successfully written
+ */
+bool BufferedXmlWriter::writeDataToSource(std::string element, uint32_t data)
+{
+  return writeDataToSource(element, DataType::INTEGER, TextEncoding::formatUnsigned(data));
+}
+
+/**
+ * Writes the open tag of a new child element at the current location and moves inside it.
+ * @param element name of the XML tag
+ * @param key optional attribute key. Blank for none
+ * @param value attribute value paired with the key
+ * @return true if the writer is started and the element name is valid
+ */
+bool BufferedXmlWriter::writeElementToSource(std::string element, std::string key,
+                                             std::string value)
+{
+  if(!started || element.empty())
+    return false;
+
+  appendChildIndent();
+  uint32_t index_entry = XmlIndex::kNO_ENTRY;
+  if(index_enabled)
+    index_entry = index.addElement(stack_index_entry.empty() ? XmlIndex::kNO_ENTRY
+                                                             : stack_index_entry.back(),
+                                   element, key, value, buffer.getSize());
+  buffer.append('<');
+  buffer.append(element);
+  if(!key.empty())
+  {
+    buffer.append(' ');
+    buffer.append(key);
+    buffer.append("=\"");
+    appendEncoded(value);
+    buffer.append('"');
+  }
+  buffer.append('>');
+
+  stack_content_offset.push_back(buffer.getSize());
+  stack_has_children.push_back(false);
+  stack_index_entry.push_back(index_entry);
+  stack_name.push_back(element);
+  return true;
+}
+
+/**
+ * Writes each element in the set as a nested child, moving inside the last one.
+ * @param element_set branch elements to write at the current location
+ * @return true if all elements were written
+ */
+bool BufferedXmlWriter::writeElementsToSource(XmlData element_set)
+{
+  XmlDataView elements(element_set);
+  bool success = started;
+  for(int i = 0; success && i < elements.getNumElements(); i++)
+    success = writeElementToSource(std::string(elements.getElement(i)),
+                                   std::string(elements.getKey(i)),
+                                   std::string(elements.getKeyValue(i)));
+  return success;
+}
+
+/*============================================================================
+ * PUBLIC FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Returns the size of the document written so far, including the declaration.
+ * @return size in bytes
+ */
+size_t BufferedXmlWriter::getBufferSize() const
+{
+  return buffer.getSize();
+}
+
+/**
+ * Returns the path to the destination file that is written.
+ * @return file system path
+ */
+std::string BufferedXmlWriter::getPath() const
+{
+  return path;
+}
+
+/**
+ * Returns if the file is compressed with {@link BlockCompression} when it's saved.
+ * @return TRUE if compressed
+ */
+bool BufferedXmlWriter::isCompressionEnabled() const
+{
+  return compression_enabled;
+}
+
+/**
+ * Returns if the offset index of the elements is saved as the sidecar of the destination.
+ * @return TRUE if the index is recorded
+ */
+bool BufferedXmlWriter::isIndexEnabled() const
+{
+  return index_enabled;
+}
+
+/**
+ * Sets if the file is compressed with {@link BlockCompression} when it's saved. Readers inflate
+ * the file as it's opened, so it reads back the same either way.
+ * @param enabled TRUE to compress
+ */
+void BufferedXmlWriter::setCompressionEnabled(bool enabled)
+{
+  compression_enabled = enabled;
+}
+
+/**
+ * Sets if the offset index of the elements is recorded as they are written, and saved as the
+ * sidecar of the destination with stop(true). This must be set before start(). An index left
+ * from an earlier save is out of date once the destination changes, so readers ignore it.
+ * @param enabled TRUE to save the index
+ */
+void BufferedXmlWriter::setIndexEnabled(bool enabled)
+{
+  index_enabled = enabled;
+}
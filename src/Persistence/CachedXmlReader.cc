@@ -0,0 +1,390 @@
+/**
+ * @class CachedXmlReader
+ *
+ * Reader implementation for an XML source that keeps a persistent cache of its parsed content
+ * next to it. The first full read parses the XML and writes every line into a binary copy (see
+ * {@link BinaryWriter}) as it goes. While the source is unchanged, every later read comes from
+ * that copy through a memory mapped {@link BinaryReader}, so nothing is tokenized, entity
+ * decoded or parsed from text. The lines read back are the same either way.
+ *
+ * The cache is the source path with ".cache" appended, and is stamped in a small file beside it
+ * (".cache.stamp") with the size, modified time and FNV-1a hash of the source. The cache is used
+ * if the size matches and either the modified time or the hash does, so a source that was only
+ * touched or copied is hashed once and then stamped again. The stamp is removed before the cache
+ * is rebuilt and only written once the cache is saved, so a cache is never used with a stale
+ * stamp. The cache is only built by a read from the start to the end: a find() abandons it, and
+ * a jump to the root starts it over.
+ */
+#include "Persistence/CachedXmlReader.h"
+using namespace core;
+
+/* Constant Implementation - see header file for descriptions */
+const std::string CachedXmlReader::kEXTENSION = ".cache";
+const std::string CachedXmlReader::kMAGIC = "FISC";
+const std::string CachedXmlReader::kSTAMP_EXTENSION = ".stamp";
+
+/*============================================================================
+ * CONSTRUCTORS / DESTRUCTORS
+ *===========================================================================*/
+
+/**
+ * Constructor function - Sets up the reader for the source file. Nothing is opened until start()
+ * is called.
+ * @param path file system path to the XML source file
+ */
+CachedXmlReader::CachedXmlReader(std::string path)
+               : path{path}
+{
+}
+
+/**
+ * Destructor function, stops the reader if it is still started. A cache that wasn't finished is
+ * discarded.
+ */
+CachedXmlReader::~CachedXmlReader()
+{
+  stopReadFromSource();
+}
+
+/*============================================================================
+ * PRIVATE FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Stops building the cache and discards what was written. The last saved cache was already
+ * unstamped when the build started, so it isn't used again.
+ */
+void CachedXmlReader::abandonCache()
+{
+  if(cache_writer)
+  {
+    cache_writer->stop(false);
+    cache_writer.reset();
+  }
+  cache_branch = XmlData();
+}
+
+/**
+ * Writes the lines that were just read into the cache being built. At the end of a well formed
+ * source, the cache is saved and then stamped. Any line that can't be written, such as one with
+ * untyped data, abandons the cache.
+ * @param lines the lines that were read
+ * @param count number of lines read into the front of the buffer
+ * @param done if the end of the source was reached
+ * @param success if the lines were read and, at the end, the source was well formed
+ */
+void CachedXmlReader::cacheLines(std::vector<XmlData>& lines, size_t count, bool done,
+                                 bool success)
+{
+  if(!cache_writer)
+    return;
+
+  for(size_t i = 0; success && i < count; i++)
+    success = XmlConverter::writeLine(cache_writer.get(), lines[i], cache_branch);
+
+  if(!success)
+  {
+    abandonCache();
+  }
+  else if(done)
+  {
+    if(cache_writer->stop(true))
+      saveStamp();
+    cache_writer.reset();
+    cache_branch = XmlData();
+  }
+}
+
+/**
+ * Returns the checksum of the content of the source. A compressed source is loaded and released
+ * a block at a time, so it's never decoded into memory whole.
+ * @param source the open source file
+ * @return checksum of the content
+ */
+uint32_t CachedXmlReader::checksumSource(MappedFile& source)
+{
+  uint32_t hash = BinaryEncoding::kCHECKSUM_SEED;
+  size_t offset = 0;
+  while(offset < source.getSize())
+  {
+    size_t end = source.load(offset, offset + 1);
+    if(end <= offset)
+      break;
+    hash = BinaryEncoding::checksum(source.getData() + offset, end - offset, hash);
+    source.releaseBefore(end);
+    offset = end;
+  }
+  return hash;
+}
+
+/**
+ * Checks the stamp file against the source. The size must match, and then either the modified
+ * time or the hash of the content. If only the hash matches, the source is stamped again with
+ * its new time, so it isn't hashed on the next start.
+ * @param source the open source file
+ * @return TRUE if the cache holds the content of the source
+ */
+bool CachedXmlReader::isCacheValid(MappedFile& source)
+{
+  MappedFile stamp;
+  if(!stamp.open(getCachePath() + kSTAMP_EXTENSION) || stamp.getSize() <= kMAGIC.size() ||
+     std::string_view(stamp.getData(), kMAGIC.size()) != kMAGIC ||
+     static_cast<uint8_t>(stamp.getData()[kMAGIC.size()]) != kVERSION)
+    return false;
+
+  const char* cursor = stamp.getData() + kMAGIC.size() + 1;
+  const char* end = stamp.getData() + stamp.getSize();
+  uint64_t size;
+  int64_t modified_time;
+  uint32_t hash;
+  if(!BinaryEncoding::readVarint(cursor, end, size) ||
+     !BinaryEncoding::readSignedVarint(cursor, end, modified_time) ||
+     !BinaryEncoding::readFixed32(cursor, end, hash) || cursor != end ||
+     size != source.getSize())
+    return false;
+
+  if(modified_time == static_cast<int64_t>(source.getModifiedTime()))
+  {
+    source_hash = hash;
+    return true;
+  }
+
+  source_hash = checksumSource(source);
+  if(hash != source_hash)
+    return false;
+  saveStamp();
+  return true;
+}
+
+/**
+ * Saves the stamp file with the source as it was when the read was started.
+ * @return TRUE if the stamp was written
+ */
+bool CachedXmlReader::saveStamp() const
+{
+  PageBuffer buffer;
+  buffer.append(kMAGIC);
+  buffer.append(static_cast<char>(kVERSION));
+  BinaryEncoding::appendVarint(buffer, source_size);
+  BinaryEncoding::appendSignedVarint(buffer, source_modified_time);
+  BinaryEncoding::appendFixed32(buffer, source_hash);
+  return buffer.writeToFile(getCachePath() + kSTAMP_EXTENSION);
+}
+
+/*=============================================================================
+ * PRIVATE FUNCTIONS - XMLREADER
+ *============================================================================*/
+
+/**
+ * Finds an element node from the current read location. The lines skipped over are never read,
+ * so the cache being built is abandoned.
+ * @param branch the child branch to find
+ * @return true if the path was found and the read pointer was moved
+ */
+bool CachedXmlReader::findInSource(XmlData branch)
+{
+  if(!reader)
+    return false;
+
+  abandonCache();
+  return reader->find(branch);
+}
+
+/**
+ * Checks if the reader has been started.
+ * @return true if start() has been called and stop() has not been called since
+ */
+bool CachedXmlReader::isSourceAvailable()
+{
+  return (reader && reader->isStarted());
+}
+
+/**
+ * Jumps the read location back to the start of the document. A cache being built is started
+ * over, since the lines are read again from the start.
+ * @return true if the reader is back at the root of the source for the next read()
+ */
+bool CachedXmlReader::jumpToRootInSource()
+{
+  if(!reader)
+    return false;
+
+  if(cache_writer)
+  {
+    cache_writer->start();
+    cache_branch = XmlData();
+  }
+  return reader->jumpToRoot();
+}
+
+/**
+ * Returns the last modified date of the source file, when the reader was started. It's the date
+ * of the source even when the read is from the cache.
+ * @return UTC date formatted as YYYY-MM-DD HH:MM:SS. Blank if not started
+ */
+std::string CachedXmlReader::lastModifiedDateFromSource()
+{
+  return source_modified_date;
+}
+
+/**
+ * Reads the next batch of data elements, and writes them into the cache if it's being built.
+ * @param lines buffer of lines, at least count long
+ * @param count maximum number of lines to read
+ * @param done set when the end of the source has been reached
+ * @param success set if all lines were read and, at the end, the source was well formed
+ * @return number of lines read into the front of the buffer
+ */
+size_t CachedXmlReader::readBatchFromSource(std::vector<XmlData>& lines, size_t count,
+                                            bool& done, bool& success)
+{
+  done = true;
+  success = false;
+  if(!reader)
+    return 0;
+
+  size_t read_count = reader->readBatch(lines, done, success, count);
+  cacheLines(lines, read_count, done, success);
+  return read_count;
+}
+
+/**
+ * Reads the next data element, and writes it into the cache if it's being built.
+ * @param done set when the end of the source has been reached and no line was returned
+ * @param success set if the line was read. An unsuccessful read at the end is a malformed source
+ * @return branch element that includes the full path location through the XML wrapping the data
+ */
+XmlData CachedXmlReader::readFromSource(bool& done, bool& success)
+{
+  done = true;
+  success = false;
+  if(!reader)
+    return XmlData();
+
+  std::vector<XmlData> lines(1);
+  lines[0] = reader->read(done, success);
+  cacheLines(lines, done ? 0 : 1, done, success);
+  return std::move(lines[0]);
+}
+
+/**
+ * Starts the read from the cache if it matches the source. Otherwise the source is parsed and
+ * the cache is built from it, after the old stamp is removed. If the reader was already started,
+ * it is restarted.
+ * @return success status of opening the cache or the source
+ */
+bool CachedXmlReader::startReadFromSource()
+{
+  stopReadFromSource();
+
+  MappedFile source;
+  if(!source.open(path))
+    return false;
+  source_modified_date = source.getModifiedDate();
+  source_modified_time = source.getModifiedTime();
+  source_size = source.getSize();
+
+  // Read from the cache, if it holds the source as it is now
+  if(isCacheValid(source))
+  {
+    reader.reset(new BinaryReader(getCachePath()));
+    if(reader->start())
+    {
+      from_cache = true;
+      return true;
+    }
+  }
+
+  // Otherwise parse the source and build the cache from it
+  source_hash = checksumSource(source);
+  source.close();
+  std::remove((getCachePath() + kSTAMP_EXTENSION).c_str());
+
+  reader.reset(new MappedXmlReader(path));
+  if(!reader->start())
+  {
+    reader.reset();
+    return false;
+  }
+  cache_writer.reset(new BinaryWriter(getCachePath()));
+  cache_writer->start();
+  return true;
+}
+
+/**
+ * Stops the read. A cache that wasn't finished is discarded.
+ * @return success status of cleaning up. Always true
+ */
+bool CachedXmlReader::stopReadFromSource()
+{
+  abandonCache();
+  if(reader)
+  {
+    reader->stop();
+    reader.reset();
+  }
+  from_cache = false;
+  return true;
+}
+
+/**
+ * Counts the total number of data elements in the cache or the source.
+ * @return total count. 0 if not started
+ */
+int CachedXmlReader::totalDataCountFromSource()
+{
+  if(!reader)
+    return 0;
+  return reader->totalDataCount();
+}
+
+/**
+ * Splits the cache, if it matches the source, or otherwise the source, into independent readers
+ * at the top-level element boundaries. Split reads don't build the cache.
+ * @param shard_count maximum number of readers to split into
+ * @return split readers in document order. Empty if the source can't be split
+ */
+std::vector<std::unique_ptr<XmlReader>> CachedXmlReader::splitSource(int shard_count)
+{
+  MappedFile source;
+  if(!source.open(path))
+    return {};
+
+  CachedXmlReader stamped(path);
+  stamped.source_modified_time = source.getModifiedTime();
+  stamped.source_size = source.getSize();
+  if(stamped.isCacheValid(source))
+    return BinaryReader(getCachePath()).split(shard_count);
+  return MappedXmlReader(path).split(shard_count);
+}
+
+/*============================================================================
+ * PUBLIC FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Returns the path to the cache file: the source path with the cache extension.
+ * @return file system path
+ */
+std::string CachedXmlReader::getCachePath() const
+{
+  return path + kEXTENSION;
+}
+
+/**
+ * Returns the path to the XML source file that is read.
+ * @return file system path
+ */
+std::string CachedXmlReader::getPath() const
+{
+  return path;
+}
+
+/**
+ * Returns if the current read is from the cache, instead of parsing the source.
+ * @return TRUE if started on a cache that matches the source
+ */
+bool CachedXmlReader::isReadFromCache() const
+{
+  return from_cache;
+}
@@ -0,0 +1,250 @@
+/**
+ * @class JournalCompactor
+ *
+ * Background compactor for a journaled save. A worker thread checks the log written by
+ * {@link JournalWriter} on an interval and, once it has grown past the size threshold, folds it
+ * into the snapshot: the live log is rotated out (new checkpoints start a fresh log), the
+ * snapshot and the rotated log are replayed with only the last line of each element path kept,
+ * and the result is saved as the new snapshot through the snapshot writer, which replaces it
+ * atomically. The rotated log is only deleted once the new snapshot is saved, so a crash at any
+ * point replays the same state, since replaying a log that was already folded changes nothing.
+ *
+ * The snapshot must already exist, such as the full save written when the game was created. The
+ * rotation is only coordinated with the journal writers of this process.
+ */
+#include "Persistence/JournalCompactor.h"
+using namespace core;
+
+/*============================================================================
+ * CONSTRUCTORS / DESTRUCTORS
+ *===========================================================================*/
+
+/**
+ * Constructor function - Sets up the compactor and starts its worker thread.
+ * @param log_path file system path to the log file, as given to the {@link JournalWriter}
+ * @param snapshot_reader reader of the snapshot file
+ * @param snapshot_writer writer of the snapshot file, which must replace it atomically
+ * @param size_threshold log size that triggers a background compaction, in bytes
+ * @param interval_ms time between checks of the log size, in milliseconds
+ */
+JournalCompactor::JournalCompactor(std::string log_path,
+                                   std::unique_ptr<XmlReader> snapshot_reader,
+                                   std::unique_ptr<XmlWriter> snapshot_writer,
+                                   size_t size_threshold, uint32_t interval_ms)
+                : interval_ms{interval_ms},
+                  log_path{log_path},
+                  size_threshold{size_threshold},
+                  snapshot_reader{std::move(snapshot_reader)},
+                  snapshot_writer{std::move(snapshot_writer)}
+{
+  worker = std::thread(&JournalCompactor::runWorker, this);
+}
+
+/**
+ * Destructor function - Stops the worker thread, after any compaction it's running. The log
+ * left behind is replayed on the next load and folded by the next compactor.
+ */
+JournalCompactor::~JournalCompactor()
+{
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    stopping = true;
+  }
+  signal.notify_all();
+  worker.join();
+}
+
+/*============================================================================
+ * PRIVATE FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Runs the checks of the worker thread. Each interval, the log is compacted if it's due. A
+ * failed compaction leaves the logs in place, so it's tried again at the next check.
+ */
+void JournalCompactor::runWorker()
+{
+  std::unique_lock<std::mutex> guard(lock);
+  while(true)
+  {
+    signal.wait_for(guard, std::chrono::milliseconds(interval_ms),
+                    [this]() { return stopping; });
+    if(stopping)
+      return;
+
+    guard.unlock();
+    bool compacted = false;
+    bool success = false;
+    std::exception_ptr compact_error;
+    if(isCompactionDue())
+    {
+      compacted = true;
+      try
+      {
+        success = compact();
+      }
+      catch(...)
+      {
+        compact_error = std::current_exception();
+      }
+    }
+    guard.lock();
+
+    if(compacted)
+    {
+      if(compact_error && !error)
+        error = compact_error;
+      last_success = success;
+    }
+  }
+}
+
+/*============================================================================
+ * PRIVATE STATIC FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Returns the key that identifies the element path of the line: the name, key and value of
+ * every element, except the data element, which only adds its name since its key is the type.
+ * @param line the data line
+ * @return path key, equal for the lines that a load applies to the same field
+ */
+std::string JournalCompactor::getPathKey(XmlDataView line)
+{
+  std::string path_key;
+  int element_count = line.getNumElements();
+  for(int i = 0; i < element_count; i++)
+  {
+    path_key += line.getElement(i);
+    path_key += '\0';
+    if(i + 1 < element_count)
+    {
+      path_key += line.getKey(i);
+      path_key += '\0';
+      path_key += line.getKeyValue(i);
+      path_key += '\0';
+    }
+  }
+  return path_key;
+}
+
+/**
+ * Finds the size of the file.
+ * @param path file system path of the file
+ * @param size set to the size of the file in bytes, if it exists
+ * @return TRUE if the file exists and can be read
+ */
+bool JournalCompactor::getFileSize(const std::string& path, size_t& size)
+{
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  if(!file.is_open())
+    return false;
+
+  size = static_cast<size_t>(file.tellg());
+  return true;
+}
+
+/*============================================================================
+ * PUBLIC FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Folds the log into the snapshot now, on the calling thread. The live log is rotated out,
+ * unless a rotated log from an earlier compaction that didn't finish is still waiting, in which
+ * case that one is folded first. The folded lines keep the order of the last line of each
+ * element path, so loading them applies the same state as replaying every line.
+ * @return TRUE if there was nothing to fold or the new snapshot was saved
+ */
+bool JournalCompactor::compact()
+{
+  std::lock_guard<std::mutex> compact_guard(compact_lock);
+  std::string rotated_path = log_path + JournalWriter::kROTATED_SUFFIX;
+
+  // Rotate the live log out, so the checkpoints during the fold start a new one
+  {
+    std::lock_guard<std::mutex> append_guard(JournalWriter::append_lock);
+    size_t size;
+    if(!getFileSize(rotated_path, size))
+    {
+      if(!getFileSize(log_path, size))
+        return true;
+      if(std::rename(log_path.c_str(), rotated_path.c_str()) != 0)
+        return false;
+    }
+  }
+
+  // Replay the snapshot and the rotated log, dropping each line that a later one replaces
+  JournalReader reader(snapshot_reader.get(), std::vector<std::string>{rotated_path});
+  if(!reader.start())
+    return false;
+
+  std::vector<XmlData> lines;
+  std::vector<bool> lines_kept;
+  std::unordered_map<std::string, size_t> line_by_path;
+  bool done = false;
+  bool success = true;
+  while(true)
+  {
+    XmlData line = reader.read(done, success);
+    if(done || !success)
+      break;
+
+    size_t& line_index = line_by_path.emplace(getPathKey(XmlDataView(line)),
+                                              lines.size()).first->second;
+    if(line_index != lines.size())
+    {
+      lines_kept[line_index] = false;
+      line_index = lines.size();
+    }
+    lines.push_back(std::move(line));
+    lines_kept.push_back(true);
+  }
+  reader.stop();
+  if(!success)
+    return false;
+
+  // Save the folded lines as the new snapshot, then the rotated log is no longer needed
+  if(!snapshot_writer->start())
+    return false;
+
+  XmlData open_branch;
+  for(size_t i = 0; success && i < lines.size(); i++)
+    if(lines_kept[i])
+      success = XmlConverter::writeLine(snapshot_writer.get(), lines[i], open_branch);
+  if(!snapshot_writer->stop(success) || !success)
+    return false;
+
+  std::remove(rotated_path.c_str());
+  return true;
+}
+
+/**
+ * Returns if a compaction is due: the live log has grown past the size threshold, or a rotated
+ * log from a compaction that didn't finish is waiting to be folded.
+ * @return TRUE if the next check compacts
+ */
+bool JournalCompactor::isCompactionDue() const
+{
+  size_t size;
+  if(getFileSize(log_path + JournalWriter::kROTATED_SUFFIX, size))
+    return true;
+  return (getFileSize(log_path, size) && size >= size_threshold);
+}
+
+/**
+ * Waits for a running compaction to finish. If a background compaction threw, the first
+ * exception is rethrown here once.
+ * @return TRUE if the last background compaction succeeded, or none has run
+ */
+bool JournalCompactor::wait()
+{
+  std::lock_guard<std::mutex> compact_guard(compact_lock);
+  std::lock_guard<std::mutex> guard(lock);
+  if(error)
+  {
+    std::exception_ptr compact_error = error;
+    error = nullptr;
+    std::rethrow_exception(compact_error);
+  }
+  return last_success;
+}
@@ -0,0 +1,477 @@
+/**
+ * @class JournalReader
+ *
+ * Reader implementation that replays a journaled save: every line of the snapshot, then every
+ * line of the log written by {@link JournalWriter}, in the order they were appended. A log that
+ * was rotated out for compaction but not yet folded into the snapshot is replayed before the
+ * live log. Since the loaders apply each line over the state already loaded, the result is the
+ * state of the last checkpoint. The removals recorded in the log are found when the reader
+ * starts, and every line beneath a removed node that comes before its removal is skipped, in the
+ * snapshot as well. A frame that fails its checksum, such as one cut short by a crash, ends the
+ * replay of that log file, which is reported by isTruncated().
+ */
+#include "Persistence/JournalReader.h"
+using namespace core;
+
+/*============================================================================
+ * CONSTRUCTORS / DESTRUCTORS
+ *===========================================================================*/
+
+/**
+ * Constructor function - Sets up the replay of the snapshot and the log. Nothing is opened until
+ * the reader is started.
+ * @param snapshot reader of the snapshot. Not owned, must outlive the reader. Null if no
+ *                 snapshot has been saved yet
+ * @param log_path file system path to the log file, as given to the {@link JournalWriter}
+ */
+JournalReader::JournalReader(XmlReader* snapshot, std::string log_path)
+             : JournalReader(snapshot, std::vector<std::string>{
+                                         log_path + JournalWriter::kROTATED_SUFFIX, log_path})
+{
+}
+
+/**
+ * Constructor function - Sets up the replay of the snapshot and the listed log files.
+ * @param snapshot reader of the snapshot. Not owned, null for none
+ * @param log_paths file system paths of the log files, in replay order. Missing ones are skipped
+ */
+JournalReader::JournalReader(XmlReader* snapshot, std::vector<std::string> log_paths)
+             : log_paths{log_paths},
+               snapshot{snapshot}
+{
+}
+
+/*============================================================================
+ * PRIVATE FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Returns if the line is beneath a node that the log removed after the line was written: a
+ * removal record with a later sequence number, whose branch starts the line. Each branch that
+ * starts the line, up to the deepest removal, is looked up by its path key, so the check doesn't
+ * grow with the number of removals.
+ * @param line the data line to check
+ * @param line_sequence sequence number of the line's record. 0 for a snapshot line
+ * @return TRUE if the line was removed and is skipped
+ */
+bool JournalReader::isRemoved(XmlDataView line, uint64_t line_sequence)
+{
+  if(removals.empty())
+    return false;
+
+  int branch_limit = std::min(removal_depth, line.getNumElements() - 1);
+  removal_key.clear();
+  for(int i = 0; ; i++)
+  {
+    auto removal = removals.find(removal_key);
+    if(removal != removals.end() && removal->second > line_sequence)
+      return true;
+    if(i >= branch_limit)
+      return false;
+    XmlIndex::appendPathKey(removal_key, line.getElement(i), line.getKey(i),
+                            line.getKeyValue(i));
+  }
+}
+
+/**
+ * Finds the removals recorded in the log files, with one pass over the records before the
+ * replay. The logs only hold the checkpoints since the last compaction, so this is small next to
+ * the snapshot. The read location is left at the end, to be reset for the replay.
+ */
+void JournalReader::loadRemovals()
+{
+  removals.clear();
+  removal_depth = 0;
+  resetReadLocation();
+
+  XmlData line;
+  while(offset < frame_end || nextFrame())
+  {
+    bool removal;
+    if(!readRecord(line, removal))
+    {
+      offset = file.getSize();
+      frame_end = offset;
+      continue;
+    }
+
+    sequence++;
+    if(removal)
+    {
+      // Only the last removal of a node matters, since the sequence numbers only grow
+      XmlDataView removed(line);
+      removal_key.clear();
+      for(int i = 0; i < removed.getNumElements(); i++)
+        XmlIndex::appendPathKey(removal_key, removed.getElement(i), removed.getKey(i),
+                                removed.getKeyValue(i));
+      removals[removal_key] = sequence;
+      removal_depth = std::max(removal_depth, removed.getNumElements());
+    }
+  }
+}
+
+/**
+ * Moves to the next whole frame. When the current log file is finished, the next one in the
+ * list is opened. A frame that is cut short or fails its checksum drops the rest of its file.
+ * @return TRUE if a frame was found. false at the end of the last log file
+ */
+bool JournalReader::nextFrame()
+{
+  while(true)
+  {
+    if(file.isOpen() && offset < file.getSize())
+    {
+      const char* data = file.getData();
+      const char* cursor = data + offset;
+      const char* end = data + file.getSize();
+      uint64_t payload_size;
+      uint32_t payload_checksum;
+      if(BinaryEncoding::readVarint(cursor, end, payload_size) &&
+         BinaryEncoding::readFixed32(cursor, end, payload_checksum) &&
+         payload_size > 0 && payload_size <= static_cast<uint64_t>(end - cursor) &&
+         BinaryEncoding::checksum(cursor, payload_size) == payload_checksum &&
+         static_cast<uint8_t>(cursor[0]) == JournalWriter::kVERSION)
+      {
+        offset = (cursor - data) + 1;
+        frame_end = (cursor - data) + payload_size;
+        branch = XmlData();
+        return true;
+      }
+      truncated = true;
+    }
+
+    file.close();
+    offset = 0;
+    frame_end = 0;
+    if(log_index >= log_paths.size())
+      return false;
+    file.open(log_paths[log_index++]);
+  }
+}
+
+/**
+ * Reads the next data line: from the snapshot until it ends, then from the log frames. Removal
+ * records and the lines they remove are skipped.
+ * @param line the line to fill, reusing its memory
+ * @param done set when the end of the replay has been reached and no line was returned
+ * @param success set if the line was read. At the end, if the snapshot ended properly
+ */
+void JournalReader::readLine(XmlData& line, bool& done, bool& success)
+{
+  done = true;
+  success = false;
+  if(!started)
+    return;
+
+  if(reading_snapshot)
+  {
+    do
+      line = snapshot->read(done, success);
+    while(!done && success && isRemoved(XmlDataView(line), 0));
+    if(!done)
+      return;
+
+    snapshot_success = success;
+    reading_snapshot = false;
+  }
+
+  while(offset < frame_end || nextFrame())
+  {
+    bool removal;
+    if(!readRecord(line, removal))
+    {
+      // A malformed record in a whole frame drops the rest of its file, the same as a torn frame
+      truncated = true;
+      offset = file.getSize();
+      frame_end = offset;
+      continue;
+    }
+
+    sequence++;
+    if(!removal && !isRemoved(XmlDataView(line), sequence))
+    {
+      done = false;
+      success = true;
+      return;
+    }
+  }
+
+  done = true;
+  success = snapshot_success;
+}
+
+/**
+ * Decodes the record at the read location: the elements shared with the last record, the new
+ * elements and then the typed data element. For a removal record, the line is the removed
+ * branch, without a data element.
+ * @param line the line to fill, reusing its memory
+ * @param removal set if the record is a removal
+ * @return TRUE if the record was well formed and within the frame
+ */
+bool JournalReader::readRecord(XmlData& line, bool& removal)
+{
+  const char* data = file.getData();
+  const char* cursor = data + offset;
+  const char* end = data + frame_end;
+
+  uint64_t shared_count;
+  uint64_t new_count;
+  if(!BinaryEncoding::readVarint(cursor, end, shared_count) ||
+     shared_count > static_cast<uint64_t>(XmlDataView(branch).getNumElements()) ||
+     !BinaryEncoding::readVarint(cursor, end, new_count))
+    return false;
+
+  while(static_cast<uint64_t>(XmlDataView(branch).getNumElements()) > shared_count)
+    branch.removeLastElement();
+  for(uint64_t i = 0; i < new_count; i++)
+  {
+    std::string_view element;
+    std::string_view key;
+    std::string_view value;
+    if(!BinaryEncoding::readString(cursor, end, element) ||
+       !BinaryEncoding::readString(cursor, end, key) ||
+       !BinaryEncoding::readString(cursor, end, value))
+      return false;
+    branch.addElementBack(element, key, value);
+  }
+
+  std::string_view element;
+  if(!BinaryEncoding::readString(cursor, end, element) || cursor >= end)
+    return false;
+  DataType type = static_cast<DataType>(*cursor++);
+
+  line = branch;
+  removal = (element.empty() && type == DataType::NONE);
+  if(removal)
+  {
+    offset = cursor - data;
+    return true;
+  }
+
+  line.addElementBack(element, XmlData::kKEY_DATA_TYPE,
+                      TextEncoding::formatInteger(static_cast<int>(type)));
+  if(type == DataType::BOOLEAN && cursor < end)
+  {
+    line.setDataOfType(*cursor++ != 0);
+  }
+  else if(type == DataType::INTEGER)
+  {
+    int64_t integer_data;
+    if(!BinaryEncoding::readSignedVarint(cursor, end, integer_data))
+      return false;
+    line.setDataOfType(static_cast<int>(integer_data));
+  }
+  else if(type == DataType::FLOAT)
+  {
+    float float_data;
+    if(!BinaryEncoding::readFloat(cursor, end, float_data))
+      return false;
+    line.setDataOfType(float_data);
+  }
+  else if(type == DataType::STRING)
+  {
+    std::string_view string_data;
+    if(!BinaryEncoding::readString(cursor, end, string_data))
+      return false;
+    line.setDataOfType(string_data);
+  }
+  else
+  {
+    return false;
+  }
+
+  offset = cursor - data;
+  return true;
+}
+
+/**
+ * Resets the read location back to the start of the snapshot, before the first log file.
+ */
+void JournalReader::resetReadLocation()
+{
+  file.close();
+  log_index = 0;
+  offset = 0;
+  frame_end = 0;
+  branch = XmlData();
+  sequence = 0;
+  reading_snapshot = (snapshot != nullptr);
+  snapshot_success = true;
+  truncated = false;
+  if(snapshot != nullptr)
+    snapshot->jumpToRoot();
+}
+
+/*=============================================================================
+ * PRIVATE FUNCTIONS - XMLREADER
+ *============================================================================*/
+
+/**
+ * Finds an element node from the current read location. The lines of a node are spread over the
+ * snapshot and the log, so this is not supported.
+ * @param branch the branch to find
+ * @return false
+ */
+bool JournalReader::findInSource(XmlData)
+{
+  return false;
+}
+
+/**
+ * Checks if the reader has been started.
+ * @return true if start() has been called and stop() has not been called since
+ */
+bool JournalReader::isSourceAvailable()
+{
+  return started;
+}
+
+/**
+ * Jumps the read location back to the start of the replay.
+ * @return true if the reader is back at the start of the snapshot for the next read()
+ */
+bool JournalReader::jumpToRootInSource()
+{
+  if(!started)
+    return false;
+
+  resetReadLocation();
+  return true;
+}
+
+/**
+ * Returns the last modified date of the replayed state: the live log if there is one, since
+ * every checkpoint appends to it, otherwise the snapshot.
+ * @return UTC date formatted as YYYY-MM-DD HH:MM:SS. Blank if neither exists
+ */
+std::string JournalReader::lastModifiedDateFromSource()
+{
+  MappedFile log_file;
+  if(!log_paths.empty() && log_file.open(log_paths.back()))
+    return log_file.getModifiedDate();
+  if(snapshot != nullptr)
+    return snapshot->lastModifiedDate();
+  return "";
+}
+
+/**
+ * Reads the next batch of data lines, filling each line of the buffer in place.
+ * @param lines buffer of lines, at least count long
+ * @param count maximum number of lines to read
+ * @param done set when the end of the replay has been reached
+ * @param success set if all lines were read and, at the end, the snapshot ended properly
+ * @return number of lines read into the front of the buffer
+ */
+size_t JournalReader::readBatchFromSource(std::vector<XmlData>& lines, size_t count, bool& done,
+                                          bool& success)
+{
+  size_t read_count = 0;
+  bool all_valid = true;
+  done = false;
+  while(read_count < count && !done)
+  {
+    bool line_success;
+    readLine(lines[read_count], done, line_success);
+    if(done)
+      all_valid &= line_success;
+    else if(line_success)
+      read_count++;
+    else
+      all_valid = false;
+  }
+
+  success = all_valid;
+  return read_count;
+}
+
+/**
+ * Reads the next data line of the replay.
+ * @param done set when the end of the replay has been reached and no line was returned
+ * @param success set if the line was read. At the end, if the snapshot ended properly
+ * @return branch element that includes the full path location through the XML wrapping the data
+ */
+XmlData JournalReader::readFromSource(bool& done, bool& success)
+{
+  XmlData line(getMemoryResource());
+  readLine(line, done, success);
+  return line;
+}
+
+/**
+ * Starts the snapshot reader, if there is one, and finds the removals recorded in the log files.
+ * The log files are opened again as the replay reaches them, and a missing one is skipped, since
+ * there is none until the first checkpoint.
+ * @return success status of starting the snapshot reader
+ */
+bool JournalReader::startReadFromSource()
+{
+  if(snapshot != nullptr && !snapshot->start())
+    return false;
+
+  started = true;
+  total_data_count = -1;
+  loadRemovals();
+  resetReadLocation();
+  return true;
+}
+
+/**
+ * Stops the snapshot reader and closes the log file.
+ * @return success status of cleaning up. Always true
+ */
+bool JournalReader::stopReadFromSource()
+{
+  if(started && snapshot != nullptr)
+    snapshot->stop();
+
+  file.close();
+  started = false;
+  total_data_count = -1;
+  return true;
+}
+
+/**
+ * Counts the total number of data lines in the snapshot and the log. The log is scanned once
+ * with a separate replay, which skips the lines it removes, and the count is cached for the rest
+ * of the read. The snapshot lines are counted by its reader, including any that are removed.
+ * @return total count. 0 if not started
+ */
+int JournalReader::totalDataCountFromSource()
+{
+  if(!started)
+    return 0;
+
+  if(total_data_count < 0)
+  {
+    total_data_count = (snapshot != nullptr ? snapshot->totalDataCount() : 0);
+
+    JournalReader log_reader(nullptr, log_paths);
+    log_reader.start();
+    XmlData line;
+    bool done = false;
+    bool success;
+    while(true)
+    {
+      log_reader.readLine(line, done, success);
+      if(done)
+        break;
+      total_data_count++;
+    }
+    log_reader.stop();
+  }
+  return total_data_count;
+}
+
+/*============================================================================
+ * PUBLIC FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Returns if a frame was dropped since the replay started, because it was cut short (such as
+ * by a crash during a checkpoint) or failed its checksum. Every line before it was replayed.
+ * @return TRUE if the log was truncated
+ */
+bool JournalReader::isTruncated() const
+{
+  return truncated;
+}
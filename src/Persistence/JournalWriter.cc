@@ -0,0 +1,365 @@
+/**
+ * @class JournalWriter
+ *
+ * Append only writer for the write-ahead journal of a save (see {@link JournalReader} and
+ * {@link JournalCompactor}). It follows the same contract as the other writers, so a checkpoint
+ * is the usual incremental save of the changed state, but stop(true) appends only the data lines
+ * written since start() to the log, as one frame with a single write and sync, instead of
+ * rewriting the whole document. Nodes in the log can't be revisited, so find() is not supported
+ * and deleteChildren() records a removal instead: a load drops every line beneath the current
+ * node from before it. A rewrite (see {@link XmlWriter#rewriteElements}) is then a removal
+ * followed by the new lines, so data the new state no longer has is gone on load as well.
+ *
+ * Each frame is a varint payload size and a 4 byte checksum of the payload (see
+ * {@link BinaryEncoding}), then the payload: a version byte and a sequence of line records. A
+ * line record is the number of leading elements shared with the line before it in the frame, the
+ * number of new elements and their name, key and value strings, and then the data element name,
+ * its {@link DataType} byte and the typed payload. A removal record has a blank data element
+ * name, the NONE type and no payload. A frame cut short by a crash fails its checksum, so it's
+ * dropped whole on load.
+ */
+#include "Persistence/JournalWriter.h"
+using namespace core;
+
+/* Constant Implementation - see header file for descriptions */
+const std::string JournalWriter::kROTATED_SUFFIX = ".compact";
+
+/* Static Implementation - see header file for descriptions */
+std::mutex JournalWriter::append_lock;
+
+/*============================================================================
+ * CONSTRUCTORS / DESTRUCTORS
+ *===========================================================================*/
+
+/**
+ * Constructor function - Sets up the writer for the log file. Nothing is written until the
+ * writer is stopped with changes saved.
+ * @param path file system path to the log file
+ */
+JournalWriter::JournalWriter(std::string path)
+             : path{path}
+{
+}
+
+/*============================================================================
+ * PRIVATE FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Appends the start of a line or removal record: the elements of the current branch that aren't
+ * shared with the last record, then the data element name and type.
+ * @param element name of the data element. Blank for a removal
+ * @param type category of the data. NONE for a removal
+ */
+void JournalWriter::writeLineHeader(const std::string& element, DataType type)
+{
+  XmlDataView current(branch);
+  XmlDataView last(last_branch);
+  int shared_count = 0;
+  while(shared_count < current.getNumElements() && shared_count < last.getNumElements() &&
+        current.getElement(shared_count) == last.getElement(shared_count) &&
+        current.getKey(shared_count) == last.getKey(shared_count) &&
+        current.getKeyValue(shared_count) == last.getKeyValue(shared_count))
+    shared_count++;
+
+  BinaryEncoding::appendVarint(buffer, shared_count);
+  BinaryEncoding::appendVarint(buffer, current.getNumElements() - shared_count);
+  for(int i = shared_count; i < current.getNumElements(); i++)
+  {
+    BinaryEncoding::appendString(buffer, current.getElement(i));
+    BinaryEncoding::appendString(buffer, current.getKey(i));
+    BinaryEncoding::appendString(buffer, current.getKeyValue(i));
+  }
+  BinaryEncoding::appendString(buffer, element);
+  buffer.append(static_cast<char>(type));
+
+  last_branch = branch;
+  line_count++;
+}
+
+/*=============================================================================
+ * PRIVATE FUNCTIONS - XMLWRITER
+ *============================================================================*/
+
+/**
+ * Deletes all child elements and data nodes beneath the current write location. Lines already
+ * in the log can't be deleted, so a removal record of the location is appended instead, which
+ * drops the lines beneath it that come before it when the log is replayed.
+ * @return true if the writer is started
+ */
+bool JournalWriter::deleteChildrenFromSource()
+{
+  if(!started)
+    return false;
+
+  writeLineHeader("", DataType::NONE);
+  return true;
+}
+
+/**
+ * Finds a lower child node from the current node location. Nodes in the log can not be
+ * revisited, so nothing is found and a rewrite writes its elements and a removal instead.
+ * @param branch the child branch to find
+ * @return false
+ */
+bool JournalWriter::findInSource(XmlData)
+{
+  return false;
+}
+
+/**
+ * Checks if the writer has been started.
+ * @return true if start() has been called and stop() has not been called since
+ */
+bool JournalWriter::isSourceAvailable()
+{
+  return started;
+}
+
+/**
+ * Checks if the writer adds to the saved content. Each checkpoint is appended to the log.
+ * @return true
+ */
+bool JournalWriter::isSourceIncremental()
+{
+  return true;
+}
+
+/**
+ * Jumps the write location up one level.
+ * @return true if the writer is started, even if already at the root
+ */
+bool JournalWriter::jumpToParentInSource()
+{
+  if(!started)
+    return false;
+
+  if(XmlDataView(branch).getNumElements() > 0)
+    branch.removeLastElement();
+  return true;
+}
+
+/**
+ * Jumps the write location back to the root.
+ * @return true if the writer is started
+ */
+bool JournalWriter::jumpToRootInSource()
+{
+  if(!started)
+    return false;
+
+  branch = XmlData();
+  return true;
+}
+
+/**
+ * Starts a new blank checkpoint. If the writer was already started, any unsaved lines are
+ * discarded.
+ * @return success status of beginning the write. Always true
+ */
+bool JournalWriter::startWriteToSource()
+{
+  buffer.truncate(0);
+  branch = XmlData();
+  last_branch = XmlData();
+  line_count = 0;
+  started = true;
+  return true;
+}
+
+/**
+ * Stops the writer. When saving a checkpoint with any lines, they are appended to the log as one
+ * checksummed frame and synced to disk. Either way, the buffer is truncated for the next start.
+ * @param save_changes true to append the checkpoint to the log. false to discard it
+ * @return success status of the append, if saving. false if not started
+ */
+bool JournalWriter::stopWriteToSource(bool save_changes)
+{
+  if(!started)
+    return false;
+
+  bool success = true;
+  if(save_changes && line_count > 0)
+  {
+    std::string payload;
+    payload += static_cast<char>(kVERSION);
+    std::string lines;
+    buffer.copyTo(lines);
+    payload += lines;
+
+    PageBuffer frame;
+    BinaryEncoding::appendVarint(frame, payload.size());
+    BinaryEncoding::appendFixed32(frame, BinaryEncoding::checksum(payload.data(),
+                                                                  payload.size()));
+    frame.append(payload);
+
+    std::lock_guard<std::mutex> guard(append_lock);
+    success = frame.appendToFile(path);
+  }
+
+  buffer.truncate(0);
+  branch = XmlData();
+  last_branch = XmlData();
+  line_count = 0;
+  started = false;
+  return success;
+}
+
+/**
+ * Writes a data line from its string form, converted to the typed payload.
+ * @param element name of the data element
+ * @param type category of the data
+ * @param data string converted data
+ * @return true if the data converted to the type and was written
+ */
+bool JournalWriter::writeDataToSource(std::string element, DataType type, std::string data)
+{
+  bool boolean_data;
+  float float_data;
+  int integer_data;
+  if(type == DataType::BOOLEAN && TextEncoding::readBoolean(data, boolean_data))
+    return writeDataToSource(element, boolean_data);
+  else if(type == DataType::INTEGER && TextEncoding::readInteger(data, integer_data))
+    return writeDataToSource(element, integer_data);
+  else if(type == DataType::FLOAT && TextEncoding::readFloat(data, float_data))
+    return writeDataToSource(element, float_data);
+  else if(type == DataType::STRING)
+    return writeDataToSource(element, data);
+  return false;
+}
+
+/**
+ * Writes a boolean data line as a single byte.
+ * @param element name of the data element
+ * @param data boolean to store
+ * @return true if the writer is started and the element name is valid
+ */
+bool JournalWriter::writeDataToSource(std::string element, bool data)
+{
+  if(!started || element.empty())
+    return false;
+
+  writeLineHeader(element, DataType::BOOLEAN);
+  buffer.append(static_cast<char>(data ? 1 : 0));
+  return true;
+}
+
+/**
+ * Writes a float data line as its raw 4 byte pattern.
+ * @param element name of the data element
+ * @param data float to store
+ * @return true if the writer is started and the element name is valid
+ */
+bool JournalWriter::writeDataToSource(std::string element, float data)
+{
+  if(!started || element.empty())
+    return false;
+
+  writeLineHeader(element, DataType::FLOAT);
+  BinaryEncoding::appendFloat(buffer, data);
+  return true;
+}
+
+/**
+ * Writes an integer data line as a zigzag varint.
+ * @param element name of the data element
+ * @param data integer to store
+ * @return true if the writer is started and the element name is valid
+ */
+bool JournalWriter::writeDataToSource(std::string element, int data)
+{
+  if(!started || element.empty())
+    return false;
+
+  writeLineHeader(element, DataType::INTEGER);
+  BinaryEncoding::appendSignedVarint(buffer, data);
+  return true;
+}
+
+/**
+ * Writes a string data line as a length and the raw bytes.
+ * @param element name of the data element
+ * @param data string to store
+ * @return true if the writer is started and the element name is valid
+ */
+bool JournalWriter::writeDataToSource(std::string element, std::string data)
+{
+  if(!started || element.empty())
+    return false;
+
+  writeLineHeader(element, DataType::STRING);
+  BinaryEncoding::appendString(buffer, data);
+  return true;
+}
+
+/**
+ * Writes an unsigned integer data line. It is stored under the general integer data type, as its
+ * full unsigned value.
+ * @param element name of the data element
+ * @param data unsigned integer to store
+ * @return true if the writer is started and the element name is valid
+ */
+bool JournalWriter::writeDataToSource(std::string element, uint32_t data)
+{
+  if(!started || element.empty())
+    return false;
+
+  writeLineHeader(element, DataType::INTEGER);
+  BinaryEncoding::appendSignedVarint(buffer, static_cast<int64_t>(data));
+  return true;
+}
+
+/**
+ * Writes a new child element at the current location and moves inside it. Nothing is appended
+ * until a data line is written beneath it.
+ * @param element name of the element
+ * @param key optional attribute key. Blank for none
+ * @param value attribute value paired with the key
+ * @return true if the writer is started and the element name is valid
+ */
+bool JournalWriter::writeElementToSource(std::string element, std::string key, std::string value)
+{
+  if(!started || element.empty())
+    return false;
+
+  branch.addElementBack(element, key, value);
+  return true;
+}
+
+/**
+ * Writes each element in the set as a nested child, moving inside the last one.
+ * @param element_set branch elements to write at the current location
+ * @return true if all elements were written
+ */
+bool JournalWriter::writeElementsToSource(XmlData element_set)
+{
+  XmlDataView elements(element_set);
+  bool success = started;
+  for(int i = 0; success && i < elements.getNumElements(); i++)
+    success = writeElementToSource(std::string(elements.getElement(i)),
+                                   std::string(elements.getKey(i)),
+                                   std::string(elements.getKeyValue(i)));
+  return success;
+}
+
+/*============================================================================
+ * PUBLIC FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Returns the number of data lines and removals in the checkpoint written since start().
+ * @return number of line and removal records
+ */
+uint32_t JournalWriter::getLineCount() const
+{
+  return line_count;
+}
+
+/**
+ * Returns the path to the log file that is appended to.
+ * @return file system path
+ */
+std::string JournalWriter::getPath() const
+{
+  return path;
+}
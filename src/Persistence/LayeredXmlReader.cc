@@ -0,0 +1,317 @@
+/**
+ * @class LayeredXmlReader
+ *
+ * Reader implementation that merges layered content packs into one stream of lines: a base pack
+ * and then any number of mod and patch packs, each of which overrides the earlier ones. Lines are
+ * merged by element path (every element name, key and value, then the data element name), and
+ * only the line of the last layer with a path is returned, so the loaders never see, or build
+ * anything from, the data that is overridden.
+ *
+ * The base is streamed in document order and each of its lines is returned in place, or replaced
+ * by the override of its path. The patch layers are read into memory when the reader is started,
+ * keeping only the last line of each path, since they don't share the document order of the base
+ * and are small next to it. The paths that the base doesn't have are returned after the end of
+ * the base, in the order they first appear in the layers. Overrides apply to single data lines,
+ * so a patch that replaces a whole object must override all of its lines.
+ */
+#include "Persistence/LayeredXmlReader.h"
+using namespace core;
+
+/*============================================================================
+ * CONSTRUCTORS / DESTRUCTORS
+ *===========================================================================*/
+
+/**
+ * Constructor function - Sets up the merge of the layers. Nothing is read until start() is
+ * called.
+ * @param layers readers of each layer in order: the base first, then each layer that overrides
+ *               the ones before it
+ */
+LayeredXmlReader::LayeredXmlReader(std::vector<std::unique_ptr<XmlReader>> layers)
+                : layers{std::move(layers)}
+{
+}
+
+/**
+ * Destructor function, stops the reader if it is still started.
+ */
+LayeredXmlReader::~LayeredXmlReader()
+{
+  stopReadFromSource();
+}
+
+/*============================================================================
+ * PRIVATE FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Builds the path key of the line: every element of the branch with its key and value, then the
+ * name of the data element, whose key is only its type. The key is built into the member, so its
+ * memory is reused from line to line.
+ * @param line the data line
+ */
+void LayeredXmlReader::buildPathKey(XmlDataView line)
+{
+  path_key.clear();
+  int last_index = line.getNumElements() - 1;
+  for(int i = 0; i < last_index; i++)
+    XmlIndex::appendPathKey(path_key, line.getElement(i), line.getKey(i), line.getKeyValue(i));
+  if(last_index >= 0)
+    XmlIndex::appendPathKey(path_key, line.getElement(last_index), "", "");
+}
+
+/**
+ * Reads every patch layer in order into the override lines. A path that repeats replaces the
+ * line kept for it, at the place where the path first appeared. Each layer is stopped once it's
+ * read.
+ * @return TRUE if every patch layer was started and read whole
+ */
+bool LayeredXmlReader::readOverrides()
+{
+  override_lines.clear();
+  override_paths.clear();
+  patch_modified_date.clear();
+
+  std::vector<XmlData> lines;
+  for(size_t i = 1; i < layers.size(); i++)
+  {
+    XmlReader* layer = layers[i].get();
+    if(!layer->start())
+      return false;
+    patch_modified_date = std::max(patch_modified_date, layer->lastModifiedDate());
+
+    bool done = false;
+    bool success = true;
+    while(!done && success)
+    {
+      size_t count = layer->readBatch(lines, done, success);
+      for(size_t j = 0; j < count; j++)
+      {
+        buildPathKey(XmlDataView(lines[j]));
+        auto path = override_paths.emplace(path_key, override_lines.size());
+        if(path.second)
+          override_lines.push_back(lines[j]);
+        else
+          override_lines[path.first->second] = lines[j];
+      }
+    }
+    lines.clear();
+    layer->stop();
+    if(!success)
+      return false;
+  }
+  return true;
+}
+
+/**
+ * Replaces the base line with the override of its path, if a patch layer has one.
+ * @param line the base line, replaced in place
+ */
+void LayeredXmlReader::replaceLine(XmlData& line)
+{
+  if(override_paths.empty())
+    return;
+
+  buildPathKey(XmlDataView(line));
+  auto path = override_paths.find(path_key);
+  if(path != override_paths.end())
+  {
+    line = override_lines[path->second];
+    if(!override_used[path->second])
+    {
+      override_used[path->second] = true;
+      override_used_count++;
+    }
+  }
+}
+
+/**
+ * Resets the read location back to the start of the base. Every override line is returned again.
+ */
+void LayeredXmlReader::resetReadLocation()
+{
+  base_done = false;
+  base_success = true;
+  override_used.assign(override_lines.size(), false);
+  override_used_count = 0;
+  tail_index = 0;
+}
+
+/*=============================================================================
+ * PRIVATE FUNCTIONS - XMLREADER
+ *============================================================================*/
+
+/**
+ * Finds an element node from the current read location. The lines of a node are spread over the
+ * layers, so this is not supported.
+ * @param branch the branch to find
+ * @return false
+ */
+bool LayeredXmlReader::findInSource(XmlData)
+{
+  return false;
+}
+
+/**
+ * Checks if the reader has been started.
+ * @return true if start() has been called and stop() has not been called since
+ */
+bool LayeredXmlReader::isSourceAvailable()
+{
+  return started;
+}
+
+/**
+ * Jumps the read location back to the start of the base.
+ * @return true if the reader is back at the start of the base for the next read()
+ */
+bool LayeredXmlReader::jumpToRootInSource()
+{
+  if(!started || !layers[0]->jumpToRoot())
+    return false;
+
+  resetReadLocation();
+  return true;
+}
+
+/**
+ * Returns the last modified date of the merged content: the latest date of any layer.
+ * @return UTC date formatted as YYYY-MM-DD HH:MM:SS. Blank if not started
+ */
+std::string LayeredXmlReader::lastModifiedDateFromSource()
+{
+  if(!started)
+    return "";
+  return std::max(layers[0]->lastModifiedDate(), patch_modified_date);
+}
+
+/**
+ * Reads the next batch of merged lines: the lines of the base, each replaced by its override if
+ * it has one, and then the override lines of the paths that the base doesn't have.
+ * @param lines buffer of lines, at least count long
+ * @param count maximum number of lines to read
+ * @param done set when the end of the base and the override lines has been reached
+ * @param success set if all lines were read and, at the end, the base was well formed
+ * @return number of lines read into the front of the buffer
+ */
+size_t LayeredXmlReader::readBatchFromSource(std::vector<XmlData>& lines, size_t count,
+                                             bool& done, bool& success)
+{
+  done = true;
+  success = false;
+  if(!started)
+    return 0;
+
+  size_t read_count = 0;
+  success = true;
+  if(!base_done)
+  {
+    read_count = layers[0]->readBatch(lines, base_done, success, count);
+    for(size_t i = 0; i < read_count; i++)
+      replaceLine(lines[i]);
+    if(base_done)
+      base_success = success;
+  }
+
+  if(base_done)
+  {
+    while(read_count < count && tail_index < override_lines.size())
+    {
+      if(!override_used[tail_index])
+        lines[read_count++] = override_lines[tail_index];
+      tail_index++;
+    }
+    success = success && base_success;
+  }
+
+  done = (base_done && tail_index >= override_lines.size());
+  return read_count;
+}
+
+/**
+ * Reads the next merged line.
+ * @param done set when the end has been reached and no line was returned
+ * @param success set if the line was read. At the end, if the base was well formed
+ * @return branch element that includes the full path location through the XML wrapping the data
+ */
+XmlData LayeredXmlReader::readFromSource(bool& done, bool& success)
+{
+  std::vector<XmlData> lines(1, XmlData(getMemoryResource()));
+  size_t read_count = readBatchFromSource(lines, 1, done, success);
+  done = (read_count == 0);
+  return std::move(lines[0]);
+}
+
+/**
+ * Starts the base and reads the patch layers into memory. If the reader was already started, it
+ * is restarted.
+ * @return success status of starting the base and reading every patch layer
+ */
+bool LayeredXmlReader::startReadFromSource()
+{
+  stopReadFromSource();
+  if(layers.empty() || !readOverrides() || !layers[0]->start())
+  {
+    override_lines.clear();
+    override_paths.clear();
+    return false;
+  }
+
+  started = true;
+  resetReadLocation();
+  return true;
+}
+
+/**
+ * Stops the base and drops the override lines.
+ * @return success status of cleaning up. Always true
+ */
+bool LayeredXmlReader::stopReadFromSource()
+{
+  if(started)
+    layers[0]->stop();
+
+  override_lines.clear();
+  override_paths.clear();
+  override_used.clear();
+  override_used_count = 0;
+  started = false;
+  return true;
+}
+
+/**
+ * Counts the total number of merged lines: the lines of the base and the override lines of the
+ * paths that the base doesn't have. Which paths the base has is only known once it has been read
+ * to the end, so until then, every override line that hasn't replaced a base line yet is counted.
+ * @return total count. Exact once the end of the base was reached. 0 if not started
+ */
+int LayeredXmlReader::totalDataCountFromSource()
+{
+  if(!started)
+    return 0;
+  return layers[0]->totalDataCount() +
+         static_cast<int>(override_lines.size() - override_used_count);
+}
+
+/*============================================================================
+ * PUBLIC FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Returns the number of layers that are merged, including the base.
+ * @return layer count
+ */
+size_t LayeredXmlReader::getLayerCount() const
+{
+  return layers.size();
+}
+
+/**
+ * Returns the number of distinct paths in the patch layers, once the reader is started. Each is
+ * either returned in place of the base lines at its path, or after the end of the base.
+ * @return override line count
+ */
+size_t LayeredXmlReader::getOverrideCount() const
+{
+  return override_lines.size();
+}
@@ -0,0 +1,251 @@
+/**
+ * @class LazySubtree
+ *
+ * Deferred load of a heavy subtree, such as the entries of a conversation or the win and lose
+ * events of a battle. When a load asks for lazy subtrees (see {@link LoadOptions}), the owner
+ * appends each data line of the subtree here instead of building its objects, and replays them
+ * through its loader the first time the subtree is accessed. The lines are kept as compact
+ * binary records (see {@link BinaryEncoding}) in small pages, which is a fraction of the size of
+ * the built objects, so the subtrees that are never triggered in a session cost neither the parse
+ * nor the memory.
+ */
+#include "Persistence/LazySubtree.h"
+using namespace core;
+
+/*============================================================================
+ * CONSTRUCTORS / DESTRUCTORS
+ *===========================================================================*/
+
+/**
+ * Constructor function, with no lines waiting.
+ */
+LazySubtree::LazySubtree()
+           : buffer(kPAGE_SIZE)
+{
+}
+
+/**
+ * Copy constructor, duplicates the waiting lines of the source.
+ * @param source object to copy
+ */
+LazySubtree::LazySubtree(const LazySubtree& source)
+           : buffer(kPAGE_SIZE)
+{
+  *this = source;
+}
+
+/*============================================================================
+ * PRIVATE STATIC FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Appends an element name or key. Interned names are stored as their atom, so most take a
+ * single byte: 0 for blank, the atom + 1 if it's interned, otherwise 1 and the string.
+ * @param name the element name or key
+ * @param atom interned atom of the name
+ */
+void LazySubtree::appendName(PageBuffer& buffer, std::string_view name, Atom atom)
+{
+  if(atom != Atom::NONE)
+  {
+    BinaryEncoding::appendVarint(buffer, static_cast<uint64_t>(atom) + 1);
+  }
+  else if(name.empty())
+  {
+    buffer.append(static_cast<char>(0));
+  }
+  else
+  {
+    buffer.append(static_cast<char>(1));
+    BinaryEncoding::appendString(buffer, name);
+  }
+}
+
+/**
+ * Decodes an element name or key at the cursor.
+ * @param cursor read location, advanced past the name on success
+ * @param end end of the readable data
+ * @param name the decoded name
+ * @param atom the interned atom of the name
+ * @return TRUE if the name was well formed
+ */
+bool LazySubtree::readName(const char*& cursor, const char* end, std::string_view& name,
+                           Atom& atom)
+{
+  uint64_t code;
+  if(!BinaryEncoding::readVarint(cursor, end, code))
+    return false;
+
+  atom = Atom::NONE;
+  name = std::string_view();
+  if(code == 1)
+    return BinaryEncoding::readString(cursor, end, name);
+  else if(code > 1)
+  {
+    if(code - 1 >= AtomTable::kCOUNT)
+      return false;
+    atom = static_cast<Atom>(code - 1);
+    name = AtomTable::getName(atom);
+  }
+  return true;
+}
+
+/*============================================================================
+ * PUBLIC FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Appends the data line to be loaded later. Only the elements from the index are kept, so each
+ * record is the element count, the name, key and value of each element, then the data element
+ * name, its {@link DataType} byte and the typed payload. Names and keys are stored as their
+ * atom where they are interned.
+ * @param data single packet of XML data
+ * @param index first element of the line that the loader reads, element 0 on replay
+ */
+void LazySubtree::append(XmlDataView data, int index)
+{
+  int last_index = data.getNumElements() - 1;
+  BinaryEncoding::appendVarint(buffer, last_index > index ? last_index - index : 0);
+  for(int i = index; i < last_index; i++)
+  {
+    appendName(buffer, data.getElement(i), data.getElementAtom(i));
+    appendName(buffer, data.getKey(i), data.getKeyAtom(i));
+    BinaryEncoding::appendString(buffer, data.getKeyValue(i));
+  }
+  appendName(buffer, data.getLastElement(), data.getElementAtom(last_index));
+
+  DataType type = data.getDataType();
+  buffer.append(static_cast<char>(type));
+  if(type == DataType::BOOLEAN)
+    buffer.append(static_cast<char>(data.getDataBoolean() ? 1 : 0));
+  else if(type == DataType::INTEGER)
+    BinaryEncoding::appendSignedVarint(buffer, data.getDataInteger());
+  else if(type == DataType::FLOAT)
+    BinaryEncoding::appendFloat(buffer, data.getDataFloat());
+  else if(type == DataType::STRING)
+    BinaryEncoding::appendString(buffer, data.getDataString());
+}
+
+/**
+ * Drops the lines that have not been loaded yet and releases their pages.
+ */
+void LazySubtree::clear()
+{
+  buffer = PageBuffer(kPAGE_SIZE);
+}
+
+/**
+ * Returns if there are no lines waiting to be loaded.
+ * @return TRUE if the subtree is fully loaded
+ */
+bool LazySubtree::isEmpty() const
+{
+  return (buffer.getSize() == 0);
+}
+
+/**
+ * Passes each waiting line to the loader, in the order they were appended, with the data element
+ * typed the same as a reader returns it. The line is reused between records to keep its memory.
+ * The lines are dropped before the first one is loaded, so the loader may append to the subtree
+ * again.
+ * @param load loader of a single line, which starts at element 0
+ */
+void LazySubtree::replay(const std::function<void(XmlDataView)>& load)
+{
+  std::string records;
+  buffer.copyTo(records);
+  clear();
+
+  const char* cursor = records.data();
+  const char* end = cursor + records.size();
+  XmlData line;
+  while(cursor < end)
+  {
+    while(XmlDataView(line).getNumElements() > 0)
+      line.removeLastElement();
+    uint64_t element_count;
+    if(!BinaryEncoding::readVarint(cursor, end, element_count))
+      return;
+    for(uint64_t i = 0; i < element_count; i++)
+    {
+      std::string_view element;
+      Atom element_atom;
+      std::string_view key;
+      Atom key_atom;
+      std::string_view value;
+      if(!readName(cursor, end, element, element_atom) ||
+         !readName(cursor, end, key, key_atom) ||
+         !BinaryEncoding::readString(cursor, end, value))
+        return;
+      line.addElementBack(element, key, value, element_atom, key_atom);
+    }
+
+    std::string_view element;
+    Atom element_atom;
+    if(!readName(cursor, end, element, element_atom) || cursor >= end)
+      return;
+    DataType type = static_cast<DataType>(*cursor++);
+    line.addElementBack(element, XmlData::kKEY_DATA_TYPE,
+                        TextEncoding::formatInteger(static_cast<int>(type)), element_atom,
+                        Atom::TYPE);
+    if(type == DataType::BOOLEAN && cursor < end)
+    {
+      line.setDataOfType(*cursor++ != 0);
+    }
+    else if(type == DataType::INTEGER)
+    {
+      int64_t integer_data;
+      if(!BinaryEncoding::readSignedVarint(cursor, end, integer_data))
+        return;
+      line.setDataOfType(static_cast<int>(integer_data));
+    }
+    else if(type == DataType::FLOAT)
+    {
+      float float_data;
+      if(!BinaryEncoding::readFloat(cursor, end, float_data))
+        return;
+      line.setDataOfType(float_data);
+    }
+    else if(type == DataType::STRING)
+    {
+      std::string_view string_data;
+      if(!BinaryEncoding::readString(cursor, end, string_data))
+        return;
+      line.setDataOfType(string_data);
+    }
+    else if(!XmlDataView(line).isDataUnset())
+    {
+      // The data of a reused line can't be unset, so an untyped line is rebuilt without it
+      XmlDataView typed_line(line);
+      XmlData untyped_line;
+      for(int i = 0; i < typed_line.getNumElements(); i++)
+        untyped_line.addElementBack(typed_line.getElement(i), typed_line.getKey(i),
+                                    typed_line.getKeyValue(i), typed_line.getElementAtom(i),
+                                    typed_line.getKeyAtom(i));
+      line = std::move(untyped_line);
+    }
+
+    load(XmlDataView(line));
+  }
+}
+
+/*=============================================================================
+ * OPERATOR FUNCTIONS
+ *============================================================================*/
+
+/**
+ * Copy assignment operator, duplicates the waiting lines of the source.
+ * @param source object to copy
+ * @return copied object, new memory
+ */
+LazySubtree& LazySubtree::operator=(const LazySubtree& source)
+{
+  if(&source != this)
+  {
+    std::string records;
+    source.buffer.copyTo(records);
+    clear();
+    buffer.append(records);
+  }
+  return *this;
+}
@@ -0,0 +1,441 @@
+/**
+ * @class MappedFile
+ *
+ * Read-only memory mapping of a file on disk. This wraps the platform specific calls so that
+ * reader backends can treat any size of file as a single contiguous buffer, with the operating
+ * system paging the content in and out on demand. A file written by {@link BlockCompression} is
+ * decoded a block at a time as the content is loaded, into memory that is only reserved when the
+ * file is opened, so the content is always the uncompressed document. Only a few decoded blocks
+ * are kept, so the memory used stays small regardless of the size of the file.
+ */
+#include "Persistence/MappedFile.h"
+
+// Platform headers are kept out of the public header to avoid leaking their macros
+#ifdef _WIN32
+  #include <windows.h>
+#else
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+using namespace core;
+
+/*============================================================================
+ * CONSTRUCTORS / DESTRUCTORS
+ *===========================================================================*/
+
+/**
+ * Destructor function, unmaps and closes the file if it is still open.
+ */
+MappedFile::~MappedFile()
+{
+  close();
+}
+
+/*============================================================================
+ * PRIVATE FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Decodes a block of the compressed file into its place in the content. If the cache is full,
+ * the least recently used block outside the kept range is evicted first. The kept range is never
+ * evicted, so the cache grows past its size when a single load needs more blocks than it holds.
+ * @param index index of the block
+ * @param keep_first first block that is kept
+ * @param keep_last last block that is kept
+ * @return TRUE if the block was decoded. FALSE if it's malformed
+ */
+bool MappedFile::decodeBlock(size_t index, size_t keep_first, size_t keep_last)
+{
+  if(cached_blocks.size() >= kCACHED_BLOCKS)
+  {
+    for(size_t i = 0; i < cached_blocks.size(); i++)
+    {
+      if(cached_blocks[i] < keep_first || cached_blocks[i] > keep_last)
+      {
+        evictBlock(i);
+        break;
+      }
+    }
+  }
+
+  size_t offset = index * block_table.block_size;
+  size_t length = std::min(size - offset, block_table.block_size);
+  char* block = const_cast<char*>(data) + offset;
+#ifdef _WIN32
+  if(VirtualAlloc(block, length, MEM_COMMIT, PAGE_READWRITE) == nullptr)
+    return false;
+#endif
+  if(!BlockCompression::decompressBlock(block_table, index, const_cast<char*>(data)))
+  {
+#ifdef _WIN32
+    VirtualFree(block, length, MEM_DECOMMIT);
+#else
+    madvise(block, length, MADV_DONTNEED);
+#endif
+    return false;
+  }
+
+  block_decoded[index] = true;
+  cached_blocks.push_back(index);
+  return true;
+}
+
+/**
+ * Releases the memory of a decoded block of the compressed file. The content of the block is not
+ * readable until it's loaded again.
+ * @param position position of the block in the cache, least recently used first
+ */
+void MappedFile::evictBlock(size_t position)
+{
+  size_t index = cached_blocks[position];
+  size_t offset = index * block_table.block_size;
+  size_t length = std::min(size - offset, block_table.block_size);
+  char* block = const_cast<char*>(data) + offset;
+#ifdef _WIN32
+  VirtualFree(block, length, MEM_DECOMMIT);
+#else
+  madvise(block, length, MADV_DONTNEED);
+#endif
+
+  block_decoded[index] = false;
+  cached_blocks.erase(cached_blocks.begin() + position);
+}
+
+/**
+ * Reads the block table of the mapped compressed file and reserves the memory the content is
+ * decoded into. Memory is only used once a block is decoded into it.
+ * @return TRUE if the block table is well formed and the memory was reserved
+ */
+bool MappedFile::openCompressed()
+{
+  if(!BlockCompression::readBlockTable(mapped_data, mapped_size, block_table))
+    return false;
+
+  size = block_table.content_size;
+  block_decoded.assign(block_table.offsets.size(), false);
+  if(size == 0)
+  {
+    data = nullptr;
+    return true;
+  }
+
+#ifdef _WIN32
+  data = static_cast<const char*>(VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_READWRITE));
+  return (data != nullptr);
+#else
+  void* content = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if(content == MAP_FAILED)
+    return false;
+  data = static_cast<const char*>(content);
+  return true;
+#endif
+}
+
+/*============================================================================
+ * PUBLIC FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Unmaps and closes the file. Any pointers previously returned by getData() are invalid after
+ * this call. If the file is not open, this is a no-op.
+ */
+void MappedFile::close()
+{
+  bool compressed = isCompressed();
+
+#ifdef _WIN32
+  if(compressed && data != nullptr)
+    VirtualFree(const_cast<char*>(data), 0, MEM_RELEASE);
+  if(mapped_data != nullptr)
+    UnmapViewOfFile(mapped_data);
+  if(map_handle != -1)
+    CloseHandle(reinterpret_cast<HANDLE>(map_handle));
+  if(file_handle != -1)
+    CloseHandle(reinterpret_cast<HANDLE>(file_handle));
+#else
+  if(compressed && data != nullptr)
+    munmap(const_cast<char*>(data), size);
+  if(mapped_data != nullptr)
+    munmap(const_cast<char*>(mapped_data), mapped_size);
+  if(file_handle != -1)
+    ::close(static_cast<int>(file_handle));
+#endif
+
+  block_decoded.clear();
+  block_table = BlockCompression::BlockTable();
+  cached_blocks.clear();
+  data = nullptr;
+  file_handle = -1;
+  map_handle = -1;
+  mapped_data = nullptr;
+  mapped_size = 0;
+  modified_time = 0;
+  mapped = false;
+  size = 0;
+}
+
+/**
+ * Returns the start of the file content. This buffer is exactly getSize() bytes long and is not
+ * null terminated. For a compressed file, only the content made readable with load() is valid.
+ * @return pointer to the first byte. Null if the file is not open or is empty
+ */
+const char* MappedFile::getData() const
+{
+  return data;
+}
+
+/**
+ * Returns the last modified date of the file, as it was when it was opened.
+ * @return UTC date formatted as YYYY-MM-DD HH:MM:SS. Blank if not open
+ */
+std::string MappedFile::getModifiedDate() const
+{
+  if(!mapped)
+    return "";
+
+  std::tm* modified_tm = std::gmtime(&modified_time);
+  if(modified_tm == nullptr)
+    return "";
+
+  char formatted[32];
+  std::strftime(formatted, sizeof(formatted), "%Y-%m-%d %H:%M:%S", modified_tm);
+  return formatted;
+}
+
+/**
+ * Returns the last modified time of the file, as it was when it was opened.
+ * @return modified time, in seconds since epoch. 0 if not open
+ */
+std::time_t MappedFile::getModifiedTime() const
+{
+  return modified_time;
+}
+
+/**
+ * Returns the size of the file content. For a compressed file, this is the decoded size.
+ * @return size in bytes
+ */
+size_t MappedFile::getSize() const
+{
+  return size;
+}
+
+/**
+ * Returns if the content is decoded from a compressed file, instead of mapped as is.
+ * @return TRUE if the content has to be loaded before it's read
+ */
+bool MappedFile::isCompressed() const
+{
+  return (block_table.blocks != nullptr);
+}
+
+/**
+ * Returns if the file is open and mapped.
+ * @return TRUE if open() succeeded and close() has not been called since
+ */
+bool MappedFile::isOpen() const
+{
+  return mapped;
+}
+
+/**
+ * Makes the content in the range readable. The content of a file mapped as is always is. The
+ * blocks of a compressed file that the range covers are decoded, unless they're in the cache
+ * already, and those blocks are the most recently used.
+ * @param begin offset of the first byte that must be readable
+ * @param end offset past the last byte that must be readable
+ * @return offset past the content that is readable from the beginning, which is at least the end
+ *         unless it's past the content or a block is malformed. The beginning if nothing is
+ */
+size_t MappedFile::load(size_t begin, size_t end)
+{
+  if(!isCompressed() || begin >= size)
+    return size;
+
+  end = std::min(std::max(end, begin + 1), size);
+  size_t first = begin / block_table.block_size;
+  size_t last = (end - 1) / block_table.block_size;
+  size_t index = first;
+  for(; index <= last; index++)
+  {
+    if(block_decoded[index])
+    {
+      auto cached = std::find(cached_blocks.begin(), cached_blocks.end(), index);
+      std::rotate(cached, cached + 1, cached_blocks.end());
+    }
+    else if(!decodeBlock(index, first, last))
+    {
+      return std::max(begin, index * block_table.block_size);
+    }
+  }
+
+  // Any decoded blocks right after the range are readable as well
+  while(index < block_decoded.size() && block_decoded[index])
+    index++;
+  return std::min(index * block_table.block_size, size);
+}
+
+/**
+ * Scans the next token with a tokenizer over the content from tokenize(). A token that reaches
+ * the end of the readable content is scanned again once the next block is loaded, so it is only
+ * returned once it's complete, or the end of the content is reached.
+ * @param tokenizer tokenizer over the readable content, which is replaced as more is loaded
+ * @param end offset past the content that is tokenized. Default is all of it
+ * @return the classification of the token, as from XmlTokenizer#next
+ */
+XmlTokenType MappedFile::nextToken(XmlTokenizer& tokenizer, size_t end)
+{
+  XmlTokenType type = tokenizer.next();
+  end = std::min(end, size);
+  while(tokenizer.getOffset() >= tokenizer.getSize() && tokenizer.getSize() < end)
+  {
+    size_t token_offset = tokenizer.getTokenOffset();
+    size_t readable = load(token_offset, tokenizer.getSize() + 1);
+    if(readable <= tokenizer.getSize())
+      break;
+
+    tokenizer = XmlTokenizer(data, std::min(readable, end));
+    tokenizer.seek(token_offset);
+    type = tokenizer.next();
+  }
+  return type;
+}
+
+/**
+ * Opens and maps the file at the path for reading. Any previously opened file is closed first.
+ * An empty file is valid and opens with a null data pointer and a size of 0. A compressed file
+ * keeps the mapping to decode its blocks from, and fails the open if its block table is
+ * malformed. Its blocks are only checked as they're loaded.
+ * @param path file system path of the file to map
+ * @return TRUE if the file was opened and mapped
+ */
+bool MappedFile::open(const std::string& path)
+{
+  close();
+
+#ifdef _WIN32
+  HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if(file == INVALID_HANDLE_VALUE)
+    return false;
+  file_handle = reinterpret_cast<intptr_t>(file);
+
+  LARGE_INTEGER file_size;
+  FILETIME file_time;
+  if(!GetFileSizeEx(file, &file_size) || !GetFileTime(file, nullptr, nullptr, &file_time))
+  {
+    close();
+    return false;
+  }
+  size = static_cast<size_t>(file_size.QuadPart);
+
+  // FILETIME is 100ns intervals since 1601-01-01, convert to seconds since the unix epoch
+  ULARGE_INTEGER file_time_value;
+  file_time_value.LowPart = file_time.dwLowDateTime;
+  file_time_value.HighPart = file_time.dwHighDateTime;
+  modified_time = static_cast<std::time_t>(file_time_value.QuadPart / 10000000ULL -
+                                           11644473600ULL);
+
+  if(size > 0)
+  {
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if(mapping == nullptr)
+    {
+      close();
+      return false;
+    }
+    map_handle = reinterpret_cast<intptr_t>(mapping);
+
+    data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if(data == nullptr)
+    {
+      close();
+      return false;
+    }
+  }
+#else
+  int file = ::open(path.c_str(), O_RDONLY);
+  if(file < 0)
+    return false;
+  file_handle = file;
+
+  struct stat file_stat;
+  if(fstat(file, &file_stat) != 0)
+  {
+    close();
+    return false;
+  }
+  size = static_cast<size_t>(file_stat.st_size);
+  modified_time = file_stat.st_mtime;
+
+  if(size > 0)
+  {
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+    if(mapping == MAP_FAILED)
+    {
+      close();
+      return false;
+    }
+    data = static_cast<const char*>(mapping);
+    madvise(mapping, size, MADV_SEQUENTIAL);
+  }
+#endif
+
+  mapped = true;
+  mapped_data = data;
+  mapped_size = size;
+  if(BlockCompression::isCompressed(data, size) && !openCompressed())
+  {
+    close();
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Hints to the operating system that all content before the offset is no longer needed in
+ * memory. The content is still valid and will be paged back in if it is accessed again. This
+ * keeps the resident size of a forward only scan constant, regardless of the file size. For a
+ * compressed file, the decoded blocks before the offset are evicted and have to be loaded again.
+ * @param offset byte offset in the content. Only whole pages or blocks before this offset are
+ *               released
+ */
+void MappedFile::releaseBefore(size_t offset)
+{
+  if(isCompressed())
+  {
+    for(size_t i = cached_blocks.size(); i > 0; i--)
+      if((cached_blocks[i - 1] + 1) * block_table.block_size <= offset)
+        evictBlock(i - 1);
+    return;
+  }
+
+#ifndef _WIN32
+  if(data != nullptr && offset <= size)
+  {
+    size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t release_size = offset - (offset % page_size);
+    if(release_size > 0)
+      madvise(const_cast<char*>(data), release_size, MADV_DONTNEED);
+  }
+#endif
+}
+
+/**
+ * Returns a tokenizer over the content that starts at the offset. The tokenizer only covers the
+ * content that's readable from the offset, so its tokens must be scanned with nextToken().
+ * @param offset byte offset in the content, at a token boundary
+ * @param end offset past the content that is tokenized. Default is all of it
+ * @return tokenizer at the offset. At its end if the offset isn't readable
+ */
+XmlTokenizer MappedFile::tokenize(size_t offset, size_t end)
+{
+  size_t readable = load(offset, offset + 1);
+  XmlTokenizer tokenizer(data, std::min(std::min(readable, end), size));
+  tokenizer.seek(offset);
+  return tokenizer;
+}
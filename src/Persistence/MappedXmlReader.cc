@@ -0,0 +1,683 @@
+/**
+ * @class MappedXmlReader
+ *
+ * Streaming XML reader implementation that memory maps the source file and tokenizes it
+ * incrementally as lines are requested. No document tree is ever built: the only state held is
+ * the element branch to the current read location, so memory stays constant regardless of the
+ * size of the file. Data elements are expected in the form <element type="N">data</element>,
+ * where N is the numeric {@link DataType} of the data. If the source has an up to date
+ * {@link XmlIndex} sidecar, find() seeks straight to the element instead of scanning for it.
+ */
+#include "Persistence/MappedXmlReader.h"
+using namespace core;
+
+/*============================================================================
+ * CONSTRUCTORS / DESTRUCTORS
+ *===========================================================================*/
+
+/**
+ * Constructor function - Sets up the reader for the source file. Nothing is opened until start()
+ * is called.
+ * @param path file system path to the XML source file
+ */
+MappedXmlReader::MappedXmlReader(std::string path)
+               : path{path}
+{
+}
+
+/**
+ * Constructor function - Sets up a split reader that only reads a range of the source file. The
+ * range must start and end on element boundaries, within the elements of the wrapping branch.
+ * @param path file system path to the XML source file
+ * @param range_begin offset in the source where the range starts
+ * @param range_end offset in the source where the range ends
+ * @param range_branch elements that wrap the range, added to the front of every line
+ */
+MappedXmlReader::MappedXmlReader(std::string path, size_t range_begin, size_t range_end,
+                                 XmlData range_branch)
+               : path{path},
+                 range_begin{range_begin},
+                 range_branch{range_branch},
+                 range_end{range_end}
+{
+}
+
+/**
+ * Destructor function, stops the reader if it is still started.
+ */
+MappedXmlReader::~MappedXmlReader()
+{
+  stopReadFromSource();
+}
+
+/*============================================================================
+ * PRIVATE FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Finds an element node from the current read location with a seek through the index. The index
+ * only answers when the result is the same as a scan would give: the element that holds the read
+ * location must be the first one at its path, and the target must name a key at every level but
+ * the last. Every seek is checked against the open tag in the source, and a mismatch drops the
+ * index as out of date.
+ * @param target the child branch to find
+ * @param found set if the branch was found and the read location moved inside it
+ * @return TRUE if the index answered, FALSE if the source has to be scanned instead
+ */
+bool MappedXmlReader::findInIndex(XmlDataView target, bool& found)
+{
+  found = false;
+  if(index.isEmpty())
+    return false;
+
+  // The element holding the read location bounds the search
+  XmlDataView branch_view(branch);
+  size_t offset = tokenizer.getOffset();
+  size_t holder_end = range_end;
+  std::string path_key;
+  for(int i = 0; i < branch_view.getNumElements(); i++)
+    XmlIndex::appendPathKey(path_key, branch_view.getElement(i), branch_view.getKey(i),
+                            branch_view.getKeyValue(i));
+  if(!path_key.empty())
+  {
+    uint32_t holder;
+    bool unique;
+    if(!index.find(path_key, holder, unique) || index.getTagOffset(holder) >= offset ||
+       index.getEndOffset(holder) < offset)
+      return false;
+    holder_end = std::min(holder_end, index.getEndOffset(holder));
+  }
+
+  // Resolve the target a level at a time. Where more than one element matches a level, the
+  // first one is taken, since it holds the first match in document order if there is one
+  int target_count = target.getNumElements();
+  uint32_t entry = XmlIndex::kNO_ENTRY;
+  bool all_unique = true;
+  for(int i = 0; i < target_count; i++)
+  {
+    std::string level_key = path_key;
+    XmlIndex::appendPathKey(level_key, target.getElement(i), target.getKey(i),
+                            target.getKeyValue(i));
+    bool unique;
+    if(!index.find(level_key, entry, unique))
+    {
+      // A keyed element missing under the only possible parents doesn't exist. Data elements
+      // aren't indexed, so they have to be scanned for
+      std::string_view key = target.getKey(i);
+      return (all_unique && !key.empty() && key != XmlData::kKEY_DATA_TYPE);
+    }
+
+    all_unique &= unique;
+    XmlIndex::appendPathKey(path_key, index.getElement(entry), index.getKey(entry),
+                            index.getKeyValue(entry));
+  }
+  if(index.getTagOffset(entry) < offset || index.getEndOffset(entry) > holder_end)
+    return false;
+
+  // Confirm the open tag is where the index says it is
+  bool valid = true;
+  tokenizer = file.tokenize(index.getTagOffset(entry), range_end);
+  if(file.nextToken(tokenizer, range_end) != XmlTokenType::ELEMENT_OPEN ||
+     tokenizer.getName() != index.getElement(entry) ||
+     XmlTokenizer::decodeView(tokenizer.getKey(), decoded_key, valid) != index.getKey(entry) ||
+     XmlTokenizer::decodeView(tokenizer.getValue(), decoded_value, valid) !=
+       index.getKeyValue(entry) || !valid)
+  {
+    tokenizer = file.tokenize(offset, range_end);
+    index.clear();
+    return false;
+  }
+
+  std::vector<uint32_t> chain;
+  for(uint32_t level = entry; chain.size() < static_cast<size_t>(target_count);
+      level = index.getParent(level))
+    chain.push_back(level);
+  for(auto level = chain.rbegin(); level != chain.rend(); level++)
+    branch.addElementBack(index.getElement(*level), index.getKey(*level),
+                          index.getKeyValue(*level));
+
+  leaf_open = true;
+  leaf_text.clear();
+  leaf_text_valid = true;
+  found = true;
+  return true;
+}
+
+/**
+ * Returns if the top (last) element of the read branch matches the element name. This is used
+ * to validate a close tag against the element it is closing.
+ * @param element the tag name to check
+ * @return TRUE if the branch is not empty and the last element matches
+ */
+bool MappedXmlReader::isBranchTop(std::string_view element)
+{
+  XmlDataView branch_view(branch);
+  return (branch_view.getNumElements() > 0 && branch_view.getLastElement() == element);
+}
+
+/**
+ * Returns if the top (last) element of the read branch is a data element, as defined by the data
+ * type attribute key.
+ * @return TRUE if the last element holds the data type attribute
+ */
+bool MappedXmlReader::isBranchTopData()
+{
+  XmlDataView branch_view(branch);
+  int count = branch_view.getNumElements();
+  return (count > 0 && branch_view.getKey(count - 1) == XmlData::kKEY_DATA_TYPE);
+}
+
+/**
+ * Reads the next data element into the line by pulling tokens from the source until a data
+ * element is closed. The line is assigned from the branch, which reuses the memory it holds.
+ * @param line set to the branch element that includes the full path location through the XML
+ *             wrapping the data. Untouched if no line was read
+ * @param done set when the end of the source has been reached and no line was read
+ * @param success set if the line was read and its data converted successfully. Data with an
+ *                unknown or malformed entity is not. An unsuccessful read at the end is a
+ *                malformed source
+ */
+void MappedXmlReader::readLine(XmlData& line, bool& done, bool& success)
+{
+  done = true;
+  success = false;
+  if(!file.isOpen())
+    return;
+
+  // Keep the resident memory of the mapping constant as the read moves forward
+  if(tokenizer.getOffset() - released_offset >= kRELEASE_INTERVAL)
+  {
+    released_offset = tokenizer.getOffset();
+    file.releaseBefore(released_offset);
+  }
+
+  while(true)
+  {
+    XmlTokenType type = file.nextToken(tokenizer, range_end);
+    if(type == XmlTokenType::ELEMENT_OPEN || type == XmlTokenType::ELEMENT_EMPTY)
+    {
+      // A malformed entity in the key or value is malformed markup
+      bool valid = true;
+      std::string_view key = XmlTokenizer::decodeView(tokenizer.getKey(), decoded_key, valid);
+      std::string_view value = XmlTokenizer::decodeView(tokenizer.getValue(), decoded_value,
+                                                        valid);
+      if(!valid)
+        return;
+
+      branch.addElementBack(tokenizer.getName(), key, value);
+      leaf_open = (type == XmlTokenType::ELEMENT_OPEN);
+      leaf_text.clear();
+      leaf_text_valid = true;
+
+      // An empty data element holds blank data
+      if(type == XmlTokenType::ELEMENT_EMPTY)
+      {
+        if(isBranchTopData())
+        {
+          line = branch;
+          branch.removeLastElement();
+
+          done = false;
+          success = (line.setData(leaf_text) && leaf_text_valid);
+          return;
+        }
+        branch.removeLastElement();
+      }
+    }
+    else if(type == XmlTokenType::TEXT)
+    {
+      if(leaf_open)
+      {
+        if(tokenizer.isTextEncoded())
+          leaf_text_valid &= XmlTokenizer::decode(tokenizer.getText(), leaf_text);
+        else
+          leaf_text.append(tokenizer.getText());
+      }
+    }
+    else if(type == XmlTokenType::ELEMENT_CLOSE)
+    {
+      if(!isBranchTop(tokenizer.getName()))
+        return;
+
+      bool data_element = (leaf_open && isBranchTopData());
+      leaf_open = false;
+      if(data_element)
+      {
+        line = branch;
+        branch.removeLastElement();
+
+        done = false;
+        success = (line.setData(leaf_text) && leaf_text_valid);
+        return;
+      }
+      branch.removeLastElement();
+    }
+    else if(type == XmlTokenType::END)
+    {
+      success = (branch.getNumElements() == range_branch.getNumElements());
+      return;
+    }
+    else
+    {
+      return;
+    }
+  }
+}
+
+/**
+ * Resets the read location back to the start of the source (or the range), with the branch that
+ * wraps it.
+ */
+void MappedXmlReader::resetReadLocation()
+{
+  branch = range_branch;
+  leaf_open = false;
+  leaf_text.clear();
+  leaf_text_valid = true;
+  released_offset = range_begin;
+  tokenizer = file.tokenize(range_begin, range_end);
+}
+
+/*=============================================================================
+ * PRIVATE FUNCTIONS - XMLREADER
+ *============================================================================*/
+
+/**
+ * Finds an element node from the current read location, with the index if it can answer or
+ * otherwise by scanning forward through the source. The search is limited to the element that
+ * holds the current read location. If the branch is found, the next read() returns the first
+ * data element inside it. If it isn't, the read location is left untouched.
+ * @param branch the child branch to find. Any key left blank in the branch matches any key
+ * @return true if the path was found and the read pointer was moved
+ */
+bool MappedXmlReader::findInSource(XmlData branch)
+{
+  if(!file.isOpen())
+    return false;
+
+  XmlDataView target(branch);
+  int target_count = target.getNumElements();
+  if(target_count == 0)
+    return true;
+
+  bool found_in_index;
+  if(findInIndex(target, found_in_index))
+    return found_in_index;
+
+  // Keep the starting read location, to restore it if the branch isn't found
+  XmlData start_branch = this->branch;
+  bool start_leaf_open = leaf_open;
+  std::string start_leaf_text = leaf_text;
+  bool start_leaf_text_valid = leaf_text_valid;
+  size_t start_offset = tokenizer.getOffset();
+
+  int base_count = this->branch.getNumElements();
+  int matched_count = 0;
+  bool found = false;
+  bool scanning = true;
+  while(scanning)
+  {
+    XmlTokenType type = file.nextToken(tokenizer, range_end);
+    if(type == XmlTokenType::ELEMENT_OPEN)
+    {
+      bool valid = true;
+      std::string_view key = XmlTokenizer::decodeView(tokenizer.getKey(), decoded_key, valid);
+      std::string_view value = XmlTokenizer::decodeView(tokenizer.getValue(), decoded_value,
+                                                        valid);
+      if(!valid)
+        break;
+
+      int level = this->branch.getNumElements() - base_count;
+      this->branch.addElementBack(tokenizer.getName(), key, value);
+
+      // Only extends the match if all parent levels matched as well
+      XmlDataView branch_view(this->branch);
+      int top = branch_view.getNumElements() - 1;
+      if(level == matched_count && level < target_count &&
+         target.getElement(level) == branch_view.getElement(top) &&
+         (target.getKey(level).empty() ||
+          (target.getKey(level) == branch_view.getKey(top) &&
+           target.getKeyValue(level) == branch_view.getKeyValue(top))))
+      {
+        matched_count++;
+        if(matched_count == target_count)
+        {
+          found = true;
+          scanning = false;
+        }
+      }
+    }
+    else if(type == XmlTokenType::ELEMENT_CLOSE)
+    {
+      if(!isBranchTop(tokenizer.getName()))
+        scanning = false;
+      else
+      {
+        this->branch.removeLastElement();
+
+        // Left the element that held the starting read location
+        int level_count = this->branch.getNumElements() - base_count;
+        if(level_count < 0)
+          scanning = false;
+        else if(matched_count > level_count)
+          matched_count = level_count;
+      }
+    }
+    else if(type == XmlTokenType::END || type == XmlTokenType::ERROR)
+    {
+      scanning = false;
+    }
+  }
+
+  if(found)
+  {
+    leaf_open = true;
+    leaf_text.clear();
+    leaf_text_valid = true;
+  }
+  else
+  {
+    this->branch = start_branch;
+    leaf_open = start_leaf_open;
+    leaf_text = start_leaf_text;
+    leaf_text_valid = start_leaf_text_valid;
+    tokenizer = file.tokenize(start_offset, range_end);
+  }
+  return found;
+}
+
+/**
+ * Checks if the reader has been started and the source file is mapped.
+ * @return true if start() has been called and the source is still available
+ */
+bool MappedXmlReader::isSourceAvailable()
+{
+  return file.isOpen();
+}
+
+/**
+ * Jumps the read location back to the start of the document.
+ * @return true if the reader is back at the root of the source for the next read()
+ */
+bool MappedXmlReader::jumpToRootInSource()
+{
+  if(!file.isOpen())
+    return false;
+
+  resetReadLocation();
+  return true;
+}
+
+/**
+ * Returns the last modified date of the source file, when the reader was started.
+ * @return UTC date formatted as YYYY-MM-DD HH:MM:SS. Blank if not started
+ */
+std::string MappedXmlReader::lastModifiedDateFromSource()
+{
+  return file.getModifiedDate();
+}
+
+/**
+ * Reads the next batch of data elements, filling each line of the buffer in place with the
+ * branch so the lines keep their memory from batch to batch.
+ * @param lines buffer of lines, at least count long
+ * @param count maximum number of lines to read
+ * @param done set when the end of the source has been reached
+ * @param success set if all lines were read and, at the end, the source was well formed
+ * @return number of lines read into the front of the buffer
+ */
+size_t MappedXmlReader::readBatchFromSource(std::vector<XmlData>& lines, size_t count,
+                                            bool& done, bool& success)
+{
+  size_t read_count = 0;
+  bool all_valid = true;
+  done = false;
+  while(read_count < count && !done)
+  {
+    bool line_success;
+    readLine(lines[read_count], done, line_success);
+    if(done)
+      all_valid &= line_success;
+    else if(line_success)
+      read_count++;
+    else
+      all_valid = false;
+  }
+
+  success = all_valid;
+  return read_count;
+}
+
+/**
+ * Reads the next data element by pulling tokens from the source until a data element is closed.
+ * @param done set when the end of the source has been reached and no line was returned
+ * @param success set if the returned line was read and its data converted successfully. An
+ *                unsuccessful read at the end is a malformed source
+ * @return branch element that includes the full path location through the XML wrapping the data
+ */
+XmlData MappedXmlReader::readFromSource(bool& done, bool& success)
+{
+  XmlData line(getMemoryResource());
+  readLine(line, done, success);
+  return line;
+}
+
+/**
+ * Maps the source file and moves the read location to the start of the document. If the reader
+ * was already started, it is restarted.
+ * @return success status of opening and mapping the file
+ */
+bool MappedXmlReader::startReadFromSource()
+{
+  if(!file.open(path))
+    return false;
+
+  total_data_count = -1;
+  resetReadLocation();
+
+  // Split readers only read forward through their range, so they skip loading the index
+  if(range_branch.getNumElements() == 0)
+    index.load(path, file);
+  return true;
+}
+
+/**
+ * Unmaps and closes the source file.
+ * @return success status of cleaning up. Always true
+ */
+bool MappedXmlReader::stopReadFromSource()
+{
+  file.close();
+  index.clear();
+  tokenizer = XmlTokenizer();
+  total_data_count = -1;
+  resetReadLocation();
+  return true;
+}
+
+/**
+ * Counts the total number of data elements in the source. This scans the entire source once
+ * without building any lines, and is cached for the rest of the read.
+ * @return total count. 0 if not started
+ */
+int MappedXmlReader::totalDataCountFromSource()
+{
+  if(!file.isOpen())
+    return 0;
+
+  if(total_data_count < 0)
+  {
+    XmlTokenizer counter = file.tokenize(range_begin, range_end);
+    bool counting = true;
+    bool element_data = false;
+    bool element_open = false;
+
+    total_data_count = 0;
+    while(counting)
+    {
+      XmlTokenType type = file.nextToken(counter, range_end);
+      if(type == XmlTokenType::ELEMENT_OPEN)
+      {
+        element_data = (counter.getKey() == XmlData::kKEY_DATA_TYPE);
+        element_open = true;
+      }
+      else if(type == XmlTokenType::ELEMENT_EMPTY)
+      {
+        if(counter.getKey() == XmlData::kKEY_DATA_TYPE)
+          total_data_count++;
+        element_open = false;
+      }
+      else if(type == XmlTokenType::ELEMENT_CLOSE)
+      {
+        if(element_open && element_data)
+          total_data_count++;
+        element_open = false;
+      }
+      else if(type != XmlTokenType::TEXT)
+      {
+        counting = false;
+      }
+    }
+
+    // The blocks of a compressed source that the read is at are released with the rest
+    file.releaseBefore(file.getSize());
+    tokenizer = file.tokenize(tokenizer.getOffset(), range_end);
+  }
+
+  return total_data_count;
+}
+
+/**
+ * Splits the source into independent readers over contiguous runs of the top-level elements.
+ * The source is scanned once, without building any lines, to find where each top-level element
+ * starts. The runs are then balanced by size. A split reader can not be split again.
+ * @param shard_count maximum number of readers to split into
+ * @return split readers in document order. Empty if the source is malformed or has no top-level
+ *         elements
+ */
+std::vector<std::unique_ptr<XmlReader>> MappedXmlReader::splitSource(int shard_count)
+{
+  std::vector<std::unique_ptr<XmlReader>> shards;
+  MappedFile source;
+  if(shard_count < 1 || range_branch.getNumElements() > 0 || !source.open(path))
+    return shards;
+
+  // Find the root element and the start of each top-level element inside it
+  XmlTokenizer scanner = source.tokenize(0);
+  XmlData root;
+  std::vector<size_t> element_begin;
+  size_t elements_end = 0;
+  int depth = 0;
+  bool scanning = true;
+  while(scanning)
+  {
+    XmlTokenType type = source.nextToken(scanner);
+    if(type == XmlTokenType::ELEMENT_OPEN)
+    {
+      if(depth == 0)
+      {
+        // Only a single root element can be split
+        if(root.getNumElements() > 0)
+          return shards;
+        bool valid = true;
+        std::string decoded_key;
+        std::string decoded_value;
+        root.addElementBack(scanner.getName(),
+                            XmlTokenizer::decodeView(scanner.getKey(), decoded_key, valid),
+                            XmlTokenizer::decodeView(scanner.getValue(), decoded_value, valid));
+        if(!valid)
+          return shards;
+      }
+      else if(depth == 1)
+        element_begin.push_back(scanner.getTokenOffset());
+      depth++;
+    }
+    else if(type == XmlTokenType::ELEMENT_EMPTY)
+    {
+      if(depth == 1)
+      {
+        element_begin.push_back(scanner.getTokenOffset());
+        elements_end = scanner.getOffset();
+      }
+    }
+    else if(type == XmlTokenType::ELEMENT_CLOSE)
+    {
+      depth--;
+      if(depth == 1)
+        elements_end = scanner.getOffset();
+      else if(depth < 0)
+        return shards;
+    }
+    else if(type == XmlTokenType::END)
+    {
+      scanning = false;
+    }
+    else if(type == XmlTokenType::ERROR)
+    {
+      return shards;
+    }
+  }
+  if(depth != 0 || element_begin.empty())
+    return shards;
+
+  // Cut the runs at the first element start past each even share of the size
+  size_t count = std::min(static_cast<size_t>(shard_count), element_begin.size());
+  size_t total_size = elements_end - element_begin.front();
+  std::vector<size_t> boundaries = {element_begin.front()};
+  size_t next_element = 0;
+  for(size_t i = 1; i < count; i++)
+  {
+    size_t target = element_begin.front() + total_size * i / count;
+    while(next_element < element_begin.size() && element_begin[next_element] < target)
+      next_element++;
+    if(next_element < element_begin.size() && element_begin[next_element] > boundaries.back())
+      boundaries.push_back(element_begin[next_element]);
+  }
+  boundaries.push_back(elements_end);
+
+  for(size_t i = 0; i + 1 < boundaries.size(); i++)
+    shards.emplace_back(new MappedXmlReader(path, boundaries[i], boundaries[i + 1], root));
+  return shards;
+}
+
+/*============================================================================
+ * PUBLIC FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Builds the offset index of the source with a first pass and saves it as the sidecar file, so
+ * this and later readers of the source can seek with find(). If the reader is started, the
+ * index is used right away. The read location is not changed.
+ * @return TRUE if the source was indexed and the sidecar was saved
+ */
+bool MappedXmlReader::buildIndex()
+{
+  MappedFile source;
+  if(!source.open(path) || !index.build(source) || !index.save(path))
+  {
+    index.clear();
+    return false;
+  }
+
+  if(!file.isOpen() || range_branch.getNumElements() > 0)
+    index.clear();
+  return true;
+}
+
+/**
+ * Returns the path to the source file that is read.
+ * @return file system path
+ */
+std::string MappedXmlReader::getPath() const
+{
+  return path;
+}
+
+/**
+ * Returns if find() is using the offset index of the source, from its sidecar file.
+ * @return TRUE if the reader is started with an up to date index
+ */
+bool MappedXmlReader::isIndexed() const
+{
+  return !index.isEmpty();
+}
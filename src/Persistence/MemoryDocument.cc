@@ -0,0 +1,116 @@
+/**
+ * @class MemoryDocument
+ *
+ * Document recorded by {@link MemoryXmlWriter} and replayed by {@link MemoryXmlReader}. It's a
+ * flat array of fixed size nodes in document order (the OPEN, DATA and CLOSE records of
+ * {@link BinaryRecordType}) with all of their strings in a single pool, so a whole document is a
+ * handful of allocations and nothing is formatted to or parsed from text. Names and keys that are
+ * interned are kept as their atom only. Each OPEN node also holds the index of its CLOSE node,
+ * so a reader can skip a whole subtree.
+ *
+ * A document is immutable once the writer saves it and is shared by const pointer, so any number
+ * of readers on any threads can replay it at the same time.
+ */
+#include "Persistence/MemoryDocument.h"
+using namespace core;
+
+/*============================================================================
+ * PRIVATE FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Appends a string to the end of the pool.
+ * @param value the string to append
+ * @return offset of the string in the pool
+ */
+uint32_t MemoryDocument::appendString(std::string_view value)
+{
+  uint32_t offset = static_cast<uint32_t>(strings.size());
+  strings.append(value);
+  return offset;
+}
+
+/**
+ * Returns the attribute key of an OPEN node.
+ * @param node the node
+ * @return key, blank if the element has none
+ */
+std::string_view MemoryDocument::getKey(const Node& node) const
+{
+  if(node.key_atom != Atom::NONE)
+    return AtomTable::getName(node.key_atom);
+  return std::string_view(strings.data() + node.key_offset, node.key_size);
+}
+
+/**
+ * Returns the element name of an OPEN or DATA node.
+ * @param node the node
+ * @return element name
+ */
+std::string_view MemoryDocument::getName(const Node& node) const
+{
+  if(node.name_atom != Atom::NONE)
+    return AtomTable::getName(node.name_atom);
+  return std::string_view(strings.data() + node.name_offset, node.name_size);
+}
+
+/**
+ * Returns the attribute value of an OPEN node, or the data of a STRING DATA node.
+ * @param node the node
+ * @return value string
+ */
+std::string_view MemoryDocument::getValue(const Node& node) const
+{
+  return std::string_view(strings.data() + node.value_offset, node.value_size);
+}
+
+/*============================================================================
+ * PUBLIC FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Returns the memory held by the document: the capacity of the nodes and the string pool.
+ * @return size in bytes
+ */
+size_t MemoryDocument::getByteSize() const
+{
+  return nodes.capacity() * sizeof(Node) + strings.capacity();
+}
+
+/**
+ * Returns the number of data elements in the document, which is the number of lines a reader
+ * returns for it.
+ * @return data count
+ */
+size_t MemoryDocument::getDataCount() const
+{
+  return data_count;
+}
+
+/**
+ * Returns the time the document was saved by the writer.
+ * @return UTC date formatted as YYYY-MM-DD HH:MM:SS. Blank if it was never saved
+ */
+std::string MemoryDocument::getModifiedDate() const
+{
+  if(modified_time == 0)
+    return "";
+
+  std::tm* modified_tm = std::gmtime(&modified_time);
+  if(modified_tm == nullptr)
+    return "";
+
+  char formatted[32];
+  std::strftime(formatted, sizeof(formatted), "%Y-%m-%d %H:%M:%S", modified_tm);
+  return formatted;
+}
+
+/**
+ * Returns the number of records in the document: every element open and close and every data
+ * element.
+ * @return node count
+ */
+size_t MemoryDocument::getNodeCount() const
+{
+  return nodes.size();
+}
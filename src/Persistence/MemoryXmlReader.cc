@@ -0,0 +1,370 @@
+/**
+ * @class MemoryXmlReader
+ *
+ * Reader implementation that replays a {@link MemoryDocument} saved by {@link MemoryXmlWriter}.
+ * It follows the same contract as the file readers, so all existing load code works unchanged,
+ * but the data arrives already typed and nothing is parsed. The document is shared, not copied,
+ * so readers on several threads can replay the same snapshot, and find() skips the subtrees that
+ * can't match without walking them.
+ */
+#include "Persistence/MemoryXmlReader.h"
+using namespace core;
+
+/*============================================================================
+ * CONSTRUCTORS / DESTRUCTORS
+ *===========================================================================*/
+
+/**
+ * Constructor function - Sets up the reader for the document. Nothing is read until start() is
+ * called.
+ * @param document the saved document to replay. Null reads as a source that can't be started
+ */
+MemoryXmlReader::MemoryXmlReader(std::shared_ptr<const MemoryDocument> document)
+               : document{document}
+{
+}
+
+/**
+ * Constructor function - Sets up a split reader that only reads a range of the document. The
+ * range must start and end on element boundaries, within the elements of the wrapping branch.
+ * @param document the saved document to replay
+ * @param range_begin index of the node where the range starts
+ * @param range_end index of the node where the range ends
+ * @param range_branch elements that wrap the range, added to the front of every line
+ */
+MemoryXmlReader::MemoryXmlReader(std::shared_ptr<const MemoryDocument> document,
+                                 size_t range_begin, size_t range_end, XmlData range_branch)
+               : document{document},
+                 range_begin{range_begin},
+                 range_branch{range_branch},
+                 range_end{range_end}
+{
+}
+
+/*============================================================================
+ * PRIVATE FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Returns the index of the node where the read stops, which is the end of the range for a split
+ * reader.
+ * @return node index. 0 if there is no document
+ */
+size_t MemoryXmlReader::getReadEnd() const
+{
+  if(!document)
+    return 0;
+  return std::min(document->nodes.size(), range_end);
+}
+
+/**
+ * Reads the next data element by applying nodes to the branch until a DATA node is reached.
+ * @param line the line to fill, reusing its memory
+ * @param done set when the end of the document has been reached and no line was returned
+ * @param success set if the line was read. At the end, if every element was closed
+ */
+void MemoryXmlReader::readLine(XmlData& line, bool& done, bool& success)
+{
+  done = true;
+  success = false;
+  if(!started)
+    return;
+
+  size_t read_end = getReadEnd();
+  while(node_index < read_end)
+  {
+    const MemoryDocument::Node& node = document->nodes[node_index++];
+    if(node.type == BinaryRecordType::OPEN)
+    {
+      branch.addElementBack(document->getName(node), document->getKey(node),
+                            document->getValue(node), node.name_atom, node.key_atom);
+    }
+    else if(node.type == BinaryRecordType::CLOSE)
+    {
+      if(branch.getNumElements() <= range_branch.getNumElements())
+        return;
+      branch.removeLastElement();
+    }
+    else
+    {
+      line = branch;
+      line.addElementBack(document->getName(node), XmlData::kKEY_DATA_TYPE,
+                          TextEncoding::formatInteger(static_cast<int>(node.data_type)),
+                          node.name_atom, Atom::TYPE);
+      if(node.data_type == DataType::BOOLEAN)
+        line.setDataOfType(node.data_boolean);
+      else if(node.data_type == DataType::INTEGER)
+        line.setDataOfType(static_cast<int>(node.data_integer));
+      else if(node.data_type == DataType::FLOAT)
+        line.setDataOfType(node.data_float);
+      else
+        line.setDataOfType(document->getValue(node));
+
+      done = false;
+      success = true;
+      return;
+    }
+  }
+
+  success = (branch.getNumElements() == range_branch.getNumElements());
+}
+
+/*=============================================================================
+ * PRIVATE FUNCTIONS - XMLREADER
+ *============================================================================*/
+
+/**
+ * Finds an element node from the current read location by moving forward through the nodes. The
+ * search is limited to the element that holds the current read location, and an element that
+ * doesn't match is skipped whole through its close index. If the branch is found, the next
+ * read() returns the first data element inside it. If it isn't, the read location is left
+ * untouched.
+ * @param branch the child branch to find. Any key left blank in the branch matches any key
+ * @return true if the path was found and the read pointer was moved
+ */
+bool MemoryXmlReader::findInSource(XmlData branch)
+{
+  if(!started)
+    return false;
+
+  XmlDataView target(branch);
+  int target_count = target.getNumElements();
+  if(target_count == 0)
+    return true;
+
+  // Keep the starting read location, to restore it if the branch isn't found
+  XmlData start_branch = this->branch;
+  size_t start_index = node_index;
+
+  int base_count = this->branch.getNumElements();
+  size_t read_end = getReadEnd();
+  bool found = false;
+  while(!found && node_index < read_end)
+  {
+    const MemoryDocument::Node& node = document->nodes[node_index];
+    if(node.type == BinaryRecordType::OPEN)
+    {
+      // Every open element in the branch past the base matched, so this is the next level
+      int level = this->branch.getNumElements() - base_count;
+      std::string_view key = document->getKey(node);
+      if(target.getElement(level) == document->getName(node) &&
+         (target.getKey(level).empty() ||
+          (target.getKey(level) == key && target.getKeyValue(level) == document->getValue(node))))
+      {
+        this->branch.addElementBack(document->getName(node), key, document->getValue(node),
+                                    node.name_atom, node.key_atom);
+        found = (level + 1 == target_count);
+        node_index++;
+      }
+      else
+      {
+        node_index = node.close_index + 1;
+      }
+    }
+    else if(node.type == BinaryRecordType::CLOSE)
+    {
+      // Left the element that held the starting read location
+      if(this->branch.getNumElements() <= base_count)
+        break;
+      this->branch.removeLastElement();
+      node_index++;
+    }
+    else
+    {
+      node_index++;
+    }
+  }
+
+  if(!found)
+  {
+    this->branch = start_branch;
+    node_index = start_index;
+  }
+  return found;
+}
+
+/**
+ * Checks if the reader has been started.
+ * @return true if start() has been called and stop() has not been called since
+ */
+bool MemoryXmlReader::isSourceAvailable()
+{
+  return started;
+}
+
+/**
+ * Jumps the read location back to the start of the document.
+ * @return true if the reader is back at the root of the document for the next read()
+ */
+bool MemoryXmlReader::jumpToRootInSource()
+{
+  if(!started)
+    return false;
+
+  branch = range_branch;
+  node_index = range_begin;
+  return true;
+}
+
+/**
+ * Returns the time the document was saved by the writer.
+ * @return UTC date formatted as YYYY-MM-DD HH:MM:SS. Blank if there is no document
+ */
+std::string MemoryXmlReader::lastModifiedDateFromSource()
+{
+  if(!document)
+    return "";
+  return document->getModifiedDate();
+}
+
+/**
+ * Reads the next batch of data elements, filling each line of the buffer in place with the
+ * branch so the lines keep their memory from batch to batch.
+ * @param lines buffer of lines, at least count long
+ * @param count maximum number of lines to read
+ * @param done set when the end of the document has been reached
+ * @param success set if all lines were read and, at the end, every element was closed
+ * @return number of lines read into the front of the buffer
+ */
+size_t MemoryXmlReader::readBatchFromSource(std::vector<XmlData>& lines, size_t count,
+                                            bool& done, bool& success)
+{
+  size_t read_count = 0;
+  done = false;
+  success = true;
+  while(read_count < count && !done)
+  {
+    readLine(lines[read_count], done, success);
+    if(!done)
+      read_count++;
+  }
+  return read_count;
+}
+
+/**
+ * Reads the next data element from the document.
+ * @param done set when the end of the document has been reached and no line was returned
+ * @param success set if the line was read. At the end, if every element was closed
+ * @return branch element that includes the full path location through the XML wrapping the data
+ */
+XmlData MemoryXmlReader::readFromSource(bool& done, bool& success)
+{
+  XmlData line(getMemoryResource());
+  readLine(line, done, success);
+  return line;
+}
+
+/**
+ * Moves the read location to the first node of the document (or the range). If the reader was
+ * already started, it is restarted.
+ * @return success status of starting. false if there is no document
+ */
+bool MemoryXmlReader::startReadFromSource()
+{
+  if(!document)
+    return false;
+
+  started = true;
+  return jumpToRootInSource();
+}
+
+/**
+ * Stops the reader. The document is kept, so it can be started again.
+ * @return success status of cleaning up. Always true
+ */
+bool MemoryXmlReader::stopReadFromSource()
+{
+  branch = XmlData();
+  node_index = range_begin;
+  started = false;
+  return true;
+}
+
+/**
+ * Counts the total number of data elements in the document, as counted by the writer. A split
+ * reader counts the DATA nodes of its range.
+ * @return total count. 0 if not started
+ */
+int MemoryXmlReader::totalDataCountFromSource()
+{
+  if(!started)
+    return 0;
+
+  if(range_begin == 0 && range_end == SIZE_MAX)
+    return static_cast<int>(document->data_count);
+
+  size_t read_end = getReadEnd();
+  int data_count = 0;
+  for(size_t i = range_begin; i < read_end; i++)
+    if(document->nodes[i].type == BinaryRecordType::DATA)
+      data_count++;
+  return data_count;
+}
+
+/**
+ * Splits the document into independent readers over contiguous runs of the top-level elements.
+ * The top-level elements are found by following the close index of each one, so nothing inside
+ * them is walked. The runs are then balanced by node count and share the same document. A split
+ * reader can not be split again.
+ * @param shard_count maximum number of readers to split into
+ * @return split readers in document order. Empty if the document doesn't have a single root
+ *         element with elements inside it
+ */
+std::vector<std::unique_ptr<XmlReader>> MemoryXmlReader::splitSource(int shard_count)
+{
+  std::vector<std::unique_ptr<XmlReader>> shards;
+  if(shard_count < 1 || !document || range_branch.getNumElements() > 0)
+    return shards;
+
+  // Only a single root element can be split
+  const std::vector<MemoryDocument::Node>& nodes = document->nodes;
+  if(nodes.empty() || nodes[0].type != BinaryRecordType::OPEN ||
+     nodes[0].close_index + 1 != nodes.size())
+    return shards;
+
+  XmlData root;
+  root.addElementBack(document->getName(nodes[0]), document->getKey(nodes[0]),
+                      document->getValue(nodes[0]), nodes[0].name_atom, nodes[0].key_atom);
+
+  std::vector<size_t> element_begin;
+  size_t elements_end = nodes[0].close_index;
+  for(size_t i = 1; i < elements_end;
+      i = (nodes[i].type == BinaryRecordType::OPEN ? nodes[i].close_index + 1 : i + 1))
+    element_begin.push_back(i);
+  if(element_begin.empty())
+    return shards;
+
+  // Cut the runs at the first element start past each even share of the nodes
+  size_t count = std::min(static_cast<size_t>(shard_count), element_begin.size());
+  size_t total_size = elements_end - element_begin.front();
+  std::vector<size_t> boundaries = {0};
+  for(size_t i = 1, next = 0; i < count; i++)
+  {
+    size_t target = element_begin.front() + total_size * i / count;
+    while(next < element_begin.size() && element_begin[next] < target)
+      next++;
+    if(next < element_begin.size() && next > boundaries.back())
+      boundaries.push_back(next);
+  }
+
+  for(size_t i = 0; i < boundaries.size(); i++)
+  {
+    size_t begin = element_begin[boundaries[i]];
+    size_t end = (i + 1 < boundaries.size() ? element_begin[boundaries[i + 1]] : elements_end);
+    shards.emplace_back(new MemoryXmlReader(document, begin, end, root));
+  }
+  return shards;
+}
+
+/*============================================================================
+ * PUBLIC FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Returns the document that is replayed.
+ * @return shared document. Null if there is none
+ */
+std::shared_ptr<const MemoryDocument> MemoryXmlReader::getDocument() const
+{
+  return document;
+}
@@ -0,0 +1,350 @@
+/**
+ * @class MemoryXmlWriter
+ *
+ * Writer implementation that records into a {@link MemoryDocument} instead of a file. It follows
+ * the same contract as the file writers, so any save code can serialize to memory: to clone an
+ * object through its save and load, to hand a snapshot to another thread or as the baseline
+ * backend of persistence benchmarks. Data is stored typed and interned names as their atom, so
+ * nothing is formatted to text. stop(true) closes all open elements and publishes the document,
+ * which is then immutable and can be read by a {@link MemoryXmlReader} on any thread.
+ */
+#include "Persistence/MemoryXmlWriter.h"
+using namespace core;
+
+/*============================================================================
+ * PRIVATE FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Appends a DATA node of the type at the current location. The caller sets the payload.
+ * @param element name of the data element
+ * @param type category of the payload
+ * @return the appended node
+ */
+MemoryDocument::Node& MemoryXmlWriter::writeDataNode(const std::string& element, DataType type)
+{
+  MemoryDocument::Node node{};
+  node.type = BinaryRecordType::DATA;
+  node.data_type = type;
+  node.name_atom = AtomTable::fromName(element);
+  node.key_atom = Atom::NONE;
+  if(node.name_atom == Atom::NONE)
+  {
+    node.name_offset = content.appendString(element);
+    node.name_size = static_cast<uint32_t>(element.size());
+  }
+
+  content.data_count++;
+  content.nodes.push_back(node);
+  return content.nodes.back();
+}
+
+/*=============================================================================
+ * PRIVATE FUNCTIONS - XMLWRITER
+ *============================================================================*/
+
+/**
+ * Deletes all child elements and data nodes beneath the current write location, by truncating
+ * the nodes and strings back to the end of the current element open node.
+ * @return true if the writer is started
+ */
+bool MemoryXmlWriter::deleteChildrenFromSource()
+{
+  if(!started)
+    return false;
+
+  if(stack_node.size() > 0)
+  {
+    content.nodes.resize(stack_node.back() + 1);
+    content.strings.resize(stack_strings_size.back());
+    content.data_count = stack_data_count.back();
+  }
+  else
+  {
+    content.nodes.clear();
+    content.strings.clear();
+    content.data_count = 0;
+  }
+  return true;
+}
+
+/**
+ * Finds a lower child node from the current node location. Written nodes can not be revisited in
+ * an append only document, so only an empty branch (the current location) is found.
+ * @param branch the child branch to find
+ * @return true only if the branch is empty and the writer is started
+ */
+bool MemoryXmlWriter::findInSource(XmlData branch)
+{
+  return (started && XmlDataView(branch).getNumElements() == 0);
+}
+
+/**
+ * Checks if the writer has been started.
+ * @return true if start() has been called and stop() has not been called since
+ */
+bool MemoryXmlWriter::isSourceAvailable()
+{
+  return started;
+}
+
+/**
+ * Jumps the write location up one level by closing the current element. The open node is linked
+ * to its close node, so readers can skip over it.
+ * @return true if the writer is started, even if already at the root
+ */
+bool MemoryXmlWriter::jumpToParentInSource()
+{
+  if(!started)
+    return false;
+
+  if(stack_node.size() > 0)
+  {
+    MemoryDocument::Node node{};
+    node.type = BinaryRecordType::CLOSE;
+    content.nodes[stack_node.back()].close_index = static_cast<uint32_t>(content.nodes.size());
+    content.nodes.push_back(node);
+
+    stack_data_count.pop_back();
+    stack_node.pop_back();
+    stack_strings_size.pop_back();
+  }
+  return true;
+}
+
+/**
+ * Jumps the write location back to the root by closing all open elements.
+ * @return true if the writer is started
+ */
+bool MemoryXmlWriter::jumpToRootInSource()
+{
+  if(!started)
+    return false;
+
+  while(stack_node.size() > 0)
+    jumpToParentInSource();
+  return true;
+}
+
+/**
+ * Starts a new blank document. If the writer was already started, any unsaved changes are
+ * discarded. The new document reserves the size of the last saved one, since repeated saves of
+ * the same state are usually about the same size.
+ * @return success status of beginning the write. Always true
+ */
+bool MemoryXmlWriter::startWriteToSource()
+{
+  content.nodes.clear();
+  content.strings.clear();
+  content.data_count = 0;
+  content.modified_time = 0;
+  if(document)
+  {
+    content.nodes.reserve(document->nodes.size());
+    content.strings.reserve(document->strings.size());
+  }
+
+  stack_data_count.clear();
+  stack_node.clear();
+  stack_strings_size.clear();
+  started = true;
+  return true;
+}
+
+/**
+ * Stops the writer. When saving, all open elements are closed and the document is published,
+ * replacing the last saved one. Readers already replaying the last document keep their copy.
+ * @param save_changes true to publish the document. false to discard it
+ * @return success status of the save. false if not started
+ */
+bool MemoryXmlWriter::stopWriteToSource(bool save_changes)
+{
+  if(!started)
+    return false;
+
+  if(save_changes)
+  {
+    jumpToRootInSource();
+    content.modified_time = std::time(nullptr);
+    document = std::make_shared<const MemoryDocument>(std::move(content));
+  }
+
+  content = MemoryDocument();
+  stack_data_count.clear();
+  stack_node.clear();
+  stack_strings_size.clear();
+  started = false;
+  return true;
+}
+
+/**
+ * Writes a data element from its string form, converted to the typed payload.
+ * @param element name of the data element
+ * @param type category of the data
+ * @param data string converted data
+ * @return true if the data converted to the type and was written
+ */
+bool MemoryXmlWriter::writeDataToSource(std::string element, DataType type, std::string data)
+{
+  bool boolean_data;
+  float float_data;
+  int integer_data;
+  if(type == DataType::BOOLEAN && TextEncoding::readBoolean(data, boolean_data))
+    return writeDataToSource(element, boolean_data);
+  else if(type == DataType::INTEGER && TextEncoding::readInteger(data, integer_data))
+    return writeDataToSource(element, integer_data);
+  else if(type == DataType::FLOAT && TextEncoding::readFloat(data, float_data))
+    return writeDataToSource(element, float_data);
+  else if(type == DataType::STRING)
+    return writeDataToSource(element, data);
+  return false;
+}
+
+/**
+ * Writes a boolean data element.
+ * @param element name of the data element
+ * @param data boolean to store
+ * @return true if the writer is started and the element name is valid
+ */
+bool MemoryXmlWriter::writeDataToSource(std::string element, bool data)
+{
+  if(!started || element.empty())
+    return false;
+
+  writeDataNode(element, DataType::BOOLEAN).data_boolean = data;
+  return true;
+}
+
+/**
+ * Writes a float data element.
+ * @param element name of the data element
+ * @param data float to store
+ * @return true if the writer is started and the element name is valid
+ */
+bool MemoryXmlWriter::writeDataToSource(std::string element, float data)
+{
+  if(!started || element.empty())
+    return false;
+
+  writeDataNode(element, DataType::FLOAT).data_float = data;
+  return true;
+}
+
+/**
+ * Writes an integer data element.
+ * @param element name of the data element
+ * @param data integer to store
+ * @return true if the writer is started and the element name is valid
+ */
+bool MemoryXmlWriter::writeDataToSource(std::string element, int data)
+{
+  if(!started || element.empty())
+    return false;
+
+  writeDataNode(element, DataType::INTEGER).data_integer = data;
+  return true;
+}
+
+/**
+ * Writes a string data element, with the string in the pool.
+ * @param element name of the data element
+ * @param data string to store
+ * @return true if the writer is started and the element name is valid
+ */
+bool MemoryXmlWriter::writeDataToSource(std::string element, std::string data)
+{
+  if(!started || element.empty())
+    return false;
+
+  MemoryDocument::Node& node = writeDataNode(element, DataType::STRING);
+  node.value_offset = content.appendString(data);
+  node.value_size = static_cast<uint32_t>(data.size());
+  return true;
+}
+
+/**
+ * Writes an unsigned integer data element. It is stored under the general integer data type, as
+ * its full unsigned value.
+ * @param element name of the data element
+ * @param data unsigned integer to store
+ * @return true if the writer is started and the element name is valid
+ */
+bool MemoryXmlWriter::writeDataToSource(std::string element, uint32_t data)
+{
+  if(!started || element.empty())
+    return false;
+
+  writeDataNode(element, DataType::INTEGER).data_integer = data;
+  return true;
+}
+
+/**
+ * Writes the open node of a new child element at the current location and moves inside it.
+ * @param element name of the element
+ * @param key optional attribute key. Blank for none
+ * @param value attribute value paired with the key
+ * @return true if the writer is started and the element name is valid
+ */
+bool MemoryXmlWriter::writeElementToSource(std::string element, std::string key,
+                                           std::string value)
+{
+  if(!started || element.empty())
+    return false;
+
+  MemoryDocument::Node node{};
+  node.type = BinaryRecordType::OPEN;
+  node.data_type = DataType::NONE;
+  node.name_atom = AtomTable::fromName(element);
+  if(node.name_atom == Atom::NONE)
+  {
+    node.name_offset = content.appendString(element);
+    node.name_size = static_cast<uint32_t>(element.size());
+  }
+  node.key_atom = AtomTable::fromName(key);
+  if(node.key_atom == Atom::NONE)
+  {
+    node.key_offset = content.appendString(key);
+    node.key_size = static_cast<uint32_t>(key.size());
+  }
+  if(!key.empty())
+  {
+    node.value_offset = content.appendString(value);
+    node.value_size = static_cast<uint32_t>(value.size());
+  }
+
+  stack_node.push_back(static_cast<uint32_t>(content.nodes.size()));
+  stack_data_count.push_back(content.data_count);
+  stack_strings_size.push_back(content.strings.size());
+  content.nodes.push_back(node);
+  return true;
+}
+
+/**
+ * Writes each element in the set as a nested child, moving inside the last one.
+ * @param element_set branch elements to write at the current location
+ * @return true if all elements were written
+ */
+bool MemoryXmlWriter::writeElementsToSource(XmlData element_set)
+{
+  XmlDataView elements(element_set);
+  bool success = started;
+  for(int i = 0; success && i < elements.getNumElements(); i++)
+    success = writeElementToSource(std::string(elements.getElement(i)),
+                                   std::string(elements.getKey(i)),
+                                   std::string(elements.getKeyValue(i)));
+  return success;
+}
+
+/*============================================================================
+ * PUBLIC FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Returns the last document saved by stop(true). It's immutable, so it can be handed to readers
+ * on other threads while this writer records the next one.
+ * @return saved document. Null if none has been saved
+ */
+std::shared_ptr<const MemoryDocument> MemoryXmlWriter::getDocument() const
+{
+  return document;
+}
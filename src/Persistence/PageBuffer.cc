@@ -0,0 +1,275 @@
+/**
+ * @class PageBuffer
+ *
+ * Append only byte buffer built as a chain of fixed size pages. Appending never moves existing
+ * content, growth costs one allocation per page and the whole chain can be flushed to a file in
+ * a single vectored write. Truncating keeps the pages allocated so they are reused by the next
+ * append.
+ */
+#include "Persistence/PageBuffer.h"
+
+// Platform headers are kept out of the public header to avoid leaking their macros
+#ifdef _WIN32
+  #include <fcntl.h>
+  #include <io.h>
+  #include <sys/stat.h>
+  #include <windows.h>
+#else
+  #include <cstdio>
+  #include <fcntl.h>
+  #include <sys/uio.h>
+  #include <unistd.h>
+#endif
+
+using namespace core;
+
+/* Constant Implementation - see header file for descriptions */
+const std::string PageBuffer::kTEMP_SUFFIX = ".tmp";
+
+/*============================================================================
+ * CONSTRUCTORS / DESTRUCTORS
+ *===========================================================================*/
+
+/**
+ * Constructor function - Sets up an empty buffer. No pages are allocated until content is
+ * appended.
+ * @param page_size size of each page in the chain, in bytes. Must be greater than 0
+ */
+PageBuffer::PageBuffer(size_t page_size)
+          : page_size{page_size > 0 ? page_size : kPAGE_SIZE}
+{
+}
+
+/*============================================================================
+ * PUBLIC FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Appends a single character to the end of the buffer.
+ * @param character the character to append
+ */
+void PageBuffer::append(char character)
+{
+  size_t page_index = size / page_size;
+  if(page_index >= pages.size())
+    pages.emplace_back(new char[page_size]);
+
+  pages[page_index][size % page_size] = character;
+  size++;
+}
+
+/**
+ * Appends a run of bytes to the end of the buffer, spilling across pages as required.
+ * @param data start of the bytes to append
+ * @param length number of bytes to append
+ */
+void PageBuffer::append(const char* data, size_t length)
+{
+  while(length > 0)
+  {
+    size_t page_index = size / page_size;
+    size_t page_offset = size % page_size;
+    if(page_index >= pages.size())
+      pages.emplace_back(new char[page_size]);
+
+    size_t copy_length = page_size - page_offset;
+    if(copy_length > length)
+      copy_length = length;
+
+    std::memcpy(pages[page_index].get() + page_offset, data, copy_length);
+    data += copy_length;
+    length -= copy_length;
+    size += copy_length;
+  }
+}
+
+/**
+ * Appends a string to the end of the buffer.
+ * @param data the characters to append
+ */
+void PageBuffer::append(std::string_view data)
+{
+  append(data.data(), data.size());
+}
+
+/**
+ * Appends the content of the buffer to the end of the file and syncs it to disk, creating the
+ * file if it doesn't exist. Unlike writeToFile(), an interrupted append can leave part of the
+ * content at the end of the file, so the content must be able to detect that when read back.
+ * @param path file system path of the file to append to
+ * @return TRUE if all content was appended and synced
+ */
+bool PageBuffer::appendToFile(const std::string& path) const
+{
+#ifdef _WIN32
+  int file = _open(path.c_str(), _O_WRONLY | _O_CREAT | _O_APPEND | _O_BINARY,
+                   _S_IREAD | _S_IWRITE);
+  if(file < 0)
+    return false;
+
+  bool success = writeTo(file);
+  if(success)
+    success = (_commit(file) == 0);
+  success = (_close(file) == 0) && success;
+#else
+  int file = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+  if(file < 0)
+    return false;
+
+  bool success = writeTo(file);
+  if(success)
+    success = (fsync(file) == 0);
+  success = (::close(file) == 0) && success;
+#endif
+
+  return success;
+}
+
+/**
+ * Copies the content of the buffer into a contiguous string.
+ * @param destination the string to fill. Any existing content is replaced
+ */
+void PageBuffer::copyTo(std::string& destination) const
+{
+  destination.clear();
+  destination.reserve(size);
+
+  size_t remaining = size;
+  for(size_t i = 0; remaining > 0; i++)
+  {
+    size_t length = (remaining < page_size ? remaining : page_size);
+    destination.append(pages[i].get(), length);
+    remaining -= length;
+  }
+}
+
+/**
+ * Copies a range of the content of the buffer into the destination. The range must be within
+ * the content.
+ * @param offset offset of the first byte to copy
+ * @param length number of bytes to copy
+ * @param destination start of the memory to copy into, at least length bytes long
+ */
+void PageBuffer::copyTo(size_t offset, size_t length, char* destination) const
+{
+  while(length > 0)
+  {
+    size_t page_offset = offset % page_size;
+    size_t copy_length = page_size - page_offset;
+    if(copy_length > length)
+      copy_length = length;
+
+    std::memcpy(destination, pages[offset / page_size].get() + page_offset, copy_length);
+    destination += copy_length;
+    offset += copy_length;
+    length -= copy_length;
+  }
+}
+
+/**
+ * Returns the total bytes of content in the buffer.
+ * @return content size
+ */
+size_t PageBuffer::getSize() const
+{
+  return size;
+}
+
+/**
+ * Truncates the content of the buffer back to a previous size. This is how appended content is
+ * rolled back. The pages are kept allocated so later appends reuse them.
+ * @param size the new content size. Ignored if it is larger than the current size
+ */
+void PageBuffer::truncate(size_t size)
+{
+  if(size < this->size)
+    this->size = size;
+}
+
+/**
+ * Writes the content of the buffer to an open file descriptor. On POSIX, the pages are handed
+ * to the operating system as a vectored write so that a full buffer needs only a single call
+ * per kWRITE_BATCH pages. Partial writes are resumed until all content is written.
+ * @param file_descriptor the open, writable file descriptor
+ * @return TRUE if all content was written
+ */
+bool PageBuffer::writeTo(int file_descriptor) const
+{
+  size_t page_count = (size + page_size - 1) / page_size;
+  size_t written_size = 0;
+
+  while(written_size < size)
+  {
+    size_t page_index = written_size / page_size;
+    size_t page_offset = written_size % page_size;
+
+#ifdef _WIN32
+    size_t page_end = (page_index + 1 < page_count ? page_size : size - page_index * page_size);
+    int written = _write(file_descriptor, pages[page_index].get() + page_offset,
+                         static_cast<unsigned int>(page_end - page_offset));
+#else
+    // Gather the next batch of pages, starting part way through the first if resumed
+    struct iovec vectors[kWRITE_BATCH];
+    int vector_count = 0;
+    for(size_t i = page_index; i < page_count && vector_count < kWRITE_BATCH; i++)
+    {
+      size_t start = (i == page_index ? page_offset : 0);
+      size_t end = (i + 1 < page_count ? page_size : size - i * page_size);
+      vectors[vector_count].iov_base = pages[i].get() + start;
+      vectors[vector_count].iov_len = end - start;
+      vector_count++;
+    }
+
+    ssize_t written = writev(file_descriptor, vectors, vector_count);
+#endif
+
+    if(written <= 0)
+      return false;
+    written_size += static_cast<size_t>(written);
+  }
+
+  return true;
+}
+
+/**
+ * Writes the content of the buffer to a temporary file beside the destination, syncs it to disk
+ * and then renames it over the destination. A failure at any point leaves the destination
+ * untouched.
+ * @param path file system path of the destination file
+ * @return TRUE if the destination file was replaced with the buffer content
+ */
+bool PageBuffer::writeToFile(const std::string& path) const
+{
+  std::string temp_path = path + kTEMP_SUFFIX;
+
+#ifdef _WIN32
+  int file = _open(temp_path.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY,
+                   _S_IREAD | _S_IWRITE);
+  if(file < 0)
+    return false;
+
+  bool success = writeTo(file);
+  if(success)
+    success = (_commit(file) == 0);
+  success = (_close(file) == 0) && success;
+  if(success)
+    success = MoveFileExA(temp_path.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING);
+  if(!success)
+    _unlink(temp_path.c_str());
+#else
+  int file = ::open(temp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if(file < 0)
+    return false;
+
+  bool success = writeTo(file);
+  if(success)
+    success = (fsync(file) == 0);
+  success = (::close(file) == 0) && success;
+  if(success)
+    success = (std::rename(temp_path.c_str(), path.c_str()) == 0);
+  if(!success)
+    std::remove(temp_path.c_str());
+#endif
+
+  return success;
+}
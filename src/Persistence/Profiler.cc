@@ -0,0 +1,243 @@
+/**
+ * @class Profiler
+ *
+ * Optional load and save profiler for the persistence layer. Each profiled call records a count,
+ * the bytes it handled and its duration in nanoseconds, both as a total and in a histogram of
+ * power of two buckets, keyed by a category (such as event loads) and a name within it (such as
+ * the event type or element name). Counters are kept per thread, so worker threads never
+ * contend, and are summed when exported as JSON. Nested calls each record their own time, so the
+ * time of an outer call includes the calls within it.
+ *
+ * Profiling is only compiled in when the library is built with FIS_PROFILE defined (make
+ * PROFILE=1). Otherwise the FIS_PROFILE macros expand to nothing, arguments included.
+ */
+#include "Persistence/Profiler.h"
+using namespace core;
+
+/* Static Implementation - see header file for descriptions */
+std::vector<std::unique_ptr<Profiler::CounterTable>> Profiler::tables;
+std::mutex Profiler::tables_lock;
+
+/*============================================================================
+ * CONSTRUCTORS / DESTRUCTORS
+ *===========================================================================*/
+
+/**
+ * Constructor function - Starts timing the block.
+ * @param category category to record under, which must be a constant that outlives the scope
+ * @param name name within the category to record under
+ */
+Profiler::Scope::Scope(std::string_view category, std::string_view name)
+               : category{category},
+                 name{name},
+                 start{std::chrono::steady_clock::now()}
+{
+}
+
+/**
+ * Destructor function - Records the block, including when it's left by an exception. A failure
+ * to record is dropped, since profiling must never change the outcome of the call.
+ */
+Profiler::Scope::~Scope()
+{
+  auto duration = std::chrono::steady_clock::now() - start;
+  try
+  {
+    record(category, name,
+           std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count(), bytes);
+  }
+  catch(...)
+  {
+  }
+}
+
+/*============================================================================
+ * PRIVATE STATIC FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Appends the string to the JSON text, in quotes and with the characters that JSON reserves
+ * escaped.
+ * @param json the JSON text to append to
+ * @param value the string to append
+ */
+void Profiler::appendJsonString(std::string& json, std::string_view value)
+{
+  json += '"';
+  for(char c : value)
+  {
+    if(c == '"' || c == '\\')
+    {
+      json += '\\';
+      json += c;
+    }
+    else if(static_cast<unsigned char>(c) < 0x20)
+    {
+      const char* kHEX = "0123456789abcdef";
+      json += "\\u00";
+      json += kHEX[(c >> 4) & 0xF];
+      json += kHEX[c & 0xF];
+    }
+    else
+    {
+      json += c;
+    }
+  }
+  json += '"';
+}
+
+/**
+ * Returns the counter table of the calling thread. The first call on a thread adds its table to
+ * the shared list, which owns it, so it's still exported after the thread finishes.
+ * @return counter table only recorded to by the calling thread
+ */
+Profiler::CounterTable& Profiler::getThreadTable()
+{
+  thread_local CounterTable* table = nullptr;
+  if(table == nullptr)
+  {
+    std::lock_guard<std::mutex> guard(tables_lock);
+    tables.push_back(std::make_unique<CounterTable>());
+    table = tables.back().get();
+  }
+  return *table;
+}
+
+/*============================================================================
+ * PUBLIC STATIC FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Returns if profiling was compiled into the library (built with FIS_PROFILE). If not, nothing
+ * is ever recorded and the export is empty.
+ * @return TRUE if the profiled calls record
+ */
+bool Profiler::isEnabled()
+{
+#ifdef FIS_PROFILE
+  return true;
+#else
+  return false;
+#endif
+}
+
+/**
+ * Records a single call under the category and name, into the counters of the calling thread.
+ * @param category category of the call
+ * @param name name within the category
+ * @param duration_ns duration of the call, in nanoseconds
+ * @param bytes bytes handled by the call
+ */
+void Profiler::record(std::string_view category, std::string_view name, uint64_t duration_ns,
+                      size_t bytes)
+{
+  CounterTable& table = getThreadTable();
+  auto category_it = table.find(category);
+  if(category_it == table.end())
+    category_it = table.emplace(std::string(category), CounterTable::mapped_type()).first;
+
+  auto counter_it = category_it->second.find(name);
+  if(counter_it == category_it->second.end())
+    counter_it = category_it->second.emplace(std::string(name), Counter()).first;
+
+  size_t bucket = 0;
+  while(bucket + 1 < kBUCKET_COUNT && (duration_ns >> (bucket + 1)) != 0)
+    bucket++;
+
+  Counter& counter = counter_it->second;
+  counter.bytes += bytes;
+  counter.count++;
+  counter.histogram[bucket]++;
+  counter.total_ns += duration_ns;
+}
+
+/**
+ * Clears all recorded counters. Only call while no profiled call is running on another thread.
+ */
+void Profiler::reset()
+{
+  std::lock_guard<std::mutex> guard(tables_lock);
+  for(std::unique_ptr<CounterTable>& table : tables)
+    table->clear();
+}
+
+/**
+ * Returns the recorded counters, summed over all threads, as a JSON object of categories, each
+ * an object of names, each an object with the count, bytes, total_ns and histogram (an array of
+ * bucket counts up to the last used bucket). Only call while no profiled call is running on
+ * another thread.
+ * @return JSON text of the counters. "{}" if nothing was recorded
+ */
+std::string Profiler::toJson()
+{
+  CounterTable sum;
+  {
+    std::lock_guard<std::mutex> guard(tables_lock);
+    for(std::unique_ptr<CounterTable>& table : tables)
+    {
+      for(auto& category : *table)
+      {
+        for(auto& entry : category.second)
+        {
+          Counter& counter = sum[category.first][entry.first];
+          counter.bytes += entry.second.bytes;
+          counter.count += entry.second.count;
+          for(size_t i = 0; i < kBUCKET_COUNT; i++)
+            counter.histogram[i] += entry.second.histogram[i];
+          counter.total_ns += entry.second.total_ns;
+        }
+      }
+    }
+  }
+
+  std::string json = "{";
+  for(auto category = sum.begin(); category != sum.end(); category++)
+  {
+    if(category != sum.begin())
+      json += ",";
+    appendJsonString(json, category->first);
+    json += ":{";
+    for(auto entry = category->second.begin(); entry != category->second.end(); entry++)
+    {
+      const Counter& counter = entry->second;
+      if(entry != category->second.begin())
+        json += ",";
+      appendJsonString(json, entry->first);
+      json += ":{\"count\":" + std::to_string(counter.count) +
+              ",\"bytes\":" + std::to_string(counter.bytes) +
+              ",\"total_ns\":" + std::to_string(counter.total_ns) + ",\"histogram\":[";
+
+      size_t bucket_count = kBUCKET_COUNT;
+      while(bucket_count > 0 && counter.histogram[bucket_count - 1] == 0)
+        bucket_count--;
+      for(size_t i = 0; i < bucket_count; i++)
+        json += (i > 0 ? "," : "") + std::to_string(counter.histogram[i]);
+      json += "]}";
+    }
+    json += "}";
+  }
+  json += "}";
+  return json;
+}
+
+/*============================================================================
+ * SCOPE FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Adds to the bytes handled by the profiled block.
+ * @param bytes number of bytes to add
+ */
+void Profiler::Scope::addBytes(size_t bytes)
+{
+  this->bytes += bytes;
+}
+
+/**
+ * Replaces the name the block is recorded under, for when it's only known partway through.
+ * @param name name within the category
+ */
+void Profiler::Scope::setName(std::string_view name)
+{
+  this->name = name;
+}
@@ -0,0 +1,302 @@
+/**
+ * @class SaveMigrator
+ *
+ * Offline migration of saves from legacy layouts into the current schema. Lines are piped from
+ * any reader into any writer one batch at a time, the same as {@link XmlConverter}, and each
+ * legacy line is rewritten on the way, so a save is never loaded whole. A directory of saves is
+ * migrated in parallel, one file at a time on each worker thread, and each file is rewritten in
+ * place in the format (and compression) it was read in. A file without legacy lines is left as
+ * it is.
+ *
+ * The only legacy layout is the conversation event that holds the entry id as a key on the
+ * conversation element (<conversation id="1.2"><text>), which is rewritten to the current entry
+ * element (<conversation><entry id="1.2"><text>). Once every save is migrated, the legacy load
+ * can be disabled for each load (see LoadOptions::legacy_conversations).
+ */
+#include "Persistence/SaveMigrator.h"
+using namespace core;
+
+/* Constant Implementation - see header file for descriptions */
+const std::string SaveMigrator::kKEY_ENTRY = "entry";
+const std::string SaveMigrator::kXML_EXTENSION = ".xml";
+
+/*============================================================================
+ * CONSTRUCTORS / DESTRUCTORS
+ *===========================================================================*/
+
+/**
+ * Constructor function - Sets up the migrator.
+ * @param thread_count number of worker threads. 0 to use one per hardware thread
+ */
+SaveMigrator::SaveMigrator(unsigned int thread_count)
+            : thread_count{thread_count}
+{
+  if(this->thread_count == 0)
+    this->thread_count = std::thread::hardware_concurrency();
+  if(this->thread_count == 0)
+    this->thread_count = 1;
+}
+
+/*============================================================================
+ * PRIVATE STATIC FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Starts the reader and the writer, and pipes every data line from one into the other, a batch
+ * at a time, migrating each legacy line on the way. The reader is stopped here, but the writer
+ * is left started so the caller decides whether to save it.
+ * @param reader source of the document. Must not be started
+ * @param writer destination of the document. Must not be started
+ * @param migrated_count set to the number of lines that were migrated
+ * @return TRUE if both started, the whole source was read and every line was written
+ */
+bool SaveMigrator::migrateLines(XmlReader* reader, XmlWriter* writer, size_t& migrated_count)
+{
+  migrated_count = 0;
+  if(!reader->start())
+    return false;
+  if(!writer->start())
+  {
+    reader->stop();
+    return false;
+  }
+
+  std::vector<XmlData> lines;
+  XmlData open_branch;
+  bool done = false;
+  bool success = true;
+  while(!done && success)
+  {
+    size_t count = reader->readBatch(lines, done, success);
+    for(size_t i = 0; success && i < count; i++)
+    {
+      if(migrateLine(lines[i]))
+        migrated_count++;
+      success = XmlConverter::writeLine(writer, lines[i], open_branch);
+    }
+  }
+
+  reader->stop();
+  return success;
+}
+
+/*============================================================================
+ * PUBLIC FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Returns the number of worker threads, which is also the maximum number of files migrated at
+ * once.
+ * @return thread count. Always at least 1
+ */
+unsigned int SaveMigrator::getThreadCount() const
+{
+  return thread_count;
+}
+
+/**
+ * Migrates every save file directly in the directory in place (see migrateFile()). Each worker
+ * thread takes the next file that isn't migrated yet, so a large save doesn't hold up the rest.
+ * A file that fails is left as it was and doesn't stop the others. If a migration throws, the
+ * first exception by file is rethrown once all workers finish.
+ * @param directory file system path to the directory of saves
+ * @param migrated_file_count set to the number of files that were rewritten
+ * @return TRUE if the directory was listed and every save in it was migrated or had no legacy
+ *         lines
+ */
+bool SaveMigrator::migrateDirectory(const std::string& directory,
+                                    size_t& migrated_file_count) const
+{
+  migrated_file_count = 0;
+
+  // List the files first, in order, so the workers share a fixed list
+  std::error_code error;
+  std::vector<std::string> paths;
+  std::filesystem::directory_iterator end;
+  for(std::filesystem::directory_iterator it(directory, error); !error && it != end;
+      it.increment(error))
+  {
+    if(it->is_regular_file(error))
+      paths.push_back(it->path().string());
+  }
+  if(error)
+    return false;
+  std::sort(paths.begin(), paths.end());
+
+  // Migrate the next file on each worker until every file is taken
+  std::vector<std::exception_ptr> errors(paths.size());
+  std::vector<char> migrated(paths.size(), false);
+  std::vector<char> successes(paths.size(), false);
+  std::atomic<size_t> next_index{0};
+  auto migrate_next = [&]()
+  {
+    for(size_t i = next_index++; i < paths.size(); i = next_index++)
+    {
+      try
+      {
+        size_t migrated_count;
+        successes[i] = migrateFile(paths[i], migrated_count);
+        migrated[i] = (migrated_count > 0);
+      }
+      catch(...)
+      {
+        errors[i] = std::current_exception();
+      }
+    }
+  };
+
+  size_t worker_count = std::min(static_cast<size_t>(thread_count), paths.size());
+  if(worker_count <= 1)
+  {
+    migrate_next();
+  }
+  else
+  {
+    std::vector<std::thread> workers;
+    for(size_t i = 0; i < worker_count; i++)
+      workers.emplace_back(migrate_next);
+    for(std::thread& worker : workers)
+      worker.join();
+  }
+
+  bool success = true;
+  for(size_t i = 0; i < paths.size(); i++)
+  {
+    if(errors[i])
+      std::rethrow_exception(errors[i]);
+    success &= (successes[i] != 0);
+    if(successes[i] && migrated[i])
+      migrated_file_count++;
+  }
+  return success;
+}
+
+/*============================================================================
+ * PUBLIC STATIC FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Copies every data line from the reader into the writer, migrating each legacy line on the way.
+ * Both are started and stopped here and the writer only saves if the whole source was read and
+ * written successfully.
+ * @param reader source of the document. Must not be started
+ * @param writer destination of the document. Must not be started
+ * @param migrated_count set to the number of lines that were migrated
+ * @return TRUE if the document was fully read and the writer saved it
+ */
+bool SaveMigrator::migrate(XmlReader* reader, XmlWriter* writer, size_t& migrated_count)
+{
+  bool success = migrateLines(reader, writer, migrated_count);
+  if(!writer->isStarted())
+    return false;
+  return writer->stop(success) && success;
+}
+
+/**
+ * Migrates the save file in place. A binary save is found by its magic, and any other file is
+ * an XML save if it has the XML extension. The file is rewritten in the same format, compressed
+ * if it was and with the XML index if it had one, and only if it has legacy lines. The rewrite
+ * replaces the file whole once it's written, so a failed migration leaves it as it was.
+ * @param path file system path to the save file
+ * @param migrated_count set to the number of lines that were migrated
+ * @return TRUE if the file was migrated, had no legacy lines or isn't a save
+ */
+bool SaveMigrator::migrateFile(const std::string& path, size_t& migrated_count)
+{
+  migrated_count = 0;
+
+  // Find the format of the save
+  MappedFile file;
+  if(!file.open(path))
+    return false;
+  const std::string& magic = BinaryEncoding::kMAGIC;
+  file.load(0, magic.size());
+  bool binary = (file.getSize() >= magic.size() &&
+                 std::string_view(file.getData(), magic.size()) == magic);
+  bool compressed = file.isCompressed();
+  file.close();
+
+  // Pipe it through the migration, into the same format
+  std::unique_ptr<XmlReader> reader;
+  std::unique_ptr<XmlWriter> writer;
+  if(binary)
+  {
+    BinaryWriter* binary_writer = new BinaryWriter(path);
+    binary_writer->setCompressionEnabled(compressed);
+    writer.reset(binary_writer);
+    reader.reset(new BinaryReader(path));
+  }
+  else if(std::filesystem::path(path).extension() == kXML_EXTENSION)
+  {
+    std::error_code error;
+    BufferedXmlWriter* xml_writer = new BufferedXmlWriter(path);
+    xml_writer->setCompressionEnabled(compressed);
+    xml_writer->setIndexEnabled(std::filesystem::exists(XmlIndex::getIndexPath(path), error));
+    writer.reset(xml_writer);
+    reader.reset(new MappedXmlReader(path));
+  }
+  else
+  {
+    return true;
+  }
+  bool success = migrateLines(reader.get(), writer.get(), migrated_count);
+
+  // Only rewrite the save if anything changed
+  if(!writer->isStarted())
+    return false;
+  bool saved = writer->stop(success && migrated_count > 0);
+  return success && saved;
+}
+
+/**
+ * Rewrites the data line from a legacy layout into the current one. A conversation element with
+ * an id key, which is only in the legacy layout, is split into the conversation element and an
+ * entry element with the id. The data and the rest of the branch are kept as they are.
+ * @param line the data line, rewritten in place
+ * @return TRUE if the line was in a legacy layout and was rewritten
+ */
+bool SaveMigrator::migrateLine(XmlData& line)
+{
+  XmlDataView view(line);
+  int element_count = view.getNumElements();
+  auto is_legacy = [&](int index)
+  {
+    return (index < element_count - 1 && view.getElementAtom(index) == Atom::CONVERSATION &&
+            view.getKeyAtom(index) == Atom::ID);
+  };
+
+  int first_legacy = 0;
+  while(first_legacy < element_count && !is_legacy(first_legacy))
+    first_legacy++;
+  if(first_legacy == element_count)
+    return false;
+
+  // Rebuild the branch with each legacy element split in two
+  XmlData migrated;
+  for(int i = 0; i < element_count; i++)
+  {
+    if(is_legacy(i))
+    {
+      migrated.addElementBack(view.getElement(i));
+      migrated.addElementBack(kKEY_ENTRY, view.getKey(i), view.getKeyValue(i));
+    }
+    else
+    {
+      migrated.addElementBack(view.getElement(i), view.getKey(i), view.getKeyValue(i),
+                              view.getElementAtom(i), view.getKeyAtom(i));
+    }
+  }
+
+  // Keep the typed data
+  if(line.isDataBoolean())
+    migrated.setDataOfType(line.getDataBoolean());
+  else if(line.isDataInteger())
+    migrated.setDataOfType(line.getDataInteger());
+  else if(line.isDataFloat())
+    migrated.setDataOfType(line.getDataFloat());
+  else if(line.isDataString())
+    migrated.setDataOfType(std::string_view(line.getDataString()));
+
+  line = std::move(migrated);
+  return true;
+}
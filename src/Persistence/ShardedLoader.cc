@@ -0,0 +1,121 @@
+/**
+ * @class ShardedLoader
+ *
+ * Parallel content loader. The source is split into shards at the top-level element boundaries
+ * (the children of the root element) and each shard is read on its own worker thread, into a
+ * result object that only that shard touches. Results are returned in document order, so
+ * merging them in sequence gives the same content as one sequential read. If the reader can't
+ * be split, the whole source is read as a single shard on the calling thread.
+ */
+#include "Persistence/ShardedLoader.h"
+using namespace core;
+
+/*============================================================================
+ * CONSTRUCTORS / DESTRUCTORS
+ *===========================================================================*/
+
+/**
+ * Constructor function - Sets up the loader for the source. The reader itself is only used
+ * directly if it can't be split.
+ * @param reader reader of the whole source. Not owned, must outlive the loader
+ * @param thread_count number of worker threads. 0 to use one per hardware thread
+ */
+ShardedLoader::ShardedLoader(XmlReader* reader, unsigned int thread_count)
+             : reader{reader},
+               thread_count{thread_count}
+{
+  if(this->thread_count == 0)
+    this->thread_count = std::thread::hardware_concurrency();
+  if(this->thread_count == 0)
+    this->thread_count = 1;
+}
+
+/*============================================================================
+ * PRIVATE FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Reads every line of the shard into the line handler, a batch at a time. The shard is started
+ * and stopped here. Lines that fail to read are skipped but fail the shard.
+ * @param shard reader of the shard
+ * @param load_line handler for each line read
+ * @return TRUE if the shard started, was read to the end and all lines were valid
+ */
+bool ShardedLoader::readShard(XmlReader* shard, std::function<void(XmlDataView)> load_line)
+{
+  if(!shard->start())
+    return false;
+
+  std::vector<XmlData> lines;
+  bool all_valid = true;
+  bool done = false;
+  bool success;
+  while(!done)
+  {
+    size_t count = shard->readBatch(lines, done, success);
+    for(size_t i = 0; i < count; i++)
+      load_line(XmlDataView(lines[i]));
+    all_valid &= success;
+  }
+
+  // The lines allocate from the session arena of the shard, which is released when it stops
+  lines.clear();
+  shard->stop();
+  return all_valid;
+}
+
+/**
+ * Runs the task for each shard index. A single shard runs on the calling thread, otherwise each
+ * shard gets its own worker thread. Any exception thrown by a task is held until all workers
+ * are joined, and then the first one by shard index is rethrown.
+ * @param shard_count number of shards to run
+ * @param task reads the shard at the index. Returns its success
+ * @return TRUE if every task was successful
+ */
+bool ShardedLoader::runShards(size_t shard_count, std::function<bool(size_t)> task)
+{
+  if(shard_count == 1)
+    return task(0);
+
+  std::vector<std::exception_ptr> errors(shard_count);
+  std::vector<char> successes(shard_count, false);
+  std::vector<std::thread> workers;
+  for(size_t i = 0; i < shard_count; i++)
+  {
+    workers.emplace_back([&, i]()
+    {
+      try
+      {
+        successes[i] = task(i);
+      }
+      catch(...)
+      {
+        errors[i] = std::current_exception();
+      }
+    });
+  }
+  for(std::thread& worker : workers)
+    worker.join();
+
+  bool success = true;
+  for(size_t i = 0; i < shard_count; i++)
+  {
+    if(errors[i])
+      std::rethrow_exception(errors[i]);
+    success &= (successes[i] != 0);
+  }
+  return success;
+}
+
+/*============================================================================
+ * PUBLIC FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Returns the number of worker threads, which is also the maximum number of shards.
+ * @return thread count. Always at least 1
+ */
+unsigned int ShardedLoader::getThreadCount() const
+{
+  return thread_count;
+}
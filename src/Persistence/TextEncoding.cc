@@ -0,0 +1,172 @@
+/**
+ * @class TextEncoding
+ *
+ * Primitive encoders and decoders for data stored as text in the XML content format. These are
+ * built on std::from_chars and std::to_chars, so they are independent of the locale, never
+ * allocate to parse and report malformed text with a return status instead of an exception.
+ * Floats are formatted as the shortest text that reads back to exactly the same value. Where the
+ * standard library has no float support in std::to_chars (__cpp_lib_to_chars is not defined),
+ * floats fall back to printf and strtof, with the decimal point of the "C" locale.
+ */
+#include "Persistence/TextEncoding.h"
+using namespace core;
+
+/* Constant Implementation - see header file for descriptions */
+const std::string_view TextEncoding::kBOOLEAN_FALSE = "false";
+const std::string_view TextEncoding::kBOOLEAN_TRUE = "true";
+
+/*============================================================================
+ * PRIVATE STATIC FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Trims the surrounding whitespace and a leading '+' off number text, which std::from_chars
+ * doesn't accept but hand edited content may contain.
+ * @param text number text
+ * @return view of the number within the text
+ */
+std::string_view TextEncoding::trimNumber(std::string_view text)
+{
+  const char* kWHITESPACE = " \t\r\n";
+  size_t begin = text.find_first_not_of(kWHITESPACE);
+  if(begin == std::string_view::npos)
+    return std::string_view();
+
+  text = text.substr(begin, text.find_last_not_of(kWHITESPACE) - begin + 1);
+  if(text.size() > 1 && text.front() == '+' && text[1] != '-')
+    text.remove_prefix(1);
+  return text;
+}
+
+/*============================================================================
+ * PUBLIC STATIC FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Formats a boolean as text.
+ * @param value the boolean to format
+ * @return "true" or "false"
+ */
+std::string TextEncoding::formatBoolean(bool value)
+{
+  return std::string(value ? kBOOLEAN_TRUE : kBOOLEAN_FALSE);
+}
+
+/**
+ * Formats a float as the shortest text that reads back to exactly the same value. Without float
+ * support in std::to_chars, it's formatted to 9 significant digits instead, which also reads
+ * back exactly but isn't always the shortest.
+ * @param value the float to format
+ * @return formatted text
+ */
+std::string TextEncoding::formatFloat(float value)
+{
+  char formatted[32];
+#ifdef __cpp_lib_to_chars
+  std::to_chars_result result = std::to_chars(formatted, formatted + sizeof(formatted), value);
+  return std::string(formatted, result.ptr);
+#else
+  int length = std::snprintf(formatted, sizeof(formatted), "%.9g", static_cast<double>(value));
+  std::string text(formatted, (length > 0 ? static_cast<size_t>(length) : 0));
+
+  // The decimal point follows the current locale, so it's swapped back to the "C" one
+  char point = std::localeconv()->decimal_point[0];
+  if(point != '.')
+    std::replace(text.begin(), text.end(), point, '.');
+  return text;
+#endif
+}
+
+/**
+ * Formats an integer as decimal text.
+ * @param value the integer to format
+ * @return formatted text
+ */
+std::string TextEncoding::formatInteger(int value)
+{
+  char formatted[16];
+  std::to_chars_result result = std::to_chars(formatted, formatted + sizeof(formatted), value);
+  return std::string(formatted, result.ptr);
+}
+
+/**
+ * Formats an unsigned integer as decimal text, so a value above the int range isn't wrapped.
+ * @param value the unsigned integer to format
+ * @return formatted text
+ */
+std::string TextEncoding::formatUnsigned(uint32_t value)
+{
+  char formatted[16];
+  std::to_chars_result result = std::to_chars(formatted, formatted + sizeof(formatted), value);
+  return std::string(formatted, result.ptr);
+}
+
+/**
+ * Decodes a boolean from text. Any text other than "true" is false, as it always has been.
+ * @param text the boolean text
+ * @param value the decoded boolean
+ * @return TRUE always, a boolean can't be malformed
+ */
+bool TextEncoding::readBoolean(std::string_view text, bool& value)
+{
+  value = (text == kBOOLEAN_TRUE);
+  return true;
+}
+
+/**
+ * Decodes a float from the whole text, ignoring surrounding whitespace.
+ * @param text the float text
+ * @param value the decoded float. Untouched on failure
+ * @return TRUE if the text is a float in range with nothing after it
+ */
+bool TextEncoding::readFloat(std::string_view text, float& value)
+{
+  text = trimNumber(text);
+#ifdef __cpp_lib_to_chars
+  const char* end = text.data() + text.size();
+  std::from_chars_result result = std::from_chars(text.data(), end, value);
+  return (result.ec == std::errc() && result.ptr == end);
+#else
+  // Only the "C" decimal point is valid, so it's swapped for the one strtof() reads in the
+  // current locale. Hex floats are rejected, the same as std::from_chars does
+  std::string number(text);
+  char point = std::localeconv()->decimal_point[0];
+  if(number.empty() || number.find_first_of("xX") != std::string::npos ||
+     (point != '.' && number.find(point) != std::string::npos))
+    return false;
+  if(point != '.')
+    std::replace(number.begin(), number.end(), '.', point);
+
+  // A subnormal result is in range, only an overflow or an underflow to zero isn't
+  char* end;
+  errno = 0;
+  float parsed = std::strtof(number.c_str(), &end);
+  if(end != number.c_str() + number.size() ||
+     (errno == ERANGE && (parsed == 0.0f || std::isinf(parsed))))
+    return false;
+  value = parsed;
+  return true;
+#endif
+}
+
+/**
+ * Decodes a decimal integer from the whole text, ignoring surrounding whitespace. Unsigned data
+ * above the int range (see formatUnsigned()) is decoded as the int with the same bits, which
+ * converts back to the unsigned value exactly.
+ * @param text the integer text
+ * @param value the decoded integer. Untouched on failure
+ * @return TRUE if the text is an int or unsigned int with nothing after it
+ */
+bool TextEncoding::readInteger(std::string_view text, int& value)
+{
+  text = trimNumber(text);
+  const char* end = text.data() + text.size();
+  int64_t wide_value;
+  std::from_chars_result result = std::from_chars(text.data(), end, wide_value);
+  if(result.ec != std::errc() || result.ptr != end || wide_value < INT_MIN ||
+     wide_value > UINT32_MAX)
+    return false;
+
+  value = static_cast<int>(static_cast<uint32_t>(wide_value));
+  return true;
+}
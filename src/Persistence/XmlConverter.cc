@@ -0,0 +1,105 @@
+/**
+ * @class XmlConverter
+ *
+ * Offline conversion of a full document between any reader and writer backend, such as XML text
+ * to the compact binary format. The reader only yields data lines, so the element tree is
+ * rebuilt from the difference between each line and the branch that is currently open in the
+ * writer.
+ */
+#include "Persistence/XmlConverter.h"
+using namespace core;
+
+/*============================================================================
+ * PUBLIC STATIC FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Copies every data line from the reader into the writer. Both are started and stopped here and
+ * the writer only saves if the whole source was read successfully. Consecutive sibling elements
+ * that share the same name, key and value are merged, since lines can not tell them apart.
+ * @param reader source of the document. Must not be started
+ * @param writer destination of the document. Must not be started
+ * @return TRUE if the document was fully read and the writer saved it
+ */
+bool XmlConverter::convert(XmlReader* reader, XmlWriter* writer)
+{
+  if(!reader->start())
+    return false;
+  if(!writer->start())
+  {
+    reader->stop();
+    return false;
+  }
+
+  XmlData open_branch;
+  bool done = false;
+  bool success = true;
+  while(success)
+  {
+    XmlData line = reader->read(done, success);
+    if(done || !success)
+      break;
+
+    success = writeLine(writer, line, open_branch);
+  }
+
+  reader->stop();
+  return writer->stop(success) && success;
+}
+
+/**
+ * Writes the data line into the writer. The elements of the open branch that the line doesn't
+ * share are closed and the rest of the line branch is opened, so consecutive lines in the same
+ * elements are written inside them.
+ * @param writer destination of the line. Must be started, with the open branch as its location
+ * @param line the data line to write
+ * @param open_branch the branch open in the writer, updated to the branch of the line
+ * @return TRUE if the line was written
+ */
+bool XmlConverter::writeLine(XmlWriter* writer, XmlData& line, XmlData& open_branch)
+{
+  bool success = true;
+
+  // Find how much of the open branch is shared with the line, not including the data element
+  XmlDataView line_view(line);
+  XmlDataView open_view(open_branch);
+  int element_count = line_view.getNumElements() - 1;
+  int shared_count = 0;
+  while(shared_count < element_count && shared_count < open_view.getNumElements() &&
+        line_view.getElement(shared_count) == open_view.getElement(shared_count) &&
+        line_view.getKey(shared_count) == open_view.getKey(shared_count) &&
+        line_view.getKeyValue(shared_count) == open_view.getKeyValue(shared_count))
+    shared_count++;
+
+  // Move the writer to the branch of the line
+  while(open_branch.getNumElements() > shared_count)
+  {
+    writer->jumpToParent();
+    open_branch.removeLastElement();
+  }
+  for(int i = shared_count; success && i < element_count; i++)
+  {
+    std::string element(line_view.getElement(i));
+    std::string key(line_view.getKey(i));
+    std::string value(line_view.getKeyValue(i));
+    success = writer->writeElement(element, key, value);
+    open_branch.addElementBack(element, key, value);
+  }
+
+  // Write the typed data
+  if(success)
+  {
+    std::string element = line.getLastElement();
+    if(line.isDataBoolean())
+      success = writer->writeData(element, line.getDataBoolean());
+    else if(line.isDataInteger())
+      success = writer->writeData(element, line.getDataInteger());
+    else if(line.isDataFloat())
+      success = writer->writeData(element, line.getDataFloat());
+    else if(line.isDataString())
+      success = writer->writeData(element, line.getDataString());
+    else
+      success = false;
+  }
+  return success;
+}
@@ -7,10 +7,40 @@
 #include "Persistence/XmlData.h"
 using namespace core;
 
+/* Constant Implementation - see header file for descriptions */
+const std::string XmlData::kKEY_DATA_TYPE = "type";
+
 /*============================================================================
  * CONSTRUCTORS / DESTRUCTORS
  *===========================================================================*/
 
+/**
+ * Constructor function - Sets up a blank class that allocates all of its content from the
+ * memory resource, such as the arena of a load session.
+ * @param resource memory resource to allocate from. Must outlive the class
+ */
+XmlData::XmlData(std::pmr::memory_resource* resource)
+       : branch{resource},
+         string_data{resource}
+{
+}
+
+/**
+ * Constructor function - Copies the line, allocating the copy from the memory resource. A plain
+ * copy always allocates from the default resource, so it can outlive the source's resource.
+ * @param source line to copy
+ * @param resource memory resource to allocate the copy from. Must outlive the class
+ */
+XmlData::XmlData(const XmlData& source, std::pmr::memory_resource* resource)
+       : branch{source.branch, resource},
+         data_type{source.data_type},
+         bool_data{source.bool_data},
+         float_data{source.float_data},
+         int_data{source.int_data},
+         string_data{source.string_data, resource}
+{
+}
+
 /**
  * Constructor function - Sets up the class with just one BOOL data element in it.
  * @param data boolean storage value to represent
@@ -47,6 +77,56 @@ XmlData::XmlData(std::string data)
   setDataOfType(data);
 }
 
+/**
+ * Constructor function - Sets up a single element of the branch.
+ * @param element the element name
+ * @param key the key for the tag identifier
+ * @param value the value corresponding to the key
+ * @param element_atom the interned atom of the element name
+ * @param key_atom the interned atom of the key
+ * @param allocator allocator for the strings
+ */
+XmlData::BranchElement::BranchElement(std::string_view element, std::string_view key,
+                                      std::string_view value, Atom element_atom, Atom key_atom,
+                                      const allocator_type& allocator)
+                      : element{element, allocator},
+                        key{key, allocator},
+                        value{value, allocator},
+                        element_atom{element_atom},
+                        key_atom{key_atom}
+{
+}
+
+/**
+ * Constructor function - Copies a single element of the branch.
+ * @param source the element to copy
+ * @param allocator allocator for the strings of the copy
+ */
+XmlData::BranchElement::BranchElement(const BranchElement& source,
+                                      const allocator_type& allocator)
+                      : element{source.element, allocator},
+                        key{source.key, allocator},
+                        value{source.value, allocator},
+                        element_atom{source.element_atom},
+                        key_atom{source.key_atom}
+{
+}
+
+/**
+ * Constructor function - Moves a single element of the branch. The strings are only copied if
+ * the allocator is from a different memory resource.
+ * @param source the element to move
+ * @param allocator allocator for the strings
+ */
+XmlData::BranchElement::BranchElement(BranchElement&& source, const allocator_type& allocator)
+                      : element{std::move(source.element), allocator},
+                        key{std::move(source.key), allocator},
+                        value{std::move(source.value), allocator},
+                        element_atom{source.element_atom},
+                        key_atom{source.key_atom}
+{
+}
+
 /*============================================================================
  * PUBLIC FUNCTIONS
  *===========================================================================*/
@@ -57,11 +137,26 @@ XmlData::XmlData(std::string data)
  * @param key the key for the tag identifier (default "")
  * @param value the value corresponding to the key (default "")
  */
-void XmlData::addElementBack(std::string element, std::string key, std::string value)
+void XmlData::addElementBack(std::string_view element, std::string_view key,
+                             std::string_view value)
 {
-  this->element.push_back(element);
-  this->key.push_back(key);
-  this->value.push_back(value);
+  branch.emplace_back(element, key, value, AtomTable::fromName(element),
+                      AtomTable::fromName(key));
+}
+
+/**
+ * Add an element to the class, with atoms that the caller already interned. It adds it to the
+ * back of the branch stack.
+ * @param element the element name (front of the tag)
+ * @param key the key for the tag identifier
+ * @param value the value corresponding to the key
+ * @param element_atom the interned atom of the element name
+ * @param key_atom the interned atom of the key
+ */
+void XmlData::addElementBack(std::string_view element, std::string_view key,
+                             std::string_view value, Atom element_atom, Atom key_atom)
+{
+  branch.emplace_back(element, key, value, element_atom, key_atom);
 }
 
 /**
@@ -70,11 +165,11 @@ void XmlData::addElementBack(std::string element, std::string key, std::string v
  * @param key the key for the tag identifier (default "")
  * @param value the value corresponding to the key (default "")
  */
-void XmlData::addElementFront(std::string element, std::string key, std::string value)
+void XmlData::addElementFront(std::string_view element, std::string_view key,
+                              std::string_view value)
 {
-  this->element.push_front(element);
-  this->key.push_front(key);
-  this->value.push_front(value);
+  branch.emplace(branch.begin(), element, key, value, AtomTable::fromName(element),
+                 AtomTable::fromName(key));
 }
 
 /**
@@ -91,19 +186,19 @@ std::string XmlData::getData(bool* success)
   /* Process the data into string form */
   if(isDataBoolean())
   {
-    data_str = (bool_data ? "true" : "false");
+    data_str = TextEncoding::formatBoolean(bool_data);
   }
   else if(isDataInteger())
   {
-    data_str = std::to_string(int_data);
+    data_str = TextEncoding::formatInteger(int_data);
   }
   else if(isDataFloat())
   {
-    data_str = std::to_string(float_data);
+    data_str = TextEncoding::formatFloat(float_data);
   }
   else if(isDataString())
   {
-    data_str = string_data;
+    data_str = std::string(string_data);
   }
   else
   {
@@ -198,7 +293,7 @@ std::string XmlData::getDataString(bool* success)
 {
   if(success != nullptr)
     *success = isDataString();
-  return string_data;
+  return std::string(string_data);
 }
 
 /**
@@ -210,7 +305,7 @@ std::string XmlData::getDataStringOrThrow()
 {
   if(!isDataString())
     throw std::bad_cast();
-  return string_data;
+  return std::string(string_data);
 }
 
 /**
@@ -229,11 +324,23 @@ DataType XmlData::getDataType()
  */
 std::string XmlData::getElement(uint16_t index)
 {
-  if(index < element.size())
-    return element[index];
+  if(index < branch.size())
+    return std::string(branch[index].element);
   return "";
 }
 
+/**
+ * Returns the interned atom of a single element of the given index, if it's within range.
+ * @param index the index of the element
+ * @return the element atom. NONE if out of range or the name is not interned
+ */
+Atom XmlData::getElementAtom(uint16_t index)
+{
+  if(index < branch.size())
+    return branch[index].element_atom;
+  return Atom::NONE;
+}
+
 /**
  * Returns a single key of the given index, if it's within range. Otherwise, it's
  * returns a blank string. This key corresponds directly to the element, at the same index.
@@ -242,11 +349,23 @@ std::string XmlData::getElement(uint16_t index)
  */
 std::string XmlData::getKey(uint16_t index)
 {
-  if(index < key.size())
-    return key[index];
+  if(index < branch.size())
+    return std::string(branch[index].key);
   return "";
 }
 
+/**
+ * Returns the interned atom of a single key of the given index, if it's within range.
+ * @param index the index of the key
+ * @return the key atom. NONE if out of range, blank or the name is not interned
+ */
+Atom XmlData::getKeyAtom(uint16_t index)
+{
+  if(index < branch.size())
+    return branch[index].key_atom;
+  return Atom::NONE;
+}
+
 /**
  * Returns a single value (of the key) of the given index, if it's within range.
  * Otherwise, it's returns a blank string.
@@ -255,8 +374,8 @@ std::string XmlData::getKey(uint16_t index)
  */
 std::string XmlData::getKeyValue(uint16_t index)
 {
-  if(index < value.size())
-    return value[index];
+  if(index < branch.size())
+    return std::string(branch[index].value);
   return "";
 }
 
@@ -266,8 +385,8 @@ std::string XmlData::getKeyValue(uint16_t index)
  */
 std::string XmlData::getLastElement()
 {
-  if(element.size() > 0)
-    return element.back();
+  if(branch.size() > 0)
+    return std::string(branch.back().element);
   return "";
 }
 
@@ -278,7 +397,16 @@ std::string XmlData::getLastElement()
  */
 int XmlData::getNumElements()
 {
-  return element.size();
+  return branch.size();
+}
+
+/**
+ * Returns the memory resource that the branch and the data of the line allocate from.
+ * @return memory resource, such as the arena of a load session or the default resource
+ */
+std::pmr::memory_resource* XmlData::getMemoryResource() const
+{
+  return branch.get_allocator().resource();
 }
 
 /**
@@ -333,46 +461,56 @@ bool XmlData::isDataUnset()
  */
 void XmlData::removeLastElement()
 {
-  if(!element.empty())
-  {
-    element.pop_back();
-    key.pop_back();
-    value.pop_back();
-  }
+  if(!branch.empty())
+    branch.pop_back();
 }
 
 /**
  * Set data to the class. It utilizes the last entered element to determine what the
- * data should be, as per the XML standard designed around this component.
+ * data should be, as per the XML standard designed around this component. Malformed data is
+ * reported by the status, it never throws.
  * @param data generic storage value to represent straight from storage reader, as a string
- * @return status if insert is successful
+ * @return status if insert is successful. FALSE if the data type or the data is malformed
  */
-bool XmlData::setData(std::string data)
+bool XmlData::setData(std::string_view data)
 {
-  bool success = true;
-
   /* Determine what the data is */
-  if(element.size() > 0)
+  int type_value;
+  if(branch.size() == 0 || !TextEncoding::readInteger(branch.back().value, type_value))
+    return false;
+
+  DataType type = static_cast<DataType>(type_value);
+  if(type == DataType::BOOLEAN)
+  {
+    bool value;
+    if(!TextEncoding::readBoolean(data, value))
+      return false;
+    setDataOfType(value);
+  }
+  else if(type == DataType::INTEGER)
+  {
+    int value;
+    if(!TextEncoding::readInteger(data, value))
+      return false;
+    setDataOfType(value);
+  }
+  else if(type == DataType::FLOAT)
+  {
+    float value;
+    if(!TextEncoding::readFloat(data, value))
+      return false;
+    setDataOfType(value);
+  }
+  else if(type == DataType::STRING)
   {
-    DataType type = static_cast<DataType>(std::stoi(value.back()));
-
-    if(type == DataType::BOOLEAN)
-      setDataOfType(data == "true");
-    else if(type == DataType::INTEGER)
-      setDataOfType(std::stoi(data));
-    else if(type == DataType::FLOAT)
-      setDataOfType(std::stof(data));
-    else if(type == DataType::STRING)
-      setDataOfType(data);
-    else
-      success = false;
+    setDataOfType(data);
   }
   else
   {
-    success = false;
+    return false;
   }
 
-  return success;
+  return true;
 }
 
 /**
@@ -409,7 +547,7 @@ void XmlData::setDataOfType(int data)
  * Set data to the class, of the type string.
  * @param data string storage value to represent
  */
-void XmlData::setDataOfType(std::string data)
+void XmlData::setDataOfType(std::string_view data)
 {
   data_type = DataType::STRING;
   string_data = data;
@@ -0,0 +1,284 @@
+/**
+ * @class XmlDataView
+ *
+ * Immutable, non-owning view of a line of XML data. This is what is passed down through the
+ * load path so a single line read from the source reaches the final setter without being copied.
+ * The viewed line is owned by the reader (or the caller of the reader) and must outlive the view.
+ */
+#include "Persistence/XmlDataView.h"
+using namespace core;
+
+/*============================================================================
+ * CONSTRUCTORS / DESTRUCTORS
+ *===========================================================================*/
+
+/**
+ * Constructor function - Sets up a view over an existing line of data. This is intentionally
+ * implicit so any XmlData can be passed directly into a load call.
+ * @param data the line of data to view. Must outlive this view
+ */
+XmlDataView::XmlDataView(const XmlData& data) : data(&data)
+{
+}
+
+/*============================================================================
+ * PUBLIC FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Returns the size of the line in bytes: the names, keys and values of every element and the
+ * data, with the non-string data counted at its stored size.
+ * @return number of bytes held by the line
+ */
+size_t XmlDataView::getByteCount() const
+{
+  size_t byte_count = 0;
+  for(const XmlData::BranchElement& element : data->branch)
+    byte_count += element.element.size() + element.key.size() + element.value.size();
+
+  switch(data->data_type) {
+    case DataType::BOOLEAN:
+      return byte_count + sizeof(data->bool_data);
+    case DataType::FLOAT:
+      return byte_count + sizeof(data->float_data);
+    case DataType::INTEGER:
+      return byte_count + sizeof(data->int_data);
+    case DataType::STRING:
+      return byte_count + data->string_data.size();
+    default:
+      return byte_count;
+  }
+}
+
+/**
+ * Returns the data stored in the viewed line, if it's a bool.
+ * @param success status if the data in the line is bool
+ * @return the bool data available in the line
+ */
+bool XmlDataView::getDataBoolean(bool* success) const
+{
+  if(success != nullptr)
+    *success = isDataBoolean();
+  return data->bool_data;
+}
+
+/**
+ * Returns the data stored in the viewed line, if its a bool.
+ * @return the bool data available in the line
+ * @throws std::bad_cast if the data in the line is not a bool
+ */
+bool XmlDataView::getDataBooleanOrThrow() const
+{
+  if(!isDataBoolean())
+    throw std::bad_cast();
+  return data->bool_data;
+}
+
+/**
+ * Returns the data stored in the viewed line, if it's a float.
+ * @param success status if the data in the line is float
+ * @return the float data available in the line
+ */
+float XmlDataView::getDataFloat(bool* success) const
+{
+  if(success != nullptr)
+    *success = isDataFloat();
+  return data->float_data;
+}
+
+/**
+ * Returns the data stored in the viewed line, if it's a float.
+ * @return the float data available in the line
+ * @throws std::bad_cast if the data in the line is not a float
+ */
+float XmlDataView::getDataFloatOrThrow() const
+{
+  if(!isDataFloat())
+    throw std::bad_cast();
+  return data->float_data;
+}
+
+/**
+ * Returns the data stored in the viewed line, if it's an integer.
+ * @param success status if the data in the line is integer
+ * @return the integer data available in the line
+ */
+int XmlDataView::getDataInteger(bool* success) const
+{
+  if(success != nullptr)
+    *success = isDataInteger();
+  return data->int_data;
+}
+
+/**
+ * Returns the data stored in the viewed line, if it's an integer.
+ * @return the integer data available in the line
+ * @throws std::bad_cast if the data in the line is not a integer
+ */
+int XmlDataView::getDataIntegerOrThrow() const
+{
+  if(!isDataInteger())
+    throw std::bad_cast();
+  return data->int_data;
+}
+
+/**
+ * Returns the data stored in the viewed line, if it's a string.
+ * @param success status if the data in the line is string
+ * @return view of the string data available in the line
+ */
+std::string_view XmlDataView::getDataString(bool* success) const
+{
+  if(success != nullptr)
+    *success = isDataString();
+  return data->string_data;
+}
+
+/**
+ * Returns the data stored in the viewed line, if it's a string.
+ * @return view of the string data available in the line
+ * @throws std::bad_cast if the data in the line is not a string
+ */
+std::string_view XmlDataView::getDataStringOrThrow() const
+{
+  if(!isDataString())
+    throw std::bad_cast();
+  return data->string_data;
+}
+
+/**
+ * Returns the data categorizing type from the viewed line.
+ * @return the current stored data type classification
+ */
+DataType XmlDataView::getDataType() const
+{
+  return data->data_type;
+}
+
+/**
+ * Returns a single element of the given index, if it's within range.
+ * @param index the index of the element to return
+ * @return view of the located element. Empty if out of range
+ */
+std::string_view XmlDataView::getElement(uint16_t index) const
+{
+  if(index < data->branch.size())
+    return data->branch[index].element;
+  return {};
+}
+
+/**
+ * Returns the interned atom of a single element of the given index, if it's within range. This
+ * is what loaders dispatch on, without comparing the element name.
+ * @param index the index of the element
+ * @return the element atom. NONE if out of range or the name is not interned
+ */
+Atom XmlDataView::getElementAtom(uint16_t index) const
+{
+  if(index < data->branch.size())
+    return data->branch[index].element_atom;
+  return Atom::NONE;
+}
+
+/**
+ * Returns a single key of the given index, if it's within range. This key corresponds directly
+ * to the element, at the same index.
+ * @param index the index of the key to return
+ * @return view of the located key. Empty if out of range
+ */
+std::string_view XmlDataView::getKey(uint16_t index) const
+{
+  if(index < data->branch.size())
+    return data->branch[index].key;
+  return {};
+}
+
+/**
+ * Returns the interned atom of a single key of the given index, if it's within range.
+ * @param index the index of the key
+ * @return the key atom. NONE if out of range, blank or the name is not interned
+ */
+Atom XmlDataView::getKeyAtom(uint16_t index) const
+{
+  if(index < data->branch.size())
+    return data->branch[index].key_atom;
+  return Atom::NONE;
+}
+
+/**
+ * Returns a single value (of the key) of the given index, if it's within range.
+ * @param index the index of the value (of the key) to return
+ * @return view of the located value. Empty if out of range
+ */
+std::string_view XmlDataView::getKeyValue(uint16_t index) const
+{
+  if(index < data->branch.size())
+    return data->branch[index].value;
+  return {};
+}
+
+/**
+ * Extracts the last element in the branch stack of fields that wrap the data.
+ * @return view of the tag name of the last element. Empty if no elements available
+ */
+std::string_view XmlDataView::getLastElement() const
+{
+  if(data->branch.size() > 0)
+    return data->branch.back().element;
+  return {};
+}
+
+/**
+ * Returns the number of elements in the viewed line. This number also indicates
+ * the number of keys and values, since these directly correlate.
+ * @return the number of elements in the line
+ */
+int XmlDataView::getNumElements() const
+{
+  return data->branch.size();
+}
+
+/**
+ * Check if the data stored in the viewed line is a boolean.
+ * @return if the data is a boolean.
+ */
+bool XmlDataView::isDataBoolean() const
+{
+  return (data->data_type == DataType::BOOLEAN);
+}
+
+/**
+ * Check if the data stored in the viewed line is a float.
+ * @return if the data is a float.
+ */
+bool XmlDataView::isDataFloat() const
+{
+  return (data->data_type == DataType::FLOAT);
+}
+
+/**
+ * Check if the data stored in the viewed line is an integer.
+ * @return if the data is an integer.
+ */
+bool XmlDataView::isDataInteger() const
+{
+  return (data->data_type == DataType::INTEGER);
+}
+
+/**
+ * Check if the data stored in the viewed line is a string.
+ * @return if the data is a string.
+ */
+bool XmlDataView::isDataString() const
+{
+  return (data->data_type == DataType::STRING);
+}
+
+/**
+ * Check if the data stored in the viewed line is unset.
+ * @return if the data is unset.
+ */
+bool XmlDataView::isDataUnset() const
+{
+  return !(isDataBoolean() || isDataFloat() || isDataInteger() || isDataString());
+}
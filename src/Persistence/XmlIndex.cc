@@ -0,0 +1,405 @@
+/**
+ * @class XmlIndex
+ *
+ * Offset index of the elements in an XML source, kept in a sidecar file next to it (the source
+ * path with ".idx" appended). Every non-data element is recorded with its parent, its key and
+ * the byte offsets of its open and close tags, so a reader can seek straight to an element path
+ * instead of scanning everything before it. The index is stamped with the size and modified
+ * time of the source it describes, and is not loaded if either has changed since.
+ *
+ * The sidecar is the magic "FISI" and a version byte, the source size (varint) and modified time
+ * (signed varint), the entry count and then each entry in document order: parent entry + 1 (0 for
+ * a root element), element, key and value strings, and the open and close tag offsets. The
+ * primitives are encoded as in {@link BinaryEncoding}.
+ */
+#include "Persistence/XmlIndex.h"
+using namespace core;
+
+/* Constant Implementation - see header file for descriptions */
+const std::string XmlIndex::kEXTENSION = ".idx";
+const std::string XmlIndex::kMAGIC = "FISI";
+
+/*============================================================================
+ * PRIVATE FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Rebuilds the path key lookup from the entries. Each element is found by its full path key,
+ * and also by the path key with its own key left blank, which matches the first element of that
+ * name under the same parent no matter its key. Only the first element at each key is kept,
+ * marked if any other element shares the key.
+ */
+void XmlIndex::buildLookup()
+{
+  lookup.clear();
+  lookup.reserve(entries.size() * 2);
+
+  std::vector<std::string> path_keys(entries.size());
+  for(uint32_t i = 0; i < entries.size(); i++)
+  {
+    const Entry& entry = entries[i];
+    std::string parent_key = (entry.parent == kNO_ENTRY ? "" : path_keys[entry.parent]);
+
+    path_keys[i] = parent_key;
+    appendPathKey(path_keys[i], entry.element, entry.key, entry.value);
+    auto added = lookup.emplace(path_keys[i], Match{i, true});
+    if(!added.second)
+      added.first->second.unique = false;
+
+    if(!entry.key.empty())
+    {
+      appendPathKey(parent_key, entry.element, "", "");
+      added = lookup.emplace(parent_key, Match{i, true});
+      if(!added.second)
+        added.first->second.unique = false;
+    }
+  }
+}
+
+/*============================================================================
+ * PUBLIC FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Adds an element as the last child of the parent entry, for building the index as the source
+ * is written. Elements must be added in document order. The lookup is not updated until the
+ * index is saved and loaded again.
+ * @param parent entry of the parent element. kNO_ENTRY for a root element
+ * @param element the element name
+ * @param key the key for the tag identifier
+ * @param value the value corresponding to the key
+ * @param tag_offset offset of the open tag in the source
+ * @return entry of the added element
+ */
+uint32_t XmlIndex::addElement(uint32_t parent, std::string_view element, std::string_view key,
+                              std::string_view value, size_t tag_offset)
+{
+  entries.push_back({parent, std::string(element), std::string(key), std::string(value),
+                     tag_offset, tag_offset});
+  return static_cast<uint32_t>(entries.size() - 1);
+}
+
+/**
+ * Builds the index of the source with a single scan, without building any lines. Data elements
+ * (and anything inside them) are not indexed.
+ * @param source the open source file
+ * @return TRUE if the source was well formed and indexed. The index is cleared otherwise
+ */
+bool XmlIndex::build(MappedFile& source)
+{
+  clear();
+  if(!source.isOpen())
+    return false;
+
+  XmlTokenizer scanner = source.tokenize(0);
+  std::string decoded_key;
+  std::string decoded_value;
+  std::vector<uint32_t> stack;
+  bool valid = true;
+  bool scanning = true;
+  bool success = false;
+  while(scanning)
+  {
+    XmlTokenType type = source.nextToken(scanner);
+    if(type == XmlTokenType::ELEMENT_OPEN)
+    {
+      uint32_t parent = (stack.empty() ? kNO_ENTRY : stack.back());
+      if((stack.empty() || parent != kNO_ENTRY) && scanner.getKey() != XmlData::kKEY_DATA_TYPE)
+        stack.push_back(addElement(parent, scanner.getName(),
+                                   XmlTokenizer::decodeView(scanner.getKey(), decoded_key,
+                                                            valid),
+                                   XmlTokenizer::decodeView(scanner.getValue(), decoded_value,
+                                                            valid),
+                                   scanner.getTokenOffset()));
+      else
+        stack.push_back(kNO_ENTRY);
+    }
+    else if(type == XmlTokenType::ELEMENT_CLOSE)
+    {
+      if(stack.empty())
+        scanning = false;
+      else
+      {
+        if(stack.back() != kNO_ENTRY)
+          setElementEnd(stack.back(), scanner.getTokenOffset());
+        stack.pop_back();
+      }
+    }
+    else if(type == XmlTokenType::END)
+    {
+      success = (stack.empty() && valid);
+      scanning = false;
+    }
+    else if(type == XmlTokenType::ERROR)
+    {
+      scanning = false;
+    }
+  }
+
+  if(!success)
+  {
+    clear();
+    return false;
+  }
+
+  source_modified_time = source.getModifiedTime();
+  source_size = source.getSize();
+  buildLookup();
+  return true;
+}
+
+/**
+ * Removes all entries and the stamp of the source.
+ */
+void XmlIndex::clear()
+{
+  entries.clear();
+  lookup.clear();
+  source_modified_time = 0;
+  source_size = 0;
+}
+
+/**
+ * Finds the first element in the document at the element path key.
+ * @param path_key element path key, built with appendPathKey()
+ * @param entry set to the entry of the element if it was found
+ * @param unique set if no other element is indexed at the path
+ * @return TRUE if an element is indexed at the path
+ */
+bool XmlIndex::find(const std::string& path_key, uint32_t& entry, bool& unique) const
+{
+  auto found = lookup.find(path_key);
+  if(found == lookup.end())
+    return false;
+
+  entry = found->second.entry;
+  unique = found->second.unique;
+  return true;
+}
+
+/**
+ * Returns the name of the indexed element.
+ * @param entry the element entry
+ * @return element name
+ */
+std::string_view XmlIndex::getElement(uint32_t entry) const
+{
+  return entries[entry].element;
+}
+
+/**
+ * Returns the offset of the close tag of the indexed element.
+ * @param entry the element entry
+ * @return offset in the source
+ */
+size_t XmlIndex::getEndOffset(uint32_t entry) const
+{
+  return entries[entry].end_offset;
+}
+
+/**
+ * Returns the number of indexed elements.
+ * @return entry count
+ */
+size_t XmlIndex::getEntryCount() const
+{
+  return entries.size();
+}
+
+/**
+ * Returns the key of the indexed element.
+ * @param entry the element entry
+ * @return decoded key. Blank if none
+ */
+std::string_view XmlIndex::getKey(uint32_t entry) const
+{
+  return entries[entry].key;
+}
+
+/**
+ * Returns the value paired with the key of the indexed element.
+ * @param entry the element entry
+ * @return decoded value
+ */
+std::string_view XmlIndex::getKeyValue(uint32_t entry) const
+{
+  return entries[entry].value;
+}
+
+/**
+ * Returns the parent of the indexed element.
+ * @param entry the element entry
+ * @return entry of the parent. kNO_ENTRY for a root element
+ */
+uint32_t XmlIndex::getParent(uint32_t entry) const
+{
+  return entries[entry].parent;
+}
+
+/**
+ * Returns the offset of the open tag of the indexed element.
+ * @param entry the element entry
+ * @return offset in the source
+ */
+size_t XmlIndex::getTagOffset(uint32_t entry) const
+{
+  return entries[entry].tag_offset;
+}
+
+/**
+ * Returns if there are no indexed elements.
+ * @return TRUE if empty
+ */
+bool XmlIndex::isEmpty() const
+{
+  return entries.empty();
+}
+
+/**
+ * Loads the sidecar file of the source, if it exists and still describes the source.
+ * @param source_path file system path to the source
+ * @param source the open source file, to check the stamp against
+ * @return TRUE if loaded. The index is cleared otherwise
+ */
+bool XmlIndex::load(const std::string& source_path, const MappedFile& source)
+{
+  clear();
+
+  MappedFile file;
+  if(!source.isOpen() || !file.open(getIndexPath(source_path)) ||
+     file.getSize() <= kMAGIC.size() ||
+     std::string_view(file.getData(), kMAGIC.size()) != kMAGIC ||
+     static_cast<uint8_t>(file.getData()[kMAGIC.size()]) != kVERSION)
+    return false;
+
+  const char* cursor = file.getData() + kMAGIC.size() + 1;
+  const char* end = file.getData() + file.getSize();
+  uint64_t size;
+  int64_t modified_time;
+  uint64_t count;
+  bool valid = (BinaryEncoding::readVarint(cursor, end, size) && size == source.getSize() &&
+                BinaryEncoding::readSignedVarint(cursor, end, modified_time) &&
+                modified_time == static_cast<int64_t>(source.getModifiedTime()) &&
+                BinaryEncoding::readVarint(cursor, end, count) &&
+                count <= static_cast<uint64_t>(end - cursor));
+  if(valid)
+    entries.reserve(count);
+
+  for(uint64_t i = 0; valid && i < count; i++)
+  {
+    uint64_t parent;
+    std::string_view element;
+    std::string_view key;
+    std::string_view value;
+    uint64_t tag_offset;
+    uint64_t end_offset;
+    valid = (BinaryEncoding::readVarint(cursor, end, parent) && parent <= i &&
+             BinaryEncoding::readString(cursor, end, element) &&
+             BinaryEncoding::readString(cursor, end, key) &&
+             BinaryEncoding::readString(cursor, end, value) &&
+             BinaryEncoding::readVarint(cursor, end, tag_offset) &&
+             BinaryEncoding::readVarint(cursor, end, end_offset) &&
+             tag_offset <= end_offset && end_offset < size);
+    if(valid)
+      entries.push_back({parent > 0 ? static_cast<uint32_t>(parent - 1) : kNO_ENTRY,
+                         std::string(element), std::string(key), std::string(value),
+                         tag_offset, end_offset});
+  }
+
+  if(!valid || cursor != end)
+  {
+    clear();
+    return false;
+  }
+
+  source_modified_time = source.getModifiedTime();
+  source_size = source.getSize();
+  buildLookup();
+  return true;
+}
+
+/**
+ * Saves the sidecar file of the source. The stamp is taken from the source as it is now, so this
+ * should be called right after the source is written or the index is built.
+ * @param source_path file system path to the source
+ * @return TRUE if the source was found and the sidecar was written
+ */
+bool XmlIndex::save(const std::string& source_path)
+{
+  MappedFile source;
+  if(!source.open(source_path))
+    return false;
+  source_modified_time = source.getModifiedTime();
+  source_size = source.getSize();
+  source.close();
+
+  PageBuffer buffer;
+  buffer.append(kMAGIC);
+  buffer.append(static_cast<char>(kVERSION));
+  BinaryEncoding::appendVarint(buffer, source_size);
+  BinaryEncoding::appendSignedVarint(buffer, source_modified_time);
+  BinaryEncoding::appendVarint(buffer, entries.size());
+  for(const Entry& entry : entries)
+  {
+    BinaryEncoding::appendVarint(buffer, entry.parent == kNO_ENTRY ? 0 : entry.parent + 1);
+    BinaryEncoding::appendString(buffer, entry.element);
+    BinaryEncoding::appendString(buffer, entry.key);
+    BinaryEncoding::appendString(buffer, entry.value);
+    BinaryEncoding::appendVarint(buffer, entry.tag_offset);
+    BinaryEncoding::appendVarint(buffer, entry.end_offset);
+  }
+  return buffer.writeToFile(getIndexPath(source_path));
+}
+
+/**
+ * Sets the offset of the close tag of the element, once it's written.
+ * @param entry the element entry
+ * @param end_offset offset of the close tag in the source
+ */
+void XmlIndex::setElementEnd(uint32_t entry, size_t end_offset)
+{
+  entries[entry].end_offset = end_offset;
+}
+
+/**
+ * Removes all elements opened past the offset, when the source written after it is rolled back.
+ * @param offset offset in the source that is kept
+ */
+void XmlIndex::truncate(size_t offset)
+{
+  while(!entries.empty() && entries.back().tag_offset >= offset)
+    entries.pop_back();
+}
+
+/*============================================================================
+ * PUBLIC STATIC FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Appends one element level to an element path key. Levels are separated with control
+ * characters which can not appear in XML content, so any path has exactly one key.
+ * @param path_key the path key to extend
+ * @param element the element name
+ * @param key the key for the tag identifier. Blank for none
+ * @param value the value corresponding to the key
+ */
+void XmlIndex::appendPathKey(std::string& path_key, std::string_view element,
+                             std::string_view key, std::string_view value)
+{
+  path_key.append(element);
+  path_key.push_back('\x1f');
+  path_key.append(key);
+  path_key.push_back('\x1f');
+  path_key.append(value);
+  path_key.push_back('\x1e');
+}
+
+/**
+ * Returns the path of the sidecar file for the source.
+ * @param source_path file system path to the source
+ * @return sidecar file path
+ */
+std::string XmlIndex::getIndexPath(const std::string& source_path)
+{
+  return source_path + kEXTENSION;
+}
@@ -24,6 +24,18 @@ bool XmlReader::find(XmlData branch)
   return findInSource(branch);
 }
 
+/**
+ * Returns the memory resource that lines read in the session are allocated from. This is the
+ * session arena if it's enabled, otherwise the default resource.
+ * @return memory resource for lines. Valid for the life of the reader
+ */
+std::pmr::memory_resource* XmlReader::getMemoryResource()
+{
+  if(session_arena_enabled)
+    return &session_pool;
+  return std::pmr::get_default_resource();
+}
+
 /**
  * Checks if the reader has been started already and is available.
  * @return true if start() has been called and the source is still available
@@ -62,7 +74,80 @@ std::string XmlReader::lastModifiedDate()
  */
 XmlData XmlReader::read(bool& done, bool& success)
 {
-  return readFromSource(done, success);
+  FIS_PROFILE_SCOPE(Profiler::kREAD, "");
+  XmlData line = readFromSource(done, success);
+  FIS_PROFILE_NAME(XmlDataView(line).getLastElement());
+  FIS_PROFILE_BYTES(XmlDataView(line).getByteCount());
+  return line;
+}
+
+/**
+ * Reads the next batch of XML data elements in one call, into a buffer of lines owned by the
+ * caller. The buffer is grown to the count if needed but never shrunk, and is meant to be reused
+ * for every batch so the lines keep their memory between reads. Its lines allocate from the
+ * session arena when it's enabled, so they must be destroyed before stop() (a buffer of lines
+ * from another resource is cleared first). Lines that fail to read are
+ * skipped, the same as a read() loop would, but fail the batch. Calling start() is required
+ * before accessing the source.
+ * @param lines buffer of lines. The first lines, up to the returned number, are set
+ * @param done has the read reached the end of the source? (passed by reference)
+ * @param success were all the lines read, and if done, did the source end properly?
+ *                (passed by reference)
+ * @param count maximum number of lines to read. Default kBATCH_SIZE
+ * @return number of lines read into the front of the buffer
+ */
+size_t XmlReader::readBatch(std::vector<XmlData>& lines, bool& done, bool& success,
+                            size_t count)
+{
+  // Grow the buffer with lines that allocate from the memory resource of the session
+  std::pmr::memory_resource* resource = getMemoryResource();
+  if(!lines.empty() && lines.front().getMemoryResource() != resource)
+    lines.clear();
+  lines.reserve(count);
+  while(lines.size() < count)
+    lines.emplace_back(resource);
+
+#ifdef FIS_PROFILE
+  // Each line of the batch is recorded with an even share of the batch time
+  auto start = std::chrono::steady_clock::now();
+  size_t read_count = readBatchFromSource(lines, count, done, success);
+  auto duration = std::chrono::steady_clock::now() - start;
+  uint64_t duration_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+  for(size_t i = 0; i < read_count; i++)
+  {
+    XmlDataView line(lines[i]);
+    Profiler::record(Profiler::kREAD, line.getLastElement(), duration_ns / read_count,
+                     line.getByteCount());
+  }
+  return read_count;
+#else
+  return readBatchFromSource(lines, count, done, success);
+#endif
+}
+
+/**
+ * Splits the source into independent readers, each covering a contiguous run of the top-level
+ * elements (the children of the root element). Every split reader returns the same lines as this
+ * reader would for its run, including the root element at the front of each branch, so the runs
+ * can be read in parallel. The split readers are not started.
+ * @param shard_count maximum number of readers to split into
+ * @return split readers in document order. Empty if the source can't be split
+ */
+std::vector<std::unique_ptr<XmlReader>> XmlReader::split(int shard_count)
+{
+  return splitSource(shard_count);
+}
+
+/**
+ * Sets if lines read in a session are allocated from the session arena. The arena recycles the
+ * memory of freed lines without returning it to the heap, and releases it all at once when the
+ * reader is stopped. Any line read with the arena enabled must be destroyed before stop().
+ * This should only be changed while the reader is stopped.
+ * @param enabled TRUE to allocate lines from the session arena
+ */
+void XmlReader::setSessionArenaEnabled(bool enabled)
+{
+  session_arena_enabled = enabled;
 }
 
 /**
@@ -76,12 +161,16 @@ bool XmlReader::start()
 }
 
 /**
- * Stops and cleans up the reader after reading from the data source.
+ * Stops and cleans up the reader after reading from the data source. The session arena is
+ * released, which invalidates any line still held that was read with it enabled.
  * @return success status of cleaning up the fragments and closing the source
  */
 bool XmlReader::stop()
 {
-  return stopReadFromSource();
+  bool success = stopReadFromSource();
+  session_pool.release();
+  session_buffer.release();
+  return success;
 }
 
 /**
@@ -93,3 +182,49 @@ int XmlReader::totalDataCount()
 {
   return totalDataCountFromSource();
 }
+
+/*=============================================================================
+ * PRIVATE FUNCTIONS - IMPLEMENTATION SPECIFIC, OPTIONAL
+ *============================================================================*/
+
+/**
+ * Reads the next batch of XML data elements into the lines. The default reads line by line,
+ * moving each new line into the buffer. Backends that can fill a line in place override this.
+ * @param lines buffer of lines, at least count long
+ * @param count maximum number of lines to read
+ * @param done has the read reached the end of the source? (passed by reference)
+ * @param success were all the lines read, and if done, did the source end properly?
+ *                (passed by reference)
+ * @return number of lines read into the front of the buffer
+ */
+size_t XmlReader::readBatchFromSource(std::vector<XmlData>& lines, size_t count, bool& done,
+                                      bool& success)
+{
+  size_t read_count = 0;
+  bool all_valid = true;
+  done = false;
+  while(read_count < count && !done)
+  {
+    bool line_success;
+    XmlData line = readFromSource(done, line_success);
+    if(done)
+      all_valid &= line_success;
+    else if(line_success)
+      lines[read_count++] = std::move(line);
+    else
+      all_valid = false;
+  }
+
+  success = all_valid;
+  return read_count;
+}
+
+/**
+ * Splits the source into independent readers. The default is for sources that can't be split.
+ * @param shard_count maximum number of readers to split into
+ * @return no readers
+ */
+std::vector<std::unique_ptr<XmlReader>> XmlReader::splitSource(int)
+{
+  return {};
+}
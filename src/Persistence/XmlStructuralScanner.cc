@@ -0,0 +1,219 @@
+/**
+ * @class XmlStructuralScanner
+ *
+ * Vectorized classifier of the characters in XML text, used by the tokenizer to jump between the
+ * characters that matter instead of testing every byte. Each 64 byte block of text is scanned
+ * into two bitmaps, one bit per byte: the markup characters (< > = " ' & /) and the whitespace
+ * characters. The kernel is picked for the processor on the first scan: AVX2 or SSE2 on x86,
+ * otherwise a portable scalar loop. Every kernel returns the same bitmaps.
+ */
+#include "Persistence/XmlStructuralScanner.h"
+using namespace core;
+
+/* Static Implementation - see header file for descriptions */
+std::atomic<XmlStructuralScanner::BlockScan> XmlStructuralScanner::block_scan{
+    &XmlStructuralScanner::scanBlockDetect};
+std::atomic<ScanKernel> XmlStructuralScanner::kernel{ScanKernel::SCALAR};
+
+/*============================================================================
+ * PRIVATE STATIC FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Picks the fastest kernel that the processor supports and scans the block with it. This is the
+ * kernel until the first scan, so the processor is only checked once.
+ * @param block start of the 64 byte block
+ * @param markup set to the bitmap of the markup characters
+ * @param whitespace set to the bitmap of the whitespace characters
+ */
+void XmlStructuralScanner::scanBlockDetect(const char* block, uint64_t& markup,
+                                           uint64_t& whitespace)
+{
+  if(!setKernel(ScanKernel::AVX2) && !setKernel(ScanKernel::SSE2))
+    setKernel(ScanKernel::SCALAR);
+  block_scan.load(std::memory_order_relaxed)(block, markup, whitespace);
+}
+
+/**
+ * Scans a block one byte at a time. This is the reference the vector kernels must match.
+ * @param block start of the 64 byte block
+ * @param markup set to the bitmap of the markup characters
+ * @param whitespace set to the bitmap of the whitespace characters
+ */
+void XmlStructuralScanner::scanBlockScalar(const char* block, uint64_t& markup,
+                                           uint64_t& whitespace)
+{
+  markup = 0;
+  whitespace = 0;
+  for(size_t i = 0; i < kBLOCK_SIZE; i++)
+  {
+    char character = block[i];
+    if(character == '<' || character == '>' || character == '=' || character == '"' ||
+       character == '\'' || character == '&' || character == '/')
+      markup |= (uint64_t(1) << i);
+    else if(character == ' ' || character == '\n' || character == '\r' || character == '\t')
+      whitespace |= (uint64_t(1) << i);
+  }
+}
+
+#ifdef FIS_SCAN_X86
+
+/**
+ * Scans a block in four 16 byte vectors. Each character class is a compare per character,
+ * combined into a byte mask that is packed into 16 bits of the bitmap.
+ * @param block start of the 64 byte block
+ * @param markup set to the bitmap of the markup characters
+ * @param whitespace set to the bitmap of the whitespace characters
+ */
+__attribute__((target("sse2")))
+void XmlStructuralScanner::scanBlockSse2(const char* block, uint64_t& markup,
+                                         uint64_t& whitespace)
+{
+  markup = 0;
+  whitespace = 0;
+  for(size_t i = 0; i < kBLOCK_SIZE; i += 16)
+  {
+    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i));
+    __m128i markup_mask = _mm_or_si128(
+        _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('<')),
+                                  _mm_cmpeq_epi8(chunk, _mm_set1_epi8('>'))),
+                     _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('=')),
+                                  _mm_cmpeq_epi8(chunk, _mm_set1_epi8('"')))),
+        _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\'')),
+                                  _mm_cmpeq_epi8(chunk, _mm_set1_epi8('&'))),
+                     _mm_cmpeq_epi8(chunk, _mm_set1_epi8('/'))));
+    __m128i whitespace_mask = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(' ')),
+                     _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n'))),
+        _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\r')),
+                     _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\t'))));
+
+    markup |= (uint64_t(static_cast<uint16_t>(_mm_movemask_epi8(markup_mask))) << i);
+    whitespace |= (uint64_t(static_cast<uint16_t>(_mm_movemask_epi8(whitespace_mask))) << i);
+  }
+}
+
+/**
+ * Scans a block in two 32 byte vectors, the same as the SSE2 kernel with twice the width.
+ * @param block start of the 64 byte block
+ * @param markup set to the bitmap of the markup characters
+ * @param whitespace set to the bitmap of the whitespace characters
+ */
+__attribute__((target("avx2")))
+void XmlStructuralScanner::scanBlockAvx2(const char* block, uint64_t& markup,
+                                         uint64_t& whitespace)
+{
+  markup = 0;
+  whitespace = 0;
+  for(size_t i = 0; i < kBLOCK_SIZE; i += 32)
+  {
+    __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + i));
+    __m256i markup_mask = _mm256_or_si256(
+        _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('<')),
+                                        _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('>'))),
+                        _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('=')),
+                                        _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('"')))),
+        _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\'')),
+                                        _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('&'))),
+                        _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('/'))));
+    __m256i whitespace_mask = _mm256_or_si256(
+        _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(' ')),
+                        _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\n'))),
+        _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\r')),
+                        _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\t'))));
+
+    markup |= (uint64_t(static_cast<uint32_t>(_mm256_movemask_epi8(markup_mask))) << i);
+    whitespace |=
+        (uint64_t(static_cast<uint32_t>(_mm256_movemask_epi8(whitespace_mask))) << i);
+  }
+}
+
+#endif // FIS_SCAN_X86
+
+/*============================================================================
+ * PUBLIC STATIC FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Returns the instruction set of the kernel in use. If nothing has been scanned yet, the kernel
+ * is picked first.
+ * @return kernel instruction set
+ */
+ScanKernel XmlStructuralScanner::getKernel()
+{
+  if(block_scan.load(std::memory_order_relaxed) == &scanBlockDetect)
+  {
+    char block[kBLOCK_SIZE] = {};
+    uint64_t markup;
+    uint64_t whitespace;
+    scanBlockDetect(block, markup, whitespace);
+  }
+  return kernel.load(std::memory_order_relaxed);
+}
+
+/**
+ * Returns if the processor supports the kernel. The scalar kernel is supported everywhere and
+ * the vector kernels only on x86 processors with the instruction set.
+ * @param kernel the kernel instruction set
+ * @return TRUE if the kernel can be used
+ */
+bool XmlStructuralScanner::isKernelSupported(ScanKernel kernel)
+{
+#ifdef FIS_SCAN_X86
+  __builtin_cpu_init();
+  if(kernel == ScanKernel::SSE2)
+    return __builtin_cpu_supports("sse2");
+  else if(kernel == ScanKernel::AVX2)
+    return __builtin_cpu_supports("avx2");
+#endif
+  return (kernel == ScanKernel::SCALAR);
+}
+
+/**
+ * Scans the 64 byte block of the text at the offset. A block that runs past the end of the text
+ * is scanned from a zero padded copy, so the bits past the end are always clear.
+ * @param data start of the text
+ * @param size number of bytes in the text
+ * @param offset offset of the block in the text
+ * @param markup set to the bitmap of the markup characters: bit i for the byte at offset + i
+ * @param whitespace set to the bitmap of the whitespace characters
+ */
+void XmlStructuralScanner::scanBlock(const char* data, size_t size, size_t offset,
+                                     uint64_t& markup, uint64_t& whitespace)
+{
+  BlockScan scan = block_scan.load(std::memory_order_relaxed);
+  if(offset + kBLOCK_SIZE <= size)
+  {
+    scan(data + offset, markup, whitespace);
+  }
+  else
+  {
+    char block[kBLOCK_SIZE] = {};
+    if(offset < size)
+      std::memcpy(block, data + offset, size - offset);
+    scan(block, markup, whitespace);
+  }
+}
+
+/**
+ * Sets the kernel to scan with, such as to compare them in benchmarks. It applies to every scan
+ * that starts after it's set, on any thread.
+ * @param kernel the kernel instruction set
+ * @return TRUE if the kernel is supported and now in use
+ */
+bool XmlStructuralScanner::setKernel(ScanKernel kernel)
+{
+  if(!isKernelSupported(kernel))
+    return false;
+
+  BlockScan scan = &scanBlockScalar;
+#ifdef FIS_SCAN_X86
+  if(kernel == ScanKernel::SSE2)
+    scan = &scanBlockSse2;
+  else if(kernel == ScanKernel::AVX2)
+    scan = &scanBlockAvx2;
+#endif
+  XmlStructuralScanner::kernel.store(kernel, std::memory_order_relaxed);
+  block_scan.store(scan, std::memory_order_relaxed);
+  return true;
+}
@@ -0,0 +1,595 @@
+/**
+ * @class XmlTokenizer
+ *
+ * Incremental pull tokenizer over a raw XML text buffer. Each call to next() scans exactly one
+ * markup token (open tag, close tag, empty tag or text run) and exposes it as views into the
+ * buffer, so no memory is allocated while scanning. Declarations, comments and doctype nodes are
+ * skipped. The buffer is not owned and must outlive the tokenizer.
+ *
+ * The buffer is classified a 64 byte block at a time by {@link XmlStructuralScanner}, and names,
+ * whitespace, text runs and attribute values are all found from the bitmaps of the block, so
+ * only the characters that end a token are ever tested one at a time.
+ */
+#include "Persistence/XmlTokenizer.h"
+using namespace core;
+
+/*============================================================================
+ * CONSTRUCTORS / DESTRUCTORS
+ *===========================================================================*/
+
+/**
+ * Constructor function - Sets up the tokenizer at the start of the raw text buffer.
+ * @param data start of the raw text buffer. Not owned, must outlive the tokenizer
+ * @param size number of bytes in the buffer
+ */
+XmlTokenizer::XmlTokenizer(const char* data, size_t size)
+            : data{data},
+              size{size}
+{
+}
+
+/*============================================================================
+ * PRIVATE FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Appends a numeric character reference, re-encoded as UTF-8. The reference must be a run of at
+ * least one decimal digit, or hex digit after an 'x', that names a Unicode scalar value. So
+ * surrogates (D800-DFFF) and anything past 10FFFF are malformed.
+ * @param entity the reference between the '&' and the ';', starting with the '#'
+ * @param decoded the plain string output. Untouched if the reference is malformed
+ * @return TRUE if the reference was well formed and appended
+ */
+bool XmlTokenizer::appendCharacterReference(std::string_view entity, std::string& decoded)
+{
+  bool hex = (entity.size() > 1 && (entity[1] == 'x' || entity[1] == 'X'));
+  size_t first_digit = (hex ? 2 : 1);
+  if(entity.size() <= first_digit)
+    return false;
+
+  // Capped at the last code point on every digit, so the value never overflows
+  uint32_t code_point = 0;
+  for(size_t i = first_digit; i < entity.size(); i++)
+  {
+    char digit = entity[i];
+    uint32_t digit_value;
+    if(digit >= '0' && digit <= '9')
+      digit_value = static_cast<uint32_t>(digit - '0');
+    else if(hex && digit >= 'a' && digit <= 'f')
+      digit_value = static_cast<uint32_t>(digit - 'a' + 10);
+    else if(hex && digit >= 'A' && digit <= 'F')
+      digit_value = static_cast<uint32_t>(digit - 'A' + 10);
+    else
+      return false;
+
+    code_point = code_point * (hex ? 16 : 10) + digit_value;
+    if(code_point > 0x10FFFF)
+      return false;
+  }
+  if(code_point >= 0xD800 && code_point <= 0xDFFF)
+    return false;
+
+  if(code_point < 0x80)
+    decoded.push_back(static_cast<char>(code_point));
+  else if(code_point < 0x800)
+  {
+    decoded.push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+    decoded.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  }
+  else if(code_point < 0x10000)
+  {
+    decoded.push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+    decoded.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+    decoded.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  }
+  else
+  {
+    decoded.push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+    decoded.push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+    decoded.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+    decoded.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  }
+  return true;
+}
+
+/**
+ * Finds the next markup character (< > = " ' & /) from the offset.
+ * @param from offset to start at
+ * @return offset of the markup character. The size if there is none
+ */
+size_t XmlTokenizer::findMarkup(size_t from)
+{
+  while(from < size)
+  {
+    size_t block = scanBlockAt(from);
+    uint64_t bits = block_markup & (~uint64_t(0) << (from - block));
+    if(bits != 0)
+      return block + __builtin_ctzll(bits);
+    from = block + XmlStructuralScanner::kBLOCK_SIZE;
+  }
+  return size;
+}
+
+/**
+ * Finds the next markup or whitespace character from the offset.
+ * @param from offset to start at
+ * @return offset of the character. The size if there is none
+ */
+size_t XmlTokenizer::findMarkupOrWhitespace(size_t from)
+{
+  while(from < size)
+  {
+    size_t block = scanBlockAt(from);
+    uint64_t bits = (block_markup | block_whitespace) & (~uint64_t(0) << (from - block));
+    if(bits != 0)
+      return block + __builtin_ctzll(bits);
+    from = block + XmlStructuralScanner::kBLOCK_SIZE;
+  }
+  return size;
+}
+
+/**
+ * Finds the next character from the offset that is not whitespace.
+ * @param from offset to start at
+ * @return offset of the character. The size if there is none
+ */
+size_t XmlTokenizer::findNonWhitespace(size_t from)
+{
+  while(from < size)
+  {
+    size_t block = scanBlockAt(from);
+    uint64_t bits = ~block_whitespace & (~uint64_t(0) << (from - block));
+    if(bits != 0)
+      return std::min(block + __builtin_ctzll(bits), size);
+    from = block + XmlStructuralScanner::kBLOCK_SIZE;
+  }
+  return size;
+}
+
+/**
+ * Checks if the character is XML whitespace (space, tab, carriage return or line feed).
+ * @param character the character to check
+ * @return TRUE if whitespace
+ */
+bool XmlTokenizer::isWhitespace(char character)
+{
+  return (character == ' ' || character == '\n' || character == '\r' || character == '\t');
+}
+
+/**
+ * Scans the 64 byte block that holds the offset, unless it's the block already scanned.
+ * @param from offset in the buffer
+ * @return offset of the start of the block
+ */
+size_t XmlTokenizer::scanBlockAt(size_t from)
+{
+  size_t block = from - (from % XmlStructuralScanner::kBLOCK_SIZE);
+  if(block != block_offset)
+  {
+    XmlStructuralScanner::scanBlock(data, size, block, block_markup, block_whitespace);
+    block_offset = block;
+  }
+  return block;
+}
+
+/**
+ * Scans a tag or attribute name starting at the current offset. The offset is left on the first
+ * character after the name.
+ * @return view of the name. Empty if there is no name at the offset
+ */
+std::string_view XmlTokenizer::scanName()
+{
+  size_t start = offset;
+  while(true)
+  {
+    offset = findMarkupOrWhitespace(offset);
+    if(offset >= size)
+      break;
+
+    char character = data[offset];
+    if(isWhitespace(character) || character == '>' || character == '/' || character == '=')
+      break;
+    offset++;
+  }
+  return std::string_view(data + start, offset - start);
+}
+
+/**
+ * Scans a tag starting at the current offset, which must be just past the opening '<'. Only the
+ * first attribute of an element is kept, since a single line of XML data only holds one key and
+ * value per element. Any further attributes are validated and skipped. A tag that is cut off by
+ * the end of the buffer leaves the offset at the end, so it can be scanned again once the buffer
+ * holds more of it.
+ * @return the classification of the scanned tag. ERROR if the tag is malformed
+ */
+XmlTokenType XmlTokenizer::scanTag()
+{
+  bool closing = (offset < size && data[offset] == '/');
+  if(closing)
+    offset++;
+
+  name = scanName();
+  key = std::string_view();
+  value = std::string_view();
+  if(name.empty())
+    return XmlTokenType::ERROR;
+
+  if(closing)
+  {
+    skipWhitespace();
+    if(offset >= size || data[offset] != '>')
+      return XmlTokenType::ERROR;
+    offset++;
+    return XmlTokenType::ELEMENT_CLOSE;
+  }
+
+  bool first_attribute = true;
+  while(true)
+  {
+    skipWhitespace();
+    if(offset >= size)
+      return XmlTokenType::ERROR;
+
+    // End of the tag
+    if(data[offset] == '>')
+    {
+      offset++;
+      return XmlTokenType::ELEMENT_OPEN;
+    }
+    else if(data[offset] == '/')
+    {
+      if(offset + 1 >= size)
+        offset = size;
+      if(offset >= size || data[offset + 1] != '>')
+        return XmlTokenType::ERROR;
+      offset += 2;
+      return XmlTokenType::ELEMENT_EMPTY;
+    }
+
+    // Attribute: name = "value"
+    std::string_view attribute_name = scanName();
+    skipWhitespace();
+    if(attribute_name.empty() || offset >= size || data[offset] != '=')
+      return XmlTokenType::ERROR;
+    offset++;
+    skipWhitespace();
+    if(offset >= size || (data[offset] != '"' && data[offset] != '\''))
+      return XmlTokenType::ERROR;
+
+    char quote = data[offset++];
+    size_t quote_end = findMarkup(offset);
+    while(quote_end < size && data[quote_end] != quote)
+      quote_end = findMarkup(quote_end + 1);
+    if(quote_end >= size)
+    {
+      offset = size;
+      return XmlTokenType::ERROR;
+    }
+
+    if(first_attribute)
+    {
+      key = attribute_name;
+      value = std::string_view(data + offset, quote_end - offset);
+      first_attribute = false;
+    }
+    offset = quote_end + 1;
+  }
+}
+
+/**
+ * Moves the scan offset just past the next occurrence of the terminator.
+ * @param terminator the character sequence to find
+ * @return TRUE if found. FALSE if the end of the buffer was reached first
+ */
+bool XmlTokenizer::skipPast(std::string_view terminator)
+{
+  size_t found = std::string_view(data, size).find(terminator, offset);
+  if(found == std::string_view::npos)
+  {
+    offset = size;
+    return false;
+  }
+  offset = found + terminator.size();
+  return true;
+}
+
+/**
+ * Moves the scan offset past any whitespace.
+ */
+void XmlTokenizer::skipWhitespace()
+{
+  offset = findNonWhitespace(offset);
+}
+
+/*============================================================================
+ * PUBLIC FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Returns the first attribute key of the last open or empty element token.
+ * @return raw view into the buffer. Empty if the element had no attributes
+ */
+std::string_view XmlTokenizer::getKey() const
+{
+  return key;
+}
+
+/**
+ * Returns the tag name of the last element token (open, close or empty).
+ * @return raw view into the buffer
+ */
+std::string_view XmlTokenizer::getName() const
+{
+  return name;
+}
+
+/**
+ * Returns the current scan offset in the buffer. This is the location that the next call to
+ * next() will start scanning from.
+ * @return byte offset
+ */
+size_t XmlTokenizer::getOffset() const
+{
+  return offset;
+}
+
+/**
+ * Returns the size of the buffer being scanned.
+ * @return size in bytes
+ */
+size_t XmlTokenizer::getSize() const
+{
+  return size;
+}
+
+/**
+ * Returns the raw text of the last text token. Use decode() to resolve the entities if
+ * isTextEncoded() is set.
+ * @return raw view into the buffer
+ */
+std::string_view XmlTokenizer::getText() const
+{
+  return text;
+}
+
+/**
+ * Returns the buffer offset where the last token started (the '<' for any tag).
+ * @return byte offset
+ */
+size_t XmlTokenizer::getTokenOffset() const
+{
+  return token_offset;
+}
+
+/**
+ * Returns the first attribute value of the last open or empty element token.
+ * @return raw view into the buffer, still entity encoded
+ */
+std::string_view XmlTokenizer::getValue() const
+{
+  return value;
+}
+
+/**
+ * Returns if the last text token is entity encoded. Text inside a CDATA section is not.
+ * @return TRUE if decode() should be used on the text
+ */
+bool XmlTokenizer::isTextEncoded() const
+{
+  return text_encoded;
+}
+
+/**
+ * Scans the next token in the buffer. Declarations, comments and doctype nodes are skipped over
+ * without being returned.
+ * @return the classification of the token. END once the buffer is exhausted and ERROR if the
+ *         markup is malformed
+ */
+XmlTokenType XmlTokenizer::next()
+{
+  while(offset < size)
+  {
+    token_offset = offset;
+
+    // Text run, up to the next markup
+    if(data[offset] != '<')
+    {
+      size_t text_end = findMarkup(offset);
+      while(text_end < size && data[text_end] != '<')
+        text_end = findMarkup(text_end + 1);
+
+      text = std::string_view(data + offset, text_end - offset);
+      text_encoded = true;
+      offset = text_end;
+      return XmlTokenType::TEXT;
+    }
+
+    // Element tag, unless it's one of the special nodes that start with "<?" or "<!"
+    char tag_start = (offset + 1 < size ? data[offset + 1] : '\0');
+    if(tag_start != '?' && tag_start != '!')
+    {
+      offset++;
+      return scanTag();
+    }
+
+    std::string_view remaining(data + offset, size - offset);
+    if(remaining.compare(0, 2, "<?") == 0)
+    {
+      if(!skipPast("?>"))
+        return XmlTokenType::ERROR;
+    }
+    else if(remaining.compare(0, 4, "<!--") == 0)
+    {
+      if(!skipPast("-->"))
+        return XmlTokenType::ERROR;
+    }
+    else if(remaining.compare(0, 9, "<![CDATA[") == 0)
+    {
+      size_t text_start = offset + 9;
+      offset = text_start;
+      if(!skipPast("]]>"))
+        return XmlTokenType::ERROR;
+
+      text = std::string_view(data + text_start, offset - 3 - text_start);
+      text_encoded = false;
+      return XmlTokenType::TEXT;
+    }
+    else
+    {
+      if(!skipPast(">"))
+        return XmlTokenType::ERROR;
+    }
+  }
+
+  token_offset = offset;
+  return XmlTokenType::END;
+}
+
+/**
+ * Moves the scan offset to a new location in the buffer. This must be at a token boundary for
+ * the next scan to be meaningful.
+ * @param offset byte offset in the buffer. Clamped to the buffer size
+ */
+void XmlTokenizer::seek(size_t offset)
+{
+  this->offset = (offset < size ? offset : size);
+}
+
+/*============================================================================
+ * PUBLIC STATIC FUNCTIONS
+ *===========================================================================*/
+
+/**
+ * Decodes the XML entities in raw text into a plain string. Any unknown or malformed entity is
+ * left as is.
+ * @param raw entity encoded text or attribute value
+ * @return the plain decoded string
+ */
+std::string XmlTokenizer::decode(std::string_view raw)
+{
+  std::string decoded;
+  decode(raw, decoded);
+  return decoded;
+}
+
+/**
+ * Decodes the XML entities in raw text into a plain string. The five predefined entities and
+ * numeric character references are resolved. An unknown or malformed entity is left as is, and
+ * makes the text malformed.
+ * @param raw entity encoded text or attribute value
+ * @param decoded the plain string output. The decoded text is appended to any existing content
+ * @return TRUE if every entity was well formed and resolved
+ */
+bool XmlTokenizer::decode(std::string_view raw, std::string& decoded)
+{
+  bool valid = true;
+  size_t start = 0;
+  size_t amp = raw.find('&');
+  while(amp != std::string_view::npos)
+  {
+    decoded.append(raw.data() + start, amp - start);
+
+    size_t semicolon = raw.find(';', amp);
+    std::string_view entity = (semicolon != std::string_view::npos
+                                 ? raw.substr(amp + 1, semicolon - amp - 1)
+                                 : std::string_view());
+    bool resolved = true;
+    if(entity == "lt")
+      decoded.push_back('<');
+    else if(entity == "gt")
+      decoded.push_back('>');
+    else if(entity == "amp")
+      decoded.push_back('&');
+    else if(entity == "quot")
+      decoded.push_back('"');
+    else if(entity == "apos")
+      decoded.push_back('\'');
+    else if(!entity.empty() && entity[0] == '#')
+      resolved = appendCharacterReference(entity, decoded);
+    else
+      resolved = false;
+
+    if(!resolved)
+    {
+      // Unknown or malformed entity, leave it untouched
+      valid = false;
+      decoded.push_back('&');
+      start = amp + 1;
+      amp = raw.find('&', start);
+      continue;
+    }
+
+    start = semicolon + 1;
+    amp = raw.find('&', start);
+  }
+
+  decoded.append(raw.data() + start, raw.size() - start);
+  return valid;
+}
+
+/**
+ * Decodes the XML entities in raw text, without a copy when there are none. Most names, keys and
+ * values hold no entities, so they're read straight from the buffer.
+ * @param raw entity encoded text or attribute value
+ * @param scratch buffer the text is decoded into if it has any entities. Replaced
+ * @param valid cleared if an entity is unknown or malformed. Untouched otherwise
+ * @return the plain text. A view of the raw text or of the scratch buffer, valid until either
+ *         changes
+ */
+std::string_view XmlTokenizer::decodeView(std::string_view raw, std::string& scratch,
+                                          bool& valid)
+{
+  if(raw.find('&') == std::string_view::npos)
+    return raw;
+
+  scratch.clear();
+  if(!decode(raw, scratch))
+    valid = false;
+  return scratch;
+}
+
+/**
+ * Encodes the XML reserved characters in plain text, for use as element text or an attribute
+ * value.
+ * @param plain the plain text
+ * @return the entity encoded string
+ */
+std::string XmlTokenizer::encode(std::string_view plain)
+{
+  std::string encoded;
+  encode(plain, encoded);
+  return encoded;
+}
+
+/**
+ * Encodes the XML reserved characters in plain text, for use as element text or an attribute
+ * value. Only the five predefined entities are used; all other characters pass through as is.
+ * @param plain the plain text
+ * @param encoded the entity encoded output. The encoded text is appended to any existing content
+ */
+void XmlTokenizer::encode(std::string_view plain, std::string& encoded)
+{
+  size_t start = 0;
+  size_t reserved = plain.find_first_of("<>&\"'");
+  while(reserved != std::string_view::npos)
+  {
+    encoded.append(plain.data() + start, reserved - start);
+
+    char character = plain[reserved];
+    if(character == '<')
+      encoded.append("&lt;");
+    else if(character == '>')
+      encoded.append("&gt;");
+    else if(character == '&')
+      encoded.append("&amp;");
+    else if(character == '"')
+      encoded.append("&quot;");
+    else
+      encoded.append("&apos;");
+
+    start = reserved + 1;
+    reserved = plain.find_first_of("<>&\"'", start);
+  }
+
+  encoded.append(plain.data() + start, plain.size() - start);
+}
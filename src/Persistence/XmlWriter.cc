@@ -33,6 +33,17 @@ bool XmlWriter::find(XmlData branch)
   return findInSource(branch);
 }
 
+/**
+ * Checks if the writer adds to the content already saved in the data source, such as appending
+ * to a log, instead of replacing it with the document written since start(). Only such a writer
+ * can save part of the state, since everything else is kept.
+ * @return true if the saved content is kept and added to
+ */
+bool XmlWriter::isIncremental()
+{
+  return isSourceIncremental();
+}
+
 /**
  * Checks if the writer has been started already and is available.
  * @return true if start() has been called and the source is still available
@@ -62,6 +73,28 @@ bool XmlWriter::jumpToRoot()
   return jumpToRootInSource();
 }
 
+/**
+ * Moves the writer to the child elements beneath the current node, to rewrite their content.
+ * This is only done by a writer that adds to the saved content (see {@link #isIncremental}),
+ * since any other would replace the whole save with just the rewritten content. If the writer
+ * can find the elements, all of their existing children are deleted. Writers that can't revisit
+ * saved nodes (append only) write the elements and then delete their children, which records a
+ * removal of everything saved beneath them before it, so the rewrite replaces it on load, even
+ * the lines that the new content no longer has. Either way, the writer finishes at the last
+ * element of the set and the content can be written.
+ * @param element_set element branch from the current node, that only holds the rewritten content
+ * @return success status of moving to the elements. false, without moving, if the writer
+ *         replaces the saved content
+ */
+bool XmlWriter::rewriteElements(XmlData element_set)
+{
+  if(!isIncremental())
+    return false;
+  if(find(element_set))
+    return deleteChildren();
+  return (writeElements(element_set) && deleteChildren());
+}
+
 /**
  * Configures and sets up the class to start writing to the data source. This is required
  * before calling any other functions. It may or may not read a data source first into memory or
@@ -92,6 +125,8 @@ bool XmlWriter::stop(bool save_changes)
  */
 bool XmlWriter::writeData(std::string element, DataType type, std::string data)
 {
+  FIS_PROFILE_SCOPE(Profiler::kWRITE, element);
+  FIS_PROFILE_BYTES(element.size() + data.size());
   return writeDataToSource(element, type, data);
 }
 
@@ -103,6 +138,8 @@ bool XmlWriter::writeData(std::string element, DataType type, std::string data)
  */
 bool XmlWriter::writeData(std::string element, bool data)
 {
+  FIS_PROFILE_SCOPE(Profiler::kWRITE, element);
+  FIS_PROFILE_BYTES(element.size() + sizeof(data));
   return writeDataToSource(element, data);
 }
 
@@ -114,6 +151,8 @@ bool XmlWriter::writeData(std::string element, bool data)
  */
 bool XmlWriter::writeData(std::string element, float data)
 {
+  FIS_PROFILE_SCOPE(Profiler::kWRITE, element);
+  FIS_PROFILE_BYTES(element.size() + sizeof(data));
   return writeDataToSource(element, data);
 }
 
@@ -125,6 +164,8 @@ bool XmlWriter::writeData(std::string element, float data)
  */
 bool XmlWriter::writeData(std::string element, int data)
 {
+  FIS_PROFILE_SCOPE(Profiler::kWRITE, element);
+  FIS_PROFILE_BYTES(element.size() + sizeof(data));
   return writeDataToSource(element, data);
 }
 
@@ -136,6 +177,8 @@ bool XmlWriter::writeData(std::string element, int data)
  */
 bool XmlWriter::writeData(std::string element, std::string data)
 {
+  FIS_PROFILE_SCOPE(Profiler::kWRITE, element);
+  FIS_PROFILE_BYTES(element.size() + data.size());
   return writeDataToSource(element, data);
 }
 
@@ -143,11 +186,14 @@ bool XmlWriter::writeData(std::string element, std::string data)
  * Writes an element that encapsulates a unsigned int at the current location in the XML document.
  * @param element name of the XML tag to wrap the data
  * @param data unsigned int type to be stored and wrapped between the open and closing tags.
- *             This wraps under the same general integer data type but handles the casting
+ *             This is stored under the same general integer data type, as its full unsigned
+ *             value, and reads back as the int with the same bits
  * @return true if successfully written to the current source
  */
 bool XmlWriter::writeData(std::string element, uint32_t data)
 {
+  FIS_PROFILE_SCOPE(Profiler::kWRITE, element);
+  FIS_PROFILE_BYTES(element.size() + sizeof(data));
   return writeDataToSource(element, data);
 }
 
@@ -161,6 +207,8 @@ bool XmlWriter::writeData(std::string element, uint32_t data)
  */
 bool XmlWriter::writeElement(std::string element, std::string key, std::string value)
 {
+  FIS_PROFILE_SCOPE(Profiler::kWRITE, element);
+  FIS_PROFILE_BYTES(element.size() + key.size() + value.size());
   return writeElementToSource(element, key, value);
 }
 
@@ -175,5 +223,21 @@ bool XmlWriter::writeElement(std::string element, std::string key, std::string v
  */
 bool XmlWriter::writeElements(XmlData element_set)
 {
+  FIS_PROFILE_SCOPE(Profiler::kWRITE, XmlDataView(element_set).getLastElement());
+  FIS_PROFILE_BYTES(XmlDataView(element_set).getByteCount());
   return writeElementsToSource(element_set);
 }
+
+/*=============================================================================
+ * PRIVATE FUNCTIONS - IMPLEMENTATION SPECIFIC, OPTIONAL
+ *============================================================================*/
+
+/**
+ * Checks if the writer adds to the saved content. The default is for writers that replace the
+ * whole document on each save.
+ * @return false
+ */
+bool XmlWriter::isSourceIncremental()
+{
+  return false;
+}